@@ -0,0 +1,721 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshComponent.h"
+#include "RuntimeMeshGenericVertex.h"
+#include "RuntimeMeshRendering.h"
+
+
+/*
+*	RuntimeMesh.Benchmark runs create/update workloads on a temporary component and writes the results as CSV,
+*	so throughput can be compared between engine versions or local changes. Each value is a list, every combination
+*	of them is run:
+*
+*		Vertices=1024,65536		Total vertices per workload, split evenly over the sections. Defaults go up to 4M
+*		Sections=1,64			Number of sections
+*		UVChannels=1,2			Generic vertex UV channel counts to run, 1 2 and 4 are supported
+*		HalfUVs=0,1				Full and/or half precision UVs
+*		Dual=0,1				Single and/or dual buffer sections
+*		Move=0,1				With and/or without ESectionUpdateFlags::MoveArrays
+*		Batch=0,1				Unbatched and/or inside BeginBatchUpdates/EndBatchUpdates
+*		Iterations=3			Times each workload is run
+*		Out=Path.csv			Output file, defaults to a timestamped file in the profiling directory
+*
+*	Render thread time is measured by holding the render thread until the game thread has issued all of a phase's
+*	commands, then timing how long it takes to work through them. Without a rendering thread it's part of the game thread time.
+*	Copied and uploaded bytes are totals over all iterations, peak memory is the highest of any iteration.
+*/
+namespace RuntimeMeshBenchmark
+{
+	struct FSettings
+	{
+		TArray<int32> VertexCounts;
+		TArray<int32> SectionCounts;
+		TArray<int32> UVChannels;
+		TArray<int32> HalfUVs;
+		TArray<int32> DualBuffer;
+		TArray<int32> MoveArrays;
+		TArray<int32> Batched;
+		int32 Iterations;
+		FString OutputPath;
+	};
+
+	struct FWorkload
+	{
+		int32 NumVertices;
+		int32 NumSections;
+		bool bDualBuffer;
+		bool bMoveArrays;
+		bool bBatched;
+	};
+
+	/* Measurements of one phase over all iterations. Byte counts are summed over them */
+	struct FPhaseResult
+	{
+		FString Phase;
+		TArray<double> GameThreadMs;
+		TArray<double> RenderThreadMs;
+		int64 BytesCopied;
+		int64 BytesUploaded;
+		int64 PeakMemoryBytes;
+
+		FPhaseResult() : BytesCopied(0), BytesUploaded(0), PeakMemoryBytes(0) { }
+	};
+
+	static double GetMean(const TArray<double>& Values)
+	{
+		double Sum = 0.0;
+		for (double Value : Values)
+		{
+			Sum += Value;
+		}
+		return Values.Num() > 0 ? Sum / Values.Num() : 0.0;
+	}
+
+	static double GetMin(const TArray<double>& Values)
+	{
+		return Values.Num() > 0 ? FMath::Min(Values) : 0.0;
+	}
+
+	static int64 GetUsedPhysicalMemory()
+	{
+		return (int64)FPlatformMemory::GetStats().UsedPhysical;
+	}
+
+	/* Times one phase on the game thread and the render thread */
+	class FPhaseTimer
+	{
+	public:
+		FPhaseTimer() : RenderThreadGate(nullptr), RenderThreadStart(0.0), RenderThreadEnd(0.0), GameThreadStart(0.0), GameThreadMs(0.0),
+			StartUploadedBytes(0), StartMemory(0), PeakMemory(0) { }
+
+		void Begin()
+		{
+			FlushRenderingCommands();
+
+			StartUploadedBytes = FRuntimeMeshUploadStats::TotalBytesUploaded.GetValue();
+			StartMemory = PeakMemory = GetUsedPhysicalMemory();
+
+			if (GIsThreadedRendering)
+			{
+				// Holds the render thread so it only starts on this phase's commands once they've all been issued
+				RenderThreadGate = FPlatformProcess::GetSynchEventFromPool(true);
+				ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+					FRuntimeMeshBenchmarkGate,
+					FEvent*, Gate, RenderThreadGate,
+					double*, Start, &RenderThreadStart,
+					{
+						// Don't hang forever if something on the game thread waits for the render thread
+						if (!Gate->Wait(60 * 1000))
+						{
+							UE_LOG(RuntimeMeshLog, Warning, TEXT("RuntimeMesh.Benchmark - Render thread gate timed out, render thread times are invalid."));
+						}
+						*Start = FPlatformTime::Seconds();
+					});
+			}
+
+			GameThreadStart = FPlatformTime::Seconds();
+		}
+
+		/* Samples memory part way through the phase, the source arrays and section copies are only all alive at once while it runs */
+		void SampleMemory()
+		{
+			PeakMemory = FMath::Max(PeakMemory, GetUsedPhysicalMemory());
+		}
+
+		void End(FPhaseResult& Result)
+		{
+			GameThreadMs = (FPlatformTime::Seconds() - GameThreadStart) * 1000.0;
+			SampleMemory();
+
+			double RenderThreadMs = 0.0;
+			if (RenderThreadGate)
+			{
+				ENQUEUE_UNIQUE_RENDER_COMMAND_ONEPARAMETER(
+					FRuntimeMeshBenchmarkEnd,
+					double*, End, &RenderThreadEnd,
+					{
+						*End = FPlatformTime::Seconds();
+					});
+
+				RenderThreadGate->Trigger();
+				FlushRenderingCommands();
+				FPlatformProcess::ReturnSynchEventToPool(RenderThreadGate);
+				RenderThreadGate = nullptr;
+
+				RenderThreadMs = (RenderThreadEnd - RenderThreadStart) * 1000.0;
+			}
+			else
+			{
+				FlushRenderingCommands();
+			}
+
+			SampleMemory();
+
+			Result.GameThreadMs.Add(GameThreadMs);
+			Result.RenderThreadMs.Add(RenderThreadMs);
+			Result.BytesUploaded += FRuntimeMeshUploadStats::TotalBytesUploaded.GetValue() - StartUploadedBytes;
+			Result.PeakMemoryBytes = FMath::Max(Result.PeakMemoryBytes, PeakMemory - StartMemory);
+		}
+
+	private:
+		FEvent* RenderThreadGate;
+		double RenderThreadStart;
+		double RenderThreadEnd;
+		double GameThreadStart;
+		double GameThreadMs;
+		int64 StartUploadedBytes;
+		int64 StartMemory;
+		int64 PeakMemory;
+	};
+
+
+	template<typename VertexType>
+	static typename TEnableIf<FVertexHasPositionComponent<VertexType>::Value>::Type SetVertexPosition(VertexType& Vertex, const FVector& Position)
+	{
+		Vertex.Position = Position;
+	}
+
+	template<typename VertexType>
+	static typename TEnableIf<!FVertexHasPositionComponent<VertexType>::Value>::Type SetVertexPosition(VertexType& Vertex, const FVector& Position)
+	{
+	}
+
+	/* Builds a flat grid with about NumVertices vertices. Offset moves it so updates actually change the data */
+	template<typename VertexType>
+	static void BuildGrid(int32 NumVertices, float Offset, TArray<FVector>& OutPositions, TArray<VertexType>& OutVertices, TArray<int32>& OutTriangles)
+	{
+		const int32 Side = FMath::Max(2, FMath::CeilToInt(FMath::Sqrt((float)NumVertices)));
+
+		OutPositions.SetNumUninitialized(Side * Side);
+		OutVertices.SetNum(Side * Side);
+		for (int32 Y = 0; Y < Side; Y++)
+		{
+			for (int32 X = 0; X < Side; X++)
+			{
+				const int32 Index = Y * Side + X;
+				OutPositions[Index] = FVector(X * 10.0f, Y * 10.0f, Offset);
+				SetVertexPosition(OutVertices[Index], OutPositions[Index]);
+				OutVertices[Index].UV0 = FVector2D((float)X / (Side - 1), (float)Y / (Side - 1));
+			}
+		}
+
+		OutTriangles.Reset((Side - 1) * (Side - 1) * 6);
+		for (int32 Y = 0; Y < Side - 1; Y++)
+		{
+			for (int32 X = 0; X < Side - 1; X++)
+			{
+				const int32 Index = Y * Side + X;
+				OutTriangles.Add(Index);
+				OutTriangles.Add(Index + Side);
+				OutTriangles.Add(Index + 1);
+				OutTriangles.Add(Index + 1);
+				OutTriangles.Add(Index + Side);
+				OutTriangles.Add(Index + Side + 1);
+			}
+		}
+	}
+
+	/* Source data for every section of a phase, built before the phase is timed */
+	template<typename VertexType>
+	struct FPhaseData
+	{
+		TArray<TArray<FVector>> Positions;
+		TArray<TArray<VertexType>> Vertices;
+		TArray<TArray<int32>> Triangles;
+
+		void Build(const FWorkload& Workload, float Offset)
+		{
+			const int32 VerticesPerSection = FMath::Max(4, Workload.NumVertices / Workload.NumSections);
+
+			Positions.SetNum(Workload.NumSections);
+			Vertices.SetNum(Workload.NumSections);
+			Triangles.SetNum(Workload.NumSections);
+
+			BuildGrid(VerticesPerSection, Offset, Positions[0], Vertices[0], Triangles[0]);
+			for (int32 SectionIdx = 1; SectionIdx < Workload.NumSections; SectionIdx++)
+			{
+				Positions[SectionIdx] = Positions[0];
+				Vertices[SectionIdx] = Vertices[0];
+				Triangles[SectionIdx] = Triangles[0];
+			}
+		}
+
+		/* Bytes the component has to copy out of the source arrays when they aren't moved */
+		int64 GetSize(bool bIncludePositions, bool bIncludeVertices, bool bIncludeTriangles) const
+		{
+			int64 Size = 0;
+			for (int32 SectionIdx = 0; SectionIdx < Vertices.Num(); SectionIdx++)
+			{
+				Size += bIncludePositions ? Positions[SectionIdx].Num() * sizeof(FVector) : 0;
+				Size += bIncludeVertices ? Vertices[SectionIdx].Num() * sizeof(VertexType) : 0;
+				Size += bIncludeTriangles ? Triangles[SectionIdx].Num() * sizeof(int32) : 0;
+			}
+			return Size;
+		}
+	};
+
+	template<typename VertexType>
+	static void RunWorkload(UWorld* World, const FWorkload& Workload, int32 Iterations, TArray<FPhaseResult>& OutResults)
+	{
+		URuntimeMeshComponent* Component = NewObject<URuntimeMeshComponent>(World, NAME_None, RF_Transient);
+		Component->RegisterComponentWithWorld(World);
+
+		const ESectionUpdateFlags UpdateFlags = Workload.bMoveArrays ? ESectionUpdateFlags::MoveArrays : ESectionUpdateFlags::None;
+
+		FPhaseResult Create, Update, Positions;
+		Create.Phase = TEXT("Create");
+		Update.Phase = TEXT("Update");
+		Positions.Phase = TEXT("PositionsImmediate");
+
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			FPhaseData<VertexType> Data;
+			FPhaseTimer Timer;
+
+			// Create
+			Data.Build(Workload, 0.0f);
+			Create.BytesCopied += Workload.bMoveArrays ? 0 : Data.GetSize(Workload.bDualBuffer, true, true);
+
+			Timer.Begin();
+			if (Workload.bBatched)
+			{
+				Component->BeginBatchUpdates();
+			}
+			for (int32 SectionIdx = 0; SectionIdx < Workload.NumSections; SectionIdx++)
+			{
+				if (Workload.bDualBuffer)
+				{
+					Component->CreateMeshSectionDualBuffer(SectionIdx, Data.Positions[SectionIdx], Data.Vertices[SectionIdx], Data.Triangles[SectionIdx], false, EUpdateFrequency::Average, UpdateFlags);
+				}
+				else
+				{
+					Component->CreateMeshSection(SectionIdx, Data.Vertices[SectionIdx], Data.Triangles[SectionIdx], false, EUpdateFrequency::Average, UpdateFlags);
+				}
+				Timer.SampleMemory();
+			}
+			if (Workload.bBatched)
+			{
+				Component->EndBatchUpdates();
+			}
+			Timer.End(Create);
+
+			// Update all vertices
+			Data.Build(Workload, 1.0f);
+			Update.BytesCopied += Workload.bMoveArrays ? 0 : Data.GetSize(Workload.bDualBuffer, true, false);
+
+			Timer.Begin();
+			if (Workload.bBatched)
+			{
+				Component->BeginBatchUpdates();
+			}
+			for (int32 SectionIdx = 0; SectionIdx < Workload.NumSections; SectionIdx++)
+			{
+				if (Workload.bDualBuffer)
+				{
+					Component->UpdateMeshSection(SectionIdx, Data.Positions[SectionIdx], Data.Vertices[SectionIdx], UpdateFlags);
+				}
+				else
+				{
+					Component->UpdateMeshSection(SectionIdx, Data.Vertices[SectionIdx], UpdateFlags);
+				}
+				Timer.SampleMemory();
+			}
+			if (Workload.bBatched)
+			{
+				Component->EndBatchUpdates();
+			}
+			Timer.End(Update);
+
+			// Positions only, which always goes straight to the render thread
+			if (Workload.bDualBuffer)
+			{
+				Data.Build(Workload, 2.0f);
+				Positions.BytesCopied += Workload.bMoveArrays ? 0 : Data.GetSize(true, false, false);
+
+				Timer.Begin();
+				for (int32 SectionIdx = 0; SectionIdx < Workload.NumSections; SectionIdx++)
+				{
+					Component->UpdateMeshSectionPositionsImmediate(SectionIdx, Data.Positions[SectionIdx], UpdateFlags);
+					Timer.SampleMemory();
+				}
+				Timer.End(Positions);
+			}
+
+			Component->ClearAllMeshSections();
+			FlushRenderingCommands();
+		}
+
+		Component->DestroyComponent();
+
+		OutResults.Add(Create);
+		OutResults.Add(Update);
+		if (Workload.bDualBuffer)
+		{
+			OutResults.Add(Positions);
+		}
+	}
+
+	template<int32 TextureChannels, bool HalfPrecisionUVs>
+	static FString RunWorkloadForVertexType(UWorld* World, const FWorkload& Workload, int32 Iterations, TArray<FPhaseResult>& OutResults)
+	{
+		if (Workload.bDualBuffer)
+		{
+			RunWorkload<FRuntimeMeshVertex<TextureChannels, HalfPrecisionUVs, false>>(World, Workload, Iterations, OutResults);
+			return FRuntimeMeshVertex<TextureChannels, HalfPrecisionUVs, false>::TypeInfo.TypeName;
+		}
+		else
+		{
+			RunWorkload<FRuntimeMeshVertex<TextureChannels, HalfPrecisionUVs, true>>(World, Workload, Iterations, OutResults);
+			return FRuntimeMeshVertex<TextureChannels, HalfPrecisionUVs, true>::TypeInfo.TypeName;
+		}
+	}
+
+	static FString RunWorkloadForVertexType(int32 UVChannels, bool bHalfUVs, UWorld* World, const FWorkload& Workload, int32 Iterations, TArray<FPhaseResult>& OutResults)
+	{
+		switch (UVChannels)
+		{
+		case 1:
+			return bHalfUVs ? RunWorkloadForVertexType<1, true>(World, Workload, Iterations, OutResults) : RunWorkloadForVertexType<1, false>(World, Workload, Iterations, OutResults);
+		case 2:
+			return bHalfUVs ? RunWorkloadForVertexType<2, true>(World, Workload, Iterations, OutResults) : RunWorkloadForVertexType<2, false>(World, Workload, Iterations, OutResults);
+		case 4:
+			return bHalfUVs ? RunWorkloadForVertexType<4, true>(World, Workload, Iterations, OutResults) : RunWorkloadForVertexType<4, false>(World, Workload, Iterations, OutResults);
+		default:
+			UE_LOG(RuntimeMeshLog, Warning, TEXT("RuntimeMesh.Benchmark - %d UV channels isn't supported, use 1, 2 or 4."), UVChannels);
+			return FString();
+		}
+	}
+
+	/* Parses Key=A,B,C from the arguments */
+	static TArray<int32> ParseList(const TArray<FString>& Args, const TCHAR* Key, const TArray<int32>& Default)
+	{
+		const FString Prefix = FString(Key) + TEXT("=");
+		for (const FString& Arg : Args)
+		{
+			if (Arg.StartsWith(Prefix))
+			{
+				TArray<FString> Values;
+				Arg.RightChop(Prefix.Len()).ParseIntoArray(Values, TEXT(","), true);
+
+				TArray<int32> Result;
+				for (const FString& Value : Values)
+				{
+					Result.Add(FCString::Atoi(*Value));
+				}
+				return Result;
+			}
+		}
+		return Default;
+	}
+
+	static void ParseSettings(const TArray<FString>& Args, FSettings& OutSettings)
+	{
+		OutSettings.VertexCounts = ParseList(Args, TEXT("Vertices"), { 1024, 65536, 1048576, 4194304 });
+		OutSettings.SectionCounts = ParseList(Args, TEXT("Sections"), { 1, 64, 1024 });
+		OutSettings.UVChannels = ParseList(Args, TEXT("UVChannels"), { 1, 2 });
+		OutSettings.HalfUVs = ParseList(Args, TEXT("HalfUVs"), { 0, 1 });
+		OutSettings.DualBuffer = ParseList(Args, TEXT("Dual"), { 0, 1 });
+		OutSettings.MoveArrays = ParseList(Args, TEXT("Move"), { 0, 1 });
+		OutSettings.Batched = ParseList(Args, TEXT("Batch"), { 0, 1 });
+
+		TArray<int32> Iterations = ParseList(Args, TEXT("Iterations"), { 3 });
+		OutSettings.Iterations = FMath::Max(1, Iterations.Num() > 0 ? Iterations[0] : 1);
+
+		OutSettings.OutputPath = FPaths::ProfilingDir() / TEXT("RuntimeMesh") / FString::Printf(TEXT("RuntimeMeshBenchmark-%s.csv"), *FDateTime::Now().ToString());
+		for (const FString& Arg : Args)
+		{
+			if (Arg.StartsWith(TEXT("Out=")))
+			{
+				OutSettings.OutputPath = Arg.RightChop(4);
+			}
+		}
+	}
+
+	static void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr)
+		{
+			UE_LOG(RuntimeMeshLog, Warning, TEXT("RuntimeMesh.Benchmark - Needs a world to run in."));
+			return;
+		}
+
+		FSettings Settings;
+		ParseSettings(Args, Settings);
+
+		FString Csv = TEXT("vertex_type,vertices,sections,dual_buffer,move_arrays,batched,phase,iterations,gt_ms_mean,gt_ms_min,rt_ms_mean,rt_ms_min,bytes_copied,bytes_uploaded,peak_memory_bytes,threaded_rendering\n");
+
+		for (int32 NumVertices : Settings.VertexCounts)
+		for (int32 NumSections : Settings.SectionCounts)
+		for (int32 UVChannels : Settings.UVChannels)
+		for (int32 HalfUVs : Settings.HalfUVs)
+		for (int32 DualBuffer : Settings.DualBuffer)
+		for (int32 MoveArrays : Settings.MoveArrays)
+		for (int32 Batched : Settings.Batched)
+		{
+			FWorkload Workload;
+			Workload.NumVertices = FMath::Max(4, NumVertices);
+			Workload.NumSections = FMath::Max(1, NumSections);
+			Workload.bDualBuffer = DualBuffer != 0;
+			Workload.bMoveArrays = MoveArrays != 0;
+			Workload.bBatched = Batched != 0;
+
+			TArray<FPhaseResult> Results;
+			FString VertexTypeName = RunWorkloadForVertexType(UVChannels, HalfUVs != 0, World, Workload, Settings.Iterations, Results);
+
+			for (const FPhaseResult& Result : Results)
+			{
+				Csv += FString::Printf(TEXT("\"%s\",%d,%d,%d,%d,%d,%s,%d,%.4f,%.4f,%.4f,%.4f,%lld,%lld,%lld,%d\n"),
+					*VertexTypeName, Workload.NumVertices, Workload.NumSections, (int32)Workload.bDualBuffer, (int32)Workload.bMoveArrays, (int32)Workload.bBatched,
+					*Result.Phase, Settings.Iterations, GetMean(Result.GameThreadMs), GetMin(Result.GameThreadMs), GetMean(Result.RenderThreadMs), GetMin(Result.RenderThreadMs),
+					Result.BytesCopied, Result.BytesUploaded, Result.PeakMemoryBytes, (int32)GIsThreadedRendering);
+
+				UE_LOG(RuntimeMeshLog, Log, TEXT("RuntimeMesh.Benchmark - %s %d verts %d sections dual=%d move=%d batch=%d %s: GT %.3f ms RT %.3f ms"),
+					*VertexTypeName, Workload.NumVertices, Workload.NumSections, (int32)Workload.bDualBuffer, (int32)Workload.bMoveArrays, (int32)Workload.bBatched,
+					*Result.Phase, GetMean(Result.GameThreadMs), GetMean(Result.RenderThreadMs));
+			}
+		}
+
+		if (FFileHelper::SaveStringToFile(Csv, *Settings.OutputPath))
+		{
+			UE_LOG(RuntimeMeshLog, Log, TEXT("RuntimeMesh.Benchmark - Results written to %s"), *Settings.OutputPath);
+		}
+		else
+		{
+			UE_LOG(RuntimeMeshLog, Warning, TEXT("RuntimeMesh.Benchmark - Unable to write results to %s"), *Settings.OutputPath);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdRuntimeMeshBenchmark(
+	TEXT("RuntimeMesh.Benchmark"),
+	TEXT("Runs create/update workloads on a temporary runtime mesh component and writes the timings as CSV.\n")
+	TEXT("Arguments are Key=A,B lists: Vertices, Sections, UVChannels (1/2/4), HalfUVs, Dual, Move, Batch, Iterations and Out=Path."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RuntimeMeshBenchmark::Run));
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/*
+*	Checks the paths the benchmark times actually do what they're timed for: the sections and buffers end up the expected
+*	size, and each path uploads what it should. Index buffers may be 16 or 32 bit so those are only checked against both.
+*/
+namespace RuntimeMeshBenchmark
+{
+	typedef FRuntimeMeshVertex<1, false, true> FTestVertex;
+
+	static const int32 TestGridVertices = 32 * 32;
+
+	/* A component registered in a world of its own, so it has a scene proxy to upload to */
+	struct FTestComponent
+	{
+		UWorld* World;
+		URuntimeMeshComponent* Component;
+
+		FTestComponent()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			Component = NewObject<URuntimeMeshComponent>(World, NAME_None, RF_Transient);
+			Component->RegisterComponentWithWorld(World);
+		}
+
+		~FTestComponent()
+		{
+			Component->DestroyComponent();
+			FlushRenderingCommands();
+			World->DestroyWorld(false);
+		}
+	};
+
+	/* Gets the bytes uploaded by the render commands issued in Function */
+	template<typename FunctionType>
+	static int64 MeasureUploads(FunctionType Function)
+	{
+		FlushRenderingCommands();
+		const int64 StartUploadedBytes = FRuntimeMeshUploadStats::TotalBytesUploaded.GetValue();
+
+		Function();
+
+		FlushRenderingCommands();
+		return FRuntimeMeshUploadStats::TotalBytesUploaded.GetValue() - StartUploadedBytes;
+	}
+
+	/* Checks the buffer sizes of NumSections sections created from Vertices and Triangles */
+	static void TestSectionSizes(FAutomationTestBase& Test, URuntimeMeshComponent* Component, int32 NumSections, const TArray<FTestVertex>& Vertices, const TArray<int32>& Triangles)
+	{
+		FRuntimeMeshMemoryUsage Usage;
+		Component->GetMemoryUsage(Usage);
+
+		const SIZE_T VertexBytes = NumSections * Vertices.Num() * sizeof(FTestVertex);
+
+		Test.TestEqual(TEXT("Section count"), Component->GetNumSections(), NumSections);
+		Test.TestEqual(TEXT("Usage section count"), Usage.NumSections, NumSections);
+		Test.TestEqual(TEXT("Vertex count"), Usage.NumVertices, NumSections * Vertices.Num());
+		Test.TestEqual(TEXT("Index count"), Usage.NumIndices, NumSections * Triangles.Num());
+		Test.TestTrue(TEXT("CPU vertex buffer holds the vertices"), Usage.CPUVertexBytes >= VertexBytes);
+		Test.TestTrue(TEXT("GPU vertex buffer holds the vertices"), Usage.GPUVertexBytes >= VertexBytes);
+		Test.TestTrue(TEXT("GPU index buffer holds the indices"), Usage.GPUIndexBytes >= NumSections * Triangles.Num() * sizeof(uint16));
+	}
+
+	/* Checks a create uploaded all of the vertices and indices of NumSections sections */
+	static void TestCreateUploads(FAutomationTestBase& Test, int64 BytesUploaded, int32 NumSections, const TArray<FTestVertex>& Vertices, const TArray<int32>& Triangles)
+	{
+		const int64 VertexBytes = NumSections * Vertices.Num() * sizeof(FTestVertex);
+		const int64 NumIndices = NumSections * Triangles.Num();
+
+		Test.TestTrue(TEXT("Create uploads the vertices and indices"),
+			BytesUploaded >= VertexBytes + NumIndices * sizeof(uint16) && BytesUploaded <= VertexBytes + NumIndices * sizeof(int32));
+	}
+
+	/* Nothing is uploaded without a scene proxy, the component needs a world with a scene */
+	static bool HasSceneProxy(FAutomationTestBase& Test, URuntimeMeshComponent* Component)
+	{
+		if (Component->SceneProxy == nullptr)
+		{
+			Test.AddError(TEXT("Component has no scene proxy to upload to."));
+			return false;
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRuntimeMeshCreateSectionTest, "RuntimeMesh.Sections.Create", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FRuntimeMeshCreateSectionTest::RunTest(const FString& Parameters)
+{
+	using namespace RuntimeMeshBenchmark;
+
+	FTestComponent Test;
+	if (!HasSceneProxy(*this, Test.Component))
+	{
+		return false;
+	}
+
+	TArray<FVector> Positions;
+	TArray<FTestVertex> Vertices;
+	TArray<int32> Triangles;
+	BuildGrid(TestGridVertices, 0.0f, Positions, Vertices, Triangles);
+
+	const int64 BytesUploaded = MeasureUploads([&]()
+	{
+		Test.Component->CreateMeshSection(0, Vertices, Triangles, false, EUpdateFrequency::Average);
+	});
+
+	TestSectionSizes(*this, Test.Component, 1, Vertices, Triangles);
+	TestCreateUploads(*this, BytesUploaded, 1, Vertices, Triangles);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRuntimeMeshUpdateSectionTest, "RuntimeMesh.Sections.Update", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FRuntimeMeshUpdateSectionTest::RunTest(const FString& Parameters)
+{
+	using namespace RuntimeMeshBenchmark;
+
+	FTestComponent Test;
+	if (!HasSceneProxy(*this, Test.Component))
+	{
+		return false;
+	}
+
+	TArray<FVector> Positions;
+	TArray<FTestVertex> Vertices;
+	TArray<int32> Triangles;
+	BuildGrid(TestGridVertices, 0.0f, Positions, Vertices, Triangles);
+	Test.Component->CreateMeshSection(0, Vertices, Triangles, false, EUpdateFrequency::Average);
+
+	BuildGrid(TestGridVertices, 1.0f, Positions, Vertices, Triangles);
+	const int64 BytesUploaded = MeasureUploads([&]()
+	{
+		Test.Component->UpdateMeshSection(0, Vertices);
+	});
+
+	// Only the vertices changed, the indices stay where they are
+	TestSectionSizes(*this, Test.Component, 1, Vertices, Triangles);
+	TestEqual(TEXT("Update uploads only the vertices"), BytesUploaded, (int64)(Vertices.Num() * sizeof(FTestVertex)));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRuntimeMeshUpdateSectionRangeTest, "RuntimeMesh.Sections.UpdateRange", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FRuntimeMeshUpdateSectionRangeTest::RunTest(const FString& Parameters)
+{
+	using namespace RuntimeMeshBenchmark;
+
+	FTestComponent Test;
+	if (!HasSceneProxy(*this, Test.Component))
+	{
+		return false;
+	}
+
+	TArray<FVector> Positions;
+	TArray<FTestVertex> Vertices;
+	TArray<int32> Triangles;
+	BuildGrid(TestGridVertices, 0.0f, Positions, Vertices, Triangles);
+	Test.Component->CreateMeshSection(0, Vertices, Triangles, false, EUpdateFrequency::Average);
+
+	const int32 FirstVertex = 10;
+	TArray<FTestVertex> RangeVertices;
+	RangeVertices.Append(Vertices.GetData() + FirstVertex, 100);
+	for (FTestVertex& Vertex : RangeVertices)
+	{
+		Vertex.Position.Z += 1.0f;
+	}
+
+	const int64 BytesUploaded = MeasureUploads([&]()
+	{
+		Test.Component->UpdateMeshSectionRange(0, FirstVertex, RangeVertices);
+	});
+
+	TestSectionSizes(*this, Test.Component, 1, Vertices, Triangles);
+	TestEqual(TEXT("Range update uploads only the range"), BytesUploaded, (int64)(RangeVertices.Num() * sizeof(FTestVertex)));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRuntimeMeshBatchUpdateTest, "RuntimeMesh.Sections.Batch", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FRuntimeMeshBatchUpdateTest::RunTest(const FString& Parameters)
+{
+	using namespace RuntimeMeshBenchmark;
+
+	FTestComponent Test;
+	if (!HasSceneProxy(*this, Test.Component))
+	{
+		return false;
+	}
+
+	const int32 NumSections = 4;
+
+	TArray<FVector> Positions;
+	TArray<FTestVertex> Vertices;
+	TArray<int32> Triangles;
+	BuildGrid(TestGridVertices, 0.0f, Positions, Vertices, Triangles);
+
+	const int64 CreateBytesUploaded = MeasureUploads([&]()
+	{
+		Test.Component->BeginBatchUpdates();
+		for (int32 SectionIdx = 0; SectionIdx < NumSections; SectionIdx++)
+		{
+			Test.Component->CreateMeshSection(SectionIdx, Vertices, Triangles, false, EUpdateFrequency::Average);
+		}
+		Test.Component->EndBatchUpdates();
+	});
+
+	TestSectionSizes(*this, Test.Component, NumSections, Vertices, Triangles);
+	TestCreateUploads(*this, CreateBytesUploaded, NumSections, Vertices, Triangles);
+
+	// Updating a section twice in a batch only sends its latest data
+	BuildGrid(TestGridVertices, 1.0f, Positions, Vertices, Triangles);
+	const int64 UpdateBytesUploaded = MeasureUploads([&]()
+	{
+		Test.Component->BeginBatchUpdates();
+		for (int32 SectionIdx = 0; SectionIdx < NumSections; SectionIdx++)
+		{
+			Test.Component->UpdateMeshSection(SectionIdx, Vertices);
+			Test.Component->UpdateMeshSection(SectionIdx, Vertices);
+		}
+		Test.Component->EndBatchUpdates();
+	});
+
+	TestSectionSizes(*this, Test.Component, NumSections, Vertices, Triangles);
+	TestEqual(TEXT("Batched update uploads each section once"), UpdateBytesUploaded, (int64)(NumSections * Vertices.Num() * sizeof(FTestVertex)));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
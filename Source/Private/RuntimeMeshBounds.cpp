@@ -0,0 +1,148 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshBounds.h"
+#include "RuntimeMeshProfiling.h"
+
+
+FBox FRuntimeMeshBounds::ComputeBounds(const uint8* FirstPosition, int32 Num, int32 Stride)
+{
+	if (Num < ParallelThreshold)
+	{
+		return ComputeBoundsSerial(FirstPosition, Num, Stride);
+	}
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+	TArray<FBox> ChunkBounds;
+	ChunkBounds.SetNumUninitialized(NumChunks);
+
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		const int32 Start = ChunkIndex * ChunkSize;
+		const int32 Count = FMath::Min(ChunkSize, Num - Start);
+
+		ChunkBounds[ChunkIndex] = ComputeBoundsSerial(FirstPosition + Start * Stride, Count, Stride);
+	});
+
+	return CombineBounds(ChunkBounds);
+}
+
+FBox FRuntimeMeshBounds::ComputeBoundsSerial(const uint8* FirstPosition, int32 Num, int32 Stride)
+{
+	if (Num <= 0)
+	{
+		return FBox(0);
+	}
+
+	VectorRegister Min = VectorLoadFloat3_W0(FirstPosition);
+	VectorRegister Max = Min;
+
+	// Two sets of accumulators so consecutive min/max don't wait on each other
+	VectorRegister MinB = Min;
+	VectorRegister MaxB = Max;
+
+	const uint8* Position = FirstPosition + Stride;
+	int32 Remaining = Num - 1;
+
+	while (Remaining >= 2)
+	{
+		VectorRegister A = VectorLoadFloat3_W0(Position);
+		VectorRegister B = VectorLoadFloat3_W0(Position + Stride);
+
+		Min = VectorMin(Min, A);
+		Max = VectorMax(Max, A);
+		MinB = VectorMin(MinB, B);
+		MaxB = VectorMax(MaxB, B);
+
+		Position += Stride * 2;
+		Remaining -= 2;
+	}
+
+	if (Remaining > 0)
+	{
+		VectorRegister A = VectorLoadFloat3_W0(Position);
+		Min = VectorMin(Min, A);
+		Max = VectorMax(Max, A);
+	}
+
+	Min = VectorMin(Min, MinB);
+	Max = VectorMax(Max, MaxB);
+
+	FBox Result;
+	VectorStoreFloat3(Min, &Result.Min);
+	VectorStoreFloat3(Max, &Result.Max);
+	Result.IsValid = 1;
+	return Result;
+}
+
+FBox FRuntimeMeshBounds::CombineBounds(const TArray<FBox>& ChunkBounds)
+{
+	FBox Result(0);
+	for (const FBox& Box : ChunkBounds)
+	{
+		Result += Box;
+	}
+	return Result;
+}
+
+
+
+void FRuntimeMeshBoundsAccumulator::SetBox(int32 Key, const FBox& Box)
+{
+	if (!Box.IsValid)
+	{
+		RemoveBox(Key);
+		return;
+	}
+
+	// FBox() leaves its members uninitialized, so new keys are added rather than default constructed
+	FBox* ExistingBox = Boxes.Find(Key);
+	if (ExistingBox == nullptr)
+	{
+		Boxes.Add(Key, Box);
+	}
+	else
+	{
+		if (ExistingBox->IsValid && !bNeedsRebuild && IsOnBoundary(*ExistingBox) && !((Box + *ExistingBox) == Box))
+		{
+			bNeedsRebuild = true;
+		}
+		*ExistingBox = Box;
+	}
+
+	if (!bNeedsRebuild)
+	{
+		Bounds += Box;
+	}
+}
+
+void FRuntimeMeshBoundsAccumulator::RemoveBox(int32 Key)
+{
+	FBox ExistingBox;
+	if (Boxes.RemoveAndCopyValue(Key, ExistingBox) && !bNeedsRebuild && IsOnBoundary(ExistingBox))
+	{
+		bNeedsRebuild = true;
+	}
+}
+
+const FBox& FRuntimeMeshBoundsAccumulator::GetBounds()
+{
+	if (bNeedsRebuild)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_RebuildBounds);
+
+		Bounds = FBox(0);
+		for (const auto& Entry : Boxes)
+		{
+			Bounds += Entry.Value;
+		}
+		bNeedsRebuild = false;
+	}
+	return Bounds;
+}
+
+bool FRuntimeMeshBoundsAccumulator::IsOnBoundary(const FBox& Box) const
+{
+	return Box.Min.X <= Bounds.Min.X || Box.Min.Y <= Bounds.Min.Y || Box.Min.Z <= Bounds.Min.Z ||
+		Box.Max.X >= Bounds.Max.X || Box.Max.Y >= Bounds.Max.Y || Box.Max.Z >= Bounds.Max.Z;
+}
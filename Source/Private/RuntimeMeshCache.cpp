@@ -0,0 +1,382 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshCache.h"
+#include "RuntimeMeshVersion.h"
+#include "Interfaces/Interface_CollisionDataProvider.h"
+
+
+static TAutoConsoleVariable<int32> CVarRuntimeMeshCacheMaxSizeMB(
+	TEXT("RuntimeMesh.CacheMaxSizeMB"),
+	256,
+	TEXT("Largest size of the on disk mesh cache in megabytes. The least recently used entries are evicted past it."),
+	ECVF_Default);
+
+
+namespace RuntimeMeshCacheInternal
+{
+	static const uint32 EntryMagic = 0x524D4348; // 'RMCH'
+	static const TCHAR* EntryExtension = TEXT(".rmcache");
+
+	static uint32 GetEngineVersion()
+	{
+		// Cooked physics data isn't guaranteed to load in any other engine version
+		return ENGINE_MAJOR_VERSION * 10000 + ENGINE_MINOR_VERSION * 100 + ENGINE_PATCH_VERSION;
+	}
+
+	/* Hashes the blobs and writes the header in front of them */
+	static void FinishEntry(FRuntimeMeshCacheEntryHeader& Header, TArray<uint8>& Data)
+	{
+		check((uint32)Data.Num() == Header.TotalSize);
+
+		Header.DataHash = FRuntimeMeshCache::HashBytes(Data.GetData() + sizeof(FRuntimeMeshCacheEntryHeader), Data.Num() - sizeof(FRuntimeMeshCacheEntryHeader));
+		FMemory::Memcpy(Data.GetData(), &Header, sizeof(FRuntimeMeshCacheEntryHeader));
+	}
+}
+
+
+FRuntimeMeshCache& FRuntimeMeshCache::Get()
+{
+	static FRuntimeMeshCache Cache;
+	return Cache;
+}
+
+FRuntimeMeshCache::FRuntimeMeshCache()
+	: CacheDirectory(FPaths::GameSavedDir() / TEXT("RuntimeMeshCache")), TotalSize(0), bHasScannedEntries(false)
+{
+}
+
+uint64 FRuntimeMeshCache::HashBytes(const void* Data, SIZE_T Size, uint64 Hash)
+{
+	const uint8* Bytes = static_cast<const uint8*>(Data);
+	for (SIZE_T Index = 0; Index < Size; Index++)
+	{
+		Hash ^= Bytes[Index];
+		Hash *= 0x100000001b3ull;
+	}
+	return Hash;
+}
+
+uint64 FRuntimeMeshCache::HashSection(const FRuntimeMeshCacheSectionView& Section)
+{
+	check(Section.VertexType);
+
+	uint64 Hash = HashBytes(&Section.VertexType->TypeGuid, sizeof(FGuid));
+	Hash = HashBytes(*Section.VertexType->TypeName, Section.VertexType->TypeName.Len() * sizeof(TCHAR), Hash);
+	Hash = HashBytes(&Section.VertexStride, sizeof(int32), Hash);
+	Hash = HashBytes(Section.Vertices, Section.NumVertices * Section.VertexStride, Hash);
+	Hash = HashBytes(Section.Positions, Section.NumPositions * sizeof(FVector), Hash);
+	Hash = HashBytes(Section.Indices, Section.NumIndices * sizeof(int32), Hash);
+	return Hash;
+}
+
+uint64 FRuntimeMeshCache::HashCollision(const FTriMeshCollisionData& CollisionData, const UBodySetup* BodySetup)
+{
+	uint64 Hash = HashBytes(CollisionData.Vertices.GetData(), CollisionData.Vertices.Num() * sizeof(FVector));
+	Hash = HashBytes(CollisionData.Indices.GetData(), CollisionData.Indices.Num() * sizeof(FTriIndices), Hash);
+	Hash = HashBytes(CollisionData.MaterialIndices.GetData(), CollisionData.MaterialIndices.Num() * sizeof(uint16), Hash);
+
+	const uint8 bFlipNormals = CollisionData.bFlipNormals;
+	Hash = HashBytes(&bFlipNormals, sizeof(uint8), Hash);
+
+	// The simple collision is cooked into the same data
+	for (const FKConvexElem& ConvexElem : BodySetup->AggGeom.ConvexElems)
+	{
+		Hash = HashBytes(ConvexElem.VertexData.GetData(), ConvexElem.VertexData.Num() * sizeof(FVector), Hash);
+	}
+
+	const uint8 Settings[] = { (uint8)BodySetup->CollisionTraceFlag, (uint8)BodySetup->bDoubleSidedGeometry, (uint8)BodySetup->bGenerateMirroredCollision };
+	Hash = HashBytes(Settings, sizeof(Settings), Hash);
+
+	const FString PhysicsFormat = FPlatformProperties::GetPhysicsFormat();
+	Hash = HashBytes(*PhysicsFormat, PhysicsFormat.Len() * sizeof(TCHAR), Hash);
+
+	// Zero is left for no key
+	return Hash != 0 ? Hash : 1;
+}
+
+FString FRuntimeMeshCache::GetEntryFileName(uint64 Key, ERuntimeMeshCacheEntryType EntryType) const
+{
+	return FString::Printf(TEXT("%s_%016llx%s"), EntryType == ERuntimeMeshCacheEntryType::Section ? TEXT("Section") : TEXT("Collision"), Key, RuntimeMeshCacheInternal::EntryExtension);
+}
+
+void FRuntimeMeshCache::InitHeader(FRuntimeMeshCacheEntryHeader& Header, uint64 Key, ERuntimeMeshCacheEntryType EntryType) const
+{
+	FMemory::Memzero(Header);
+	Header.Magic = RuntimeMeshCacheInternal::EntryMagic;
+	Header.Version = FRuntimeMeshVersion::LatestVersion;
+	Header.EntryType = (uint32)EntryType;
+	Header.EngineVersion = RuntimeMeshCacheInternal::GetEngineVersion();
+	Header.Key = Key;
+}
+
+bool FRuntimeMeshCache::StoreSection(uint64 Key, const FRuntimeMeshCacheSectionView& Section)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_StoreCachedMesh);
+
+	check(Section.VertexType && Section.VertexStride > 0);
+	check(Section.NumPositions == 0 || Section.NumPositions == Section.NumVertices);
+
+	FRuntimeMeshCacheEntryHeader Header;
+	InitHeader(Header, Key, ERuntimeMeshCacheEntryType::Section);
+	Header.VertexTypeGuid = Section.VertexType->TypeGuid;
+	Header.VertexTypeNameHash = FCrc::StrCrc32(*Section.VertexType->TypeName);
+	Header.VertexStride = Section.VertexStride;
+	Header.NumVertices = Section.NumVertices;
+	Header.NumPositions = Section.NumPositions;
+	Header.NumIndices = Section.NumIndices;
+
+	const FVector BoundsMin = Section.Bounds.IsValid ? Section.Bounds.Min : FVector::ZeroVector;
+	const FVector BoundsMax = Section.Bounds.IsValid ? Section.Bounds.Max : FVector::ZeroVector;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		Header.BoundsMin[Axis] = BoundsMin[Axis];
+		Header.BoundsMax[Axis] = BoundsMax[Axis];
+	}
+
+	// Each blob starts on a 16 byte boundary so it can be used straight from the entry
+	uint32 Offset = Align(sizeof(FRuntimeMeshCacheEntryHeader), 16);
+	Header.VertexOffset = Offset;
+	Offset = Align(Offset + Section.NumVertices * Section.VertexStride, 16);
+	Header.PositionOffset = Offset;
+	Offset = Align(Offset + Section.NumPositions * sizeof(FVector), 16);
+	Header.IndexOffset = Offset;
+	Header.TotalSize = Offset + Section.NumIndices * sizeof(int32);
+
+	TArray<uint8> Data;
+	Data.SetNumZeroed(Header.TotalSize);
+	FMemory::Memcpy(Data.GetData() + Header.VertexOffset, Section.Vertices, Section.NumVertices * Section.VertexStride);
+	FMemory::Memcpy(Data.GetData() + Header.PositionOffset, Section.Positions, Section.NumPositions * sizeof(FVector));
+	FMemory::Memcpy(Data.GetData() + Header.IndexOffset, Section.Indices, Section.NumIndices * sizeof(int32));
+
+	RuntimeMeshCacheInternal::FinishEntry(Header, Data);
+	return WriteEntry(GetEntryFileName(Key, ERuntimeMeshCacheEntryType::Section), Data);
+}
+
+bool FRuntimeMeshCache::LoadSection(uint64 Key, const FRuntimeMeshVertexTypeInfo& VertexType, int32 VertexStride, FRuntimeMeshCacheEntry& OutEntry)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_LoadCachedMesh);
+
+	if (!ReadEntry(Key, ERuntimeMeshCacheEntryType::Section, OutEntry))
+	{
+		return false;
+	}
+
+	// Same key with another vertex type is most likely a caller bug, but either way it can't be loaded
+	const FRuntimeMeshCacheEntryHeader& Header = OutEntry.GetHeader();
+	if (Header.VertexTypeGuid != VertexType.TypeGuid || Header.VertexTypeNameHash != FCrc::StrCrc32(*VertexType.TypeName) || Header.VertexStride != VertexStride)
+	{
+		UE_LOG(RuntimeMeshLog, Warning, TEXT("FRuntimeMeshCache::LoadSection() - Entry %016llx was stored with a different vertex type than %s."), Key, *VertexType.TypeName);
+		INC_DWORD_STAT(STAT_RuntimeMesh_CacheMisses);
+		return false;
+	}
+
+	return true;
+}
+
+bool FRuntimeMeshCache::StoreCollision(uint64 Key, UBodySetup* BodySetup)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_StoreCachedMesh);
+
+	check(BodySetup);
+
+	// Cooks it if it hasn't been cooked yet, otherwise hands back what's there
+	const FName PhysicsFormatName(FPlatformProperties::GetPhysicsFormat());
+	FByteBulkData* CookedData = BodySetup->GetCookedData(PhysicsFormatName);
+	if (CookedData == nullptr || CookedData->GetBulkDataSize() == 0)
+	{
+		return false;
+	}
+
+	FRuntimeMeshCacheEntryHeader Header;
+	InitHeader(Header, Key, ERuntimeMeshCacheEntryType::Collision);
+	Header.CollisionOffset = Align(sizeof(FRuntimeMeshCacheEntryHeader), 16);
+	Header.CollisionSize = CookedData->GetBulkDataSize();
+	Header.TotalSize = Header.CollisionOffset + Header.CollisionSize;
+
+	TArray<uint8> Data;
+	Data.SetNumZeroed(Header.TotalSize);
+	FMemory::Memcpy(Data.GetData() + Header.CollisionOffset, CookedData->Lock(LOCK_READ_ONLY), Header.CollisionSize);
+	CookedData->Unlock();
+
+	RuntimeMeshCacheInternal::FinishEntry(Header, Data);
+	return WriteEntry(GetEntryFileName(Key, ERuntimeMeshCacheEntryType::Collision), Data);
+}
+
+bool FRuntimeMeshCache::LoadCollision(uint64 Key, UBodySetup* BodySetup)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_LoadCachedMesh);
+
+	check(BodySetup);
+
+	FRuntimeMeshCacheEntry Entry;
+	if (!ReadEntry(Key, ERuntimeMeshCacheEntryType::Collision, Entry))
+	{
+		return false;
+	}
+
+	// The body setup finds this when it goes to cook, and creates its meshes from it instead
+	const FRuntimeMeshCacheEntryHeader& Header = Entry.GetHeader();
+	FByteBulkData& CookedData = BodySetup->CookedFormatData.GetFormat(FName(FPlatformProperties::GetPhysicsFormat()));
+	CookedData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(CookedData.Realloc(Header.CollisionSize), Entry.GetBlob(Header.CollisionOffset), Header.CollisionSize);
+	CookedData.Unlock();
+
+	return true;
+}
+
+void FRuntimeMeshCache::Clear()
+{
+	FScopeLock Lock(&EntriesLock);
+	ScanEntries();
+
+	for (const auto& Entry : Entries)
+	{
+		IFileManager::Get().Delete(*(CacheDirectory / Entry.Key), false, false, true);
+	}
+
+	Entries.Empty();
+	TotalSize = 0;
+}
+
+int64 FRuntimeMeshCache::GetTotalSize()
+{
+	FScopeLock Lock(&EntriesLock);
+	ScanEntries();
+
+	return TotalSize;
+}
+
+bool FRuntimeMeshCache::WriteEntry(const FString& FileName, TArray<uint8>& Data)
+{
+	const FString FilePath = CacheDirectory / FileName;
+
+	// Written aside and moved into place so a reader never sees half an entry
+	const FString TempFilePath = CacheDirectory / (FGuid::NewGuid().ToString() + TEXT(".tmp"));
+	if (!FFileHelper::SaveArrayToFile(Data, *TempFilePath) || !IFileManager::Get().Move(*FilePath, *TempFilePath, true, true, false, true))
+	{
+		IFileManager::Get().Delete(*TempFilePath, false, false, true);
+		UE_LOG(RuntimeMeshLog, Warning, TEXT("FRuntimeMeshCache::WriteEntry() - Unable to write %s."), *FilePath);
+		return false;
+	}
+
+	FScopeLock Lock(&EntriesLock);
+	ScanEntries();
+
+	FEntryInfo& Entry = Entries.FindOrAdd(FileName);
+	TotalSize += Data.Num() - Entry.Size;
+	Entry.Size = Data.Num();
+	Entry.LastUsed = FDateTime::UtcNow();
+
+	EvictEntries();
+	return true;
+}
+
+bool FRuntimeMeshCache::ReadEntry(uint64 Key, ERuntimeMeshCacheEntryType EntryType, FRuntimeMeshCacheEntry& OutEntry)
+{
+	const FString FileName = GetEntryFileName(Key, EntryType);
+	const FString FilePath = CacheDirectory / FileName;
+
+	// The whole entry in one read, the blobs are used from it as they are
+	if (!FFileHelper::LoadFileToArray(OutEntry.Data, *FilePath, FILEREAD_Silent))
+	{
+		INC_DWORD_STAT(STAT_RuntimeMesh_CacheMisses);
+		return false;
+	}
+
+	bool bIsValid = OutEntry.Data.Num() >= sizeof(FRuntimeMeshCacheEntryHeader);
+	if (bIsValid)
+	{
+		const FRuntimeMeshCacheEntryHeader& Header = OutEntry.GetHeader();
+		bIsValid = Header.Magic == RuntimeMeshCacheInternal::EntryMagic && Header.Version == FRuntimeMeshVersion::LatestVersion &&
+			Header.EntryType == (uint32)EntryType && Header.EngineVersion == RuntimeMeshCacheInternal::GetEngineVersion() && Header.Key == Key &&
+			Header.TotalSize == (uint32)OutEntry.Data.Num() &&
+			Header.DataHash == HashBytes(OutEntry.Data.GetData() + sizeof(FRuntimeMeshCacheEntryHeader), OutEntry.Data.Num() - sizeof(FRuntimeMeshCacheEntryHeader));
+	}
+
+	FScopeLock Lock(&EntriesLock);
+	ScanEntries();
+
+	// Stale entries are only in the way of new ones
+	if (!bIsValid)
+	{
+		IFileManager::Get().Delete(*FilePath, false, false, true);
+		if (const FEntryInfo* Entry = Entries.Find(FileName))
+		{
+			TotalSize -= Entry->Size;
+			Entries.Remove(FileName);
+		}
+
+		OutEntry.Data.Empty();
+		INC_DWORD_STAT(STAT_RuntimeMesh_CacheMisses);
+		return false;
+	}
+
+	// The time stamp keeps the eviction order across sessions
+	const FDateTime Now = FDateTime::UtcNow();
+	IFileManager::Get().SetTimeStamp(*FilePath, Now);
+
+	FEntryInfo& Entry = Entries.FindOrAdd(FileName);
+	TotalSize += OutEntry.Data.Num() - Entry.Size;
+	Entry.Size = OutEntry.Data.Num();
+	Entry.LastUsed = Now;
+
+	INC_DWORD_STAT(STAT_RuntimeMesh_CacheHits);
+	return true;
+}
+
+void FRuntimeMeshCache::ScanEntries()
+{
+	if (bHasScannedEntries)
+	{
+		return;
+	}
+	bHasScannedEntries = true;
+
+	IFileManager& FileManager = IFileManager::Get();
+	FileManager.MakeDirectory(*CacheDirectory, true);
+
+	TArray<FString> FileNames;
+	FileManager.FindFiles(FileNames, *(CacheDirectory / (FString(TEXT("*")) + RuntimeMeshCacheInternal::EntryExtension)), true, false);
+
+	for (const FString& FileName : FileNames)
+	{
+		const FString FilePath = CacheDirectory / FileName;
+
+		FEntryInfo& Entry = Entries.Add(FileName);
+		Entry.Size = FMath::Max<int64>(FileManager.FileSize(*FilePath), 0);
+		Entry.LastUsed = FileManager.GetTimeStamp(*FilePath);
+		TotalSize += Entry.Size;
+	}
+
+	// Left behind by a session that stopped part way through a write
+	TArray<FString> TempFileNames;
+	FileManager.FindFiles(TempFileNames, *(CacheDirectory / TEXT("*.tmp")), true, false);
+	for (const FString& FileName : TempFileNames)
+	{
+		FileManager.Delete(*(CacheDirectory / FileName), false, false, true);
+	}
+
+	EvictEntries();
+}
+
+void FRuntimeMeshCache::EvictEntries()
+{
+	const int64 MaxSize = (int64)FMath::Max(CVarRuntimeMeshCacheMaxSizeMB.GetValueOnAnyThread(), 0) * 1024 * 1024;
+
+	while (TotalSize > MaxSize && Entries.Num() > 0)
+	{
+		auto Oldest = Entries.CreateIterator();
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (It.Value().LastUsed < Oldest.Value().LastUsed)
+			{
+				Oldest = It;
+			}
+		}
+
+		IFileManager::Get().Delete(*(CacheDirectory / Oldest.Key()), false, false, true);
+		TotalSize -= Oldest.Value().Size;
+		Oldest.RemoveCurrent();
+	}
+}
@@ -0,0 +1,214 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshCollisionSnapshot.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#if WITH_PHYSX
+#include "Interfaces/ITargetPlatformManagerModule.h"
+#include "Interfaces/IPhysXFormat.h"
+#endif
+
+class IPhysXFormat;
+
+
+#if WITH_PHYSX
+namespace RuntimeMeshCollisionSnapshotInternal
+{
+	/* Appends one cooked mesh to the cooked data, prefixed by whether it cooked */
+	template<typename CookFunctionType>
+	static int32 AppendCookedMesh(TArray<uint8>& OutData, CookFunctionType CookFunction)
+	{
+		const int32 ResultInfoOffset = OutData.Add(false);
+		if (CookFunction())
+		{
+			OutData[ResultInfoOffset] = true;
+			return 1;
+		}
+		return 0;
+	}
+
+	/*
+	*	Cooks the convex elements and trimesh into the layout the engine's own cooker builds and
+	*	UBodySetup::CreatePhysicsMeshes() reads: endianness, the number of convex, mirrored convex
+	*	and trimeshes, then each mesh. Only touches the cooker and the copies passed in, so it's safe on a worker.
+	*/
+	static void BuildCookedData(const IPhysXFormat* Cooker, FName Format, const TArray<TArray<FVector>>& ConvexVertices,
+		const FTriMeshCollisionData* TriMesh, TArray<uint8>& OutData)
+	{
+		uint8 bLittleEndian = PLATFORM_LITTLE_ENDIAN;
+		int32 NumConvexElementsCooked = 0;
+		int32 NumMirroredElementsCooked = 0;
+		int32 NumTriMeshesCooked = 0;
+
+		FMemoryWriter Ar(OutData);
+		Ar << bLittleEndian;
+		const int64 CookedMeshInfoOffset = Ar.Tell();
+		Ar << NumConvexElementsCooked;
+		Ar << NumMirroredElementsCooked;
+		Ar << NumTriMeshesCooked;
+
+		for (const TArray<FVector>& Vertices : ConvexVertices)
+		{
+			NumConvexElementsCooked += AppendCookedMesh(OutData, [&]()
+			{
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 13
+				return Cooker->CookConvex(Format, EPhysXMeshCookFlags::Default, Vertices, OutData) != EPhysXCookingResult::Failed;
+#else
+				return Cooker->CookConvex(Format, Vertices, OutData);
+#endif
+			});
+		}
+
+		if (TriMesh != nullptr)
+		{
+			NumTriMeshesCooked += AppendCookedMesh(OutData, [&]()
+			{
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 13
+				return Cooker->CookTriMesh(Format, EPhysXMeshCookFlags::Default, TriMesh->Vertices, TriMesh->Indices, TriMesh->MaterialIndices, TriMesh->bFlipNormals, OutData);
+#else
+				return Cooker->CookTriMesh(Format, TriMesh->Vertices, TriMesh->Indices, TriMesh->MaterialIndices, TriMesh->bFlipNormals, OutData);
+#endif
+			});
+		}
+
+		// The counts are only known once everything is cooked
+		Ar.Seek(CookedMeshInfoOffset);
+		Ar << NumConvexElementsCooked;
+		Ar << NumMirroredElementsCooked;
+		Ar << NumTriMeshesCooked;
+
+		if (NumConvexElementsCooked == 0 && NumTriMeshesCooked == 0)
+		{
+			OutData.Empty();
+		}
+	}
+}
+#endif // WITH_PHYSX
+
+void URuntimeMeshCollisionSnapshot::StartCook()
+{
+	check(IsInGameThread());
+	check(BodySetup);
+	check(!CookResult.IsValid());
+
+	const FName PhysicsFormatName(FPlatformProperties::GetPhysicsFormat());
+	CookedData.Empty();
+
+	// Filled in from the collision cache, there's nothing left to cook
+	if (BodySetup->CookedFormatData.Contains(PhysicsFormatName))
+	{
+		TPromise<bool> Result;
+		Result.SetValue(true);
+		CookResult = Result.GetFuture();
+		return;
+	}
+
+	// UBodySetup::GetCookedData() isn't safe off the game thread. It finds the cooker through the module manager,
+	// and goes through the DDC in the editor. The cooker is found here, and only the copied mesh is cooked on the worker.
+	const IPhysXFormat* Cooker = nullptr;
+#if WITH_PHYSX
+	if (ITargetPlatformManagerModule* TargetPlatformManager = FModuleManager::LoadModulePtr<ITargetPlatformManagerModule>(TEXT("TargetPlatform")))
+	{
+		Cooker = TargetPlatformManager->FindPhysXFormat(PhysicsFormatName);
+	}
+#endif
+
+	// UVs from hit results are stored along with the cooked data, so those are left to the engine
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 12
+	const bool bNeedsUVInfo = UPhysicsSettings::Get()->bSupportUVFromHitResults;
+#else
+	const bool bNeedsUVInfo = false;
+#endif
+
+	if (Cooker == nullptr || bNeedsUVInfo)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CookCollisionAsync);
+
+		TPromise<bool> Result;
+		Result.SetValue(BodySetup->GetCookedData(PhysicsFormatName) != nullptr);
+		CookResult = Result.GetFuture();
+		return;
+	}
+
+#if WITH_PHYSX
+	// Copied here so the worker never reads the body setup
+	TArray<TArray<FVector>> ConvexVertices;
+	if (BodySetup->CollisionTraceFlag != CTF_UseComplexAsSimple)
+	{
+		for (const FKConvexElem& ConvexElem : BodySetup->AggGeom.ConvexElems)
+		{
+			ConvexVertices.Add(ConvexElem.VertexData);
+		}
+	}
+
+	// CollisionData isn't touched again until the cook is complete
+	const FTriMeshCollisionData* TriMesh = BodySetup->CollisionTraceFlag != CTF_UseSimpleAsComplex && CollisionData.Indices.Num() > 0 ? &CollisionData : nullptr;
+	TArray<uint8>* OutCookedData = &CookedData;
+
+	// This only builds the cooked data which is the expensive part. It's handed to the body setup
+	// by ApplyCookedData() so CreatePhysicsMeshes() on the game thread just has to create the meshes from it.
+	CookResult = Async<bool>(EAsyncExecution::ThreadPool, [Cooker, PhysicsFormatName, ConvexVertices, TriMesh, OutCookedData]()
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CookCollisionAsync);
+		RuntimeMeshCollisionSnapshotInternal::BuildCookedData(Cooker, PhysicsFormatName, ConvexVertices, TriMesh, *OutCookedData);
+		return OutCookedData->Num() > 0;
+	});
+#endif
+}
+
+void URuntimeMeshCollisionSnapshot::ApplyCookedData()
+{
+	check(IsInGameThread());
+	check(IsCookComplete());
+
+	if (CookedData.Num() > 0)
+	{
+		FByteBulkData& FormatData = BodySetup->CookedFormatData.GetFormat(FName(FPlatformProperties::GetPhysicsFormat()));
+		FormatData.Lock(LOCK_READ_WRITE);
+		FMemory::Memcpy(FormatData.Realloc(CookedData.Num()), CookedData.GetData(), CookedData.Num());
+		FormatData.Unlock();
+
+		CookedData.Empty();
+	}
+}
+
+bool URuntimeMeshCollisionSnapshot::IsCookComplete() const
+{
+	return CookResult.IsValid() && CookResult.IsReady();
+}
+
+void URuntimeMeshCollisionSnapshot::WaitForCook() const
+{
+	check(CookResult.IsValid());
+	CookResult.Wait();
+}
+
+void URuntimeMeshCollisionSnapshot::ReleaseCollisionData()
+{
+	CollisionData.Vertices.Empty();
+	CollisionData.Indices.Empty();
+	CollisionData.MaterialIndices.Empty();
+}
+
+void URuntimeMeshCollisionSnapshot::BeginDestroy()
+{
+	// The cook is still reading us and writing to the body setup, it can't be aborted
+	// part way but it's bounded so wait it out before anything gets torn down.
+	if (CookResult.IsValid())
+	{
+		CookResult.Wait();
+	}
+
+	Super::BeginDestroy();
+}
+
+bool URuntimeMeshCollisionSnapshot::GetPhysicsTriMeshData(struct FTriMeshCollisionData* OutCollisionData, bool InUseAllTriData)
+{
+	*OutCollisionData = CollisionData;
+	return CollisionData.Indices.Num() > 0;
+}
+
+bool URuntimeMeshCollisionSnapshot::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
+{
+	return CollisionData.Indices.Num() > 0;
+}
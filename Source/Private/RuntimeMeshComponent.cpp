@@ -7,6 +7,19 @@
 #include "RuntimeMeshCore.h"
 #include "RuntimeMeshGenericVertex.h"
 #include "RuntimeMeshVersion.h"
+#include "RuntimeMeshCollisionSnapshot.h"
+#include "PrimitiveSceneInfo.h"
+#include "AI/NavigationSystemHelpers.h"
+
+
+static TAutoConsoleVariable<int32> CVarRuntimeMeshSectionCulling(
+	TEXT("RuntimeMesh.SectionCulling"),
+	1,
+	TEXT("Per section culling in the dynamic path.\n")
+	TEXT(" 0: Off\n")
+	TEXT(" 1: Distance cull all sections, frustum cull sections that don't cast shadows (default)\n")
+	TEXT(" 2: Distance and frustum cull all sections. Shadows from off screen sections may pop as shadow passes reuse the main view."),
+	ECVF_RenderThreadSafe);
 
 
 /** Runtime mesh scene proxy */
@@ -15,72 +28,362 @@ class FRuntimeMeshSceneProxy : public FPrimitiveSceneProxy
 private:
 	TUniformBufferRef<FPrimitiveUniformShaderParameters> MeshUniformBuffer;
 
+	/* Sections found to be packable together, before they're packed */
+	struct FRuntimeMeshPackingCandidateGroup
+	{
+		const FRuntimeMeshVertexTypeInfo* VertexType;
+		bool bIsDualBuffer;
+		bool bCastsShadow;
+		UMaterialInterface* Material;
+		TArray<int32> SectionIndices;
+	};
+
 public:
 
 	FRuntimeMeshSceneProxy(URuntimeMeshComponent* Component)
-		: FPrimitiveSceneProxy(Component), MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+		: FPrimitiveSceneProxy(Component), RenderData(FRuntimeMeshSharedRenderData::Create()), bStaticMeshesDirty(false), bIsApplyingBatchUpdate(false), MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+		, bUseDitheredLODTransitions(Component->bUseDitheredLODTransitions), GPUMemory(Component->GPUMemory)
+		, ReportedGPUVertexBytes(0), ReportedGPUIndexBytes(0)
 	{
+		// Sections shared from another component are drawn along with our own
+		if (Component->SharedMeshData.IsValid())
+		{
+			SharedRenderData = Component->SharedMeshData->GetRenderData();
+
+			for (UMaterialInterface* Material : Component->SharedMeshData->GetMaterials())
+			{
+				if (Material)
+				{
+					MaterialRelevance |= Material->GetRelevance(GetScene().GetFeatureLevel());
+				}
+			}
+		}
+
 		// Get the proxy for all mesh sections
 
 		const int32 NumSections = Component->MeshSections.Num();
-		Sections.AddDefaulted(NumSections);
+		RenderData->Sections.Reserve(Component->GetNumSections());
+
+		// Sections that will be drawn from shared buffers instead of getting their own proxy
+		TBitArray<> PackedSections(false, NumSections);
+		TArray<FRuntimeMeshPackingCandidateGroup> PackingGroups;
+		if (Component->bMergeSectionsForRendering)
+		{
+			GatherPackingGroups(Component, PackingGroups);
+
+			for (const FRuntimeMeshPackingCandidateGroup& PackingGroup : PackingGroups)
+			{
+				for (int32 SectionIdx : PackingGroup.SectionIndices)
+				{
+					PackedSections[SectionIdx] = true;
+				}
+			}
+		}
 
-		for (int32 SectionIdx = 0; SectionIdx < NumSections; SectionIdx++)
+		for (int32 SectionIdx : Component->ValidSectionIndices)
 		{
 			RuntimeMeshSectionPtr& SourceSection = Component->MeshSections[SectionIdx];
-			if (SourceSection.IsValid())
+			if (!PackedSections[SectionIdx])
 			{
-				UMaterialInterface* Material = Component->GetMaterial(SectionIdx);
-				if (Material == nullptr)
+				// Render only sections can't be rebuilt once their data is released, so their section proxies are 
+				// taken over from the previous scene proxy instead. See CreateRenderThreadResources()
+				if (SourceSection->bHasReleasedCPUData)
 				{
-					Material = UMaterial::GetDefaultMaterial(MD_Surface);
+					if (Component->RetainedRenderData.IsValid())
+					{
+						PreviousRenderData = Component->RetainedRenderData;
+						ReleasedSections.Emplace(SectionIdx, Component->GetSectionMaterial(SectionIdx));
+					}
+					else
+					{
+						UE_LOG(RuntimeMeshLog, Warning, TEXT("FRuntimeMeshSceneProxy() - Section %d is render only and its data has been released, but there's no previous scene proxy to take it from. It won't be drawn until it's created again."), SectionIdx);
+					}
+					continue;
 				}
 
+				UMaterialInterface* Material = Component->GetSectionMaterial(SectionIdx);
+
 
 				// Get the section creation data
 				auto* SectionData = SourceSection->GetSectionCreationData(Material);
+
+				// The new proxy gets the full buffers so any pending range updates are already included
+				SourceSection->ClearDirtyRanges();
+				SourceSection->ClearInstanceChanges();
+
+				// The proxy now references the data so the section can let go of it
+				SourceSection->ReleaseCPUDataIfRenderOnly();
 				
+				// Save ref to new section
+				AddSection(SectionIdx, FinishCreateSection(SectionData));
+			}
+		}
+
+		// Pack the grouped sections back to back into one proxy per group
+		for (const FRuntimeMeshPackingCandidateGroup& PackingGroup : PackingGroups)
+		{
+			TArray<FRuntimeMeshSectionInterface*> GroupSections;
+			for (int32 SectionIdx : PackingGroup.SectionIndices)
+			{
+				FRuntimeMeshSectionInterface* SourceSection = Component->MeshSections[SectionIdx].Get();
+				SourceSection->ClearDirtyRanges();
+				GroupSections.Add(SourceSection);
+			}
 
-				auto Proxy = SectionData->NewProxy;
+			FRuntimeMeshPackedSectionGroup& PackedGroup = RenderData->PackedGroups[RenderData->PackedGroups.AddDefaulted()];
+			auto* SectionData = GroupSections[0]->GetPackedSectionCreationData(GroupSections, PackingGroup.Material, PackedGroup.Ranges);
 
-				if (!IsInRenderingThread())
-				{
-					// Enqueue update on RT
-					ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
-						FRuntimeMeshCreateSectionInternalCommand,
-						FRuntimeMeshSectionProxyInterface*, Proxy, Proxy,
-						FRuntimeMeshSectionCreateDataInterface*, SectionData, SectionData,
-						{
-							Proxy->FinishCreate_RenderThread(SectionData);
-							delete SectionData;
-						}
-					);
-				}
-				else
+			for (int32 RangeIdx = 0; RangeIdx < PackedGroup.Ranges.Num(); RangeIdx++)
+			{
+				PackedGroup.Ranges[RangeIdx].SectionIndex = PackingGroup.SectionIndices[RangeIdx];
+			}
+
+			PackedGroup.Proxy = FinishCreateSection(SectionData);
+		}
+	}
+
+	/* Groups the sections that can share buffers. Only groups of at least two sections are returned */
+	static void GatherPackingGroups(URuntimeMeshComponent* Component, TArray<FRuntimeMeshPackingCandidateGroup>& OutGroups)
+	{
+		for (int32 SectionIdx : Component->ValidSectionIndices)
+		{
+			const RuntimeMeshSectionPtr& SourceSection = Component->MeshSections[SectionIdx];
+
+			// Packed sections are rebuilt from the game thread data whenever the group is repacked, so render
+			// only sections are left alone. Hidden, instanced, quantized and GPU deformable sections and sections with LODs are drawn on their own.
+			if (SourceSection->UpdateFrequency != EUpdateFrequency::Infrequent || !SourceSection->bIsVisible ||
+				SourceSection->bIsRenderOnly || SourceSection->bQuantizePositions || SourceSection->bGPUDeformable || SourceSection->bIsInstanced || SourceSection->LODs.Num() > 0 || 
+				SourceSection->GetNumVertices() == 0 || SourceSection->IndexBuffer.Num() == 0)
+			{
+				continue;
+			}
+
+			UMaterialInterface* Material = Component->GetMaterial(SectionIdx);
+			if (Material == nullptr)
+			{
+				Material = UMaterial::GetDefaultMaterial(MD_Surface);
+			}
+
+			FRuntimeMeshPackingCandidateGroup* Group = OutGroups.FindByPredicate([&](const FRuntimeMeshPackingCandidateGroup& Candidate)
+			{
+				return Candidate.VertexType == SourceSection->GetVertexType() && Candidate.bIsDualBuffer == SourceSection->IsDualBufferSection() &&
+					Candidate.bCastsShadow == SourceSection->bCastsShadow && Candidate.Material == Material;
+			});
+
+			if (Group == nullptr)
+			{
+				Group = &OutGroups[OutGroups.AddDefaulted()];
+				Group->VertexType = SourceSection->GetVertexType();
+				Group->bIsDualBuffer = SourceSection->IsDualBufferSection();
+				Group->bCastsShadow = SourceSection->bCastsShadow;
+				Group->Material = Material;
+			}
+
+			Group->SectionIndices.Add(SectionIdx);
+		}
+
+		// A single section gains nothing from packing
+		OutGroups.RemoveAll([](const FRuntimeMeshPackingCandidateGroup& Group) { return Group.SectionIndices.Num() < 2; });
+	}
+
+	/* Finishes creating a section proxy on the RT, returns the proxy */
+	static FRuntimeMeshSectionProxyInterface* FinishCreateSection(FRuntimeMeshSectionCreateDataInterface* SectionData)
+	{
+		auto Proxy = SectionData->NewProxy;
+
+		if (!IsInRenderingThread())
+		{
+			// Enqueue update on RT
+			ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+				FRuntimeMeshCreateSectionInternalCommand,
+				FRuntimeMeshSectionProxyInterface*, Proxy, Proxy,
+				FRuntimeMeshSectionCreateDataInterface*, SectionData, SectionData,
 				{
 					Proxy->FinishCreate_RenderThread(SectionData);
-					delete SectionData;
+					SectionData->Release();
 				}
+			);
+		}
+		else
+		{
+			Proxy->FinishCreate_RenderThread(SectionData);
+			SectionData->Release();
+		}
 
-				// Save ref to new section
-				Sections[SectionIdx] = Proxy;
+		return Proxy;
+	}
 
-			}
+	virtual ~FRuntimeMeshSceneProxy()
+	{
+		// The sections go with the render data once nothing else is drawing them
+		for (FRuntimeMeshSectionProxyInterface* Section : RetiredStaticSections)
+		{
+			delete Section;
+		}
+
+		// The buffers were released along with the sections
+		if (GPUMemory.IsValid())
+		{
+			GPUMemory->VertexBytes.Subtract(ReportedGPUVertexBytes);
+			GPUMemory->IndexBytes.Subtract(ReportedGPUIndexBytes);
 		}
 	}
 
-	virtual ~FRuntimeMeshSceneProxy()
+	virtual void CreateRenderThreadResources() override
 	{
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		// The previous scene proxy has been removed from the scene by now, so its released render only sections can be moved over.
+		// Components still drawing its render data as a shared mesh just stop drawing them until they pick up ours
+		if (PreviousRenderData.IsValid())
 		{
-			if (Section)
+			for (const TPair<int32, UMaterialInterface*>& ReleasedSection : ReleasedSections)
 			{
-				delete Section;
+				FRuntimeMeshSectionProxyInterface* Section = nullptr;
+				if (PreviousRenderData->Sections.RemoveAndCopyValue(ReleasedSection.Key, Section))
+				{
+					(Section->WantsToRenderInStaticPath() ? PreviousRenderData->NumStaticSections : PreviousRenderData->NumDynamicSections)--;
+
+					Section->SetMaterial_RenderThread(ReleasedSection.Value);
+					AddSection(ReleasedSection.Key, Section);
+					UpdateSectionUniformBuffer(Section);
+				}
 			}
+
+			PreviousRenderData.Reset();
+			ReleasedSections.Empty();
+		}
+
+		// All the sections have been created by now
+		UpdateGPUMemoryUsage();
+	}
+
+	/* Gets the GPU memory held by all the section buffers */
+	void GetGPUMemoryUsage(SIZE_T& OutVertexBytes, SIZE_T& OutIndexBytes) const
+	{
+		OutVertexBytes = 0;
+		OutIndexBytes = 0;
+
+		for (const auto& SectionEntry : RenderData->Sections)
+		{
+			SectionEntry.Value->GetGPUMemoryUsage(OutVertexBytes, OutIndexBytes);
+		}
+
+		for (const FRuntimeMeshPackedSectionGroup& PackedGroup : RenderData->PackedGroups)
+		{
+			PackedGroup.Proxy->GetGPUMemoryUsage(OutVertexBytes, OutIndexBytes);
+		}
+	}
+
+	/* Reports any change in GPU memory to the component. Called after each change to the sections */
+	void UpdateGPUMemoryUsage()
+	{
+		check(IsInRenderingThread());
+
+		if (GPUMemory.IsValid())
+		{
+			SIZE_T VertexBytes, IndexBytes;
+			GetGPUMemoryUsage(VertexBytes, IndexBytes);
+
+			GPUMemory->VertexBytes.Add((int64)VertexBytes - (int64)ReportedGPUVertexBytes);
+			GPUMemory->IndexBytes.Add((int64)IndexBytes - (int64)ReportedGPUIndexBytes);
+			ReportedGPUVertexBytes = VertexBytes;
+			ReportedGPUIndexBytes = IndexBytes;
+		}
+	}
+
+	/* Gets the proxy of a section, or null if it has none */
+	FRuntimeMeshSectionProxyInterface* FindSection(int32 SectionIndex) const
+	{
+		FRuntimeMeshSectionProxyInterface* const* Section = RenderData->Sections.Find(SectionIndex);
+		return Section ? *Section : nullptr;
+	}
+
+	/* Adds a section proxy, which must not replace an existing one */
+	void AddSection(int32 SectionIndex, FRuntimeMeshSectionProxyInterface* Section)
+	{
+		check(!RenderData->Sections.Contains(SectionIndex));
+
+		RenderData->Sections.Add(SectionIndex, Section);
+		(Section->WantsToRenderInStaticPath() ? RenderData->NumStaticSections : RenderData->NumDynamicSections)++;
+	}
+
+	/* Removes a section proxy from the section map and returns it, or null if there wasn't one */
+	FRuntimeMeshSectionProxyInterface* RemoveSection(int32 SectionIndex)
+	{
+		FRuntimeMeshSectionProxyInterface* Section = nullptr;
+		if (RenderData->Sections.RemoveAndCopyValue(SectionIndex, Section))
+		{
+			(Section->WantsToRenderInStaticPath() ? RenderData->NumStaticSections : RenderData->NumDynamicSections)--;
+		}
+		return Section;
+	}
+
+	/* 
+	 *	Flags the static meshes of this primitive to be re-cached after a static section changed. They're re-cached
+	 *	by UpdateStaticMeshesIfDirty_RenderThread() once the current update or batch update has been applied.
+	 */
+	void MarkStaticMeshesDirty_RenderThread()
+	{
+		check(IsInRenderingThread());
+
+		bStaticMeshesDirty = true;
+	}
+
+	/*
+	 *	Re-caches the static meshes if a static section changed, unless a batch update is still being applied.
+	 *	The engine's deferred static mesh update only re-adds the meshes it already has, so they're removed and
+	 *	added again instead, which has DrawStaticElements() build them from the current sections. The engine can't
+	 *	invalidate single static meshes so every static section is resubmitted, but their buffers are left as they are.
+	 */
+	void UpdateStaticMeshesIfDirty_RenderThread()
+	{
+		check(IsInRenderingThread());
+
+		if (!bStaticMeshesDirty || bIsApplyingBatchUpdate)
+		{
+			return;
+		}
+		bStaticMeshesDirty = false;
+
+#if RUNTIMEMESH_ENABLE_STATIC_SECTION_UPDATES
+		if (FPrimitiveSceneInfo* SceneInfo = GetPrimitiveSceneInfo())
+		{
+			SceneInfo->RemoveStaticMeshes();
+			SceneInfo->AddStaticMeshes(FRHICommandListExecutor::GetImmediateCommandList());
+		}
+#endif
+
+		// The old static meshes are gone, so nothing references the retired sections anymore
+		for (FRuntimeMeshSectionProxyInterface* Section : RetiredStaticSections)
+		{
+			delete Section;
+		}
+		RetiredStaticSections.Reset();
+	}
+
+	/* Re-caches the static meshes if the section is drawn in the static path */
+	void MarkStaticMeshesDirtyIfStatic_RenderThread(FRuntimeMeshSectionProxyInterface* Section)
+	{
+		if (Section->WantsToRenderInStaticPath())
+		{
+			MarkStaticMeshesDirty_RenderThread();
+		}
+	}
+
+	/* Deletes a section that's been replaced or destroyed. Static sections live on until their cached static meshes are gone */
+	void ReleaseSection_RenderThread(FRuntimeMeshSectionProxyInterface* Section)
+	{
+		if (RUNTIMEMESH_ENABLE_STATIC_SECTION_UPDATES && Section->WantsToRenderInStaticPath() && GetPrimitiveSceneInfo() != nullptr)
+		{
+			RetiredStaticSections.Add(Section);
+			MarkStaticMeshesDirty_RenderThread();
+		}
+		else
+		{
+			delete Section;
 		}
 	}
 
-	/** Called on render thread to create a new dynamic section. (Static sections are handled differently) */
+	/** Called on render thread to create a new section. Static sections have the static meshes re-cached to pick it up */
 	void CreateSection_RenderThread(FRuntimeMeshSectionCreateDataInterface* SectionData)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateSection_RenderThread);
@@ -89,27 +392,26 @@ public:
 		check(SectionData);
 
 		int32 SectionIndex = SectionData->GetTargetSection();
-
-		// Make sure the array is big enough
-		if (SectionIndex >= Sections.Num())
-		{
-			Sections.SetNum(SectionIndex + 1, false);
-		}
 		
 		// If a section already exists... destroy it!
-		if (FRuntimeMeshSectionProxyInterface* Section = Sections[SectionIndex])
+		if (FRuntimeMeshSectionProxyInterface* Section = RemoveSection(SectionIndex))
 		{			
-			delete Section;
+			ReleaseSection_RenderThread(Section);
 		}
 		
 		// Get the proxy and finish the creation here on the render thread.
 		FRuntimeMeshSectionProxyInterface* Section = SectionData->NewProxy;
 		Section->FinishCreate_RenderThread(SectionData);		
+		UpdateSectionUniformBuffer(Section);
 
 		// Save ref to new section
-		Sections[SectionIndex] = Section;
+		AddSection(SectionIndex, Section);
+		MarkStaticMeshesDirtyIfStatic_RenderThread(Section);
 		
-		delete SectionData;
+		SectionData->Release();
+
+		UpdateStaticMeshesIfDirty_RenderThread();
+		UpdateGPUMemoryUsage();
 	}
 
 	/** Called on render thread to assign new dynamic data */
@@ -120,12 +422,19 @@ public:
   		check(IsInRenderingThread());
 		check(SectionData);
 
-		if (SectionData->GetTargetSection() < Sections.Num() && Sections[SectionData->GetTargetSection()] != nullptr)
+		if (FRuntimeMeshSectionProxyInterface* Section = FindSection(SectionData->GetTargetSection()))
 		{
-			Sections[SectionData->GetTargetSection()]->FinishUpdate_RenderThread(SectionData);
+			Section->FinishUpdate_RenderThread(SectionData);
+			UpdateSectionUniformBuffer(Section);
+
+			// The draw counts in the cached static meshes are out of date
+			MarkStaticMeshesDirtyIfStatic_RenderThread(Section);
 		}
 
-		delete SectionData;
+		SectionData->Release();
+
+		UpdateStaticMeshesIfDirty_RenderThread();
+		UpdateGPUMemoryUsage();
  	}
 
 	void UpdateSectionPositionOnly_RenderThread(FRuntimeMeshRenderThreadCommandInterface* SectionData)
@@ -135,12 +444,40 @@ public:
 		check(IsInRenderingThread());
 		check(SectionData);
 
-		if (SectionData->GetTargetSection() < Sections.Num() && Sections[SectionData->GetTargetSection()] != nullptr)
+		if (FRuntimeMeshSectionProxyInterface* Section = FindSection(SectionData->GetTargetSection()))
+		{
+			Section->FinishPositionUpdate_RenderThread(SectionData);
+			UpdateSectionUniformBuffer(Section);
+
+			// Quantized sections have a new uniform buffer the cached static meshes don't know about
+			if (Section->HasPositionTransform())
+			{
+				MarkStaticMeshesDirtyIfStatic_RenderThread(Section);
+			}
+		}
+
+		SectionData->Release();
+
+		UpdateStaticMeshesIfDirty_RenderThread();
+		UpdateGPUMemoryUsage();
+	}
+
+	void UpdateSectionRange_RenderThread(FRuntimeMeshRenderThreadCommandInterface* SectionData)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateSectionRange_RenderThread);
+
+		check(IsInRenderingThread());
+		check(SectionData);
+
+		if (FRuntimeMeshSectionProxyInterface* Section = FindSection(SectionData->GetTargetSection()))
 		{
-			Sections[SectionData->GetTargetSection()]->FinishPositionUpdate_RenderThread(SectionData);
+			Section->FinishRangeUpdate_RenderThread(SectionData);
 		}
 
-		delete SectionData;
+		SectionData->Release();
+
+		UpdateStaticMeshesIfDirty_RenderThread();
+		UpdateGPUMemoryUsage();
 	}
 
 	void UpdateSectionProperties_RenderThread(FRuntimeMeshRenderThreadCommandInterface* SectionData)
@@ -150,12 +487,51 @@ public:
 		check(IsInRenderingThread());
 		check(SectionData);
 
-		int32 SectionIndex = SectionData->GetTargetSection();
+		if (FRuntimeMeshSectionProxyInterface* Section = FindSection(SectionData->GetTargetSection()))
+		{
+			Section->FinishPropertyUpdate_RenderThread(SectionData);
+
+			// Visibility and shadow casting are baked into the cached static meshes
+			MarkStaticMeshesDirtyIfStatic_RenderThread(Section);
+		}
+
+		SectionData->Release();
+
+		UpdateStaticMeshesIfDirty_RenderThread();
+	}
+
+
+	void DeformSectionGPU_RenderThread(FRHICommandListImmediate& RHICmdList, int32 SectionIndex, const FRuntimeMeshGPUDeformer& Deformer, const FBox& ConservativeBounds)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_DeformSectionGPU_RenderThread);
+
+		check(IsInRenderingThread());
+
+		if (FRuntimeMeshSectionProxyInterface* Section = FindSection(SectionIndex))
+		{
+			Section->DeformGPU_RenderThread(RHICmdList, Deformer, ConservativeBounds);
+		}
+	}
 
-		if (SectionIndex < Sections.Num() && Sections[SectionIndex] != nullptr)
+	void UpdateSectionInstances_RenderThread(FRuntimeMeshRenderThreadCommandInterface* SectionData)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateSectionInstances_RenderThread);
+
+		check(IsInRenderingThread());
+		check(SectionData);
+
+		if (FRuntimeMeshSectionProxyInterface* Section = FindSection(SectionData->GetTargetSection()))
 		{
-			Sections[SectionIndex]->FinishPropertyUpdate_RenderThread(SectionData);
+			Section->FinishInstanceUpdate_RenderThread(SectionData);
+
+			// The instance count is baked into the cached static meshes
+			MarkStaticMeshesDirtyIfStatic_RenderThread(Section);
 		}
+
+		SectionData->Release();
+
+		UpdateStaticMeshesIfDirty_RenderThread();
+		UpdateGPUMemoryUsage();
 	}
 
 
@@ -163,11 +539,13 @@ public:
 	{
 		check(IsInRenderingThread());
 
-		if (SectionIndex < Sections.Num() && Sections[SectionIndex] != nullptr)
+		if (FRuntimeMeshSectionProxyInterface* Section = RemoveSection(SectionIndex))
 		{
-			delete Sections[SectionIndex];
-			Sections[SectionIndex] = nullptr;
+			ReleaseSection_RenderThread(Section);
 		}
+
+		UpdateStaticMeshesIfDirty_RenderThread();
+		UpdateGPUMemoryUsage();
 	}
 
 	void ApplyBatchUpdate_RenderThread(FRuntimeMeshBatchUpdateData* BatchUpdateData)
@@ -177,6 +555,9 @@ public:
 		check(IsInRenderingThread());
 		check(BatchUpdateData);
 
+		// The static meshes are re-cached once for the whole batch
+		bIsApplyingBatchUpdate = true;
+
 		// Destroy flagged sections
 		for (auto& SectionIndex : BatchUpdateData->DestroySections)
 		{
@@ -195,12 +576,27 @@ public:
 			UpdateSection_RenderThread(SectionToUpdate);
 		}		
 
+		// Apply range updates after full updates so they land in correctly sized buffers
+		for (auto& SectionToUpdate : BatchUpdateData->RangeUpdateSections)
+		{
+			UpdateSectionRange_RenderThread(SectionToUpdate);
+		}
+
 		// Apply section property updates
 		for (auto& SectionToUpdate : BatchUpdateData->PropertyUpdateSections)
 		{
 			UpdateSectionProperties_RenderThread(SectionToUpdate);
 		}
 
+		// Apply instance updates
+		for (auto& SectionToUpdate : BatchUpdateData->InstanceUpdateSections)
+		{
+			UpdateSectionInstances_RenderThread(SectionToUpdate);
+		}
+
+		bIsApplyingBatchUpdate = false;
+		UpdateStaticMeshesIfDirty_RenderThread();
+
 		delete BatchUpdateData;
 
 	}
@@ -213,30 +609,52 @@ public:
 
 		// Create a uniform buffer with the transform for this mesh.
 		MeshUniformBuffer = CreatePrimitiveUniformBufferImmediate(GetLocalToWorld(), GetBounds(), GetLocalBounds(), true, UseEditorDepthTest());
+
+		// Sections with their own transform need theirs rebuilt as well
+		for (const auto& SectionEntry : RenderData->Sections)
+		{
+			UpdateSectionUniformBuffer(SectionEntry.Value);
+		}
+
+		// Shared ones are rebuilt as they're next drawn
+		SharedSectionUniformBuffers.Empty();
 	}
 
-	bool HasDynamicSections() const
+	/* Rebuilds the uniform buffer of a section with its own position transform, like quantized sections */
+	void UpdateSectionUniformBuffer(FRuntimeMeshSectionProxyInterface* Section) const
 	{
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		if (Section->HasPositionTransform())
 		{
-			if (Section && !Section->WantsToRenderInStaticPath())
-			{
-				return true;
-			}
+			Section->UpdateUniformBuffer(GetLocalToWorld(), GetBounds(), GetLocalBounds(), UseEditorDepthTest());
 		}
-		return false;
 	}
 
-	bool HasStaticSections() const 
+	/* Gets the uniform buffer for a shared section with its own position transform, built with this proxy's transform */
+	const TUniformBufferRef<FPrimitiveUniformShaderParameters>& GetSharedSectionUniformBuffer(int32 SectionIndex, const FRuntimeMeshSectionProxyInterface* Section) const
 	{
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		// The source may have replaced the section or moved its positions since the buffer was built
+		FRuntimeMeshSharedSectionUniformBuffer& SectionUniformBuffer = SharedSectionUniformBuffers.FindOrAdd(SectionIndex);
+		if (!SectionUniformBuffer.UniformBuffer.IsValid() || !SectionUniformBuffer.PositionTransform.Equals(Section->GetPositionTransform(), 0.0f))
 		{
-			if (Section && Section->WantsToRenderInStaticPath())
-			{
-				return true;
-			}
+			SectionUniformBuffer.PositionTransform = Section->GetPositionTransform();
+			SectionUniformBuffer.UniformBuffer = CreatePrimitiveUniformBufferImmediate(SectionUniformBuffer.PositionTransform * GetLocalToWorld(), GetBounds(), GetLocalBounds(), true, UseEditorDepthTest());
 		}
-		return false;
+		return SectionUniformBuffer.UniformBuffer;
+	}
+
+	/* Our sections, for the components sharing this components mesh */
+	const TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe>& GetRenderData() const { return RenderData; }
+
+	bool HasDynamicSections() const
+	{
+		// Shared sections are only drawn in the dynamic path
+		return RenderData->NumDynamicSections > 0 || (SharedRenderData.IsValid() && SharedRenderData->HasSections());
+	}
+
+	bool HasStaticSections() const 
+	{
+		// Only static sections are packed
+		return RenderData->NumStaticSections > 0 || RenderData->PackedGroups.Num() > 0;
 	}
 
 #if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 11
@@ -262,66 +680,212 @@ public:
 		return Result;
 	}
 
-	void CreateMeshBatch(FMeshBatch& MeshBatch, FRuntimeMeshSectionProxyInterface* Section, FMaterialRenderProxy* WireframeMaterial) const
+	void CreateMeshBatch(FMeshBatch& MeshBatch, FRuntimeMeshSectionProxyInterface* Section, FMaterialRenderProxy* WireframeMaterial, int32 LODIndex = 0) const
 	{
-		Section->CreateMeshBatch(MeshBatch, WireframeMaterial, IsSelected());
+		Section->CreateMeshBatch(MeshBatch, WireframeMaterial, IsSelected(), LODIndex);
 
 		MeshBatch.ReverseCulling = IsLocalToWorldDeterminantNegative();
 		MeshBatch.bCanApplyViewModeOverrides = false;
 		
 		FMeshBatchElement& BatchElement = MeshBatch.Elements[0];
-		BatchElement.PrimitiveUniformBuffer = MeshUniformBuffer;
+		BatchElement.PrimitiveUniformBuffer = Section->HasPositionTransform() ? Section->GetUniformBuffer() : MeshUniformBuffer;
 	}
-	
-	virtual void DrawStaticElements(FStaticPrimitiveDrawInterface* PDI) override
+
+	/* 
+	 *	Creates the mesh batch for a packed group, with one element per run of adjacent visible ranges.
+	 *	When every range is visible this is a single element drawing the whole group.
+	 */
+	void CreatePackedMeshBatch(FMeshBatch& MeshBatch, const FRuntimeMeshPackedSectionGroup& PackedGroup, const TBitArray<>& VisibleRanges, FMaterialRenderProxy* WireframeMaterial) const
 	{
-		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_DrawStaticElements);
+		CreateMeshBatch(MeshBatch, PackedGroup.Proxy, WireframeMaterial);
 
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		const FMeshBatchElement TemplateElement = MeshBatch.Elements[0];
+		MeshBatch.Elements.Reset();
+
+		for (int32 RangeIdx = 0; RangeIdx < PackedGroup.Ranges.Num(); RangeIdx++)
 		{
-			if (Section && Section->ShouldRender() && Section->WantsToRenderInStaticPath())
+			if (!VisibleRanges[RangeIdx])
 			{
-				FMeshBatch MeshBatch;
-				CreateMeshBatch(MeshBatch, Section, nullptr);
-				PDI->DrawMesh(MeshBatch, FLT_MAX);
+				continue;
+			}
+
+			// Ranges are back to back in the index buffer, so a run of visible ranges is one contiguous draw
+			const FRuntimeMeshPackedSectionRange& FirstRange = PackedGroup.Ranges[RangeIdx];
+			int32 NumIndices = FirstRange.NumIndices;
+			int32 MinVertexIndex = FirstRange.MinVertexIndex;
+			int32 MaxVertexIndex = FirstRange.MaxVertexIndex;
+
+			while (RangeIdx + 1 < PackedGroup.Ranges.Num() && VisibleRanges[RangeIdx + 1])
+			{
+				RangeIdx++;
+				const FRuntimeMeshPackedSectionRange& Range = PackedGroup.Ranges[RangeIdx];
+				NumIndices += Range.NumIndices;
+				MinVertexIndex = FMath::Min(MinVertexIndex, Range.MinVertexIndex);
+				MaxVertexIndex = FMath::Max(MaxVertexIndex, Range.MaxVertexIndex);
 			}
+
+			FMeshBatchElement& BatchElement = MeshBatch.Elements[MeshBatch.Elements.Add(TemplateElement)];
+			BatchElement.FirstIndex = FirstRange.FirstIndex;
+			BatchElement.NumPrimitives = NumIndices / 3;
+			BatchElement.MinVertexIndex = MinVertexIndex;
+			BatchElement.MaxVertexIndex = MaxVertexIndex;
 		}
 	}
-
-	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	
+	virtual void DrawStaticElements(FStaticPrimitiveDrawInterface* PDI) override
 	{
-		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_GetDynamicMeshElements);
-
-		// Set up wireframe material (if needed)
-		const bool bWireframe = AllowDebugViewmodes() && ViewFamily.EngineShowFlags.Wireframe;
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_DrawStaticElements);
 
-		FColoredMaterialRenderProxy* WireframeMaterialInstance = nullptr;
-		if (bWireframe)
+		// The renderer picks one LOD index for the whole primitive in the static path, so every section
+		// submits a mesh for every LOD index in use, repeating its lowest detail LOD if it has fewer.
+		// Packed groups are drawn whole as one mesh, they only hold static sections without LODs.
+		TArray<FRuntimeMeshSectionProxyInterface*, TInlineAllocator<16>> StaticSections;
+		if (RenderData->NumStaticSections > 0)
 		{
-			WireframeMaterialInstance = new FColoredMaterialRenderProxy(
-				GEngine->WireframeMaterial ? GEngine->WireframeMaterial->GetRenderProxy(IsSelected()) : nullptr,
-				FLinearColor(0, 0.5f, 1.f)
+			for (const auto& SectionEntry : RenderData->Sections)
+			{
+				FRuntimeMeshSectionProxyInterface* Section = SectionEntry.Value;
+				if (Section->ShouldRender() && Section->WantsToRenderInStaticPath())
+				{
+					StaticSections.Add(Section);
+				}
+			}
+		}
+		for (const FRuntimeMeshPackedSectionGroup& PackedGroup : RenderData->PackedGroups)
+		{
+			if (PackedGroup.Proxy->ShouldRender())
+			{
+				StaticSections.Add(PackedGroup.Proxy);
+			}
+		}
+
+		int32 NumLODs = 1;
+		for (FRuntimeMeshSectionProxyInterface* Section : StaticSections)
+		{
+			NumLODs = FMath::Max(NumLODs, Section->GetNumLODs());
+		}
+
+		for (FRuntimeMeshSectionProxyInterface* Section : StaticSections)
+		{
+			for (int32 LODIndex = 0; LODIndex < NumLODs; LODIndex++)
+			{
+				const int32 SectionLODIndex = FMath::Min(LODIndex, Section->GetNumLODs() - 1);
+
+				FMeshBatch MeshBatch;
+				CreateMeshBatch(MeshBatch, Section, nullptr, SectionLODIndex);
+				MeshBatch.LODIndex = LODIndex;
+				MeshBatch.bDitheredLODTransition = bUseDitheredLODTransitions && NumLODs > 1;
+				PDI->DrawMesh(MeshBatch, Section->GetLODScreenSize(SectionLODIndex));
+			}
+		}
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_GetDynamicMeshElements);
+
+		// Set up wireframe material (if needed)
+		const bool bWireframe = AllowDebugViewmodes() && ViewFamily.EngineShowFlags.Wireframe;
+
+		FColoredMaterialRenderProxy* WireframeMaterialInstance = nullptr;
+		if (bWireframe)
+		{
+			WireframeMaterialInstance = new FColoredMaterialRenderProxy(
+				GEngine->WireframeMaterial ? GEngine->WireframeMaterial->GetRenderProxy(IsSelected()) : nullptr,
+				FLinearColor(0, 0.5f, 1.f)
 				);
 
 			Collector.RegisterOneFrameMaterialProxy(WireframeMaterialInstance);
 		}
 
+		int32 NumSectionsDrawn = 0;
+		int32 NumSectionsCulled = 0;
+		int32 NumInstancesDrawn = 0;
+
+		GetRenderDataMeshElements(*RenderData, false, Views, VisibilityMap, Collector, WireframeMaterialInstance, NumSectionsDrawn, NumSectionsCulled, NumInstancesDrawn);
+
+		if (SharedRenderData.IsValid())
+		{
+			GetRenderDataMeshElements(*SharedRenderData, true, Views, VisibilityMap, Collector, WireframeMaterialInstance, NumSectionsDrawn, NumSectionsCulled, NumInstancesDrawn);
+		}
+
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_SectionsDrawn, NumSectionsDrawn);
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_SectionsCulled, NumSectionsCulled);
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_InstancesDrawn, NumInstancesDrawn);
+
+		// Draw bounds
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+		{
+			if (VisibilityMap & (1 << ViewIndex))
+			{
+				// Render bounds
+				RenderBounds(Collector.GetPDI(ViewIndex), ViewFamily.EngineShowFlags, GetBounds(), IsSelected());
+			}
+		}
+#endif
+	}
+
+
+	/* 
+	 *	Adds the dynamic path meshes of a set of sections for every view they're visible in.
+	 *	Sections shared from another component are always drawn here, their static meshes are cached by the source's proxy only.
+	 */
+	void GetRenderDataMeshElements(const FRuntimeMeshSharedRenderData& Data, bool bIsShared, const TArray<const FSceneView*>& Views, uint32 VisibilityMap, FMeshElementCollector& Collector,
+		FMaterialRenderProxy* WireframeMaterialInstance, int32& NumSectionsDrawn, int32& NumSectionsCulled, int32& NumInstancesDrawn) const
+	{
+		const int32 CullingMode = CVarRuntimeMeshSectionCulling.GetValueOnRenderThread();
+		const float MaxDrawDistanceSquared = FMath::Square(GetMaxDrawDistance());
+		const float MinDrawDistanceSquared = FMath::Square(GetMinDrawDistance());
+		const bool bHasMaxDrawDistance = GetMaxDrawDistance() > 0.0f && GetMaxDrawDistance() < FLT_MAX;
+
 		// Iterate over sections
-		for (FRuntimeMeshSectionProxyInterface* Section : Sections)
+		for (const auto& SectionEntry : Data.Sections)
 		{
-			if (Section && Section->ShouldRender())
+			FRuntimeMeshSectionProxyInterface* Section = SectionEntry.Value;
+			if (Section->ShouldRender())
 			{
+				// World space bounds for culling, only needed if the section has valid bounds
+				const FBox& SectionLocalBounds = Section->GetLocalBounds();
+				const bool bCanCull = CullingMode > 0 && SectionLocalBounds.IsValid;
+				const bool bCanFrustumCull = bCanCull && (CullingMode > 1 || !Section->CastsShadow());
+				const bool bHasLODs = Section->GetNumLODs() > 1 && SectionLocalBounds.IsValid;
+				const FBox SectionBounds = (bCanCull || bHasLODs) ? SectionLocalBounds.TransformBy(GetLocalToWorld()) : FBox(0);
+
 				// Add the mesh batch to every view it's visible in
 				for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
 				{
 					if (VisibilityMap & (1 << ViewIndex))
 					{
-						bool bForceDynamicPath = IsRichView(*Views[ViewIndex]->Family) || Views[ViewIndex]->Family->EngineShowFlags.Wireframe || IsSelected() || !IsStaticPathAvailable();
+						bool bForceDynamicPath = bIsShared || IsRichView(*Views[ViewIndex]->Family) || Views[ViewIndex]->Family->EngineShowFlags.Wireframe || IsSelected() || !IsStaticPathAvailable();
 
 						if (bForceDynamicPath || !Section->WantsToRenderInStaticPath())
 						{
+							if (bCanCull && IsSectionCulled(*Views[ViewIndex], SectionBounds, bCanFrustumCull, bHasMaxDrawDistance, MinDrawDistanceSquared, MaxDrawDistanceSquared))
+							{
+								NumSectionsCulled++;
+								continue;
+							}
+
+							NumSectionsDrawn++;
+							NumInstancesDrawn += Section->GetNumInstances();
+
+							// Pick the LOD from how large the section is on screen in this view
+							int32 LODIndex = 0;
+							if (bHasLODs)
+							{
+								const float ScreenSize = ComputeBoundsScreenSize(SectionBounds.GetCenter(), SectionBounds.GetExtent().Size(), *Views[ViewIndex]);
+								LODIndex = Section->GetLODForScreenSize(ScreenSize);
+							}
+
 							FMeshBatch& MeshBatch = Collector.AllocateMesh();
-							CreateMeshBatch(MeshBatch, Section, WireframeMaterialInstance);
+							CreateMeshBatch(MeshBatch, Section, WireframeMaterialInstance, LODIndex);
+
+							// The section's own uniform buffer is built with the source's transform
+							if (bIsShared && Section->HasPositionTransform())
+							{
+								MeshBatch.Elements[0].PrimitiveUniformBuffer = GetSharedSectionUniformBuffer(SectionEntry.Key, Section);
+							}
 
 							Collector.AddMesh(ViewIndex, MeshBatch);
 						}
@@ -330,19 +894,68 @@ public:
 			}			
 		}
 
-		// Draw bounds
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+		// Packed groups are static, so they only get here when the dynamic path is forced
+		for (const FRuntimeMeshPackedSectionGroup& PackedGroup : Data.PackedGroups)
 		{
-			if (VisibilityMap & (1 << ViewIndex))
+			if (!PackedGroup.Proxy->ShouldRender())
 			{
-				// Render bounds
-				RenderBounds(Collector.GetPDI(ViewIndex), ViewFamily.EngineShowFlags, GetBounds(), IsSelected());
+				continue;
+			}
+
+			const bool bCanFrustumCull = CullingMode > 1 || !PackedGroup.Proxy->CastsShadow();
+
+			for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+			{
+				if (VisibilityMap & (1 << ViewIndex))
+				{
+					bool bForceDynamicPath = bIsShared || IsRichView(*Views[ViewIndex]->Family) || Views[ViewIndex]->Family->EngineShowFlags.Wireframe || IsSelected() || !IsStaticPathAvailable();
+					if (!bForceDynamicPath)
+					{
+						continue;
+					}
+
+					// Cull each packed section on its own, the survivors are merged back into as few elements as possible
+					TBitArray<> VisibleRanges(true, PackedGroup.Ranges.Num());
+					int32 NumRangesVisible = PackedGroup.Ranges.Num();
+					if (CullingMode > 0)
+					{
+						for (int32 RangeIdx = 0; RangeIdx < PackedGroup.Ranges.Num(); RangeIdx++)
+						{
+							const FBox& RangeLocalBounds = PackedGroup.Ranges[RangeIdx].LocalBounds;
+							if (RangeLocalBounds.IsValid && IsSectionCulled(*Views[ViewIndex], RangeLocalBounds.TransformBy(GetLocalToWorld()), bCanFrustumCull, bHasMaxDrawDistance, MinDrawDistanceSquared, MaxDrawDistanceSquared))
+							{
+								VisibleRanges[RangeIdx] = false;
+								NumRangesVisible--;
+							}
+						}
+					}
+
+					NumSectionsDrawn += NumRangesVisible;
+					NumSectionsCulled += PackedGroup.Ranges.Num() - NumRangesVisible;
+
+					if (NumRangesVisible > 0)
+					{
+						FMeshBatch& MeshBatch = Collector.AllocateMesh();
+						CreatePackedMeshBatch(MeshBatch, PackedGroup, VisibleRanges, WireframeMaterialInstance);
+
+						Collector.AddMesh(ViewIndex, MeshBatch);
+					}
+				}
 			}
 		}
-#endif
 	}
 
+	/* Tests a sections world space bounds against a views frustum and the draw distance settings */
+	static bool IsSectionCulled(const FSceneView& View, const FBox& SectionBounds, bool bFrustumCull, bool bHasMaxDrawDistance, float MinDrawDistanceSquared, float MaxDrawDistanceSquared)
+	{
+		const float DistanceSquared = ComputeSquaredDistanceFromBoxToPoint(SectionBounds.Min, SectionBounds.Max, View.ViewMatrices.ViewOrigin);
+		if ((bHasMaxDrawDistance && DistanceSquared > MaxDrawDistanceSquared) || DistanceSquared < MinDrawDistanceSquared)
+		{
+			return true;
+		}
+
+		return bFrustumCull && !View.ViewFrustum.IntersectBox(SectionBounds.GetCenter(), SectionBounds.GetExtent());
+	}
 
 	virtual bool CanBeOccluded() const override
 	{
@@ -356,14 +969,60 @@ public:
 
 	uint32 GetAllocatedSize(void) const
 	{
-		return(FPrimitiveSceneProxy::GetAllocatedSize());
+		SIZE_T Size = FPrimitiveSceneProxy::GetAllocatedSize() + RenderData->Sections.GetAllocatedSize() + RenderData->PackedGroups.GetAllocatedSize();
+
+		for (const auto& SectionEntry : RenderData->Sections)
+		{
+			Size += SectionEntry.Value->GetAllocatedSize();
+		}
+
+		for (const FRuntimeMeshPackedSectionGroup& PackedGroup : RenderData->PackedGroups)
+		{
+			Size += PackedGroup.Proxy->GetAllocatedSize() + PackedGroup.Ranges.GetAllocatedSize();
+		}
+
+		return Size;
 	}
 
 private:
-	/** Array of sections */
-	TArray<FRuntimeMeshSectionProxyInterface*> Sections;
+	/** Our sections, shared with the scene proxies of any components drawing this components mesh */
+	TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe> RenderData;
+
+	/** Sections shared from another component, drawn along with our own. Only ever read here */
+	TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe> SharedRenderData;
+
+	/** Render data of the previous scene proxy, and the released render only sections to take over from it along with their materials */
+	TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe> PreviousRenderData;
+	TArray<TPair<int32, UMaterialInterface*>> ReleasedSections;
+
+	/** Uniform buffer of a shared section with its own position transform, and the transform it was built with */
+	struct FRuntimeMeshSharedSectionUniformBuffer
+	{
+		FMatrix PositionTransform;
+		TUniformBufferRef<FPrimitiveUniformShaderParameters> UniformBuffer;
+	};
+
+	/** Uniform buffers of the shared sections that need their own, by section index. Built on demand while drawing */
+	mutable TMap<int32, FRuntimeMeshSharedSectionUniformBuffer> SharedSectionUniformBuffers;
+
+	/** Replaced or destroyed static sections, kept until the static meshes referencing them are re-cached */
+	TArray<FRuntimeMeshSectionProxyInterface*> RetiredStaticSections;
+
+	/** Has a static section changed since the static meshes were last re-cached */
+	bool bStaticMeshesDirty;
+
+	/** Is a batch update being applied, the static meshes are re-cached once it's done */
+	bool bIsApplyingBatchUpdate;
 
 	FMaterialRelevance MaterialRelevance;
+
+	/** Should the static path use dithered transitions between section LODs */
+	bool bUseDitheredLODTransitions;
+
+	/** GPU memory of this proxy as seen by the component, and how much of it this proxy has added */
+	TSharedPtr<FRuntimeMeshGPUMemoryCounter, ESPMode::ThreadSafe> GPUMemory;
+	SIZE_T ReportedGPUVertexBytes;
+	SIZE_T ReportedGPUIndexBytes;
 };
 
 
@@ -391,6 +1050,28 @@ FString FRuntimeMeshComponentPrePhysicsTickFunction::DiagnosticMessage()
 	return Target->GetFullName() + TEXT("[PrePhysicsTick]");
 }
 
+void FRuntimeMeshComponentEndOfFrameTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	/* Ensure target still exists */
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 11
+	bool bIsValid = Target && !Target->IsPendingKillOrUnreachable();
+#else
+	bool bIsValid = Target && !Target->HasAnyFlags(RF_PendingKill | RF_Unreachable);
+#endif
+
+	if (bIsValid)
+	{
+		FScopeCycleCounterUObject ActorScope(Target);
+		Target->TickEndOfFrame();
+	}
+}
+
+FString FRuntimeMeshComponentEndOfFrameTickFunction::DiagnosticMessage()
+{
+	return Target->GetFullName() + TEXT("[EndOfFrameTick]");
+}
+
 
 
 /* Helper for converting an array of FLinearColor to an array of FColors*/
@@ -407,13 +1088,21 @@ void ConvertLinearColorToFColor(const TArray<FLinearColor>& LinearColors, TArray
 
 
 URuntimeMeshComponent::URuntimeMeshComponent(const FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer), bUseComplexAsSimpleCollision(true), bShouldSerializeMeshData(true), bCollisionDirty(true)
+	: Super(ObjectInitializer), bUseComplexAsSimpleCollision(true), bShouldSerializeMeshData(true), bCompressSerializedMeshData(false), bUseDitheredLODTransitions(false), bMergeSectionsForRendering(false), NormalSmoothingTolerance(-1.0f), bUseAsyncCooking(false), bUseIncrementalSectionCollision(false), bAutoBatchUpdates(false), bUseUploadBudget(false), bUseCollisionCache(false)
+	, MeshBulkDataVersion(FRuntimeMeshVersion::LatestVersion), bHasPendingMeshBulkData(false)
+	, GPUMemory(MakeShareable(new FRuntimeMeshGPUMemoryCounter())), AccountedCollisionMemory(0), bCollisionDirty(true), bSimpleCollisionDirty(true), AsyncCookSnapshot(nullptr), CollisionCookGeneration(0), ElementCookBatch(0)
 {
 	// Setup the collision update ticker
 	PrePhysicsTick.TickGroup = TG_PrePhysics;
 	PrePhysicsTick.bCanEverTick = true;
 	PrePhysicsTick.bStartWithTickEnabled = true;
 
+	// Setup the auto batch ticker, it's only enabled while updates are pending
+	EndOfFrameTick.TickGroup = TG_LastDemotable;
+	EndOfFrameTick.bCanEverTick = true;
+	EndOfFrameTick.bStartWithTickEnabled = false;
+	EndOfFrameTick.bTickEvenWhenPaused = true;
+
 	// Reset the batch state
 	BatchState.ResetBatch();
 }
@@ -510,20 +1199,78 @@ TSharedPtr<FRuntimeMeshSectionInterface> URuntimeMeshComponent::CreateOrResetSec
 }
 
 
-void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex)
+void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex, ESectionUpdateFlags UpdateFlags)
 {
 	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
 	check(Section.IsValid());
 
+	// Collision needs the game thread copy of the data, so render only can't be used with it
+	bool bWantsRenderOnly = (UpdateFlags & ESectionUpdateFlags::RenderOnly) != ESectionUpdateFlags::None;
+	if (bWantsRenderOnly && Section->CollisionEnabled)
+	{
+		Log(TEXT("CreateMeshSection() - Render only sections can't have collision. The section data will be kept."));
+		bWantsRenderOnly = false;
+	}
+	Section->bIsRenderOnly = bWantsRenderOnly;
+
+	// The current scene proxy is the only place the data will be once it's released
+	if (bWantsRenderOnly && SceneProxy)
+	{
+		RetainedRenderData = static_cast<FRuntimeMeshSceneProxy*>(SceneProxy)->GetRenderData();
+	}
+
+	// Quantized positions replace the position only stream, so single buffer sections can't use them
+	bool bWantsQuantizedPositions = (UpdateFlags & ESectionUpdateFlags::QuantizePositions) != ESectionUpdateFlags::None;
+	if (bWantsQuantizedPositions && !Section->IsDualBufferSection())
+	{
+		Log(TEXT("CreateMeshSection() - Only dual buffer sections can quantize their positions. Positions will be kept at full precision."));
+		bWantsQuantizedPositions = false;
+	}
+	Section->bQuantizePositions = bWantsQuantizedPositions;
+
+	// GPU writes go through the full precision position buffer
+	bool bWantsGPUDeformable = (UpdateFlags & ESectionUpdateFlags::GPUDeformable) != ESectionUpdateFlags::None;
+	if (bWantsGPUDeformable && (!Section->IsDualBufferSection() || bWantsQuantizedPositions || !RHISupportsComputeShaders(GMaxRHIShaderPlatform)))
+	{
+		Log(TEXT("CreateMeshSection() - GPU deformable sections must be dual buffer, not quantized, and need compute shader support. The section won't be GPU deformable."));
+		bWantsGPUDeformable = false;
+	}
+	Section->bGPUDeformable = bWantsGPUDeformable;
+
+	// Has to happen before anything is sent to the RT or released
+	if ((UpdateFlags & (ESectionUpdateFlags::OptimizeMesh | ESectionUpdateFlags::OptimizeVertexOrder)) != ESectionUpdateFlags::None)
+	{
+		if (!Section->OptimizeMesh((UpdateFlags & ESectionUpdateFlags::OptimizeVertexOrder) != ESectionUpdateFlags::None))
+		{
+			Log(TEXT("CreateMeshSection() - Section data has been released, it can't be optimized."));
+		}
+	}
+
+	if ((UpdateFlags & ESectionUpdateFlags::CalculateNormalTangent) != ESectionUpdateFlags::None)
+	{
+		if (!Section->CalculateNormalTangents(NormalSmoothingTolerance, false))
+		{
+			Log(TEXT("CreateMeshSection() - Normals and tangents can only be calculated for the generic vertex types."));
+		}
+	}
+
+	INC_DWORD_STAT(STAT_RuntimeMesh_SectionsCreated);
+	Section->UpdateMemoryStats();
+	UpdateSectionBounds(SectionIndex);
+
+	// Collect the change for the end of the frame if auto batching
+	StartAutoBatchIfEnabled();
+
 	// Use the batch update if one is running
 	if (BatchState.IsBatchPending())
 	{
 		// Mark section created
-		BatchState.MarkSectionCreated(SectionIndex, Section->UpdateFrequency == EUpdateFrequency::Infrequent);
+		BatchState.MarkSectionCreated(SectionIndex, RequiresProxyRecreateForChange(*Section) || bMergeSectionsForRendering);
 
 		// Flag collision if this section affects it
 		if (Section->CollisionEnabled)
 		{
+			MarkSectionCollisionDirty(SectionIndex);
 			BatchState.MarkCollisionDirty();
 		}
 		
@@ -534,8 +1281,8 @@ void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex)
 		return;
 	}
 
-	// Enqueue the RT command if we already have a SceneProxy
-	if (SceneProxy && Section->UpdateFrequency != EUpdateFrequency::Infrequent)
+	// Enqueue the RT command if we already have a SceneProxy. Sections are repacked when one is created while packing
+	if (SceneProxy && !RequiresProxyRecreateForChange(*Section) && !bMergeSectionsForRendering)
 	{
 		// Gather all needed update info
 		auto* SectionData = Section->GetSectionCreationData(GetSectionMaterial(SectionIndex));
@@ -550,6 +1297,8 @@ void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex)
 				RuntimeMeshSceneProxy->CreateSection_RenderThread(SectionData);
 			}
 		);
+
+		Section->ReleaseCPUDataIfRenderOnly();
 	}
 	else
 	{
@@ -560,6 +1309,7 @@ void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex)
 	// Mark collision dirty so it's re-baked at the end of this frame
 	if (Section->CollisionEnabled)
 	{
+		MarkSectionCollisionDirty(SectionIndex);
 		MarkCollisionDirty();
 	}
 
@@ -568,23 +1318,44 @@ void URuntimeMeshComponent::CreateSectionInternal(int32 SectionIndex)
 
 }
 
-void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates, bool bNeedsBoundsUpdate)
+void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags)
 {
 	// Ensure that something was updated
-	check(bHadVertexPositionsUpdate || bHadVertexUpdates || bNeedsBoundsUpdate);
+	check(bHadVertexPositionsUpdate || bHadVertexUpdates || bHadIndexUpdates || bNeedsBoundsUpdate);
 
 	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());	
 	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
 
+	// Positions, UVs and triangles all feed the tangent basis, so any of them changing means the vertices change too
+	if ((UpdateFlags & ESectionUpdateFlags::CalculateNormalTangent) != ESectionUpdateFlags::None && (bHadVertexPositionsUpdate || bHadVertexUpdates || bHadIndexUpdates))
+	{
+		if (Section->CalculateNormalTangents(NormalSmoothingTolerance, false))
+		{
+			bHadVertexUpdates = true;
+		}
+		else
+		{
+			Log(TEXT("UpdateMeshSection() - Normals and tangents can only be calculated for generic vertex types that still have their data."));
+		}
+	}
+
+	INC_DWORD_STAT(STAT_RuntimeMesh_SectionsUpdated);
+	Section->UpdateMemoryStats();
+
 	/* Make sure this is only flagged if the section is dual buffer */
 	bHadVertexPositionsUpdate = Section->IsDualBufferSection() && bHadVertexPositionsUpdate;
-	bool bNeedsCollisionUpdate = Section->CollisionEnabled && (bHadVertexPositionsUpdate || (!Section->IsDualBufferSection() && bHadVertexUpdates));
+	bool bNeedsCollisionUpdate = Section->CollisionEnabled && (bHadVertexPositionsUpdate || bHadIndexUpdates || (!Section->IsDualBufferSection() && bHadVertexUpdates));
+
+	UpdateSectionBounds(SectionIndex);
 	
+	// Collect the change for the end of the frame if auto batching
+	StartAutoBatchIfEnabled();
+
 	// Use the batch update if one is running
 	if (BatchState.IsBatchPending())
 	{
-		// Mark update for section or promote to proxy recreate if static section
-		if (Section->UpdateFrequency == EUpdateFrequency::Infrequent)
+		// Mark update for section or promote to proxy recreate if the section can't be updated in place
+		if (RequiresProxyRecreateForChange(*Section))
 		{
 			BatchState.MarkRenderStateDirty();
 		}
@@ -601,6 +1372,7 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 		// Flag collision if this section affects it
 		if (bNeedsCollisionUpdate)
 		{
+			MarkSectionCollisionDirty(SectionIndex);
 			BatchState.MarkCollisionDirty();
 		}
 
@@ -616,7 +1388,7 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 
 
 	// Send the update to the render thread if the scene proxy exists
-	if (SceneProxy && Section->UpdateFrequency != EUpdateFrequency::Infrequent)
+	if (SceneProxy && !RequiresProxyRecreateForChange(*Section))
 	{
 		auto* SectionData = Section->GetSectionUpdateData(bHadVertexPositionsUpdate, bHadVertexUpdates, bHadIndexUpdates);
 		SectionData->SetTargetSection(SectionIndex);
@@ -630,6 +1402,8 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 				RuntimeMeshSceneProxy->UpdateSection_RenderThread(SectionData);
 			}
 		);
+
+		Section->ReleaseCPUDataIfRenderOnly();
 	}
 	else
 	{
@@ -640,6 +1414,7 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 	// Mark collision dirty so it's re-baked at the end of this frame
 	if (bNeedsCollisionUpdate)
 	{
+		MarkSectionCollisionDirty(SectionIndex);
 		MarkCollisionDirty();
 	}
 
@@ -650,45 +1425,136 @@ void URuntimeMeshComponent::UpdateSectionInternal(int32 SectionIndex, bool bHadV
 	}
 }
 
-void URuntimeMeshComponent::UpdateSectionVertexPositionsInternal(int32 SectionIndex, bool bNeedsBoundsUpdate)
+void URuntimeMeshComponent::UpdateSectionRangeInternal(int32 SectionIndex, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags)
 {
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_FinishRangeUpdateSectionInternal);
+
 	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());
 	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
 
-	if (SceneProxy)
+	// Only recalculates the vertices around the dirty ranges, and adds them to the dirty vertex ranges
+	if ((UpdateFlags & ESectionUpdateFlags::CalculateNormalTangent) != ESectionUpdateFlags::None)
 	{
-		auto SectionData = Section->GetSectionPositionUpdateData();
+		if (!Section->CalculateNormalTangents(NormalSmoothingTolerance, true))
+		{
+			Log(TEXT("UpdateMeshSectionRange() - Normals and tangents can only be calculated for generic vertex types that still have their data."));
+		}
+	}
+
+	bool bHadPositionRanges = Section->IsDualBufferSection() && !Section->DirtyPositionRanges.IsEmpty();
+	bool bHadVertexRanges = !Section->DirtyVertexRanges.IsEmpty();
+	bool bHadIndexRanges = !Section->DirtyIndexRanges.IsEmpty();
+
+	// Frequent sections start out with dynamic buffers that are discarded whenever they're written. The first range update
+	// sends the whole section once while the RT moves it to buffers that can be written in place, later ones only send the ranges.
+	if (Section->UpdateFrequency == EUpdateFrequency::Frequent && !Section->bRangeUpdatesEnabled)
+	{
+		Section->bRangeUpdatesEnabled = true;
+		Section->ClearDirtyRanges();
+		UpdateSectionInternal(SectionIndex, Section->IsDualBufferSection(), true, true, bNeedsBoundsUpdate);
+		return;
+	}
+
+	// Quantized positions are relative to the bounds, so when they grow every position has to be requantized.
+	if (Section->bQuantizePositions && bHadPositionRanges && bNeedsBoundsUpdate)
+	{
+		Section->ClearDirtyRanges();
+		UpdateSectionInternal(SectionIndex, bHadPositionRanges, bHadVertexRanges, bHadIndexRanges, bNeedsBoundsUpdate);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_RuntimeMesh_SectionsUpdated);
+	Section->UpdateMemoryStats();
+
+	bool bNeedsCollisionUpdate = Section->CollisionEnabled && (bHadPositionRanges || bHadIndexRanges || (!Section->IsDualBufferSection() && bHadVertexRanges));
+
+	UpdateSectionBounds(SectionIndex);
+
+	// Collect the change for the end of the frame if auto batching
+	StartAutoBatchIfEnabled();
+
+	// Use the batch update if one is running
+	if (BatchState.IsBatchPending())
+	{
+		// Mark update for section or promote to proxy recreate if the section can't be updated in place
+		if (RequiresProxyRecreateForChange(*Section))
+		{
+			BatchState.MarkRenderStateDirty();
+		}
+		else
+		{
+			BatchState.MarkUpdateForSection(SectionIndex, ERuntimeMeshSectionBatchUpdateType::RangeUpdate);
+		}
+
+		// Flag collision if this section affects it
+		if (bNeedsCollisionUpdate)
+		{
+			MarkSectionCollisionDirty(SectionIndex);
+			BatchState.MarkCollisionDirty();
+		}
+
+		// Flag bounds update if needed.
+		if (bNeedsBoundsUpdate)
+		{
+			BatchState.MarkBoundsDirty();
+		}
+
+		// bail since we don't update directly in this case.
+		return;
+	}
+
+	// Send the changed spans to the render thread if the scene proxy exists
+	if (SceneProxy && !RequiresProxyRecreateForChange(*Section))
+	{
+		auto* SectionData = Section->GetSectionRangeUpdateData();
 		SectionData->SetTargetSection(SectionIndex);
 
-		// Enqueue command to modify render thread info
+		// Enqueue update on RT
 		ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
-			FRuntimeMeshSectionPositionUpdate,
+			FRuntimeMeshSectionRangeUpdate,
 			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
 			FRuntimeMeshRenderThreadCommandInterface*, SectionData, SectionData,
 			{
-				RuntimeMeshSceneProxy->UpdateSectionPositionOnly_RenderThread(SectionData);
+				RuntimeMeshSceneProxy->UpdateSectionRange_RenderThread(SectionData);
 			}
 		);
 	}
 	else
 	{
+		// Mark the renderstate dirty so it's recreated when necessary. The new proxy picks up the full buffers.
 		MarkRenderStateDirty();
 	}
 
+	// Mark collision dirty so it's re-baked at the end of this frame
+	if (bNeedsCollisionUpdate)
+	{
+		MarkSectionCollisionDirty(SectionIndex);
+		MarkCollisionDirty();
+	}
+
+	// Update overall bounds if needed
 	if (bNeedsBoundsUpdate)
 	{
 		UpdateLocalBounds();
 	}
 }
 
-void URuntimeMeshComponent::UpdateSectionPropertiesInternal(int32 SectionIndex, bool bUpdateRequiresProxyRecreateIfStatic)
+void URuntimeMeshComponent::UpdateSectionVertexPositionsInternal(int32 SectionIndex, bool bNeedsBoundsUpdate)
 {
 	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());
 	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
 
-	bool bRequiresRecreate = bUpdateRequiresProxyRecreateIfStatic && Section->UpdateFrequency == EUpdateFrequency::Infrequent;
+	INC_DWORD_STAT(STAT_RuntimeMesh_SectionsUpdated);
+	Section->UpdateMemoryStats();
 
-	// Use the batch update if one is running
+	// Packed sections don't have a proxy of their own, so they're repacked instead
+	bool bRequiresRecreate = RequiresProxyRecreateForChange(*Section);
+
+	UpdateSectionBounds(SectionIndex);
+
+	StartAutoBatchIfEnabled();
+
+	// Positions sent right away could reach the RT before a batch creates the section, so they join the batch instead
 	if (BatchState.IsBatchPending())
 	{
 		if (bRequiresRecreate)
@@ -697,43 +1563,191 @@ void URuntimeMeshComponent::UpdateSectionPropertiesInternal(int32 SectionIndex,
 		}
 		else
 		{
-			BatchState.MarkUpdateForSection(SectionIndex, ERuntimeMeshSectionBatchUpdateType::PropertyUpdate);
+			BatchState.MarkUpdateForSection(SectionIndex, ERuntimeMeshSectionBatchUpdateType::PositionsUpdate);
+		}
+
+		if (bNeedsBoundsUpdate)
+		{
+			BatchState.MarkBoundsDirty();
 		}
 
 		// bail since we don't update directly in this case.
 		return;
 	}
 
-
-
 	if (SceneProxy && !bRequiresRecreate)
 	{
-		auto SectionData = new FRuntimeMeshSectionPropertyUpdateData();
+		auto SectionData = Section->GetSectionPositionUpdateData();
 		SectionData->SetTargetSection(SectionIndex);
-		SectionData->bIsVisible = Section->bIsVisible;
-		SectionData->bCastsShadow = Section->bCastsShadow;
-
 
 		// Enqueue command to modify render thread info
 		ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
-			FRuntimeMeshSectionPropertyUpdate,
+			FRuntimeMeshSectionPositionUpdate,
 			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
 			FRuntimeMeshRenderThreadCommandInterface*, SectionData, SectionData,
 			{
-				RuntimeMeshSceneProxy->UpdateSectionProperties_RenderThread(SectionData);
+				RuntimeMeshSceneProxy->UpdateSectionPositionOnly_RenderThread(SectionData);
 			}
 		);
+
+		Section->ReleaseCPUDataIfRenderOnly();
 	}
 	else
 	{
 		MarkRenderStateDirty();
 	}
-}
 
+	if (bNeedsBoundsUpdate)
+	{
+		UpdateLocalBounds();
+	}
+}
 
-void URuntimeMeshComponent::UpdateMeshSectionPositionsImmediate(int32 SectionIndex, TArray<FVector>& VertexPositions, ESectionUpdateFlags UpdateFlags)
+void URuntimeMeshComponent::UpdateSectionPropertiesInternal(int32 SectionIndex)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionPositionsImmediate);
+	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());
+	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
+
+	// Static sections might be packed with others while packing, which always needs a repack
+	bool bRequiresRecreate = RequiresProxyRecreateForChange(*Section);
+
+	// Collect the change for the end of the frame if auto batching
+	StartAutoBatchIfEnabled();
+
+	// Use the batch update if one is running
+	if (BatchState.IsBatchPending())
+	{
+		if (bRequiresRecreate)
+		{
+			BatchState.MarkRenderStateDirty();
+		}
+		else
+		{
+			BatchState.MarkUpdateForSection(SectionIndex, ERuntimeMeshSectionBatchUpdateType::PropertyUpdate);
+		}
+
+		// bail since we don't update directly in this case.
+		return;
+	}
+
+
+
+	if (SceneProxy && !bRequiresRecreate)
+	{
+		auto SectionData = new FRuntimeMeshSectionPropertyUpdateData();
+		SectionData->SetTargetSection(SectionIndex);
+		SectionData->bIsVisible = Section->bIsVisible;
+		SectionData->bCastsShadow = Section->bCastsShadow;
+
+
+		// Enqueue command to modify render thread info
+		ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+			FRuntimeMeshSectionPropertyUpdate,
+			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+			FRuntimeMeshRenderThreadCommandInterface*, SectionData, SectionData,
+			{
+				RuntimeMeshSceneProxy->UpdateSectionProperties_RenderThread(SectionData);
+			}
+		);
+	}
+	else
+	{
+		MarkRenderStateDirty();
+	}
+}
+
+
+void URuntimeMeshComponent::UpdateSectionInstancesInternal(int32 SectionIndex, bool bInstancingChanged)
+{
+	check(SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid());
+	RuntimeMeshSectionPtr Section = MeshSections[SectionIndex];
+
+	// Instances move the section bounds
+	UpdateSectionBounds(SectionIndex);
+
+	// Static sections might be packed with others while packing, which always needs a repack
+	bool bRequiresRecreate = RequiresProxyRecreateForChange(*Section);
+
+	// Collect the change for the end of the frame if auto batching
+	StartAutoBatchIfEnabled();
+
+	// Use the batch update if one is running
+	if (BatchState.IsBatchPending())
+	{
+		if (bRequiresRecreate)
+		{
+			BatchState.MarkRenderStateDirty();
+		}
+		else if (bInstancingChanged)
+		{
+			// Instanced and regular sections use different vertex factories, so the section proxy is replaced
+			BatchState.MarkSectionCreated(SectionIndex, false);
+		}
+		else
+		{
+			BatchState.MarkUpdateForSection(SectionIndex, ERuntimeMeshSectionBatchUpdateType::InstanceUpdate);
+		}
+
+		// Flag bounds update
+		BatchState.MarkBoundsDirty();
+
+		// bail since we don't update directly in this case.
+		return;
+	}
+
+	if (SceneProxy && !bRequiresRecreate)
+	{
+		if (bInstancingChanged)
+		{
+			// Instanced and regular sections use different vertex factories, so the section proxy is replaced
+			auto* SectionData = Section->GetSectionCreationData(GetSectionMaterial(SectionIndex));
+			SectionData->SetTargetSection(SectionIndex);
+
+			// The new proxy gets the full buffers
+			Section->ClearDirtyRanges();
+			Section->ClearInstanceChanges();
+
+			// Enqueue update on RT
+			ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+				FRuntimeMeshSectionInstancingCreate,
+				FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+				FRuntimeMeshSectionCreateDataInterface*, SectionData, SectionData,
+				{
+					RuntimeMeshSceneProxy->CreateSection_RenderThread(SectionData);
+				}
+			);
+
+			Section->ReleaseCPUDataIfRenderOnly();
+		}
+		else
+		{
+			auto* SectionData = Section->GetSectionInstanceUpdateData();
+			SectionData->SetTargetSection(SectionIndex);
+
+			// Enqueue command to modify render thread info
+			ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+				FRuntimeMeshSectionInstanceUpdate,
+				FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+				FRuntimeMeshRenderThreadCommandInterface*, SectionData, SectionData,
+				{
+					RuntimeMeshSceneProxy->UpdateSectionInstances_RenderThread(SectionData);
+				}
+			);
+		}
+	}
+	else
+	{
+		MarkRenderStateDirty();
+	}
+
+	// Update overall bounds
+	UpdateLocalBounds();
+}
+
+
+void URuntimeMeshComponent::UpdateMeshSectionPositionsImmediate(int32 SectionIndex, TArray<FVector>& VertexPositions, ESectionUpdateFlags UpdateFlags)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionPositionsImmediate);
 
 	// Validate all update parameters
 	RMC_VALIDATE_UPDATEPARAMETERS_DUALBUFFER(SectionIndex);
@@ -741,6 +1755,11 @@ void URuntimeMeshComponent::UpdateMeshSectionPositionsImmediate(int32 SectionInd
 	// Get section
 	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 
+	if (!CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSectionPositionsImmediate()")))
+	{
+		return;
+	}
+
 	// Check dual buffer section status
 	if (VertexPositions.Num() != Section->PositionVertexBuffer.Num())
 	{
@@ -763,10 +1782,17 @@ void URuntimeMeshComponent::UpdateMeshSectionPositionsImmediate(int32 SectionInd
 		Log(TEXT("UpdatemeshSection() - Vertex positions empty. They will not be updated."));
 	}
 
-	// Finalize section update if we have anything to apply
+	// Finalize section update if we have anything to apply. Recalculated normals change the vertices as well, so that needs the full update
 	if (bUpdatedVertexPositions)
 	{
-		UpdateSectionVertexPositionsInternal(SectionIndex, bNeedsBoundsUpdate);
+		if ((UpdateFlags & ESectionUpdateFlags::CalculateNormalTangent) != ESectionUpdateFlags::None)
+		{
+			UpdateSectionInternal(SectionIndex, true, false, false, bNeedsBoundsUpdate, UpdateFlags);
+		}
+		else
+		{
+			UpdateSectionVertexPositionsInternal(SectionIndex, bNeedsBoundsUpdate);
+		}
 	}
 }
 
@@ -780,6 +1806,11 @@ void URuntimeMeshComponent::UpdateMeshSectionPositionsImmediate(int32 SectionInd
 	// Get section
 	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 
+	if (!CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSectionPositionsImmediate()")))
+	{
+		return;
+	}
+
 	// Check dual buffer section status
 	if (VertexPositions.Num() != Section->PositionVertexBuffer.Num())
 	{
@@ -802,10 +1833,17 @@ void URuntimeMeshComponent::UpdateMeshSectionPositionsImmediate(int32 SectionInd
 		Log(TEXT("UpdatemeshSection() - Vertex positions empty. They will not be updated."));
 	}
 
-	// Finalize section update if we have anything to apply
+	// Finalize section update if we have anything to apply. Recalculated normals change the vertices as well, so that needs the full update
 	if (bUpdatedVertexPositions)
 	{
-		UpdateSectionVertexPositionsInternal(SectionIndex, bNeedsBoundsUpdate);
+		if ((UpdateFlags & ESectionUpdateFlags::CalculateNormalTangent) != ESectionUpdateFlags::None)
+		{
+			UpdateSectionInternal(SectionIndex, true, false, false, bNeedsBoundsUpdate, UpdateFlags);
+		}
+		else
+		{
+			UpdateSectionVertexPositionsInternal(SectionIndex, bNeedsBoundsUpdate);
+		}
 	}
 }
 
@@ -818,7 +1856,8 @@ TArray<FVector>* URuntimeMeshComponent::BeginMeshSectionPositionUpdate(int32 Sec
 	// Get section
 	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 	
-	return &Section->PositionVertexBuffer;
+	// Edit detaches the buffer from any data the RT still references
+	return &Section->PositionVertexBuffer.Edit();
 }
 
 void URuntimeMeshComponent::EndMeshSectionPositionUpdate(int32 SectionIndex)
@@ -826,6 +1865,11 @@ void URuntimeMeshComponent::EndMeshSectionPositionUpdate(int32 SectionIndex)
 	// Validate all update parameters
 	RMC_VALIDATE_UPDATEPARAMETERS_DUALBUFFER(SectionIndex);
 	
+	if (!CanPartiallyUpdateSection(SectionIndex, TEXT("EndMeshSectionPositionUpdate()")))
+	{
+		return;
+	}
+
 	// TODO: Validate that the position buffer is still the same length
 
 	UpdateSectionVertexPositionsInternal(SectionIndex, true);
@@ -836,6 +1880,11 @@ void URuntimeMeshComponent::EndMeshSectionPositionUpdate(int32 SectionIndex, con
 	// Validate all update parameters
 	RMC_VALIDATE_UPDATEPARAMETERS_DUALBUFFER(SectionIndex);
 
+	if (!CanPartiallyUpdateSection(SectionIndex, TEXT("EndMeshSectionPositionUpdate()")))
+	{
+		return;
+	}
+
 	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 	
 	bool bNeedsBoundingBoxUpdate = !(Section->LocalBoundingBox == BoundingBox);
@@ -849,100 +1898,330 @@ void URuntimeMeshComponent::EndMeshSectionPositionUpdate(int32 SectionIndex, con
 	UpdateSectionVertexPositionsInternal(SectionIndex, bNeedsBoundingBoxUpdate);
 }
 
+void URuntimeMeshComponent::DeformMeshSectionGPU(int32 SectionIndex, const FRuntimeMeshGPUDeformer& Deformer, const FBox& ConservativeBounds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_DeformMeshSectionGPU);
 
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS_DUALBUFFER(SectionIndex);
 
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 
+	if (!Section->bGPUDeformable)
+	{
+		Log(TEXT("DeformMeshSectionGPU() - Section wasn't created with ESectionUpdateFlags::GPUDeformable."), true);
+		return;
+	}
 
+	if (!Deformer)
+	{
+		Log(TEXT("DeformMeshSectionGPU() - Deformer is unbound. Section will not be deformed."), true);
+		return;
+	}
 
+	bool bNeedsBoundsUpdate = !(Section->LocalBoundingBox == ConservativeBounds);
+	if (bNeedsBoundsUpdate)
+	{
+		Section->LocalBoundingBox = ConservativeBounds;
+		UpdateSectionBounds(SectionIndex);
+	}
 
+	// Nothing has been drawn yet if there's no proxy, and the section's data will go up in full with the next one
+	if (SceneProxy)
+	{
+		ENQUEUE_UNIQUE_RENDER_COMMAND_FOURPARAMETER(
+			FRuntimeMeshSectionDeformGPU,
+			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+			int32, SectionIndex, SectionIndex,
+			FRuntimeMeshGPUDeformer, Deformer, Deformer,
+			FBox, RenderBounds, Section->GetRenderBounds(),
+			{
+				RuntimeMeshSceneProxy->DeformSectionGPU_RenderThread(RHICmdList, SectionIndex, Deformer, RenderBounds);
+			}
+		);
+	}
 
-void URuntimeMeshComponent::CreateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector>& Normals,
-	const TArray<FVector2D>& UV0, const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents, bool bCreateCollision,	EUpdateFrequency UpdateFrequency)
-{
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateMeshSection);
+	if (bNeedsBoundsUpdate)
+	{
+		if (BatchState.IsBatchPending())
+		{
+			BatchState.MarkBoundsDirty();
+		}
+		else
+		{
+			UpdateLocalBounds();
+		}
+	}
+}
 
-	// Validate all creation parameters
-	RMC_VALIDATE_CREATIONPARAMETERS(SectionIndex, Vertices, Triangles);
+void URuntimeMeshComponent::EndMeshSectionPositionUpdate(int32 SectionIndex, const TArray<FRuntimeMeshBufferRange>& DirtyRanges, ESectionUpdateFlags UpdateFlags)
+{
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS_DUALBUFFER(SectionIndex);
 
-	// Create the section
-	auto NewSection = CreateOrResetSectionInternalType(SectionIndex, 1, false);
+	if (!CanPartiallyUpdateSection(SectionIndex, TEXT("EndMeshSectionPositionUpdate()")))
+	{
+		return;
+	}
 
-	// Update the mesh data in the section
-	NewSection->UpdateVertexBufferInternal(Vertices, Normals, Tangents, UV0, TArray<FVector2D>(), Colors);
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 
-	TArray<int32>& TrianglesRef = const_cast<TArray<int32>&>(Triangles);
-	NewSection->UpdateIndexBuffer(TrianglesRef, false);
+	for (const FRuntimeMeshBufferRange& Range : DirtyRanges)
+	{
+		if (Range.Start < 0 || Range.Count < 0 || Range.End() > Section->PositionVertexBuffer.Num())
+		{
+			Log(TEXT("EndMeshSectionPositionUpdate() - Range must lie within the existing positions."), true);
+			return;
+		}
+	}
 
-	// Track collision status and update collision information if necessary
-	NewSection->CollisionEnabled = bCreateCollision;
-	NewSection->UpdateFrequency = UpdateFrequency;
+	bool bNeedsBoundingBoxUpdate = Section->MarkPositionRangesDirty(DirtyRanges);
 
-	// Finalize section.
-	CreateSectionInternal(SectionIndex);
+	if (Section->HasDirtyRanges())
+	{
+		UpdateSectionRangeInternal(SectionIndex, bNeedsBoundingBoxUpdate, UpdateFlags);
+	}
 }
 
-void URuntimeMeshComponent::CreateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector>& Normals,
-	const TArray<FVector2D>& UV0, const TArray<FVector2D>& UV1, const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents,
-	bool bCreateCollision, EUpdateFrequency UpdateFrequency)
+void URuntimeMeshComponent::UpdateMeshSectionPositionsRange(int32 SectionIndex, int32 FirstVertex, const TArray<FVector>& VertexPositions, ESectionUpdateFlags UpdateFlags)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateMeshSection_DualUV);
-
-	// Validate all creation parameters
-	RMC_VALIDATE_CREATIONPARAMETERS(SectionIndex, Vertices, Triangles);
-
-	// Create the section
-	auto NewSection = CreateOrResetSectionInternalType(SectionIndex, 2, false);
-
-	// Update the mesh data in the section
-	NewSection->UpdateVertexBufferInternal(Vertices, Normals, Tangents, UV0, UV1, Colors);
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionPositionsRange);
 
-	TArray<int32>& TrianglesRef = const_cast<TArray<int32>&>(Triangles);
-	NewSection->UpdateIndexBuffer(TrianglesRef, false);
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS_DUALBUFFER(SectionIndex);
 
-	// Track collision status and update collision information if necessary
-	NewSection->CollisionEnabled = bCreateCollision;
-	NewSection->UpdateFrequency = UpdateFrequency;
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 
-	// Finalize section.
-	CreateSectionInternal(SectionIndex);
-}
+	if (VertexPositions.Num() == 0)
+	{
+		Log(TEXT("UpdateMeshSectionPositionsRange() - Vertex positions empty. They will not be updated."));
+		return;
+	}
 
+	if (!CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSectionPositionsRange()")))
+	{
+		return;
+	}
 
+	if (FirstVertex < 0 || FirstVertex + VertexPositions.Num() > Section->PositionVertexBuffer.Num())
+	{
+		Log(TEXT("UpdateMeshSectionPositionsRange() - Range must lie within the existing positions. Use UpdateMeshSection to change the length."), true);
+		return;
+	}
 
-void URuntimeMeshComponent::UpdateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<FVector2D>& UV0,
-	const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents)
-{
-	UpdateMeshSection(SectionIndex, Vertices, TArray<int32>(), Normals, UV0, Colors, Tangents);
-}
+	bool bNeedsBoundsUpdate = Section->UpdateVertexPositionBufferRange(FirstVertex, VertexPositions);
 
-void URuntimeMeshComponent::UpdateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<FVector2D>& UV0,
-	const TArray<FVector2D>& UV1, const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents)
-{
-	UpdateMeshSection(SectionIndex, Vertices, TArray<int32>(), Normals, UV0, UV1, Colors, Tangents);
+	UpdateSectionRangeInternal(SectionIndex, bNeedsBoundsUpdate, UpdateFlags);
 }
 
-void URuntimeMeshComponent::UpdateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector>& Normals,
-	const TArray<FVector2D>& UV0, const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents)
+void URuntimeMeshComponent::EndMeshSectionUpdate(int32 SectionIndex, const TArray<FRuntimeMeshBufferRange>& DirtyRanges, ESectionUpdateFlags UpdateFlags)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSection);
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_EndMeshSectionUpdate);
 
 	// Validate all update parameters
-	RMC_VALIDATE_UPDATEPARAMETERS_INTERNALSECTION(SectionIndex);
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
 
-	// Validate section type
-	MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<FRuntimeMeshVertex<1>>();
+	if (!CanPartiallyUpdateSection(SectionIndex, TEXT("EndMeshSectionUpdate()")))
+	{
+		return;
+	}
 
-	// Get section
 	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
-	
-	// Tell the section to update the vertex buffer
-	bool bHadVertexUpdates = Section->UpdateVertexBufferInternal(Vertices, Normals, Tangents, UV0, TArray<FVector2D>(), Colors);
 
-	bool bHadTriangleUpdates = Triangles.Num() > 0;
-	if (bHadTriangleUpdates)
+	for (const FRuntimeMeshBufferRange& Range : DirtyRanges)
 	{
-		TArray<int32>& TrianglesRef = const_cast<TArray<int32>&>(Triangles);
-
+		if (Range.Start < 0 || Range.Count < 0 || Range.End() > Section->GetNumVertices())
+		{
+			Log(TEXT("EndMeshSectionUpdate() - Range must lie within the existing vertices."), true);
+			return;
+		}
+	}
+
+	bool bNeedsBoundsUpdate = Section->MarkVertexRangesDirty(DirtyRanges);
+
+	if (Section->HasDirtyRanges())
+	{
+		UpdateSectionRangeInternal(SectionIndex, bNeedsBoundsUpdate, UpdateFlags);
+	}
+}
+
+
+void URuntimeMeshComponent::UpdateMeshSectionTriangles(int32 SectionIndex, TArray<int32>& Triangles, ESectionUpdateFlags UpdateFlags)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionTriangles);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+	if (Triangles.Num() == 0)
+	{
+		Log(TEXT("UpdateMeshSectionTriangles() - Triangles empty. They will not be updated."));
+		return;
+	}
+
+	// Get section
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	bool bShouldUseMove = (UpdateFlags & ESectionUpdateFlags::MoveArrays) != ESectionUpdateFlags::None;
+	Section->UpdateIndexBuffer(Triangles, bShouldUseMove);
+
+	UpdateSectionInternal(SectionIndex, false, false, true, false, UpdateFlags);
+}
+
+void URuntimeMeshComponent::UpdateMeshSectionTriangles(int32 SectionIndex, const TArray<uint16>& Triangles)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionTriangles_16Bit);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+	if (Triangles.Num() == 0)
+	{
+		Log(TEXT("UpdateMeshSectionTriangles() - Triangles empty. They will not be updated."));
+		return;
+	}
+
+	// Get section
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	// Make sure the section can actually be addressed by 16 bit indices
+	if (!FRuntimeMeshIndexBuffer::CanUse16BitIndices(Section->GetNumVertices()))
+	{
+		Log(TEXT("UpdateMeshSectionTriangles() - Section has too many vertices for 16 bit indices."), true);
+		return;
+	}
+
+	Section->UpdateIndexBuffer(Triangles);
+
+	UpdateSectionInternal(SectionIndex, false, false, true, false);
+}
+
+void URuntimeMeshComponent::UpdateMeshSectionTrianglesRange(int32 SectionIndex, int32 FirstIndex, const TArray<int32>& Triangles, ESectionUpdateFlags UpdateFlags)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionTrianglesRange);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+	if (Triangles.Num() == 0)
+	{
+		Log(TEXT("UpdateMeshSectionTrianglesRange() - Triangles empty. They will not be updated."));
+		return;
+	}
+
+	// Get section
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	if (!CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSectionTrianglesRange()")))
+	{
+		return;
+	}
+
+	if (FirstIndex < 0 || FirstIndex + Triangles.Num() > Section->IndexBuffer.Num())
+	{
+		Log(TEXT("UpdateMeshSectionTrianglesRange() - Range must lie within the existing triangles. Use UpdateMeshSectionTriangles to change the length."), true);
+		return;
+	}
+
+	Section->UpdateIndexBufferRange(FirstIndex, Triangles);
+
+	UpdateSectionRangeInternal(SectionIndex, false, UpdateFlags);
+}
+
+
+
+
+
+
+
+
+void URuntimeMeshComponent::CreateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector>& Normals,
+	const TArray<FVector2D>& UV0, const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents, bool bCreateCollision,	EUpdateFrequency UpdateFrequency)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateMeshSection);
+
+	// Validate all creation parameters
+	RMC_VALIDATE_CREATIONPARAMETERS(SectionIndex, Vertices, Triangles);
+
+	// Create the section
+	auto NewSection = CreateOrResetSectionInternalType(SectionIndex, 1, false);
+
+	// Update the mesh data in the section
+	NewSection->UpdateVertexBufferInternal(Vertices, Normals, Tangents, UV0, TArray<FVector2D>(), Colors);
+
+	TArray<int32>& TrianglesRef = const_cast<TArray<int32>&>(Triangles);
+	NewSection->UpdateIndexBuffer(TrianglesRef, false);
+
+	// Track collision status and update collision information if necessary
+	NewSection->CollisionEnabled = bCreateCollision;
+	NewSection->UpdateFrequency = UpdateFrequency;
+
+	// Finalize section.
+	CreateSectionInternal(SectionIndex);
+}
+
+void URuntimeMeshComponent::CreateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector>& Normals,
+	const TArray<FVector2D>& UV0, const TArray<FVector2D>& UV1, const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents,
+	bool bCreateCollision, EUpdateFrequency UpdateFrequency)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateMeshSection_DualUV);
+
+	// Validate all creation parameters
+	RMC_VALIDATE_CREATIONPARAMETERS(SectionIndex, Vertices, Triangles);
+
+	// Create the section
+	auto NewSection = CreateOrResetSectionInternalType(SectionIndex, 2, false);
+
+	// Update the mesh data in the section
+	NewSection->UpdateVertexBufferInternal(Vertices, Normals, Tangents, UV0, UV1, Colors);
+
+	TArray<int32>& TrianglesRef = const_cast<TArray<int32>&>(Triangles);
+	NewSection->UpdateIndexBuffer(TrianglesRef, false);
+
+	// Track collision status and update collision information if necessary
+	NewSection->CollisionEnabled = bCreateCollision;
+	NewSection->UpdateFrequency = UpdateFrequency;
+
+	// Finalize section.
+	CreateSectionInternal(SectionIndex);
+}
+
+
+
+void URuntimeMeshComponent::UpdateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<FVector2D>& UV0,
+	const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents)
+{
+	UpdateMeshSection(SectionIndex, Vertices, TArray<int32>(), Normals, UV0, Colors, Tangents);
+}
+
+void URuntimeMeshComponent::UpdateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<FVector2D>& UV0,
+	const TArray<FVector2D>& UV1, const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents)
+{
+	UpdateMeshSection(SectionIndex, Vertices, TArray<int32>(), Normals, UV0, UV1, Colors, Tangents);
+}
+
+void URuntimeMeshComponent::UpdateMeshSection(int32 SectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector>& Normals,
+	const TArray<FVector2D>& UV0, const TArray<FColor>& Colors, const TArray<FRuntimeMeshTangent>& Tangents)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSection);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS_INTERNALSECTION(SectionIndex);
+
+	// Validate section type
+	MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<FRuntimeMeshVertex<1>>();
+
+	// Get section
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+	
+	// Tell the section to update the vertex buffer
+	bool bHadVertexUpdates = Section->UpdateVertexBufferInternal(Vertices, Normals, Tangents, UV0, TArray<FVector2D>(), Colors);
+
+	bool bHadTriangleUpdates = Triangles.Num() > 0;
+	if (bHadTriangleUpdates)
+	{
+		TArray<int32>& TrianglesRef = const_cast<TArray<int32>&>(Triangles);
+
 		Section->UpdateIndexBuffer(TrianglesRef, false);
 	}
 
@@ -1007,24 +2286,37 @@ void URuntimeMeshComponent::ClearMeshSection(int32 SectionIndex)
 {
 	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_ClearMeshSection);
 
+	// A pending async result would bring the section back
+	SupersedeAsyncSections(SectionIndex);
+	DeferredUploadFrames.Remove(SectionIndex);
+
  	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
  	{
 		// Did this section have collision
 		bool HadCollision = MeshSections[SectionIndex]->CollisionEnabled;
-		bool bWasStaticSection = MeshSections[SectionIndex]->UpdateFrequency == EUpdateFrequency::Infrequent;
+
+		// Sections are repacked when one is destroyed while packing
+		bool bRequiresRecreate = RequiresProxyRecreateForChange(*MeshSections[SectionIndex]) || bMergeSectionsForRendering;
 
 		// Clear the section
 		MeshSections[SectionIndex].Reset();
+		RemoveValidSectionIndex(SectionIndex);
+		UpdateSectionBounds(SectionIndex);
+		INC_DWORD_STAT(STAT_RuntimeMesh_SectionsDestroyed);
 		
+		// Collect the change for the end of the frame if auto batching
+		StartAutoBatchIfEnabled();
+
 		// Use the batch update if one is running
 		if (BatchState.IsBatchPending())
 		{
 			// Mark section created
-			BatchState.MarkSectionDestroyed(SectionIndex, bWasStaticSection);
+			BatchState.MarkSectionDestroyed(SectionIndex, bRequiresRecreate);
 
 			// Flag collision if this section affects it
 			if (HadCollision)
 			{
+				MarkSectionCollisionDirty(SectionIndex);
 				BatchState.MarkCollisionDirty();
 			}
 
@@ -1036,7 +2328,7 @@ void URuntimeMeshComponent::ClearMeshSection(int32 SectionIndex)
 		}
 
 
-		if (SceneProxy && !bWasStaticSection)
+		if (SceneProxy && !bRequiresRecreate)
 		{			
 			// Enqueue update on RT
 			ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
@@ -1056,6 +2348,7 @@ void URuntimeMeshComponent::ClearMeshSection(int32 SectionIndex)
 		// Update our collision info only if this section had any influence on it
 		if (HadCollision)
 		{
+			MarkSectionCollisionDirty(SectionIndex);
 			MarkCollisionDirty();
 		}
 		
@@ -1066,7 +2359,17 @@ void URuntimeMeshComponent::ClearMeshSection(int32 SectionIndex)
 
 void URuntimeMeshComponent::ClearAllMeshSections()
 {
+	INC_DWORD_STAT_BY(STAT_RuntimeMesh_SectionsDestroyed, GetNumSections());
  	MeshSections.Empty();
+	ValidSectionIndices.Empty();
+	SectionBounds.Reset();
+
+	// A pending async result would bring its section back
+	CancelAllAsyncSections();
+	DeferredUploadFrames.Empty();
+
+	// Collect the change for the end of the frame if auto batching
+	StartAutoBatchIfEnabled();
 
 	// Use the batch update if one is running
 	if (BatchState.IsBatchPending())
@@ -1075,6 +2378,7 @@ void URuntimeMeshComponent::ClearAllMeshSections()
 		BatchState.MarkRenderStateDirty();
 
 		// Flag collision
+		MarkAllSectionCollisionDirty();
 		BatchState.MarkCollisionDirty();
 
 		// Flag bounds update
@@ -1085,6 +2389,7 @@ void URuntimeMeshComponent::ClearAllMeshSections()
 	}
 	
  	MarkRenderStateDirty();
+	MarkAllSectionCollisionDirty();
 	MarkCollisionDirty();
 	UpdateLocalBounds();
 }
@@ -1106,8 +2411,11 @@ void URuntimeMeshComponent::SetMeshSectionVisible(int32 SectionIndex, bool bNewV
  		// Set game thread state
  		MeshSections[SectionIndex]->bIsVisible = bNewVisibility;
 
+		// Only visible sections count towards the bounds, which pick this up on the next bounds update
+		UpdateSectionBounds(SectionIndex);
+
 		// Finish the update
-		UpdateSectionPropertiesInternal(SectionIndex, false);
+		UpdateSectionPropertiesInternal(SectionIndex);
  	}
 }
 
@@ -1124,7 +2432,7 @@ void URuntimeMeshComponent::SetMeshSectionCastsShadow(int32 SectionIndex, bool b
 		MeshSections[SectionIndex]->bCastsShadow = bNewCastsShadow;
 
 		// Finish the update
-		UpdateSectionPropertiesInternal(SectionIndex, true);
+		UpdateSectionPropertiesInternal(SectionIndex);
 	}
 }
 
@@ -1138,6 +2446,19 @@ void URuntimeMeshComponent::SetMeshSectionCollisionEnabled(int32 SectionIndex, b
 	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
 	{
 		auto& Section = MeshSections[SectionIndex];
+
+		if (bNewCollisionEnabled && Section->bIsRenderOnly)
+		{
+			Log(TEXT("SetMeshSectionCollisionEnabled() - Render only sections don't keep the data needed for collision."), true);
+			return;
+		}
+
+		if (bNewCollisionEnabled && Section->bIsInstanced)
+		{
+			Log(TEXT("SetMeshSectionCollisionEnabled() - Instanced sections don't build collision."), true);
+			return;
+		}
+
 		if (Section->CollisionEnabled != bNewCollisionEnabled)
 		{
 			Section->CollisionEnabled = bNewCollisionEnabled;
@@ -1146,10 +2467,12 @@ void URuntimeMeshComponent::SetMeshSectionCollisionEnabled(int32 SectionIndex, b
 			if (BatchState.IsBatchPending())
 			{
 				// Mark render state dirty
+				MarkSectionCollisionDirty(SectionIndex);
 				BatchState.MarkCollisionDirty();
 			}
 			else
 			{
+				MarkSectionCollisionDirty(SectionIndex);
 				MarkCollisionDirty();
 			}
 		}
@@ -1161,70 +2484,419 @@ bool URuntimeMeshComponent::IsMeshSectionCollisionEnabled(int32 SectionIndex)
 	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->CollisionEnabled;
 }
 
+void URuntimeMeshComponent::SetMeshSectionLOD(int32 SectionIndex, int32 LODIndex, const TArray<int32>& Triangles, float ScreenSize)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_SetMeshSectionLOD);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
 
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 
-int32 URuntimeMeshComponent::GetNumSections() const
+	if (LODIndex < 1 || LODIndex > Section->LODs.Num() + 1)
+	{
+		Log(TEXT("SetMeshSectionLOD() - LODIndex must be between 1 and one past the current last LOD."), true);
+		return;
+	}
+
+	if (Triangles.Num() == 0)
+	{
+		Log(TEXT("SetMeshSectionLOD() - Triangles empty. LOD will not be set."), true);
+		return;
+	}
+
+	if (Section->bIsRenderOnly)
+	{
+		Log(TEXT("SetMeshSectionLOD() - Render only sections can't be updated once their data has been released."), true);
+		return;
+	}
+
+	if (LODIndex > Section->LODs.Num())
+	{
+		Section->LODs.AddDefaulted();
+	}
+
+	FRuntimeMeshSectionLOD& LOD = Section->LODs[LODIndex - 1];
+	LOD.IndexBuffer.Set(Triangles);
+	LOD.ScreenSize = ScreenSize;
+
+	// LODs are sent with the index buffer
+	UpdateSectionInternal(SectionIndex, false, false, true, false);
+}
+
+void URuntimeMeshComponent::ClearMeshSectionLODs(int32 SectionIndex)
 {
-	int32 SectionCount = 0;
-	for (int32 Index = 0; Index < MeshSections.Num(); Index++)
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->LODs.Num() > 0)
 	{
-		if (MeshSections[Index].IsValid())
+		if (MeshSections[SectionIndex]->bIsRenderOnly)
 		{
-			SectionCount++;
+			Log(TEXT("ClearMeshSectionLODs() - Render only sections can't be updated once their data has been released."), true);
+			return;
 		}
-	}
 
-	return SectionCount;
+		MeshSections[SectionIndex]->LODs.Empty();
+
+		// LODs are sent with the index buffer
+		UpdateSectionInternal(SectionIndex, false, false, true, false);
+	}
 }
 
-bool URuntimeMeshComponent::DoesSectionExist(int32 SectionIndex) const
+int32 URuntimeMeshComponent::GetNumMeshSectionLODs(int32 SectionIndex) const
 {
-	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid();
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid())
+	{
+		return MeshSections[SectionIndex]->LODs.Num() + 1;
+	}
+	return 0;
 }
 
-int32 URuntimeMeshComponent::FirstAvailableMeshSectionIndex(int32 SectionIndex) const
+
+/* Async simplification of a section into its LODs */
+class FRuntimeMeshAsyncLODJob : public FRuntimeMeshAsyncSectionJob
 {
-	for (int32 Index = 0; Index < MeshSections.Num(); Index++)
+public:
+	FRuntimeMeshAsyncLODJob(int32 InSectionIndex)
+		: FRuntimeMeshAsyncSectionJob(InSectionIndex, false), CollisionLODIndex(INDEX_NONE), CollisionSectionIndex(0) { }
+
+	virtual void Generate() override
 	{
-		if (!MeshSections[Index].IsValid())
+		if (State->GetStatus() != ERuntimeMeshAsyncSectionStatus::Pending)
+		{
+			return;
+		}
+
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_SimplifyMesh);
+
+		const uint8* FirstPosition = reinterpret_cast<const uint8*>(Positions.GetData());
+		const int32 NumIndices = Indices->Num();
+
+		GeneratedLODs.SetNum(Settings.Num());
+		for (int32 LODIndex = 0; LODIndex < Settings.Num(); LODIndex++)
+		{
+			const TArray<int32>& Source = LODIndex == 0 ? *Indices : GeneratedLODs[LODIndex - 1];
+			const int32 TargetIndexCount = FMath::Max(FMath::RoundToInt(NumIndices * Settings[LODIndex].TriangleRatio / 3.0f) * 3, 3);
+
+			FRuntimeMeshSimplifier::Simplify(FirstPosition, sizeof(FVector), Positions.Num(), Source, TargetIndexCount, Settings[LODIndex].MaxError, GeneratedLODs[LODIndex]);
+		}
+
+		if (GeneratedLODs.IsValidIndex(CollisionLODIndex - 1))
 		{
-			return Index;
+			FRuntimeMeshSimplifier::CompactMesh(FirstPosition, sizeof(FVector), Positions.Num(), GeneratedLODs[CollisionLODIndex - 1], CollisionPositions, CollisionIndices);
 		}
 	}
-	return MeshSections.Num();
-}
 
+	virtual void Commit(URuntimeMeshComponent* Component) override
+	{
+		Component->CommitAsyncSectionLODs(*this);
+	}
+
+	virtual bool ChangesSectionMesh() const override { return false; }
 
-void URuntimeMeshComponent::SetMeshCollisionSection(int32 CollisionSectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles)
+	/* Snapshot of the section taken when the job was queued */
+	TArray<FVector> Positions;
+	FRuntimeMeshSharedBuffer<int32>::SharedArrayRef Indices;
+
+	TArray<FRuntimeMeshSimplifySettings> Settings;
+	int32 CollisionLODIndex;
+	int32 CollisionSectionIndex;
+
+	TArray<TArray<int32>> GeneratedLODs;
+	TArray<FVector> CollisionPositions;
+	TArray<int32> CollisionIndices;
+};
+
+FRuntimeMeshAsyncSectionHandle URuntimeMeshComponent::GenerateMeshSectionLODsAsync(int32 SectionIndex, const TArray<FRuntimeMeshSimplifySettings>& LODs,
+	int32 CollisionLODIndex, int32 CollisionSectionIndex)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_SetMeshCollisionSection);
+	check(IsInGameThread());
 
-	if (MeshCollisionSections.Num() <= CollisionSectionIndex)
+	if (SectionIndex >= MeshSections.Num() || !MeshSections[SectionIndex].IsValid())
 	{
-		MeshCollisionSections.SetNum(CollisionSectionIndex + 1, false);
+		Log(TEXT("GenerateMeshSectionLODsAsync() - Mesh section index is invalid."), true);
+		return FRuntimeMeshAsyncSectionHandle();
 	}
 
-	auto& Section = MeshCollisionSections[CollisionSectionIndex];
-	Section.VertexBuffer = Vertices;
-	Section.IndexBuffer = Triangles;
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
 
-	// Use the batch update if one is running
-	if (BatchState.IsBatchPending())
+	if (Section->bIsRenderOnly)
 	{
-		// Mark render state dirty
-		BatchState.MarkCollisionDirty();
+		Log(TEXT("GenerateMeshSectionLODsAsync() - Render only sections can't be updated once their data has been released."), true);
+		return FRuntimeMeshAsyncSectionHandle();
 	}
-	else
+
+	if (LODs.Num() == 0)
 	{
-		MarkCollisionDirty();
+		Log(TEXT("GenerateMeshSectionLODsAsync() - No LODs to generate."), true);
+		return FRuntimeMeshAsyncSectionHandle();
+	}
+
+	if (CollisionLODIndex != INDEX_NONE && (CollisionLODIndex < 1 || CollisionLODIndex > LODs.Num()))
+	{
+		Log(TEXT("GenerateMeshSectionLODsAsync() - CollisionLODIndex must be INDEX_NONE or one of the generated LODs."), true);
+		return FRuntimeMeshAsyncSectionHandle();
 	}
+
+	auto* Job = new FRuntimeMeshAsyncLODJob(SectionIndex);
+	Section->GetAllVertexPositions(Job->Positions);
+	Job->Indices = Section->IndexBuffer.Share();
+	Job->Settings = LODs;
+	Job->CollisionLODIndex = CollisionLODIndex;
+	Job->CollisionSectionIndex = CollisionSectionIndex;
+	return QueueAsyncSectionJob(MakeShareable(Job));
 }
 
-void URuntimeMeshComponent::ClearMeshCollisionSection(int32 CollisionSectionIndex)
+void URuntimeMeshComponent::CommitAsyncSectionLODs(FRuntimeMeshAsyncLODJob& Job)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_ClearMeshCollisionSection);
-
-	if (MeshCollisionSections.Num() <= CollisionSectionIndex)
+	// Sharing the index buffer means any change to the triangles since shows up as a different buffer
+	const bool bSectionMatches = Job.SectionIndex < MeshSections.Num() && MeshSections[Job.SectionIndex].IsValid() &&
+		!MeshSections[Job.SectionIndex]->bIsRenderOnly && MeshSections[Job.SectionIndex]->IndexBuffer.Share() == Job.Indices &&
+		MeshSections[Job.SectionIndex]->GetNumVertices() == Job.Positions.Num();
+	if (!bSectionMatches)
+	{
+		if (Job.State->Finish(ERuntimeMeshAsyncSectionStatus::Failed))
+		{
+			Log(FString::Printf(TEXT("GenerateMeshSectionLODsAsync() - Section %d changed while it was simplified. LODs will not be set."), Job.SectionIndex), true);
+		}
+		return;
+	}
+
+	if (!Job.State->Finish(ERuntimeMeshAsyncSectionStatus::Committed))
+	{
+		return;
+	}
+
+	RuntimeMeshSectionPtr& Section = MeshSections[Job.SectionIndex];
+
+	Section->LODs.SetNum(Job.GeneratedLODs.Num());
+	for (int32 LODIndex = 0; LODIndex < Job.GeneratedLODs.Num(); LODIndex++)
+	{
+		Section->LODs[LODIndex].IndexBuffer.Set(MoveTemp(Job.GeneratedLODs[LODIndex]));
+		Section->LODs[LODIndex].ScreenSize = Job.Settings[LODIndex].ScreenSize;
+	}
+
+	// LODs are sent with the index buffer
+	UpdateSectionInternal(Job.SectionIndex, false, false, true, false);
+
+	if (Job.CollisionLODIndex != INDEX_NONE)
+	{
+		SetMeshCollisionSection(Job.CollisionSectionIndex, Job.CollisionPositions, Job.CollisionIndices);
+
+		// The simplified collision stands in for the section's own
+		if (Section->CollisionEnabled)
+		{
+			SetMeshSectionCollisionEnabled(Job.SectionIndex, false);
+		}
+	}
+}
+
+bool URuntimeMeshComponent::ValidateInstanceUpdate(const TCHAR* FunctionName, int32 SectionIndex, const TArray<FTransform>& Transforms, const TArray<float>& CustomData)
+{
+	const RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	if (CustomData.Num() > 0 && CustomData.Num() != Transforms.Num())
+	{
+		Log(FString::Printf(TEXT("%s() - CustomData must be empty or the same length as Transforms."), FunctionName), true);
+		return false;
+	}
+
+	// The instance transform is applied before the primitive transform, so it can't be combined with the dequantize transform
+	if (Section->bQuantizePositions)
+	{
+		Log(FString::Printf(TEXT("%s() - Sections with quantized positions can't be instanced."), FunctionName), true);
+		return false;
+	}
+
+	return true;
+}
+
+int32 URuntimeMeshComponent::AddMeshSectionInstances(int32 SectionIndex, const TArray<FTransform>& Transforms, const TArray<float>& CustomData)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionInstances);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+	if (Transforms.Num() == 0 || !ValidateInstanceUpdate(TEXT("AddMeshSectionInstances"), SectionIndex, Transforms, CustomData))
+	{
+		return INDEX_NONE;
+	}
+
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	// Becoming instanced replaces the section proxy, which needs the section data
+	const bool bInstancingChanged = !Section->bIsInstanced;
+	if (bInstancingChanged && Section->bHasReleasedCPUData)
+	{
+		Log(TEXT("AddMeshSectionInstances() - Render only sections can't become instanced once their data has been released."), true);
+		return INDEX_NONE;
+	}
+
+	if (bInstancingChanged && Section->CollisionEnabled)
+	{
+		Log(TEXT("AddMeshSectionInstances() - Instanced sections don't build collision. Collision has been disabled for the section."));
+		SetMeshSectionCollisionEnabled(SectionIndex, false);
+	}
+
+	Section->bIsInstanced = true;
+	const int32 FirstInstance = Section->AddInstances(Transforms, CustomData);
+
+	UpdateSectionInstancesInternal(SectionIndex, bInstancingChanged);
+
+	return FirstInstance;
+}
+
+void URuntimeMeshComponent::UpdateMeshSectionInstances(int32 SectionIndex, int32 FirstInstance, const TArray<FTransform>& Transforms, const TArray<float>& CustomData)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionInstances);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+	if (Transforms.Num() == 0 || !ValidateInstanceUpdate(TEXT("UpdateMeshSectionInstances"), SectionIndex, Transforms, CustomData))
+	{
+		return;
+	}
+
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	if (FirstInstance < 0 || FirstInstance + Transforms.Num() > Section->Instances.Num())
+	{
+		Log(TEXT("UpdateMeshSectionInstances() - Instances out of range of the section's instances."), true);
+		return;
+	}
+
+	Section->UpdateInstances(FirstInstance, Transforms, CustomData);
+
+	UpdateSectionInstancesInternal(SectionIndex, false);
+}
+
+void URuntimeMeshComponent::RemoveMeshSectionInstances(int32 SectionIndex, int32 FirstInstance, int32 NumInstances)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionInstances);
+
+	// Validate all update parameters
+	RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+	RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+	if (FirstInstance < 0 || NumInstances < 0 || FirstInstance + NumInstances > Section->Instances.Num())
+	{
+		Log(TEXT("RemoveMeshSectionInstances() - Instances out of range of the section's instances."), true);
+		return;
+	}
+
+	if (NumInstances == 0)
+	{
+		return;
+	}
+
+	// The section stays instanced and just stops drawing if every instance is removed
+	Section->RemoveInstances(FirstInstance, NumInstances);
+
+	UpdateSectionInstancesInternal(SectionIndex, false);
+}
+
+void URuntimeMeshComponent::ClearMeshSectionInstances(int32 SectionIndex)
+{
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->bIsInstanced)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionInstances);
+
+		RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+		// Going back to a regular section replaces the section proxy, which needs the section data
+		if (Section->bHasReleasedCPUData)
+		{
+			Log(TEXT("ClearMeshSectionInstances() - Render only sections can't stop being instanced once their data has been released."), true);
+			return;
+		}
+
+		Section->Instances.Release();
+		Section->bIsInstanced = false;
+		Section->ClearInstanceChanges();
+
+		UpdateSectionInstancesInternal(SectionIndex, true);
+	}
+}
+
+int32 URuntimeMeshComponent::GetNumMeshSectionInstances(int32 SectionIndex) const
+{
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->bIsInstanced)
+	{
+		return MeshSections[SectionIndex]->Instances.Num();
+	}
+	return 0;
+}
+
+void URuntimeMeshComponent::SetMergeSectionsForRendering(bool bNewMergeSections)
+{
+	if (bMergeSectionsForRendering != bNewMergeSections)
+	{
+		bMergeSectionsForRendering = bNewMergeSections;
+
+		// Packing happens when the proxy is created
+		MarkRenderStateDirty();
+	}
+}
+
+
+
+int32 URuntimeMeshComponent::GetNumSections() const
+{
+	return ValidSectionIndices.Num();
+}
+
+bool URuntimeMeshComponent::DoesSectionExist(int32 SectionIndex) const
+{
+	return SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid();
+}
+
+int32 URuntimeMeshComponent::FirstAvailableMeshSectionIndex(int32 SectionIndex) const
+{
+	// The valid indices are sorted, so the first free index is the first one that doesn't match its position
+	for (int32 Position = 0; Position < ValidSectionIndices.Num(); Position++)
+	{
+		if (ValidSectionIndices[Position] != Position)
+		{
+			return Position;
+		}
+	}
+	return ValidSectionIndices.Num();
+}
+
+
+void URuntimeMeshComponent::SetMeshCollisionSection(int32 CollisionSectionIndex, const TArray<FVector>& Vertices, const TArray<int32>& Triangles)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_SetMeshCollisionSection);
+
+	if (MeshCollisionSections.Num() <= CollisionSectionIndex)
+	{
+		MeshCollisionSections.SetNum(CollisionSectionIndex + 1, false);
+	}
+
+	auto& Section = MeshCollisionSections[CollisionSectionIndex];
+	Section.VertexBuffer = Vertices;
+	Section.IndexBuffer = Triangles;
+
+	// Use the batch update if one is running
+	if (BatchState.IsBatchPending())
+	{
+		// Mark render state dirty
+		MarkCollisionSectionDirty(CollisionSectionIndex);
+		BatchState.MarkCollisionDirty();
+	}
+	else
+	{
+		MarkCollisionSectionDirty(CollisionSectionIndex);
+		MarkCollisionDirty();
+	}
+}
+
+void URuntimeMeshComponent::ClearMeshCollisionSection(int32 CollisionSectionIndex)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_ClearMeshCollisionSection);
+
+	if (MeshCollisionSections.Num() <= CollisionSectionIndex)
 		return;
 
 	MeshCollisionSections[CollisionSectionIndex].Reset();
@@ -1233,10 +2905,12 @@ void URuntimeMeshComponent::ClearMeshCollisionSection(int32 CollisionSectionInde
 	if (BatchState.IsBatchPending())
 	{
 		// Mark render state dirty
+		MarkCollisionSectionDirty(CollisionSectionIndex);
 		BatchState.MarkCollisionDirty();
 	}
 	else
 	{
+		MarkCollisionSectionDirty(CollisionSectionIndex);
 		MarkCollisionDirty();
 	}
 }
@@ -1251,10 +2925,12 @@ void URuntimeMeshComponent::ClearAllMeshCollisionSections()
 	if (BatchState.IsBatchPending())
 	{
 		// Mark render state dirty
+		MarkAllCollisionSectionsDirty();
 		BatchState.MarkCollisionDirty();
 	}
 	else
 	{
+		MarkAllCollisionSectionsDirty();
 		MarkCollisionDirty();
 	}
 }
@@ -1276,10 +2952,12 @@ void URuntimeMeshComponent::AddCollisionConvexMesh(TArray<FVector> ConvexVerts)
 		if (BatchState.IsBatchPending())
 		{
 			// Mark render state dirty
+			bSimpleCollisionDirty = true;
 			BatchState.MarkCollisionDirty();
 		}
 		else
 		{
+			bSimpleCollisionDirty = true;
 			MarkCollisionDirty();
 		}
 	}
@@ -1297,10 +2975,12 @@ void URuntimeMeshComponent::ClearCollisionConvexMeshes()
 	if (BatchState.IsBatchPending())
 	{
 		// Mark render state dirty
+		bSimpleCollisionDirty = true;
 		BatchState.MarkCollisionDirty();
 	}
 	else
 	{
+		bSimpleCollisionDirty = true;
 		MarkCollisionDirty();
 	}
 }
@@ -1325,10 +3005,12 @@ void URuntimeMeshComponent::SetCollisionConvexMeshes(const TArray< TArray<FVecto
 	if (BatchState.IsBatchPending())
 	{
 		// Mark render state dirty
+		bSimpleCollisionDirty = true;
 		BatchState.MarkCollisionDirty();
 	}
 	else
 	{
+		bSimpleCollisionDirty = true;
 		MarkCollisionDirty();
 	}
 }
@@ -1338,18 +3020,15 @@ void URuntimeMeshComponent::UpdateLocalBounds(bool bMarkRenderTransform)
 {
 	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateLocalBounds);
 	
-	FBox LocalBox(0);
+	const FBox& LocalBox = SectionBounds.GetBounds();
+
+	LocalBounds = LocalBox.IsValid ? FBoxSphereBounds(LocalBox) : FBoxSphereBounds(FVector(0, 0, 0), FVector(0, 0, 0), 0); // fallback to reset box sphere bounds
 
-	for (const RuntimeMeshSectionPtr& Section : MeshSections)
+	if (OwnedSharedMeshData.IsValid())
 	{
-		if (Section.IsValid() && Section->bIsVisible)
-		{
-			LocalBox += Section->LocalBoundingBox;
-		}
+		OwnedSharedMeshData->PublishBounds(LocalBox);
 	}
 
-	LocalBounds = LocalBox.IsValid ? FBoxSphereBounds(LocalBox) : FBoxSphereBounds(FVector(0, 0, 0), FVector(0, 0, 0), 0); // fallback to reset box sphere bounds
-
 	// Update global bounds
 	UpdateBounds();
 
@@ -1360,255 +3039,1562 @@ void URuntimeMeshComponent::UpdateLocalBounds(bool bMarkRenderTransform)
 	}
 }
 
-FPrimitiveSceneProxy* URuntimeMeshComponent::CreateSceneProxy()
+void URuntimeMeshComponent::UpdateSectionBounds(int32 SectionIndex)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateSceneProxy);
-
-	return new FRuntimeMeshSceneProxy(this);
+	if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->bIsVisible)
+	{
+		SectionBounds.SetBox(SectionIndex, MeshSections[SectionIndex]->GetRenderBounds());
+	}
+	else
+	{
+		SectionBounds.RemoveBox(SectionIndex);
+	}
 }
 
-int32 URuntimeMeshComponent::GetNumMaterials() const
+void URuntimeMeshComponent::RebuildSectionIndices()
 {
-	return MeshSections.Num();
+	ValidSectionIndices.Reset();
+	SectionBounds.Reset();
+
+	for (int32 SectionIndex = 0; SectionIndex < MeshSections.Num(); SectionIndex++)
+	{
+		if (MeshSections[SectionIndex].IsValid())
+		{
+			ValidSectionIndices.Add(SectionIndex);
+			UpdateSectionBounds(SectionIndex);
+		}
+	}
 }
 
-FBoxSphereBounds URuntimeMeshComponent::CalcBounds(const FTransform& LocalToWorld) const
+/* Position of the first entry in a sorted array that isn't less than Value */
+static int32 LowerBoundSectionIndex(const TArray<int32>& SortedIndices, int32 Value)
 {
-	return LocalBounds.TransformBy(LocalToWorld);
+	int32 First = 0;
+	int32 Count = SortedIndices.Num();
+	while (Count > 0)
+	{
+		const int32 Step = Count / 2;
+		if (SortedIndices[First + Step] < Value)
+		{
+			First += Step + 1;
+			Count -= Step + 1;
+		}
+		else
+		{
+			Count = Step;
+		}
+	}
+	return First;
 }
 
-
-
-
-
-void URuntimeMeshComponent::EndBatchUpdates()
+void URuntimeMeshComponent::AddValidSectionIndex(int32 SectionIndex)
 {
-	// Bail if we have no pending updates
-	if (!BatchState.IsBatchPending())
+	// Sections are usually created in ascending order, which only appends
+	if (ValidSectionIndices.Num() == 0 || ValidSectionIndices.Last() < SectionIndex)
+	{
+		ValidSectionIndices.Add(SectionIndex);
 		return;
+	}
 
-	// Handle all pending rendering updates..
-	if (BatchState.RequiresSceneProxyRecreate())
+	const int32 Position = LowerBoundSectionIndex(ValidSectionIndices, SectionIndex);
+	if (Position == ValidSectionIndices.Num() || ValidSectionIndices[Position] != SectionIndex)
 	{
-		MarkRenderStateDirty();
+		ValidSectionIndices.Insert(SectionIndex, Position);
 	}
-	else
+}
+
+void URuntimeMeshComponent::RemoveValidSectionIndex(int32 SectionIndex)
+{
+	const int32 Position = LowerBoundSectionIndex(ValidSectionIndices, SectionIndex);
+	if (Position < ValidSectionIndices.Num() && ValidSectionIndices[Position] == SectionIndex)
 	{
-		auto* BatchUpdateData = new FRuntimeMeshBatchUpdateData;
+		ValidSectionIndices.RemoveAt(Position, 1, false);
+	}
+}
 
-		for (int32 Index = 0; Index <= BatchState.GetMaxSection(); Index++)
+bool URuntimeMeshComponent::HasRenderOnlySections() const
+{
+	for (int32 SectionIndex : ValidSectionIndices)
+	{
+		if (MeshSections[SectionIndex]->bIsRenderOnly)
 		{
-			// Skip this section if it has no updates.
-			if (!BatchState.HasAnyFlagSet(Index))
-			{
-				continue;
-			}
-
-			// Check that we don't have both create and destroy flagged
-			check(!(BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Create) && BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Destroy)));
-
-			// Handle section created
-			if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Create))
-			{
-				// Validate section exists
-				check(MeshSections.Num() >= Index && MeshSections[Index].IsValid());
-				
-				UMaterialInterface* Material = GetMaterial(Index);
-				if (Material == nullptr)
-				{
-					Material = UMaterial::GetDefaultMaterial(MD_Surface);
-				}
+			return true;
+		}
+	}
+	return false;
+}
 
-				// Get the section create data and add it to the list
-				auto SectionCreateData = MeshSections[Index]->GetSectionCreationData(Material);
-				SectionCreateData->SetTargetSection(Index);
+FPrimitiveSceneProxy* URuntimeMeshComponent::CreateSceneProxy()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateSceneProxy);
+	INC_DWORD_STAT(STAT_RuntimeMesh_ProxyRecreates);
 
-				BatchUpdateData->CreateSections.Add(SectionCreateData);
-			}
-			// Handle destroy
-			else if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Destroy))
-			{
-				BatchUpdateData->DestroySections.Add(Index);
-			}
-			// Handle vertex/index updates
-			else if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::VerticesUpdate) || BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::IndicesUpdate))
-			{
-				// Validate section exists
-				check(MeshSections.Num() >= Index && MeshSections[Index].IsValid());
+	FRuntimeMeshSceneProxy* Proxy = new FRuntimeMeshSceneProxy(this);
 
-				// Get the section update data and add it to the list.
-				bool bHadPositionUpdates = BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::PositionsUpdate);
-				bool bHadVertexUpdates = BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::VerticesUpdate);
-				bool bHadIndexUpdates = BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::IndicesUpdate);
-				auto SectionUpdateData = MeshSections[Index]->GetSectionUpdateData(bHadPositionUpdates, bHadVertexUpdates, bHadIndexUpdates);
-				SectionUpdateData->SetTargetSection(Index);
+	// Keep the sections around for the next proxy while there are render only sections it can't rebuild
+	if (HasRenderOnlySections())
+	{
+		RetainedRenderData = Proxy->GetRenderData();
+	}
+	else
+	{
+		RetainedRenderData.Reset();
+	}
 
-				BatchUpdateData->UpdateSections.Add(SectionUpdateData);
-			}
-			// Handle property updates
-			else if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::PropertyUpdate))
-			{
-				// Validate section exists
-				check(MeshSections.Num() >= Index && MeshSections[Index].IsValid());
+	// Components sharing our mesh move over to the new sections
+	if (OwnedSharedMeshData.IsValid())
+	{
+		TArray<UMaterialInterface*> Materials;
+		GetUsedMaterials(Materials);
+		OwnedSharedMeshData->PublishRenderData(Proxy->GetRenderData(), Materials);
+	}
 
-				auto SectionProperties = new(BatchUpdateData->PropertyUpdateSections) FRuntimeMeshSectionPropertyUpdateData;
+	return Proxy;
+}
 
-				auto& Section = MeshSections[Index];
+TSharedRef<FRuntimeMeshSharedData> URuntimeMeshComponent::ShareMeshData()
+{
+	if (!OwnedSharedMeshData.IsValid())
+	{
+		OwnedSharedMeshData = MakeShareable(new FRuntimeMeshSharedData(this));
 
-				SectionProperties->SetTargetSection(Index);
-				SectionProperties->bIsVisible = Section->bIsVisible;
-				SectionProperties->bCastsShadow = Section->bCastsShadow;
-			}
-			else
-			{
-				// Unknown update type.
-				checkNoEntry();
-			}
+		// Publish what we have now, later changes are published as they're made
+		if (SceneProxy)
+		{
+			TArray<UMaterialInterface*> Materials;
+			GetUsedMaterials(Materials);
+			OwnedSharedMeshData->PublishRenderData(static_cast<FRuntimeMeshSceneProxy*>(SceneProxy)->GetRenderData(), Materials);
 		}
+		OwnedSharedMeshData->PublishBounds(SectionBounds.GetBounds());
+		OwnedSharedMeshData->PublishBodySetup(BodySetup);
+	}
 
+	return OwnedSharedMeshData.ToSharedRef();
+}
+
+void URuntimeMeshComponent::SetSharedMeshData(const TSharedPtr<FRuntimeMeshSharedData>& InSharedData)
+{
+	if (InSharedData.IsValid() && InSharedData->GetSource() == this)
+	{
+		Log(TEXT("SetSharedMeshData() - A component can't draw its own shared mesh."), true);
+		return;
+	}
+
+	if (SharedMeshData == InSharedData)
+	{
+		return;
+	}
+
+	if (SharedMeshData.IsValid())
+	{
+		SharedMeshData->RemoveUser(this);
+	}
+
+	SharedMeshData = InSharedData;
+
+	if (SharedMeshData.IsValid())
+	{
+		SharedMeshData->AddUser(this);
+	}
+
+	UpdateBounds();
+	MarkRenderStateDirty();
+
+	// Pick up the shared collision, or go back to our own
+	if (bPhysicsStateCreated)
+	{
+		RecreatePhysicsState();
+	}
+}
+
+int32 URuntimeMeshComponent::GetNumMaterials() const
+{
+	return MeshSections.Num();
+}
+
+void URuntimeMeshComponent::GetMemoryUsage(FRuntimeMeshMemoryUsage& OutUsage, TMap<FString, FRuntimeMeshMemoryUsage>* OutUsagePerVertexType) const
+{
+	OutUsage = FRuntimeMeshMemoryUsage();
+
+	for (int32 SectionIndex : ValidSectionIndices)
+	{
+		const RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+
+		FRuntimeMeshMemoryUsage SectionUsage;
+		SectionUsage.NumSections = 1;
+		SectionUsage.NumVertices = Section->GetNumVertices();
+		SectionUsage.NumIndices = Section->IndexBuffer.Num();
+		SectionUsage.CPUVertexBytes = Section->GetVertexDataSize();
+		SectionUsage.CPUPositionBytes = Section->GetPositionDataSize();
+		SectionUsage.CPUIndexBytes = Section->GetIndexDataSize();
+
+		OutUsage.NumSections++;
+		OutUsage.NumVertices += SectionUsage.NumVertices;
+		OutUsage.NumIndices += SectionUsage.NumIndices;
+		OutUsage.CPUVertexBytes += SectionUsage.CPUVertexBytes;
+		OutUsage.CPUPositionBytes += SectionUsage.CPUPositionBytes;
+		OutUsage.CPUIndexBytes += SectionUsage.CPUIndexBytes;
+
+		if (OutUsagePerVertexType)
+		{
+			FRuntimeMeshMemoryUsage& TypeUsage = OutUsagePerVertexType->FindOrAdd(Section->GetVertexType()->TypeName);
+			TypeUsage.NumSections++;
+			TypeUsage.NumVertices += SectionUsage.NumVertices;
+			TypeUsage.NumIndices += SectionUsage.NumIndices;
+			TypeUsage.CPUVertexBytes += SectionUsage.CPUVertexBytes;
+			TypeUsage.CPUPositionBytes += SectionUsage.CPUPositionBytes;
+			TypeUsage.CPUIndexBytes += SectionUsage.CPUIndexBytes;
+		}
+	}
+
+	OutUsage.CPUCollisionBytes = GetCollisionDataSize();
+
+	if (GPUMemory.IsValid())
+	{
+		OutUsage.GPUVertexBytes = GPUMemory->VertexBytes.GetValue();
+		OutUsage.GPUIndexBytes = GPUMemory->IndexBytes.GetValue();
+	}
+}
+
+bool URuntimeMeshComponent::SaveMeshSectionToCache(int32 SectionIndex, uint64 Key)
+{
+	if (!DoesSectionExist(SectionIndex))
+	{
+		Log(TEXT("SaveMeshSectionToCache() - Mesh section doesn't exist."), true);
+		return false;
+	}
+
+	const RuntimeMeshSectionPtr& Section = MeshSections[SectionIndex];
+	if (Section->bHasReleasedCPUData)
+	{
+		Log(TEXT("SaveMeshSectionToCache() - Render only sections can't be stored once their data has been released."), true);
+		return false;
+	}
+
+	FRuntimeMeshCacheSectionView View;
+	Section->GetCacheView(View);
+
+	return FRuntimeMeshCache::Get().StoreSection(Key != 0 ? Key : FRuntimeMeshCache::HashSection(View), View);
+}
+
+uint64 URuntimeMeshComponent::GetMeshSectionContentHash(int32 SectionIndex) const
+{
+	if (!DoesSectionExist(SectionIndex))
+	{
+		return 0;
+	}
+
+	FRuntimeMeshCacheSectionView View;
+	MeshSections[SectionIndex]->GetCacheView(View);
+
+	return FRuntimeMeshCache::HashSection(View);
+}
+
+SIZE_T URuntimeMeshComponent::GetCollisionDataSize() const
+{
+	SIZE_T Size = MeshCollisionSections.GetAllocatedSize() + ConvexCollisionSections.GetAllocatedSize();
+
+	for (const FRuntimeMeshCollisionSection& CollisionSection : MeshCollisionSections)
+	{
+		Size += CollisionSection.VertexBuffer.GetAllocatedSize() + CollisionSection.IndexBuffer.GetAllocatedSize();
+	}
+
+	for (const FRuntimeConvexCollisionSection& ConvexSection : ConvexCollisionSections)
+	{
+		Size += ConvexSection.VertexBuffer.GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+void URuntimeMeshComponent::UpdateCollisionMemoryStats()
+{
+	const SIZE_T CollisionMemory = GetCollisionDataSize();
+
+	DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUCollisionMemory, AccountedCollisionMemory);
+	INC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUCollisionMemory, CollisionMemory);
+	AccountedCollisionMemory = CollisionMemory;
+}
+
+void URuntimeMeshComponent::BeginDestroy()
+{
+	Super::BeginDestroy();
+
+	// Workers still generating keep their jobs alive until they're done
+	CancelAllAsyncSections();
+
+	// Anything sharing our mesh keeps drawing it as it is now
+	if (SharedMeshData.IsValid())
+	{
+		SharedMeshData->RemoveUser(this);
+		SharedMeshData.Reset();
+	}
+	OwnedSharedMeshData.Reset();
+
+	// The sections take their own memory out of the stats when they're destroyed
+	DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUCollisionMemory, AccountedCollisionMemory);
+	AccountedCollisionMemory = 0;
+}
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 14
+void URuntimeMeshComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	FRuntimeMeshMemoryUsage Usage;
+	GetMemoryUsage(Usage);
+
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Usage.GetCPUBytes() + MeshSections.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedVideoMemoryBytes(Usage.GetGPUBytes());
+}
+#else
+SIZE_T URuntimeMeshComponent::GetResourceSize(EResourceSizeMode::Type Mode)
+{
+	FRuntimeMeshMemoryUsage Usage;
+	GetMemoryUsage(Usage);
+
+	return Super::GetResourceSize(Mode) + Usage.GetCPUBytes() + MeshSections.GetAllocatedSize() + Usage.GetGPUBytes();
+}
+#endif
+
+/* Logs the memory held by every runtime mesh component, and the section data by vertex type */
+static void DumpRuntimeMeshMemory()
+{
+	FRuntimeMeshMemoryUsage Total;
+	TMap<FString, FRuntimeMeshMemoryUsage> UsagePerVertexType;
+	int32 NumComponents = 0;
+
+	UE_LOG(RuntimeMeshLog, Log, TEXT("RuntimeMesh.DumpMemory - Sizes in KB. CPU is vertex/position/index/collision, GPU is vertex/index."));
+
+	for (TObjectIterator<URuntimeMeshComponent> It; It; ++It)
+	{
+		URuntimeMeshComponent* Component = *It;
+		if (Component->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) || Component->IsPendingKill())
+		{
+			continue;
+		}
+
+		FRuntimeMeshMemoryUsage Usage;
+		Component->GetMemoryUsage(Usage, &UsagePerVertexType);
+
+		UE_LOG(RuntimeMeshLog, Log, TEXT("  %s: %d sections, %d verts, %d tris, CPU %.1f/%.1f/%.1f/%.1f, GPU %.1f/%.1f"),
+			*Component->GetPathName(), Usage.NumSections, Usage.NumVertices, Usage.NumIndices / 3,
+			Usage.CPUVertexBytes / 1024.0f, Usage.CPUPositionBytes / 1024.0f, Usage.CPUIndexBytes / 1024.0f, Usage.CPUCollisionBytes / 1024.0f,
+			Usage.GPUVertexBytes / 1024.0f, Usage.GPUIndexBytes / 1024.0f);
+
+		NumComponents++;
+		Total.NumSections += Usage.NumSections;
+		Total.NumVertices += Usage.NumVertices;
+		Total.NumIndices += Usage.NumIndices;
+		Total.CPUVertexBytes += Usage.CPUVertexBytes;
+		Total.CPUPositionBytes += Usage.CPUPositionBytes;
+		Total.CPUIndexBytes += Usage.CPUIndexBytes;
+		Total.CPUCollisionBytes += Usage.CPUCollisionBytes;
+		Total.GPUVertexBytes += Usage.GPUVertexBytes;
+		Total.GPUIndexBytes += Usage.GPUIndexBytes;
+	}
+
+	UE_LOG(RuntimeMeshLog, Log, TEXT("By vertex type (CPU vertex/position/index):"));
+	for (const auto& Entry : UsagePerVertexType)
+	{
+		const FRuntimeMeshMemoryUsage& Usage = Entry.Value;
+		UE_LOG(RuntimeMeshLog, Log, TEXT("  %s: %d sections, %d verts, %d tris, CPU %.1f/%.1f/%.1f"), *Entry.Key,
+			Usage.NumSections, Usage.NumVertices, Usage.NumIndices / 3, Usage.CPUVertexBytes / 1024.0f, Usage.CPUPositionBytes / 1024.0f, Usage.CPUIndexBytes / 1024.0f);
+	}
+
+	UE_LOG(RuntimeMeshLog, Log, TEXT("Total: %d components, %d sections, %d verts, %d tris, CPU %.1f KB, GPU %.1f KB"),
+		NumComponents, Total.NumSections, Total.NumVertices, Total.NumIndices / 3, Total.GetCPUBytes() / 1024.0f, Total.GetGPUBytes() / 1024.0f);
+}
+
+static FAutoConsoleCommand CmdRuntimeMeshDumpMemory(
+	TEXT("RuntimeMesh.DumpMemory"),
+	TEXT("Logs the CPU and GPU memory held by every runtime mesh component, with the section data broken down by vertex type."),
+	FConsoleCommandDelegate::CreateStatic(&DumpRuntimeMeshMemory));
+
+FBoxSphereBounds URuntimeMeshComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	// A shared mesh is drawn along with our own sections
+	if (SharedMeshData.IsValid() && SharedMeshData->GetLocalBounds().IsValid)
+	{
+		// Without sections of our own the local bounds are a point at the origin, which shouldn't grow the shared ones
+		const FBox& SharedBox = SharedMeshData->GetLocalBounds();
+		return FBoxSphereBounds(LocalBounds.SphereRadius > 0.0f ? LocalBounds.GetBox() + SharedBox : SharedBox).TransformBy(LocalToWorld);
+	}
+
+	return LocalBounds.TransformBy(LocalToWorld);
+}
+
+
+
+
+
+/* Render payloads for one section in a batch update, built in parallel by EndBatchUpdates() */
+struct FRuntimeMeshBatchSectionWork
+{
+	int32 SectionIndex;
+
+	/* Material for a created section, looked up on the game thread */
+	UMaterialInterface* Material;
+
+	FRuntimeMeshSectionCreateDataInterface* CreateData;
+	FRuntimeMeshRenderThreadCommandInterface* UpdateData;
+	FRuntimeMeshRenderThreadCommandInterface* RangeUpdateData;
+	FRuntimeMeshSectionPropertyUpdateData* PropertyData;
+	FRuntimeMeshSectionInstanceUpdateData* InstanceData;
+
+	/* What to send for this section */
+	ERuntimeMeshSectionBatchUpdateType Updates;
+
+	/* Bytes the upload is expected to send, used for the upload budget */
+	SIZE_T UploadSize;
+
+	/* Order to send uploads in when they're budgeted, higher first. Then by distance to the closest view */
+	float Priority;
+	float ViewDistanceSquared;
+
+	FRuntimeMeshBatchSectionWork(int32 InSectionIndex, ERuntimeMeshSectionBatchUpdateType InUpdates)
+		: SectionIndex(InSectionIndex), Material(nullptr), CreateData(nullptr), UpdateData(nullptr), RangeUpdateData(nullptr), PropertyData(nullptr), InstanceData(nullptr)
+		, Updates(InUpdates), UploadSize(0), Priority(0.0f), ViewDistanceSquared(0.0f)
+	{}
+
+	bool HasUpdate(ERuntimeMeshSectionBatchUpdateType UpdateType) const { return (Updates & UpdateType) == UpdateType; }
+};
+
+/* Updates that upload mesh data, and so count against the upload budget */
+static const ERuntimeMeshSectionBatchUpdateType RuntimeMeshBudgetedUpdates = ERuntimeMeshSectionBatchUpdateType::Create | ERuntimeMeshSectionBatchUpdateType::PositionsUpdate |
+	ERuntimeMeshSectionBatchUpdateType::VerticesUpdate | ERuntimeMeshSectionBatchUpdateType::IndicesUpdate | ERuntimeMeshSectionBatchUpdateType::RangeUpdate |
+	ERuntimeMeshSectionBatchUpdateType::InstanceUpdate;
+
+void URuntimeMeshComponent::SetMeshSectionUploadPriority(int32 SectionIndex, float Priority)
+{
+	SectionUploadPriorities.Add(SectionIndex, Priority);
+}
+
+void URuntimeMeshComponent::ScheduleBatchUploads(TArray<FRuntimeMeshBatchSectionWork>& SectionWork, TArray<TPair<int32, ERuntimeMeshSectionBatchUpdateType>>& OutDeferred)
+{
+	// Deferred uploads are picked up by the end of frame tick, without it they'd never be sent
+	if (!bUseUploadBudget || !FRuntimeMeshUploadBudget::IsEnabled() || !EndOfFrameTick.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	TArray<FRuntimeMeshBatchSectionWork*> Uploads;
+	for (FRuntimeMeshBatchSectionWork& Work : SectionWork)
+	{
+		if (!EnumHasAnyFlags(Work.Updates, RuntimeMeshBudgetedUpdates))
+		{
+			continue;
+		}
+
+		auto& Section = MeshSections[Work.SectionIndex];
+		if (Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::Create))
+		{
+			Work.UploadSize = Section->GetVertexDataSize() + Section->GetPositionDataSize() + Section->GetIndexDataSize() + Section->Instances.GetAllocatedSize();
+		}
+		else
+		{
+			const bool bHasPositionsUpdate = Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::PositionsUpdate);
+			const bool bHasVerticesUpdate = Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::VerticesUpdate);
+			const bool bHasIndicesUpdate = Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::IndicesUpdate);
+
+			Work.UploadSize += bHasPositionsUpdate ? Section->GetPositionDataSize() : 0;
+			Work.UploadSize += bHasVerticesUpdate ? Section->GetVertexDataSize() : 0;
+			Work.UploadSize += bHasIndicesUpdate ? Section->GetIndexDataSize() : 0;
+			Work.UploadSize += Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::InstanceUpdate) && Section->bIsInstanced ? Section->GetInstanceUpdateDataSize() : 0;
+
+			// Ranges of a buffer that's also sent in full are dropped, only the rest is sent
+			if (Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::RangeUpdate))
+			{
+				Work.UploadSize += Section->GetDirtyRangeDataSize(!bHasPositionsUpdate, !bHasVerticesUpdate, !bHasIndicesUpdate);
+			}
+		}
+
+		const float* Priority = SectionUploadPriorities.Find(Work.SectionIndex);
+		Work.Priority = Priority ? *Priority : 0.0f;
+
+		const FBox SectionRenderBounds = Section->GetRenderBounds();
+		if (World && World->ViewLocationsRenderedLastFrame.Num() > 0 && SectionRenderBounds.IsValid)
+		{
+			const FBox WorldBox = SectionRenderBounds.TransformBy(ComponentToWorld);
+
+			Work.ViewDistanceSquared = MAX_flt;
+			for (const FVector& ViewLocation : World->ViewLocationsRenderedLastFrame)
+			{
+				Work.ViewDistanceSquared = FMath::Min(Work.ViewDistanceSquared, ComputeSquaredDistanceFromBoxToPoint(WorldBox.Min, WorldBox.Max, ViewLocation));
+			}
+		}
+
+		Uploads.Add(&Work);
+	}
+
+	Uploads.Sort([](const FRuntimeMeshBatchSectionWork& A, const FRuntimeMeshBatchSectionWork& B)
+	{
+		if (A.Priority != B.Priority)
+		{
+			return A.Priority > B.Priority;
+		}
+		return A.ViewDistanceSquared < B.ViewDistanceSquared;
+	});
+
+	const uint64 CurrentFrame = GFrameCounter;
+	for (FRuntimeMeshBatchSectionWork* Work : Uploads)
+	{
+		if (FRuntimeMeshUploadBudget::TryConsume(Work->UploadSize))
+		{
+			// Track how long it waited if it was deferred before
+			uint64 DeferredSince;
+			if (DeferredUploadFrames.RemoveAndCopyValue(Work->SectionIndex, DeferredSince))
+			{
+				INC_DWORD_STAT_BY(STAT_RuntimeMesh_DeferredUploadWaitFrames, (uint32)(CurrentFrame - DeferredSince));
+			}
+			continue;
+		}
+
+		// Keep the uploads for a later frame, property updates still go now
+		OutDeferred.Add(TPairInitializer<int32, ERuntimeMeshSectionBatchUpdateType>(Work->SectionIndex, Work->Updates & RuntimeMeshBudgetedUpdates));
+		Work->Updates &= ~RuntimeMeshBudgetedUpdates;
+
+		if (!DeferredUploadFrames.Contains(Work->SectionIndex))
+		{
+			DeferredUploadFrames.Add(Work->SectionIndex, CurrentFrame);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_RuntimeMesh_DeferredUploads, OutDeferred.Num());
+
+	SectionWork.RemoveAll([](const FRuntimeMeshBatchSectionWork& Work) { return Work.Updates == ERuntimeMeshSectionBatchUpdateType::None; });
+}
+
+void URuntimeMeshComponent::StartAutoBatchIfEnabled()
+{
+	if (!(bAutoBatchUpdates || bUseUploadBudget) || BatchState.IsBatchPending())
+	{
+		return;
+	}
+
+	// Editor worlds don't tick components, so the batch would never be sent
+	UWorld* World = GetWorld();
+	if (World == nullptr || !World->IsGameWorld() || !EndOfFrameTick.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	BatchState.StartBatch(true);
+	EndOfFrameTick.SetTickFunctionEnable(true);
+}
+
+void URuntimeMeshComponent::FlushAutoBatchUpdates()
+{
+	// Batches started with BeginBatchUpdates() are left to EndBatchUpdates()
+	if (BatchState.IsAutoBatch())
+	{
+		EndBatchUpdates();
+	}
+	
+	UpdateEndOfFrameTickEnabled();
+}
+
+void URuntimeMeshComponent::TickEndOfFrame()
+{
+	// Finished async sections join the auto batch if there is one
+	CommitFinishedAsyncSections();
+	FlushAutoBatchUpdates();
+}
+
+void URuntimeMeshComponent::UpdateEndOfFrameTickEnabled()
+{
+	EndOfFrameTick.SetTickFunctionEnable(BatchState.IsAutoBatch() || PendingAsyncSections.Num() > 0);
+}
+
+FRuntimeMeshAsyncSectionHandle URuntimeMeshComponent::QueueAsyncSectionJob(const TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>& Job)
+{
+	check(IsInGameThread());
+
+	// Only the latest result for a section is kept. Jobs deriving from the mesh only replace each other
+	SupersedeAsyncSections(Job->SectionIndex, !Job->ChangesSectionMesh());
+	PendingAsyncSections.Add(Job);
+
+	// The worker holds its own reference so the job outlives the component if need be
+	TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe> WorkerJob = Job;
+	Async<void>(EAsyncExecution::ThreadPool, [WorkerJob]()
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_GenerateAsyncSection);
+
+		WorkerJob->Generate();
+		WorkerJob->MarkGenerated();
+	});
+
+	UpdateEndOfFrameTickEnabled();
+
+	return FRuntimeMeshAsyncSectionHandle(Job->State);
+}
+
+void URuntimeMeshComponent::SupersedeAsyncSections(int32 SectionIndex, bool bOnlyDerived)
+{
+	if (PendingAsyncSections.Num() == 0)
+	{
+		return;
+	}
+
+	for (const TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>& Job : PendingAsyncSections)
+	{
+		if (Job->SectionIndex == SectionIndex && !(bOnlyDerived && Job->ChangesSectionMesh()))
+		{
+			Job->State->Finish(ERuntimeMeshAsyncSectionStatus::Superseded);
+		}
+	}
+
+	PendingAsyncSections.RemoveAll([](const TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>& Job)
+	{
+		return Job->State->GetStatus() != ERuntimeMeshAsyncSectionStatus::Pending;
+	});
+}
+
+void URuntimeMeshComponent::CancelAllAsyncSections()
+{
+	for (const TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>& Job : PendingAsyncSections)
+	{
+		Job->State->Finish(ERuntimeMeshAsyncSectionStatus::Cancelled);
+	}
+	PendingAsyncSections.Empty();
+
+	UpdateEndOfFrameTickEnabled();
+}
+
+void URuntimeMeshComponent::CommitFinishedAsyncSections()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CommitAsyncSections);
+
+	// Take the finished jobs out first, committing them can supersede others
+	TArray<TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>> FinishedJobs;
+	for (int32 Index = 0; Index < PendingAsyncSections.Num();)
+	{
+		const TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>& Job = PendingAsyncSections[Index];
+		const bool bIsCancelled = Job->State->GetStatus() != ERuntimeMeshAsyncSectionStatus::Pending;
+
+		if (bIsCancelled || Job->IsGenerated())
+		{
+			if (!bIsCancelled)
+			{
+				FinishedJobs.Add(Job);
+			}
+			PendingAsyncSections.RemoveAt(Index, 1, false);
+		}
+		else
+		{
+			Index++;
+		}
+	}
+
+	if (FinishedJobs.Num() > 0)
+	{
+		// Everything that finished this frame goes to the RT in one batch
+		bool bStartedBatch = !BatchState.IsBatchPending();
+		if (bStartedBatch)
+		{
+			BeginBatchUpdates();
+		}
+
+		for (const TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>& Job : FinishedJobs)
+		{
+			Job->Commit(this);
+		}
+
+		if (bStartedBatch)
+		{
+			EndBatchUpdates();
+		}
+	}
+
+	UpdateEndOfFrameTickEnabled();
+}
+
+void URuntimeMeshComponent::EndBatchUpdates()
+{
+	// Bail if we have no pending updates
+	if (!BatchState.IsBatchPending())
+		return;
+
+	// Uploads held back by the upload budget, sent with a later batch
+	TArray<TPair<int32, ERuntimeMeshSectionBatchUpdateType>> DeferredUploads;
+
+	// Handle all pending rendering updates..
+	if (BatchState.RequiresSceneProxyRecreate() || SceneProxy == nullptr)
+	{
+		MarkRenderStateDirty();
+		DeferredUploadFrames.Empty();
+	}
+	else
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_PrepareBatchUpdate);
+
+		auto* BatchUpdateData = new FRuntimeMeshBatchUpdateData;
+
+		// Only the sections touched by the batch are visited, in section order so the RT applies them as before
+		TArray<int32> DirtySections = BatchState.GetDirtySections();
+		DirtySections.Sort();
+
+		// Gather the sections with work to do. Destroys don't need any so they're added directly.
+		TArray<FRuntimeMeshBatchSectionWork> SectionWork;
+		SectionWork.Reserve(DirtySections.Num());
+		for (int32 Index : DirtySections)
+		{
+			// Skip this section if it has no updates.
+			if (!BatchState.HasAnyFlagSet(Index))
+			{
+				continue;
+			}
+
+			// Check that we don't have both create and destroy flagged
+			check(!(BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Create) && BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Destroy)));
+
+			if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Destroy))
+			{
+				BatchUpdateData->DestroySections.Add(Index);
+				continue;
+			}
+
+			// Validate section exists
+			check(MeshSections.Num() >= Index && MeshSections[Index].IsValid());
+
+			FRuntimeMeshBatchSectionWork& Work = SectionWork[SectionWork.Emplace(Index, BatchState.GetSectionUpdates(Index))];
+
+			// Materials are UObjects so they're resolved here instead of on the workers
+			if (BatchState.HasFlagSet(Index, ERuntimeMeshSectionBatchUpdateType::Create))
+			{
+				Work.Material = GetSectionMaterial(Index);
+			}
+		}
+
+		// Hold back whatever doesn't fit this frame's upload budget
+		ScheduleBatchUploads(SectionWork, DeferredUploads);
+
+		// Build the render payloads. Each job only touches its own section.
+		ParallelFor(SectionWork.Num(), [&](int32 WorkIndex)
+		{
+			FRuntimeMeshBatchSectionWork& Work = SectionWork[WorkIndex];
+			const int32 Index = Work.SectionIndex;
+			auto& Section = MeshSections[Index];
+
+			// Handle section created
+			if (Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::Create))
+			{
+				// Get the section create data
+				Work.CreateData = Section->GetSectionCreationData(Work.Material);
+				Work.CreateData->SetTargetSection(Index);
+
+				// Creation sends the full buffers
+				Section->ClearDirtyRanges();
+				Section->ClearInstanceChanges();
+				Section->ReleaseCPUDataIfRenderOnly();
+				return;
+			}
+
+			// Handle position/vertex/index updates
+			bool bHadPositionUpdates = Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::PositionsUpdate);
+			bool bHadVertexUpdates = Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::VerticesUpdate);
+			bool bHadIndexUpdates = Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::IndicesUpdate);
+			if (bHadPositionUpdates || bHadVertexUpdates || bHadIndexUpdates)
+			{
+				// Get the section update data
+				Work.UpdateData = Section->GetSectionUpdateData(bHadPositionUpdates, bHadVertexUpdates, bHadIndexUpdates);
+				Work.UpdateData->SetTargetSection(Index);
+
+				// Buffers sent in full don't need their ranges sent as well, and the ranges may no longer fit them
+				if (bHadPositionUpdates)
+				{
+					Section->DirtyPositionRanges.Reset();
+				}
+				if (bHadVertexUpdates)
+				{
+					Section->DirtyVertexRanges.Reset();
+				}
+				if (bHadIndexUpdates)
+				{
+					Section->DirtyIndexRanges.Reset();
+				}
+
+				Section->ReleaseCPUDataIfRenderOnly();
+			}
+
+			// Handle range updates
+			if (Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::RangeUpdate) && Section->HasDirtyRanges())
+			{
+				Work.RangeUpdateData = Section->GetSectionRangeUpdateData();
+				Work.RangeUpdateData->SetTargetSection(Index);
+			}
+
+			// Handle property updates
+			if (Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::PropertyUpdate))
+			{
+				Work.PropertyData = new FRuntimeMeshSectionPropertyUpdateData;
+				Work.PropertyData->SetTargetSection(Index);
+				Work.PropertyData->bIsVisible = Section->bIsVisible;
+				Work.PropertyData->bCastsShadow = Section->bCastsShadow;
+			}
+
+			// Handle instance updates
+			if (Work.HasUpdate(ERuntimeMeshSectionBatchUpdateType::InstanceUpdate) && Section->bIsInstanced)
+			{
+				Work.InstanceData = Section->GetSectionInstanceUpdateData();
+				Work.InstanceData->SetTargetSection(Index);
+			}
+		}, SectionWork.Num() < 2);
+
+		// Assemble the batch in section order
+		for (const FRuntimeMeshBatchSectionWork& Work : SectionWork)
+		{
+			if (Work.CreateData)
+			{
+				BatchUpdateData->CreateSections.Add(Work.CreateData);
+			}
+			if (Work.UpdateData)
+			{
+				BatchUpdateData->UpdateSections.Add(Work.UpdateData);
+			}
+			if (Work.RangeUpdateData)
+			{
+				BatchUpdateData->RangeUpdateSections.Add(Work.RangeUpdateData);
+			}
+			if (Work.PropertyData)
+			{
+				BatchUpdateData->PropertyUpdateSections.Add(Work.PropertyData);
+			}
+			if (Work.InstanceData)
+			{
+				BatchUpdateData->InstanceUpdateSections.Add(Work.InstanceData);
+			}
+		}
+
+
+
+		// Enqueue update on RT
+		ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+			FRuntimeMeshBatchUpdateCommand,
+			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
+			FRuntimeMeshBatchUpdateData*, BatchUpdateData, BatchUpdateData,
+			{
+				RuntimeMeshSceneProxy->ApplyBatchUpdate_RenderThread(BatchUpdateData);
+			}
+		);
+
+
+	}
+
+	// Update collision if necessary
+	if (BatchState.RequiresCollisionUpdate())
+	{
+		MarkCollisionDirty();
+	}
+
+	// Update local bounds if necessary
+	if (BatchState.RequiresBoundsUpdate())
+	{
+		UpdateLocalBounds(!BatchState.RequiresSceneProxyRecreate());
+	}
+
+	// Clear batch info
+	BatchState.ResetBatch();
+
+	// Deferred uploads go out with the next frame's batch
+	if (DeferredUploads.Num() > 0)
+	{
+		BatchState.StartBatch(true);
+		for (const TPair<int32, ERuntimeMeshSectionBatchUpdateType>& Deferred : DeferredUploads)
+		{
+			BatchState.MarkUpdateForSection(Deferred.Key, Deferred.Value);
+		}
+	}
+	UpdateEndOfFrameTickEnabled();
+}
+
+
+
+
+
+
+
+
+
+bool URuntimeMeshComponent::GetPhysicsTriMeshData(struct FTriMeshCollisionData* CollisionData, bool InUseAllTriData)
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_GetPhysicsTriMeshData);
+
+	// Sections are cooked into their own elements, the main body only has the simple collision
+	if (bUseIncrementalSectionCollision)
+	{
+		return false;
+	}
+
+ 	int32 VertexBase = 0; // Base vertex index for current section
+ 
+	bool HadCollision = false;
+
+	// For each section..
+	for (int32 SectionIdx : ValidSectionIndices)
+	{ 
+		const RuntimeMeshSectionPtr& Section = MeshSections[SectionIdx];
+
+		if (Section->CollisionEnabled)
+		{
+			// Copy vertex data
+			Section->GetAllVertexPositions(CollisionData->Vertices);
+
+			// Copy indices
+			const int32 NumTriangles = Section->IndexBuffer.Num() / 3;
+			for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
+			{
+				// Add the triangle
+				FTriIndices& Triangle = *new (CollisionData->Indices) FTriIndices;
+				Triangle.v0 = Section->IndexBuffer[(TriIdx * 3) + 0] + VertexBase;
+				Triangle.v1 = Section->IndexBuffer[(TriIdx * 3) + 1] + VertexBase;
+				Triangle.v2 = Section->IndexBuffer[(TriIdx * 3) + 2] + VertexBase;
+
+				// Add material info
+				CollisionData->MaterialIndices.Add(SectionIdx);
+			}
+
+			// Update the vertex base index
+			VertexBase = CollisionData->Vertices.Num();
+			HadCollision = true;
+		}
+	}
+
+	for (int32 SectionIdx = 0; SectionIdx < MeshCollisionSections.Num(); SectionIdx++)
+	{
+		auto& Section = MeshCollisionSections[SectionIdx];
+		if (Section.VertexBuffer.Num() > 0 && Section.IndexBuffer.Num() > 0)
+		{
+			CollisionData->Vertices.Append(Section.VertexBuffer);
+
+			const int32 NumTriangles = Section.IndexBuffer.Num() / 3;
+			for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
+			{
+				// Add the triangle
+				FTriIndices& Triangle = *new (CollisionData->Indices) FTriIndices;
+				Triangle.v0 = Section.IndexBuffer[(TriIdx * 3) + 0] + VertexBase;
+				Triangle.v1 = Section.IndexBuffer[(TriIdx * 3) + 1] + VertexBase;
+				Triangle.v2 = Section.IndexBuffer[(TriIdx * 3) + 2] + VertexBase;
+
+				// Add material info
+				CollisionData->MaterialIndices.Add(SectionIdx);
+			}
+
+
+			VertexBase = CollisionData->Vertices.Num();
+			HadCollision = true;
+		}
+	}
+ 
+ 	CollisionData->bFlipNormals = true;
+ 
+ 	return HadCollision;
+ }
+
+ bool URuntimeMeshComponent::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
+ {
+	if (bUseIncrementalSectionCollision)
+	{
+		return false;
+	}
+
+ 	for (int32 SectionIdx : ValidSectionIndices)
+ 	{
+		const RuntimeMeshSectionPtr& Section = MeshSections[SectionIdx];
+ 		if (Section->IndexBuffer.Num() >= 3 && Section->CollisionEnabled)
+ 		{
+ 			return true;
+ 		}
+ 	}
 
+	for (const auto& Section : MeshCollisionSections)
+	{
+		if (Section.VertexBuffer.Num() > 0 && Section.IndexBuffer.Num() > 0)
+		{
+			return true;
+		}
+	}
+ 
+ 	return false;
+ }
 
-		// Enqueue update on RT
-		ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
-			FRuntimeMeshBatchUpdateCommand,
-			FRuntimeMeshSceneProxy*, RuntimeMeshSceneProxy, (FRuntimeMeshSceneProxy*)SceneProxy,
-			FRuntimeMeshBatchUpdateData*, BatchUpdateData, BatchUpdateData,
+void URuntimeMeshComponent::EnsureBodySetupCreated()
+{
+	if (BodySetup == nullptr)
+	{
+		BodySetup = NewObject<UBodySetup>(this);
+		BodySetup->BodySetupGuid = FGuid::NewGuid();
+
+		BodySetup->bGenerateMirroredCollision = false;
+		BodySetup->bDoubleSidedGeometry = true;
+	}
+}
+
+void URuntimeMeshComponent::UpdateCollision()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateCollision);
+
+	if (bUseIncrementalSectionCollision)
+	{
+		const int32 NumElementCooks = ElementCookSnapshots.Num();
+		UpdateSectionCollision();
+
+		// The main body only needs rebuilding when the convex elements change
+		if (!bSimpleCollisionDirty)
+		{
+			// Async element cooks broadcast once they're swapped in
+			if (ElementCookSnapshots.Num() == NumElementCooks)
 			{
-				RuntimeMeshSceneProxy->ApplyBatchUpdate_RenderThread(BatchUpdateData);
+				BroadcastCollisionUpdated();
 			}
-		);
+			return;
+		}
+		bSimpleCollisionDirty = false;
+	}
+	else
+	{
+		DirtySectionCollision.Empty();
+		DirtyCollisionSections.Empty();
+	}
+
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	if (bUseAsyncCooking)
+	{
+		StartAsyncCollisionCook();
+		return;
+	}
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
 
+	// Anything still cooking is older than what's about to be cooked here
+	SupersedeAsyncCollisionCook();
 
+	bool NeedsNewPhysicsState = false;
+
+	// Destroy physics state if it exists
+	if (bPhysicsStateCreated)
+	{
+		DestroyPhysicsState();
+		NeedsNewPhysicsState = true;
 	}
 
-	// Update collision if necessary
-	if (BatchState.RequiresCollisionUpdate())
+	// A body setup from an async cook pulls its mesh from the snapshot, so we need our own again
+	if (BodySetup != nullptr && BodySetup->GetOuter() != this)
 	{
-		MarkCollisionDirty();
+		BodySetup = nullptr;
 	}
 
-	// Update local bounds if necessary
-	if (BatchState.RequiresBoundsUpdate())
+	// Ensure we have a BodySetup
+	EnsureBodySetupCreated();
+
+	ConfigureBodySetup(BodySetup);
+
+
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	// Clear current mesh data
+	BodySetup->InvalidatePhysicsData();
+
+	// A mesh that was cooked before has its cooked data filled in from the cache
+	uint64 CollisionCacheKey = 0;
+	if (bUseCollisionCache)
 	{
-		UpdateLocalBounds(!BatchState.RequiresSceneProxyRecreate());
+		FTriMeshCollisionData CollisionData;
+		GetPhysicsTriMeshData(&CollisionData, true);
+		CollisionCacheKey = FRuntimeMeshCache::HashCollision(CollisionData, BodySetup);
 	}
 
-	// Clear batch info
-	BatchState.ResetBatch();
+	if (CollisionCacheKey == 0 || !FRuntimeMeshCache::Get().LoadCollision(CollisionCacheKey, BodySetup))
+	{
+		INC_DWORD_STAT(STAT_RuntimeMesh_CollisionCooks);
+
+		// Cooks it now, creating the meshes below drops the cooked data outside the editor
+		if (CollisionCacheKey != 0)
+		{
+			FRuntimeMeshCache::Get().StoreCollision(CollisionCacheKey, BodySetup);
+		}
+	}
+
+	// Create new mesh data
+	BodySetup->CreatePhysicsMeshes();
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+
+	// Recreate physics state if necessary
+	if (NeedsNewPhysicsState)
+	{
+		CreatePhysicsState();
+	}
+
+	BroadcastCollisionUpdated();
+}
+
+void URuntimeMeshComponent::MarkAllSectionCollisionDirty()
+{
+	const int32 NumSections = FMath::Max(MeshSections.Num(), SectionCollisionElements.Num());
+	for (int32 SectionIndex = 0; SectionIndex < NumSections; SectionIndex++)
+	{
+		DirtySectionCollision.Add(SectionIndex);
+	}
+}
+
+void URuntimeMeshComponent::MarkAllCollisionSectionsDirty()
+{
+	const int32 NumSections = FMath::Max(MeshCollisionSections.Num(), CollisionSectionElements.Num());
+	for (int32 SectionIndex = 0; SectionIndex < NumSections; SectionIndex++)
+	{
+		DirtyCollisionSections.Add(SectionIndex);
+	}
+}
+
+void URuntimeMeshComponent::UpdateSectionCollision()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateSectionCollision);
+
+	const TArray<int32> NoIndices;
+	const TArray<FVector> NoVertices;
+
+	TArray<FVector> Positions;
+	for (int32 SectionIndex : DirtySectionCollision)
+	{
+		if (SectionIndex >= SectionCollisionElements.Num())
+		{
+			SectionCollisionElements.SetNum(SectionIndex + 1, false);
+		}
+
+		if (SectionIndex < MeshSections.Num() && MeshSections[SectionIndex].IsValid() && MeshSections[SectionIndex]->CollisionEnabled)
+		{
+			Positions.Reset();
+			MeshSections[SectionIndex]->GetAllVertexPositions(Positions);
+
+			UpdateCollisionElement(false, SectionIndex, Positions, MeshSections[SectionIndex]->IndexBuffer.Get());
+		}
+		else
+		{
+			// Section removed or no longer has collision
+			UpdateCollisionElement(false, SectionIndex, NoVertices, NoIndices);
+		}
+	}
+
+	for (int32 CollisionSectionIndex : DirtyCollisionSections)
+	{
+		if (CollisionSectionIndex >= CollisionSectionElements.Num())
+		{
+			CollisionSectionElements.SetNum(CollisionSectionIndex + 1, false);
+		}
+
+		if (CollisionSectionIndex < MeshCollisionSections.Num())
+		{
+			const FRuntimeMeshCollisionSection& Section = MeshCollisionSections[CollisionSectionIndex];
+			UpdateCollisionElement(true, CollisionSectionIndex, Section.VertexBuffer, Section.IndexBuffer);
+		}
+		else
+		{
+			UpdateCollisionElement(true, CollisionSectionIndex, NoVertices, NoIndices);
+		}
+	}
+
+	DirtySectionCollision.Empty();
+	DirtyCollisionSections.Empty();
+
+	// Without async cooking the batch is still cooked in parallel, just waited on here
+	if (!bUseAsyncCooking)
+	{
+		for (URuntimeMeshCollisionSnapshot* Snapshot : ElementCookSnapshots)
+		{
+			if (Snapshot->Generation == ElementCookBatch)
+			{
+				Snapshot->WaitForCook();
+			}
+		}
+
+		FinishCollisionElementCooks();
+	}
+
+	ElementCookBatch++;
+}
+
+FRuntimeMeshCollisionElement* URuntimeMeshComponent::FindCollisionElement(bool bIsCollisionSectionElement, int32 ElementIndex)
+{
+	TArray<FRuntimeMeshCollisionElement>& Elements = bIsCollisionSectionElement ? CollisionSectionElements : SectionCollisionElements;
+	return Elements.IsValidIndex(ElementIndex) ? &Elements[ElementIndex] : nullptr;
+}
+
+void URuntimeMeshComponent::UpdateCollisionElement(bool bIsCollisionSectionElement, int32 ElementIndex, const TArray<FVector>& Vertices, const TArray<int32>& Indices)
+{
+	FRuntimeMeshCollisionElement& Element = *FindCollisionElement(bIsCollisionSectionElement, ElementIndex);
+
+	const int32 NumTriangles = Indices.Num() / 3;
+	const bool bHasCollision = Vertices.Num() > 0 && NumTriangles > 0;
+
+	uint32 ContentHash = 0;
+	if (bHasCollision)
+	{
+		ContentHash = FCrc::MemCrc32(Vertices.GetData(), Vertices.Num() * sizeof(FVector));
+		ContentHash = FCrc::MemCrc32(Indices.GetData(), Indices.Num() * sizeof(int32), ContentHash);
+		ContentHash = FCrc::MemCrc32(&ElementIndex, sizeof(int32), ContentHash);
+
+		// Nothing to do if the mesh hasn't actually changed, any cook still in flight is out of date then
+		if (Element.BodySetup != nullptr && Element.ContentHash == ContentHash)
+		{
+			Element.PendingContentHash = 0;
+			return;
+		}
+
+		// Or if it's already being cooked
+		if (Element.PendingContentHash == ContentHash)
+		{
+			return;
+		}
+	}
+
+	// Any cook still in flight is out of date now
+	Element.PendingContentHash = 0;
+
+	if (!bHasCollision)
+	{
+		DestroyCollisionElementBody(Element);
+		Element.BodySetup = nullptr;
+		Element.ContentHash = 0;
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CookCollisionElement);
+
+	// The snapshot provides the mesh to the cooker
+	URuntimeMeshCollisionSnapshot* Snapshot = NewObject<URuntimeMeshCollisionSnapshot>(this);
+	FTriMeshCollisionData& CollisionData = Snapshot->CollisionData;
+	CollisionData.Vertices = Vertices;
+	CollisionData.Indices.SetNumUninitialized(NumTriangles);
+	CollisionData.MaterialIndices.Init(ElementIndex, NumTriangles);
+	for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
+	{
+		FTriIndices& Triangle = CollisionData.Indices[TriIdx];
+		Triangle.v0 = Indices[(TriIdx * 3) + 0];
+		Triangle.v1 = Indices[(TriIdx * 3) + 1];
+		Triangle.v2 = Indices[(TriIdx * 3) + 2];
+	}
+	CollisionData.bFlipNormals = true;
+
+	UBodySetup* NewBodySetup = NewObject<UBodySetup>(Snapshot);
+	NewBodySetup->BodySetupGuid = FGuid::NewGuid();
+	NewBodySetup->bGenerateMirroredCollision = false;
+	NewBodySetup->bDoubleSidedGeometry = true;
+	NewBodySetup->CollisionTraceFlag = bUseComplexAsSimpleCollision ? CTF_UseComplexAsSimple : CTF_UseDefault;
+
+	Snapshot->BodySetup = NewBodySetup;
+	Snapshot->CacheKey = 0;
+	Snapshot->ElementIndex = ElementIndex;
+	Snapshot->bIsCollisionSectionElement = bIsCollisionSectionElement;
+	Snapshot->ContentHash = ContentHash;
+	Snapshot->Generation = ElementCookBatch;
+
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	// With the cooked data filled in from the cache the background cook has nothing left to do
+	const uint64 CollisionCacheKey = bUseCollisionCache ? FRuntimeMeshCache::HashCollision(CollisionData, NewBodySetup) : 0;
+	if (CollisionCacheKey == 0 || !FRuntimeMeshCache::Get().LoadCollision(CollisionCacheKey, NewBodySetup))
+	{
+		INC_DWORD_STAT(STAT_RuntimeMesh_CollisionCooks);
+		Snapshot->CacheKey = CollisionCacheKey;
+	}
+
+	// Cooked on the worker along with the rest of the batch, the current element body stays in use until it's swapped in
+	Snapshot->StartCook();
+
+	Element.PendingContentHash = ContentHash;
+	ElementCookSnapshots.Add(Snapshot);
+#else
+	Snapshot->ReleaseCollisionData();
+
+	DestroyCollisionElementBody(Element);
+	Element.BodySetup = NewBodySetup;
+	Element.ContentHash = ContentHash;
+
+	if (bPhysicsStateCreated)
+	{
+		CreateCollisionElementBody(Element);
+	}
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+}
+
+bool URuntimeMeshComponent::FinishCollisionElementCooks()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_FinishAsyncCollisionCook);
+
+	// A batch is swapped in all at once, so it waits for its slowest cook
+	TSet<uint32> UnfinishedBatches;
+	for (URuntimeMeshCollisionSnapshot* Snapshot : ElementCookSnapshots)
+	{
+		if (!Snapshot->IsCookComplete())
+		{
+			UnfinishedBatches.Add(Snapshot->Generation);
+		}
+	}
+
+	bool bAnyElementChanged = false;
+
+	for (int32 Index = 0; Index < ElementCookSnapshots.Num(); Index++)
+	{
+		URuntimeMeshCollisionSnapshot* Snapshot = ElementCookSnapshots[Index];
+		if (UnfinishedBatches.Contains(Snapshot->Generation))
+		{
+			continue;
+		}
+
+		ElementCookSnapshots.RemoveAt(Index--, 1, false);
+
+		// The element has been changed or removed since this cook started, a newer one replaces it
+		FRuntimeMeshCollisionElement* Element = FindCollisionElement(Snapshot->bIsCollisionSectionElement, Snapshot->ElementIndex);
+		if (Element == nullptr || Element->PendingContentHash != Snapshot->ContentHash)
+		{
+			continue;
+		}
+
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+		Snapshot->ApplyCookedData();
+
+		// Has to be stored before the meshes are created, which drops the cooked data outside the editor
+		if (Snapshot->CacheKey != 0)
+		{
+			FRuntimeMeshCache::Get().StoreCollision(Snapshot->CacheKey, Snapshot->BodySetup);
+		}
+
+		Snapshot->BodySetup->CreatePhysicsMeshes();
+#endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+
+		Snapshot->ReleaseCollisionData();
+
+		DestroyCollisionElementBody(*Element);
+		Element->BodySetup = Snapshot->BodySetup;
+		Element->ContentHash = Snapshot->ContentHash;
+		Element->PendingContentHash = 0;
+
+		if (bPhysicsStateCreated)
+		{
+			CreateCollisionElementBody(*Element);
+		}
+
+		bAnyElementChanged = true;
+	}
+
+	return bAnyElementChanged;
+}
+
+void URuntimeMeshComponent::CreateCollisionElementBody(FRuntimeMeshCollisionElement& Element)
+{
+	check(Element.BodyInstance == nullptr);
+
+	UWorld* World = GetWorld();
+	FPhysScene* PhysScene = World ? World->GetPhysicsScene() : nullptr;
+
+	if (Element.BodySetup == nullptr || PhysScene == nullptr)
+	{
+		return;
+	}
+
+	Element.BodyInstance = new FBodyInstance();
+	CopyCollisionSettingsToElementBody(*Element.BodyInstance);
+	Element.BodyInstance->bSimulatePhysics = false;
+	Element.BodyInstance->InitBody(Element.BodySetup, ComponentToWorld, this, PhysScene);
+}
+
+void URuntimeMeshComponent::CopyCollisionSettingsToElementBody(FBodyInstance& ElementBodyInstance) const
+{
+	// The main body is already initialized so only its settings are copied, not the whole instance
+	ElementBodyInstance.SetCollisionEnabled(BodyInstance.GetCollisionEnabled(), false);
+	ElementBodyInstance.SetObjectType(BodyInstance.GetObjectType());
+	ElementBodyInstance.SetResponseToChannels(BodyInstance.GetResponseToChannels());
+	ElementBodyInstance.bNotifyRigidBodyCollision = BodyInstance.bNotifyRigidBodyCollision;
+	ElementBodyInstance.bUseCCD = BodyInstance.bUseCCD;
+}
+
+void URuntimeMeshComponent::OnComponentCollisionSettingsChanged()
+{
+	Super::OnComponentCollisionSettingsChanged();
+
+	// Section bodies don't see the changes made to the main body
+	for (FRuntimeMeshCollisionElement& Element : SectionCollisionElements)
+	{
+		if (Element.BodyInstance != nullptr)
+		{
+			CopyCollisionSettingsToElementBody(*Element.BodyInstance);
+			Element.BodyInstance->UpdatePhysicsFilterData();
+		}
+	}
+
+	for (FRuntimeMeshCollisionElement& Element : CollisionSectionElements)
+	{
+		if (Element.BodyInstance != nullptr)
+		{
+			CopyCollisionSettingsToElementBody(*Element.BodyInstance);
+			Element.BodyInstance->UpdatePhysicsFilterData();
+		}
+	}
 }
 
+bool URuntimeMeshComponent::DoCustomNavigableGeometryExport(FNavigableGeometryExport& GeomExport) const
+{
+	// The main body only has the simple collision, the sections complex collision is in the element bodies
+	if (bUseIncrementalSectionCollision)
+	{
+		for (const FRuntimeMeshCollisionElement& Element : SectionCollisionElements)
+		{
+			if (Element.BodySetup != nullptr)
+			{
+				GeomExport.ExportRigidBodySetup(*Element.BodySetup, ComponentToWorld);
+			}
+		}
+
+		for (const FRuntimeMeshCollisionElement& Element : CollisionSectionElements)
+		{
+			if (Element.BodySetup != nullptr)
+			{
+				GeomExport.ExportRigidBodySetup(*Element.BodySetup, ComponentToWorld);
+			}
+		}
+	}
+
+	// The main body is still exported as usual
+	return true;
+}
 
+void URuntimeMeshComponent::DestroyCollisionElementBody(FRuntimeMeshCollisionElement& Element)
+{
+	if (Element.BodyInstance != nullptr)
+	{
+		Element.BodyInstance->TermBody();
+		delete Element.BodyInstance;
+		Element.BodyInstance = nullptr;
+	}
+}
 
+void URuntimeMeshComponent::OnCreatePhysicsState()
+{
+	Super::OnCreatePhysicsState();
 
+	for (FRuntimeMeshCollisionElement& Element : SectionCollisionElements)
+	{
+		CreateCollisionElementBody(Element);
+	}
 
+	for (FRuntimeMeshCollisionElement& Element : CollisionSectionElements)
+	{
+		CreateCollisionElementBody(Element);
+	}
+}
 
+void URuntimeMeshComponent::OnDestroyPhysicsState()
+{
+	for (FRuntimeMeshCollisionElement& Element : SectionCollisionElements)
+	{
+		DestroyCollisionElementBody(Element);
+	}
 
+	for (FRuntimeMeshCollisionElement& Element : CollisionSectionElements)
+	{
+		DestroyCollisionElementBody(Element);
+	}
 
+	Super::OnDestroyPhysicsState();
+}
 
-bool URuntimeMeshComponent::GetPhysicsTriMeshData(struct FTriMeshCollisionData* CollisionData, bool InUseAllTriData)
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 12
+void URuntimeMeshComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_GetPhysicsTriMeshData);
- 	int32 VertexBase = 0; // Base vertex index for current section
- 
-	bool HadCollision = false;
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
 
-	// For each section..
-	for (int32 SectionIdx = 0; SectionIdx < MeshSections.Num(); SectionIdx++)
-	{ 
-		const RuntimeMeshSectionPtr& Section = MeshSections[SectionIdx];
+	const bool bSkipPhysicsMove = !!(UpdateTransformFlags & EUpdateTransformFlags::SkipPhysicsUpdate);
+#else
+void URuntimeMeshComponent::OnUpdateTransform(bool bSkipPhysicsMove, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(bSkipPhysicsMove, Teleport);
+#endif
 
-		if (Section.IsValid() && Section->CollisionEnabled)
+	// Section bodies aren't part of the main body so they need moving along with it
+	if (!bSkipPhysicsMove)
+	{
+		for (FRuntimeMeshCollisionElement& Element : SectionCollisionElements)
 		{
-			// Copy vertex data
-			Section->GetAllVertexPositions(CollisionData->Vertices);
-
-			// Copy indices
-			const int32 NumTriangles = Section->IndexBuffer.Num() / 3;
-			for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
+			if (Element.BodyInstance != nullptr)
 			{
-				// Add the triangle
-				FTriIndices& Triangle = *new (CollisionData->Indices) FTriIndices;
-				Triangle.v0 = Section->IndexBuffer[(TriIdx * 3) + 0] + VertexBase;
-				Triangle.v1 = Section->IndexBuffer[(TriIdx * 3) + 1] + VertexBase;
-				Triangle.v2 = Section->IndexBuffer[(TriIdx * 3) + 2] + VertexBase;
-
-				// Add material info
-				CollisionData->MaterialIndices.Add(SectionIdx);
+				Element.BodyInstance->SetBodyTransform(ComponentToWorld, Teleport);
 			}
+		}
 
-			// Update the vertex base index
-			VertexBase = CollisionData->Vertices.Num();
-			HadCollision = true;
+		for (FRuntimeMeshCollisionElement& Element : CollisionSectionElements)
+		{
+			if (Element.BodyInstance != nullptr)
+			{
+				Element.BodyInstance->SetBodyTransform(ComponentToWorld, Teleport);
+			}
 		}
 	}
+}
 
-	for (int32 SectionIdx = 0; SectionIdx < MeshCollisionSections.Num(); SectionIdx++)
+void URuntimeMeshComponent::ConfigureBodySetup(UBodySetup* Setup)
+{
+	// Fill in simple collision convex elements
+	Setup->AggGeom.ConvexElems.SetNum(ConvexCollisionSections.Num());
+	for (int32 Index = 0; Index < ConvexCollisionSections.Num(); Index++)
 	{
-		auto& Section = MeshCollisionSections[SectionIdx];
-		if (Section.VertexBuffer.Num() > 0 && Section.IndexBuffer.Num() > 0)
-		{
-			CollisionData->Vertices.Append(Section.VertexBuffer);
+		FKConvexElem& NewConvexElem = Setup->AggGeom.ConvexElems[Index];
 
-			const int32 NumTriangles = Section.IndexBuffer.Num() / 3;
-			for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
-			{
-				// Add the triangle
-				FTriIndices& Triangle = *new (CollisionData->Indices) FTriIndices;
-				Triangle.v0 = Section.IndexBuffer[(TriIdx * 3) + 0] + VertexBase;
-				Triangle.v1 = Section.IndexBuffer[(TriIdx * 3) + 1] + VertexBase;
-				Triangle.v2 = Section.IndexBuffer[(TriIdx * 3) + 2] + VertexBase;
+		NewConvexElem.VertexData = ConvexCollisionSections[Index].VertexBuffer;
+		NewConvexElem.ElemBox = FBox(NewConvexElem.VertexData);
+	}
 
-				// Add material info
-				CollisionData->MaterialIndices.Add(SectionIdx);
-			}
+	// Set trace flag
+	Setup->CollisionTraceFlag = bUseComplexAsSimpleCollision ? CTF_UseComplexAsSimple : CTF_UseDefault;
 
+	// New GUID as collision has changed
+	Setup->BodySetupGuid = FGuid::NewGuid();
+}
 
-			VertexBase = CollisionData->Vertices.Num();
-			HadCollision = true;
-		}
-	}
- 
- 	CollisionData->bFlipNormals = true;
- 
- 	return HadCollision;
- }
+void URuntimeMeshComponent::StartAsyncCollisionCook()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_StartAsyncCollisionCook);
 
- bool URuntimeMeshComponent::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
- {
- 	for (const RuntimeMeshSectionPtr& Section : MeshSections)
- 	{
- 		if (Section.IsValid() && Section->IndexBuffer.Num() >= 3 && Section->CollisionEnabled)
- 		{
- 			return true;
- 		}
- 	}
+	// The newest cook starts right away, one still in flight is out of date and only ever discarded
+	SupersedeAsyncCollisionCook();
 
-	for (const auto& Section : MeshCollisionSections)
+	URuntimeMeshCollisionSnapshot* Snapshot = NewObject<URuntimeMeshCollisionSnapshot>(this);
+	Snapshot->Generation = CollisionCookGeneration;
+	GetPhysicsTriMeshData(&Snapshot->CollisionData, true);
+
+	// The current body setup stays in use until this one is finished
+	UBodySetup* NewBodySetup = NewObject<UBodySetup>(Snapshot);
+	NewBodySetup->bGenerateMirroredCollision = false;
+	NewBodySetup->bDoubleSidedGeometry = true;
+	ConfigureBodySetup(NewBodySetup);
+
+	Snapshot->BodySetup = NewBodySetup;
+	Snapshot->CacheKey = 0;
+
+	// With the cooked data filled in from the cache the background cook has nothing left to do
+	const uint64 CollisionCacheKey = bUseCollisionCache ? FRuntimeMeshCache::HashCollision(Snapshot->CollisionData, NewBodySetup) : 0;
+	if (CollisionCacheKey == 0 || !FRuntimeMeshCache::Get().LoadCollision(CollisionCacheKey, NewBodySetup))
 	{
-		if (Section.VertexBuffer.Num() > 0 && Section.IndexBuffer.Num() > 0)
-		{
-			return true;
-		}
+		INC_DWORD_STAT(STAT_RuntimeMesh_CollisionCooks);
+		Snapshot->CacheKey = CollisionCacheKey;
 	}
- 
- 	return false;
- }
 
-void URuntimeMeshComponent::EnsureBodySetupCreated()
-{
-	if (BodySetup == nullptr)
-	{
-		BodySetup = NewObject<UBodySetup>(this);
-		BodySetup->BodySetupGuid = FGuid::NewGuid();
+	Snapshot->StartCook();
 
-		BodySetup->bGenerateMirroredCollision = false;
-		BodySetup->bDoubleSidedGeometry = true;
-	}
+	AsyncCookSnapshot = Snapshot;
 }
 
-void URuntimeMeshComponent::UpdateCollision()
+void URuntimeMeshComponent::FinishAsyncCollisionCook()
 {
-	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateCollision);
+	SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_FinishAsyncCollisionCook);
+
+	check(AsyncCookSnapshot && AsyncCookSnapshot->IsCookComplete());
+
+	URuntimeMeshCollisionSnapshot* Snapshot = AsyncCookSnapshot;
+	AsyncCookSnapshot = nullptr;
+
+	// The collision changed again since this was taken
+	if (Snapshot->Generation != CollisionCookGeneration)
+	{
+		return;
+	}
 
 	bool NeedsNewPhysicsState = false;
 
@@ -1619,48 +4605,70 @@ void URuntimeMeshComponent::UpdateCollision()
 		NeedsNewPhysicsState = true;
 	}
 
-	// Ensure we have a BodySetup
-	EnsureBodySetupCreated();
+#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
+	Snapshot->ApplyCookedData();
 
-	// Fill in simple collision convex elements
-	BodySetup->AggGeom.ConvexElems.SetNum(ConvexCollisionSections.Num());
-	for (int32 Index = 0; Index < ConvexCollisionSections.Num(); Index++)
+	// Has to be stored before the meshes are created, which drops the cooked data outside the editor
+	if (Snapshot->CacheKey != 0)
 	{
-		FKConvexElem& NewConvexElem = BodySetup->AggGeom.ConvexElems[Index];
-
-		NewConvexElem.VertexData = ConvexCollisionSections[Index].VertexBuffer;
-		NewConvexElem.ElemBox = FBox(NewConvexElem.VertexData);
-	} 
-
-	// Set trace flag
-	BodySetup->CollisionTraceFlag = bUseComplexAsSimpleCollision ? CTF_UseComplexAsSimple : CTF_UseDefault;
-
-	// New GUID as collision has changed
-	BodySetup->BodySetupGuid = FGuid::NewGuid();
-
+		FRuntimeMeshCache::Get().StoreCollision(Snapshot->CacheKey, Snapshot->BodySetup);
+	}
 
-#if WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
-	// Clear current mesh data
-	BodySetup->InvalidatePhysicsData();
-	// Create new mesh data
-	BodySetup->CreatePhysicsMeshes();
+	// Cooked data is already built so this only has to create the meshes from it
+	Snapshot->BodySetup->CreatePhysicsMeshes();
 #endif // WITH_RUNTIME_PHYSICS_COOKING || WITH_EDITOR
 
+	// Swap in the new body, the old one is released to GC
+	BodySetup = Snapshot->BodySetup;
+	Snapshot->ReleaseCollisionData();
+
 	// Recreate physics state if necessary
 	if (NeedsNewPhysicsState)
 	{
 		CreatePhysicsState();
 	}
+
+	BroadcastCollisionUpdated();
+}
+
+void URuntimeMeshComponent::SupersedeAsyncCollisionCook()
+{
+	CollisionCookGeneration++;
+
+	if (AsyncCookSnapshot != nullptr)
+	{
+		SupersededCookSnapshots.Add(AsyncCookSnapshot);
+		AsyncCookSnapshot = nullptr;
+	}
+}
+
+void URuntimeMeshComponent::BroadcastCollisionUpdated()
+{
+	if (OwnedSharedMeshData.IsValid())
+	{
+		OwnedSharedMeshData->PublishBodySetup(BodySetup);
+	}
+
+	CollisionUpdated.Broadcast();
 }
 
 UBodySetup* URuntimeMeshComponent::GetBodySetup()
 {
+	// Shared collision replaces our own
+	if (SharedMeshData.IsValid() && SharedMeshData->GetBodySetup() != nullptr)
+	{
+		return SharedMeshData->GetBodySetup();
+	}
+
 	EnsureBodySetupCreated();
 	return BodySetup;
 }
 
 void URuntimeMeshComponent::MarkCollisionDirty()
 {
+	// Every change to the collision sections ends up here
+	UpdateCollisionMemoryStats();
+
 	if (!bCollisionDirty)
 	{
 		bCollisionDirty = true;
@@ -1671,11 +4679,30 @@ void URuntimeMeshComponent::MarkCollisionDirty()
 
 void URuntimeMeshComponent::BakeCollision()
 {
-	// Bake the collision
-	UpdateCollision();
+	// Swap in an async cook once it's done
+	if (AsyncCookSnapshot != nullptr && AsyncCookSnapshot->IsCookComplete())
+	{
+		FinishAsyncCollisionCook();
+	}
+
+	// Superseded cooks are only waited out, their results are stale
+	SupersededCookSnapshots.RemoveAll([](URuntimeMeshCollisionSnapshot* Snapshot) { return Snapshot->IsCookComplete(); });
+
+	if (ElementCookSnapshots.Num() > 0 && FinishCollisionElementCooks())
+	{
+		BroadcastCollisionUpdated();
+	}
+
+	// Bake the collision. A cook still in flight is superseded by this one, so the newest
+	// collision is never held up behind a stale cook.
+	if (bCollisionDirty)
+	{
+		UpdateCollision();
+		bCollisionDirty = false;
+	}
 
-	bCollisionDirty = false;
-	PrePhysicsTick.SetTickFunctionEnable(false);
+	// Keep ticking while a cook is in flight so we can pick it up
+	PrePhysicsTick.SetTickFunctionEnable(bCollisionDirty || HasPendingCollisionCooks());
 }
 
 void URuntimeMeshComponent::RegisterComponentTickFunctions(bool bRegister)
@@ -1687,7 +4714,13 @@ void URuntimeMeshComponent::RegisterComponentTickFunctions(bool bRegister)
 		if (SetupActorComponentTickFunction(&PrePhysicsTick))
 		{
 			PrePhysicsTick.Target = this;
-			PrePhysicsTick.SetTickFunctionEnable(bCollisionDirty);
+			PrePhysicsTick.SetTickFunctionEnable(bCollisionDirty || HasPendingCollisionCooks());
+		}
+
+		if (SetupActorComponentTickFunction(&EndOfFrameTick))
+		{
+			EndOfFrameTick.Target = this;
+			UpdateEndOfFrameTickEnabled();
 		}
 	}
 	else
@@ -1696,6 +4729,14 @@ void URuntimeMeshComponent::RegisterComponentTickFunctions(bool bRegister)
 		{
 			PrePhysicsTick.UnRegisterTickFunction();
 		}
+
+		if (EndOfFrameTick.IsTickFunctionRegistered())
+		{
+			EndOfFrameTick.UnRegisterTickFunction();
+		}
+
+		// Nothing would send the pending changes anymore
+		FlushAutoBatchUpdates();
 	}
 }
 
@@ -1708,6 +4749,94 @@ void URuntimeMeshComponent::Serialize(FArchive& Ar)
 
 	Ar.UsingCustomVersion(FRuntimeMeshVersion::GUID);
 
+	if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::BulkSerialization)
+	{
+		// Only packages get the bulk data, transactions and other in memory archives take the sections inline
+		bool bUsesBulkData = Ar.IsSaving() && Ar.IsPersistent() && !Ar.IsTransacting();
+		Ar << bUsesBulkData;
+
+		if (bUsesBulkData)
+		{
+			if (Ar.IsSaving())
+			{
+				// Saved again before PostLoad got to it
+				if (bHasPendingMeshBulkData)
+				{
+					UnpackMeshBulkData();
+				}
+
+				TArray<uint8> MeshData;
+				FMemoryWriter Writer(MeshData, Ar.IsPersistent());
+				Writer.SetCustomVersion(FRuntimeMeshVersion::GUID, Ar.CustomVer(FRuntimeMeshVersion::GUID), TEXT("RuntimeMesh"));
+				Writer.SetByteSwapping(Ar.IsByteSwapping());
+				SerializeMeshSections(Writer);
+
+				// The linker writes the payload after the exports, so this copy has to outlive the Serialize call
+				MeshBulkData.Lock(LOCK_READ_WRITE);
+				FMemory::Memcpy(MeshBulkData.Realloc(MeshData.Num()), MeshData.GetData(), MeshData.Num());
+				MeshBulkData.Unlock();
+
+				if (bCompressSerializedMeshData)
+				{
+					MeshBulkData.SetBulkDataFlags(BULKDATA_SerializeCompressedZLIB);
+				}
+				else
+				{
+					MeshBulkData.ClearBulkDataFlags(BULKDATA_SerializeCompressedZLIB);
+				}
+			}
+
+			MeshBulkData.Serialize(Ar, this);
+
+			if (Ar.IsLoading())
+			{
+				MeshBulkDataVersion = Ar.CustomVer(FRuntimeMeshVersion::GUID);
+
+				// Loads through a linker always get a PostLoad, so the sections are unpacked there
+				if (Ar.GetLinker())
+				{
+					bHasPendingMeshBulkData = true;
+				}
+				else
+				{
+					UnpackMeshBulkData();
+				}
+			}
+		}
+		else
+		{
+			SerializeMeshSections(Ar);
+		}
+	}
+	else
+	{
+		SerializeMeshSections(Ar);
+	}
+
+	if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::SerializationOptional)
+	{		
+		
+		if (bShouldSerializeMeshData || Ar.IsLoading())
+		{
+			// Serialize the real data if we want it, also use this path for loading to get anything that was in the last save
+
+			// Serialize the collision data
+			Ar << MeshCollisionSections;
+			Ar << ConvexCollisionSections;
+		}
+		else
+		{
+			// serialize empty arrays if we don't want serialization
+			TArray<FRuntimeMeshCollisionSection> NullCollisionSections;
+			Ar << NullCollisionSections;
+			TArray<FRuntimeConvexCollisionSection> NullConvexBodies;
+			Ar << NullConvexBodies;
+		}
+	}
+}
+
+void URuntimeMeshComponent::SerializeMeshSections(FArchive& Ar)
+{
 	if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::Initial)
 	{
 		int32 SectionsCount = bShouldSerializeMeshData ? MeshSections.Num() : 0;
@@ -1722,7 +4851,8 @@ void URuntimeMeshComponent::Serialize(FArchive& Ar)
 			bool IsSectionValid = MeshSections[Index].IsValid();
 
 			// WE can only load/save internal types (we don't know how to serialize arbitrary vertex types.
-			if (Ar.IsSaving() && (IsSectionValid && !MeshSections[Index]->bIsInternalSectionType))
+			// Render only sections don't keep their data so they're skipped as well.
+			if (Ar.IsSaving() && (IsSectionValid && (!MeshSections[Index]->bIsInternalSectionType || MeshSections[Index]->bIsRenderOnly)))
 			{
 				IsSectionValid = false;
 			}
@@ -1771,37 +4901,53 @@ void URuntimeMeshComponent::Serialize(FArchive& Ar)
 				FRuntimeMeshSectionInterface& SectionPtr = *MeshSections[Index].Get();
 				Ar << SectionPtr;
 
+				if (Ar.IsLoading())
+				{
+					SectionPtr.UpdateMemoryStats();
+				}
+
 			}
 		}
-	}
 
-	if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::SerializationOptional)
-	{		
-		
-		if (bShouldSerializeMeshData || Ar.IsLoading())
+		// The loaded sections' bounds only arrive after they're created
+		if (Ar.IsLoading())
 		{
-			// Serialize the real data if we want it, also use this path for loading to get anything that was in the last save
-
-			// Serialize the collision data
-			Ar << MeshCollisionSections;
-			Ar << ConvexCollisionSections;
+			RebuildSectionIndices();
 		}
-		else
+	}
+}
+
+void URuntimeMeshComponent::UnpackMeshBulkData()
+{
+	bHasPendingMeshBulkData = false;
+
+	const int32 BulkDataSize = MeshBulkData.GetBulkDataSize();
+	if (BulkDataSize > 0)
+	{
 		{
-			// serialize empty arrays if we don't want serialization
-			TArray<FRuntimeMeshCollisionSection> NullCollisionSections;
-			Ar << NullCollisionSections;
-			TArray<FRuntimeConvexCollisionSection> NullConvexBodies;
-			Ar << NullConvexBodies;
+			FBufferReader Reader(MeshBulkData.Lock(LOCK_READ_ONLY), BulkDataSize, false, true);
+			Reader.SetCustomVersion(FRuntimeMeshVersion::GUID, MeshBulkDataVersion, TEXT("RuntimeMesh"));
+			SerializeMeshSections(Reader);
 		}
+		MeshBulkData.Unlock();
 	}
-}	
+
+	MeshBulkData.RemoveBulkData();
+}
 
 void URuntimeMeshComponent::PostLoad()
 {
 	Super::PostLoad();
 
+	if (bHasPendingMeshBulkData)
+	{
+		UnpackMeshBulkData();
+	}
+
 	// Rebuild collision and local bounds.
+	MarkAllSectionCollisionDirty();
+	MarkAllCollisionSectionsDirty();
+	bSimpleCollisionDirty = true;
 	MarkCollisionDirty();
 	UpdateLocalBounds();
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "RuntimeMeshComponentPluginPrivatePCH.h"
 #include "RuntimeMeshVersion.h"
 #include "RuntimeMeshComponentPlugin.h"
+#include "RuntimeMeshUpdateCommands.h"
 
 
 // Register the custom version with core
@@ -24,13 +25,24 @@ IMPLEMENT_MODULE(FRuntimeMeshComponentPlugin, RuntimeMeshComponent)
 
 void FRuntimeMeshComponentPlugin::StartupModule()
 {
-
+	// FRuntimeMeshInstancedVertexFactory registers when the module loads, which in the Default phase is after the engine's
+	// default materials were loaded. Their shader maps are missing it then, and they're what every material without the
+	// instanced permutation falls back to. Any material loaded later compiles it as usual. Cooked shader maps already have it.
+	if (!FPlatformProperties::RequiresCookedData() && FApp::CanEverRender())
+	{
+		UMaterial* DefaultMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+		if (DefaultMaterial != nullptr)
+		{
+			DefaultMaterial->ForceRecompileForRendering();
+		}
+	}
 }
 
 
 void FRuntimeMeshComponentPlugin::ShutdownModule()
 {
-
+	// Free the pooled command storage
+	FRuntimeMeshCommandAllocator::Trim();
 }
 
 
@@ -140,3 +140,41 @@ void URuntimeMeshLibrary::CreateBoxMesh(FVector BoxRadius, TArray<FVector>& Vert
 	UVs[3] = UVs[7] = UVs[11] = UVs[15] = UVs[19] = UVs[23] = FVector2D(1.f, 0.f);
 }
 
+void URuntimeMeshLibrary::OptimizeMeshTriangles(const TArray<FVector>& Vertices, TArray<int32>& Triangles)
+{
+	if (Triangles.Num() == 0)
+	{
+		return;
+	}
+
+	const FString Error = RuntimeMeshAsyncInternal::ValidateMesh(Vertices.Num(), Vertices.Num(), false, Triangles);
+	if (!Error.IsEmpty())
+	{
+		UE_LOG(RuntimeMeshLog, Warning, TEXT("OptimizeMeshTriangles() - %s Triangles will not be changed."), *Error);
+		return;
+	}
+
+	FRuntimeMeshOptimizer::OptimizeVertexCache(Triangles, Vertices.Num());
+	FRuntimeMeshOptimizer::OptimizeOverdraw(Triangles, reinterpret_cast<const uint8*>(Vertices.GetData()), sizeof(FVector), Vertices.Num());
+}
+
+float URuntimeMeshLibrary::SimplifyMeshTriangles(const TArray<FVector>& Vertices, const TArray<int32>& Triangles, float TriangleRatio, float MaxError, TArray<int32>& OutTriangles)
+{
+	OutTriangles.Reset();
+
+	if (Triangles.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	const FString Error = RuntimeMeshAsyncInternal::ValidateMesh(Vertices.Num(), Vertices.Num(), false, Triangles);
+	if (!Error.IsEmpty())
+	{
+		UE_LOG(RuntimeMeshLog, Warning, TEXT("SimplifyMeshTriangles() - %s Triangles will not be simplified."), *Error);
+		return 0.0f;
+	}
+
+	const int32 TargetIndexCount = FMath::Max(FMath::RoundToInt(Triangles.Num() * TriangleRatio / 3.0f) * 3, 3);
+	return FRuntimeMeshSimplifier::Simplify(reinterpret_cast<const uint8*>(Vertices.GetData()), sizeof(FVector), Vertices.Num(),
+		Triangles, TargetIndexCount, MaxError, OutTriangles);
+}
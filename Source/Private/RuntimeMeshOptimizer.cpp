@@ -0,0 +1,380 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshOptimizer.h"
+
+
+namespace RuntimeMeshOptimizerInternal
+{
+	/* Compressed table of the triangles touching each vertex */
+	struct FVertexTriangles
+	{
+		TArray<int32> Offsets;
+		TArray<int32> Triangles;
+
+		void Build(const TArray<int32>& Indices, int32 NumVertices)
+		{
+			Offsets.SetNumZeroed(NumVertices + 1);
+
+			for (int32 Index : Indices)
+			{
+				check(Index >= 0 && Index < NumVertices);
+				Offsets[Index + 1]++;
+			}
+			for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+			{
+				Offsets[VertexIndex + 1] += Offsets[VertexIndex];
+			}
+
+			TArray<int32> Cursor(Offsets.GetData(), NumVertices);
+			Triangles.SetNumUninitialized(Indices.Num());
+			for (int32 Index = 0; Index < Indices.Num(); Index++)
+			{
+				Triangles[Cursor[Indices[Index]]++] = Index / 3;
+			}
+		}
+
+		int32 Num(int32 VertexIndex) const { return Offsets[VertexIndex + 1] - Offsets[VertexIndex]; }
+		int32 Start(int32 VertexIndex) const { return Offsets[VertexIndex]; }
+		int32 End(int32 VertexIndex) const { return Offsets[VertexIndex + 1]; }
+	};
+
+	/*
+	*	FIFO post transform cache. A vertex is cached while fewer than CacheSize misses have happened since it was last loaded,
+	*	which is tracked with a running timestamp instead of an actual queue.
+	*/
+	struct FVertexCache
+	{
+		TArray<int32> CacheTime;
+		int32 TimeStamp;
+		int32 CacheSize;
+
+		FVertexCache(int32 NumVertices, int32 InCacheSize)
+			: TimeStamp(InCacheSize + 1), CacheSize(InCacheSize)
+		{
+			CacheTime.SetNumZeroed(NumVertices);
+		}
+
+		bool IsCached(int32 VertexIndex) const { return TimeStamp - CacheTime[VertexIndex] <= CacheSize; }
+
+		/* Loads the vertex if needed, returns whether it missed */
+		bool Touch(int32 VertexIndex)
+		{
+			if (IsCached(VertexIndex))
+			{
+				return false;
+			}
+			CacheTime[VertexIndex] = TimeStamp++;
+			return true;
+		}
+	};
+
+	/* Tipsify's choice of the next fanning vertex, the most recently used one that stays in the cache through its remaining triangles */
+	int32 GetNextVertex(const TArray<int32>& Candidates, const TArray<int32>& LiveTriangles, const FVertexCache& Cache,
+		TArray<int32>& DeadEnds, int32& Cursor, int32 NumVertices)
+	{
+		int32 BestVertex = INDEX_NONE;
+		int32 BestPriority = -1;
+
+		for (int32 Candidate : Candidates)
+		{
+			if (LiveTriangles[Candidate] > 0)
+			{
+				int32 Priority = 0;
+				const int32 Age = Cache.TimeStamp - Cache.CacheTime[Candidate];
+				if (Age + 2 * LiveTriangles[Candidate] <= Cache.CacheSize)
+				{
+					Priority = Age;
+				}
+
+				if (Priority > BestPriority)
+				{
+					BestPriority = Priority;
+					BestVertex = Candidate;
+				}
+			}
+		}
+
+		if (BestVertex != INDEX_NONE)
+		{
+			return BestVertex;
+		}
+
+		// Dead end, go back to a recently used vertex that still has triangles
+		while (DeadEnds.Num() > 0)
+		{
+			const int32 VertexIndex = DeadEnds.Pop(false);
+			if (LiveTriangles[VertexIndex] > 0)
+			{
+				return VertexIndex;
+			}
+		}
+
+		// Nothing recent is left, carry on in input order
+		while (Cursor < NumVertices)
+		{
+			if (LiveTriangles[Cursor] > 0)
+			{
+				return Cursor;
+			}
+			Cursor++;
+		}
+
+		return INDEX_NONE;
+	}
+
+	/* Run of consecutive triangles that's kept together when sorting */
+	struct FCluster
+	{
+		int32 FirstTriangle;
+		int32 NumTriangles;
+		float SortKey;
+	};
+
+	FORCEINLINE const FVector& GetPosition(const uint8* FirstPosition, int32 PositionStride, int32 VertexIndex)
+	{
+		return *reinterpret_cast<const FVector*>(FirstPosition + VertexIndex * PositionStride);
+	}
+}
+
+void FRuntimeMeshOptimizer::OptimizeVertexCache(TArray<int32>& Indices, int32 NumVertices, int32 CacheSize)
+{
+	using namespace RuntimeMeshOptimizerInternal;
+
+	check(Indices.Num() % 3 == 0);
+	check(CacheSize >= 3);
+
+	const int32 NumTriangles = Indices.Num() / 3;
+	if (NumTriangles <= 1 || NumVertices <= 0)
+	{
+		return;
+	}
+
+	FVertexTriangles VertexTriangles;
+	VertexTriangles.Build(Indices, NumVertices);
+
+	TArray<int32> LiveTriangles;
+	LiveTriangles.SetNumUninitialized(NumVertices);
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+	{
+		LiveTriangles[VertexIndex] = VertexTriangles.Num(VertexIndex);
+	}
+
+	TBitArray<> Emitted(false, NumTriangles);
+	FVertexCache Cache(NumVertices, CacheSize);
+
+	TArray<int32> DeadEnds;
+	DeadEnds.Reserve(Indices.Num());
+
+	TArray<int32> Candidates;
+	Candidates.Reserve(64);
+
+	TArray<int32> Result;
+	Result.Reserve(Indices.Num());
+
+	int32 Cursor = 0;
+	int32 FanVertex = GetNextVertex(Candidates, LiveTriangles, Cache, DeadEnds, Cursor, NumVertices);
+
+	while (FanVertex != INDEX_NONE)
+	{
+		Candidates.Reset();
+
+		// Emit every remaining triangle around the fanning vertex
+		for (int32 Entry = VertexTriangles.Start(FanVertex); Entry < VertexTriangles.End(FanVertex); Entry++)
+		{
+			const int32 Triangle = VertexTriangles.Triangles[Entry];
+			if (Emitted[Triangle])
+			{
+				continue;
+			}
+			Emitted[Triangle] = true;
+
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				const int32 VertexIndex = Indices[Triangle * 3 + Corner];
+				Result.Add(VertexIndex);
+				DeadEnds.Add(VertexIndex);
+				Candidates.Add(VertexIndex);
+				LiveTriangles[VertexIndex]--;
+				Cache.Touch(VertexIndex);
+			}
+		}
+
+		FanVertex = GetNextVertex(Candidates, LiveTriangles, Cache, DeadEnds, Cursor, NumVertices);
+	}
+
+	check(Result.Num() == Indices.Num());
+	Indices = MoveTemp(Result);
+}
+
+void FRuntimeMeshOptimizer::OptimizeOverdraw(TArray<int32>& Indices, const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, float Threshold, int32 CacheSize)
+{
+	using namespace RuntimeMeshOptimizerInternal;
+
+	check(Indices.Num() % 3 == 0);
+	check(FirstPosition != nullptr || Indices.Num() == 0);
+
+	const int32 NumTriangles = Indices.Num() / 3;
+	if (NumTriangles <= 1 || NumVertices <= 0)
+	{
+		return;
+	}
+
+	// Misses per triangle in the current order
+	TArray<uint8> Misses;
+	Misses.SetNumUninitialized(NumTriangles);
+	{
+		FVertexCache Cache(NumVertices, CacheSize);
+		for (int32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+		{
+			check(Indices[Triangle * 3] < NumVertices && Indices[Triangle * 3 + 1] < NumVertices && Indices[Triangle * 3 + 2] < NumVertices);
+			Misses[Triangle] = (uint8)Cache.Touch(Indices[Triangle * 3]) + (uint8)Cache.Touch(Indices[Triangle * 3 + 1]) + (uint8)Cache.Touch(Indices[Triangle * 3 + 2]);
+		}
+	}
+
+	// Hard boundaries are where all three corners missed, so the cache had already moved on and reordering there costs nothing extra.
+	// Each hard cluster is then split further wherever its running miss rate has got back down near the cluster's own rate.
+	TArray<FCluster> Clusters;
+	int32 HardStart = 0;
+	while (HardStart < NumTriangles)
+	{
+		int32 HardEnd = HardStart + 1;
+		int32 HardMisses = Misses[HardStart];
+		while (HardEnd < NumTriangles && Misses[HardEnd] < 3)
+		{
+			HardMisses += Misses[HardEnd];
+			HardEnd++;
+		}
+
+		const float HardACMR = (float)HardMisses / (HardEnd - HardStart);
+
+		int32 SoftStart = HardStart;
+		int32 SoftMisses = 0;
+		for (int32 Triangle = HardStart; Triangle < HardEnd; Triangle++)
+		{
+			if (Triangle > SoftStart && Misses[Triangle] >= 2 && SoftMisses <= Threshold * HardACMR * (Triangle - SoftStart))
+			{
+				Clusters.Add(FCluster{ SoftStart, Triangle - SoftStart, 0.0f });
+				SoftStart = Triangle;
+				SoftMisses = 0;
+			}
+			SoftMisses += Misses[Triangle];
+		}
+		Clusters.Add(FCluster{ SoftStart, HardEnd - SoftStart, 0.0f });
+
+		HardStart = HardEnd;
+	}
+
+	if (Clusters.Num() <= 1)
+	{
+		return;
+	}
+
+	// Area weighted centroid and normal of each cluster, and of the whole mesh
+	TArray<FVector> ClusterCentroids;
+	TArray<FVector> ClusterNormals;
+	ClusterCentroids.SetNumZeroed(Clusters.Num());
+	ClusterNormals.SetNumZeroed(Clusters.Num());
+
+	FVector MeshCentroid = FVector::ZeroVector;
+	float MeshArea = 0.0f;
+
+	for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ClusterIndex++)
+	{
+		const FCluster& Cluster = Clusters[ClusterIndex];
+		float ClusterArea = 0.0f;
+
+		for (int32 Triangle = Cluster.FirstTriangle; Triangle < Cluster.FirstTriangle + Cluster.NumTriangles; Triangle++)
+		{
+			const FVector& P0 = GetPosition(FirstPosition, PositionStride, Indices[Triangle * 3]);
+			const FVector& P1 = GetPosition(FirstPosition, PositionStride, Indices[Triangle * 3 + 1]);
+			const FVector& P2 = GetPosition(FirstPosition, PositionStride, Indices[Triangle * 3 + 2]);
+
+			// Same winding as the tangent calculation, length is twice the area
+			const FVector Normal = (P2 - P0) ^ (P1 - P0);
+			const float Area = Normal.Size();
+
+			ClusterCentroids[ClusterIndex] += (P0 + P1 + P2) * (Area / 3.0f);
+			ClusterNormals[ClusterIndex] += Normal;
+			ClusterArea += Area;
+		}
+
+		MeshCentroid += ClusterCentroids[ClusterIndex];
+		MeshArea += ClusterArea;
+
+		ClusterCentroids[ClusterIndex] = ClusterArea > SMALL_NUMBER ? ClusterCentroids[ClusterIndex] / ClusterArea : FVector::ZeroVector;
+	}
+
+	if (MeshArea <= SMALL_NUMBER)
+	{
+		return;
+	}
+	MeshCentroid /= MeshArea;
+
+	// Clusters facing away from the middle of the mesh are the likeliest to occlude the rest, so they go first
+	for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ClusterIndex++)
+	{
+		Clusters[ClusterIndex].SortKey = FVector::DotProduct(ClusterCentroids[ClusterIndex] - MeshCentroid, ClusterNormals[ClusterIndex].GetSafeNormal());
+	}
+
+	Clusters.StableSort([](const FCluster& A, const FCluster& B) { return A.SortKey > B.SortKey; });
+
+	TArray<int32> Result;
+	Result.Reserve(Indices.Num());
+	for (const FCluster& Cluster : Clusters)
+	{
+		Result.Append(Indices.GetData() + Cluster.FirstTriangle * 3, Cluster.NumTriangles * 3);
+	}
+	Indices = MoveTemp(Result);
+}
+
+void FRuntimeMeshOptimizer::BuildVertexFetchRemap(const TArray<int32>& Indices, int32 NumVertices, TArray<int32>& OutRemap)
+{
+	OutRemap.Init(INDEX_NONE, NumVertices);
+
+	int32 NextVertex = 0;
+	for (int32 Index : Indices)
+	{
+		check(Index >= 0 && Index < NumVertices);
+		if (OutRemap[Index] == INDEX_NONE)
+		{
+			OutRemap[Index] = NextVertex++;
+		}
+	}
+
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+	{
+		if (OutRemap[VertexIndex] == INDEX_NONE)
+		{
+			OutRemap[VertexIndex] = NextVertex++;
+		}
+	}
+}
+
+void FRuntimeMeshOptimizer::RemapIndices(TArray<int32>& Indices, const TArray<int32>& Remap)
+{
+	for (int32& Index : Indices)
+	{
+		Index = Remap[Index];
+	}
+}
+
+float FRuntimeMeshOptimizer::ComputeACMR(const TArray<int32>& Indices, int32 NumVertices, int32 CacheSize)
+{
+	using namespace RuntimeMeshOptimizerInternal;
+
+	const int32 NumTriangles = Indices.Num() / 3;
+	if (NumTriangles == 0)
+	{
+		return 0.0f;
+	}
+
+	FVertexCache Cache(NumVertices, CacheSize);
+	int32 NumMisses = 0;
+	for (int32 Index : Indices)
+	{
+		NumMisses += Cache.Touch(Index) ? 1 : 0;
+	}
+
+	return (float)NumMisses / NumTriangles;
+}
@@ -0,0 +1,196 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshRendering.h"
+
+
+static TAutoConsoleVariable<float> CVarRuntimeMeshBufferGrowthFactor(
+	TEXT("RuntimeMesh.BufferGrowthFactor"),
+	1.5f,
+	TEXT("How much larger than needed a vertex/index buffer is allocated when it has to grow. 1 allocates the exact size."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRuntimeMeshBufferShrinkThreshold(
+	TEXT("RuntimeMesh.BufferShrinkThreshold"),
+	0.5f,
+	TEXT("A vertex/index buffer is only reallocated smaller once less than this fraction of it is in use. 0 never shrinks buffers, 1 always does."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRuntimeMeshStreamingBufferCount(
+	TEXT("RuntimeMesh.StreamingBufferCount"),
+	1,
+	TEXT("Number of copies of each buffer Frequent sections cycle through so uploads don't wait on the GPU. Each copy costs the full buffer size in GPU memory. ")
+	TEXT("Buffers that receive range updates always keep a single copy. Only applies to buffers created after it's changed."),
+	ECVF_Default);
+
+
+int32 FRuntimeMeshBufferSizing::GetCapacity(int32 CurrentCapacity, int32 NewCount)
+{
+	// First allocation is exact, most sections are never resized
+	if (CurrentCapacity == 0)
+	{
+		return NewCount;
+	}
+
+	if (NewCount > CurrentCapacity)
+	{
+		const float GrowthFactor = FMath::Max(CVarRuntimeMeshBufferGrowthFactor.GetValueOnAnyThread(), 1.0f);
+		return FMath::Max(NewCount, FMath::CeilToInt(CurrentCapacity * GrowthFactor));
+	}
+
+	const float ShrinkThreshold = FMath::Clamp(CVarRuntimeMeshBufferShrinkThreshold.GetValueOnAnyThread(), 0.0f, 1.0f);
+	if (NewCount < CurrentCapacity * ShrinkThreshold)
+	{
+		return NewCount;
+	}
+
+	return CurrentCapacity;
+}
+
+int32 FRuntimeMeshBufferSizing::GetStreamingBufferCount()
+{
+	return FMath::Clamp(CVarRuntimeMeshStreamingBufferCount.GetValueOnAnyThread(), 1, RUNTIMEMESH_MAX_STREAMING_BUFFER_COUNT);
+}
+
+
+FThreadSafeCounter64 FRuntimeMeshUploadStats::TotalBytesUploaded;
+
+
+/* Parameters for the instancing path of the local vertex factory shader. Instances are always fully shown, there's no distance fading or LOD dithering */
+class FRuntimeMeshInstancedVertexFactoryShaderParameters : public FVertexFactoryShaderParameters
+{
+public:
+	virtual void Bind(const FShaderParameterMap& ParameterMap) override
+	{
+		InstancingFadeOutParamsParameter.Bind(ParameterMap, TEXT("InstancingFadeOutParams"));
+		InstancingViewZCompareZeroParameter.Bind(ParameterMap, TEXT("InstancingViewZCompareZero"));
+		InstancingViewZCompareOneParameter.Bind(ParameterMap, TEXT("InstancingViewZCompareOne"));
+		InstancingViewZConstantParameter.Bind(ParameterMap, TEXT("InstancingViewZConstant"));
+		InstancingWorldViewOriginZeroParameter.Bind(ParameterMap, TEXT("InstancingWorldViewOriginZero"));
+		InstancingWorldViewOriginOneParameter.Bind(ParameterMap, TEXT("InstancingWorldViewOriginOne"));
+	}
+
+	virtual void Serialize(FArchive& Ar) override
+	{
+		Ar << InstancingFadeOutParamsParameter;
+		Ar << InstancingViewZCompareZeroParameter;
+		Ar << InstancingViewZCompareOneParameter;
+		Ar << InstancingViewZConstantParameter;
+		Ar << InstancingWorldViewOriginZeroParameter;
+		Ar << InstancingWorldViewOriginOneParameter;
+	}
+
+	virtual void SetMesh(FRHICommandList& RHICmdList, FShader* VertexShader, const class FVertexFactory* VertexFactory, const class FSceneView& View, const struct FMeshBatchElement& BatchElement, uint32 DataFlags) const override
+	{
+		FVertexShaderRHIParamRef VertexShaderRHI = VertexShader->GetVertexShader();
+
+		// Fade distance that's never reached, and every instance visible
+		SetShaderValue(RHICmdList, VertexShaderRHI, InstancingFadeOutParamsParameter, FVector4(MAX_flt, 0.0f, 1.0f, 1.0f));
+
+		// LOD transition ranges that always resolve to fully shown
+		SetShaderValue(RHICmdList, VertexShaderRHI, InstancingViewZCompareZeroParameter, FVector4(MIN_flt, MIN_flt, MAX_flt, 1.0f));
+		SetShaderValue(RHICmdList, VertexShaderRHI, InstancingViewZCompareOneParameter, FVector4(MIN_flt, MIN_flt, MAX_flt, 0.0f));
+		SetShaderValue(RHICmdList, VertexShaderRHI, InstancingViewZConstantParameter, FVector4(0.0f, 0.0f, 0.0f, 0.0f));
+		SetShaderValue(RHICmdList, VertexShaderRHI, InstancingWorldViewOriginZeroParameter, FVector4(0.0f, 0.0f, 0.0f, 0.0f));
+		SetShaderValue(RHICmdList, VertexShaderRHI, InstancingWorldViewOriginOneParameter, FVector4(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	virtual uint32 GetSize() const override { return sizeof(*this); }
+
+private:
+	FShaderParameter InstancingFadeOutParamsParameter;
+	FShaderParameter InstancingViewZCompareZeroParameter;
+	FShaderParameter InstancingViewZCompareOneParameter;
+	FShaderParameter InstancingViewZConstantParameter;
+	FShaderParameter InstancingWorldViewOriginZeroParameter;
+	FShaderParameter InstancingWorldViewOriginOneParameter;
+};
+
+
+bool FRuntimeMeshInstancedVertexFactory::ShouldCache(EShaderPlatform Platform, const class FMaterial* Material, const class FShaderType* ShaderType)
+{
+	// Hardware instancing needs SM4, and only materials flagged for instancing get the permutation
+	return IsFeatureLevelSupported(Platform, ERHIFeatureLevel::SM4)
+		&& (Material->IsUsedWithInstancedStaticMeshes() || Material->IsSpecialEngineMaterial())
+		&& FLocalVertexFactory::ShouldCache(Platform, Material, ShaderType);
+}
+
+void FRuntimeMeshInstancedVertexFactory::ModifyCompilationEnvironment(EShaderPlatform Platform, const FMaterial* Material, FShaderCompilerEnvironment& OutEnvironment)
+{
+	OutEnvironment.SetDefine(TEXT("USE_INSTANCING"), TEXT("1"));
+	OutEnvironment.SetDefine(TEXT("USE_DITHERED_LOD_TRANSITION_FOR_INSTANCED"), TEXT("0"));
+	FLocalVertexFactory::ModifyCompilationEnvironment(Platform, Material, OutEnvironment);
+}
+
+FVertexFactoryShaderParameters* FRuntimeMeshInstancedVertexFactory::ConstructShaderParameters(EShaderFrequency ShaderFrequency)
+{
+	return ShaderFrequency == SF_Vertex ? new FRuntimeMeshInstancedVertexFactoryShaderParameters() : nullptr;
+}
+
+void FRuntimeMeshInstancedVertexFactory::InitRHI()
+{
+	FVertexDeclarationElementList Elements;
+
+	// Section vertex streams, at the same attributes the local vertex factory uses
+	if (InstancedData.PositionComponent.VertexBuffer != nullptr)
+	{
+		Elements.Add(AccessStreamComponent(InstancedData.PositionComponent, 0));
+	}
+
+	// Only tangent X and Z are stored, Y is derived in the shader
+	const uint8 TangentBasisAttributes[2] = { 1, 2 };
+	for (int32 AxisIndex = 0; AxisIndex < 2; AxisIndex++)
+	{
+		if (InstancedData.TangentBasisComponents[AxisIndex].VertexBuffer != nullptr)
+		{
+			Elements.Add(AccessStreamComponent(InstancedData.TangentBasisComponents[AxisIndex], TangentBasisAttributes[AxisIndex]));
+		}
+	}
+
+	if (InstancedData.ColorComponent.VertexBuffer != nullptr)
+	{
+		Elements.Add(AccessStreamComponent(InstancedData.ColorComponent, 3));
+	}
+	else
+	{
+		// Vertex types without color read white from the engine's null color buffer
+		FVertexStreamComponent NullColorComponent(&GNullColorVertexBuffer, 0, 0, VET_Color);
+		Elements.Add(AccessStreamComponent(NullColorComponent, 3));
+	}
+
+	if (InstancedData.TextureCoordinates.Num())
+	{
+		const int32 BaseTexCoordAttribute = 4;
+		for (int32 CoordinateIndex = 0; CoordinateIndex < InstancedData.TextureCoordinates.Num(); CoordinateIndex++)
+		{
+			Elements.Add(AccessStreamComponent(InstancedData.TextureCoordinates[CoordinateIndex], BaseTexCoordAttribute + CoordinateIndex));
+		}
+
+		// Texture coordinates fill attributes 4 to 7, 8 and up belong to the instance stream
+		for (int32 CoordinateIndex = InstancedData.TextureCoordinates.Num(); CoordinateIndex < 4; CoordinateIndex++)
+		{
+			Elements.Add(AccessStreamComponent(InstancedData.TextureCoordinates[InstancedData.TextureCoordinates.Num() - 1], BaseTexCoordAttribute + CoordinateIndex));
+		}
+	}
+
+	if (InstancedData.LightMapCoordinateComponent.VertexBuffer != nullptr)
+	{
+		Elements.Add(AccessStreamComponent(InstancedData.LightMapCoordinateComponent, 15));
+	}
+	else if (InstancedData.TextureCoordinates.Num())
+	{
+		Elements.Add(AccessStreamComponent(InstancedData.TextureCoordinates[0], 15));
+	}
+
+	// Per instance streams, at the attributes the instancing shader reads them from
+	Elements.Add(AccessStreamComponent(InstancedData.InstanceOriginComponent, 8));
+	for (int32 RowIndex = 0; RowIndex < 3; RowIndex++)
+	{
+		Elements.Add(AccessStreamComponent(InstancedData.InstanceTransformComponent[RowIndex], 9 + RowIndex));
+	}
+	Elements.Add(AccessStreamComponent(InstancedData.InstanceLightmapAndShadowMapUVBiasComponent, 12));
+
+	InitDeclaration(Elements);
+}
+
+IMPLEMENT_VERTEX_FACTORY_TYPE(FRuntimeMeshInstancedVertexFactory, "LocalVertexFactory", true, false, true, true, false);
@@ -0,0 +1,93 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshSharedData.h"
+
+
+FRuntimeMeshSharedData::FRuntimeMeshSharedData(URuntimeMeshComponent* InSource)
+	: Source(InSource), BodySetup(nullptr), LocalBounds(0)
+{
+	check(IsInGameThread());
+}
+
+int32 FRuntimeMeshSharedData::GetNumUsers() const
+{
+	int32 NumUsers = 0;
+	for (const TWeakObjectPtr<URuntimeMeshComponent>& User : Users)
+	{
+		if (User.IsValid())
+		{
+			NumUsers++;
+		}
+	}
+	return NumUsers;
+}
+
+void FRuntimeMeshSharedData::PublishRenderData(const TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe>& InRenderData, const TArray<UMaterialInterface*>& InMaterials)
+{
+	check(IsInGameThread());
+
+	RenderData = InRenderData;
+	Materials = InMaterials;
+
+	// The users' proxies hold on to the old buffers until they're recreated
+	for (const TWeakObjectPtr<URuntimeMeshComponent>& User : Users)
+	{
+		if (User.IsValid())
+		{
+			User->MarkRenderStateDirty();
+		}
+	}
+}
+
+void FRuntimeMeshSharedData::PublishBounds(const FBox& InLocalBounds)
+{
+	check(IsInGameThread());
+
+	LocalBounds = InLocalBounds;
+
+	for (const TWeakObjectPtr<URuntimeMeshComponent>& User : Users)
+	{
+		if (User.IsValid())
+		{
+			User->UpdateBounds();
+			User->MarkRenderTransformDirty();
+		}
+	}
+}
+
+void FRuntimeMeshSharedData::PublishBodySetup(UBodySetup* InBodySetup)
+{
+	check(IsInGameThread());
+
+	BodySetup = InBodySetup;
+
+	for (const TWeakObjectPtr<URuntimeMeshComponent>& User : Users)
+	{
+		if (User.IsValid() && User->IsPhysicsStateCreated())
+		{
+			User->RecreatePhysicsState();
+		}
+	}
+}
+
+void FRuntimeMeshSharedData::AddUser(URuntimeMeshComponent* User)
+{
+	check(IsInGameThread());
+
+	Users.RemoveAll([](const TWeakObjectPtr<URuntimeMeshComponent>& Existing) { return !Existing.IsValid(); });
+	Users.AddUnique(User);
+}
+
+void FRuntimeMeshSharedData::RemoveUser(URuntimeMeshComponent* User)
+{
+	check(IsInGameThread());
+
+	Users.RemoveAll([User](const TWeakObjectPtr<URuntimeMeshComponent>& Existing) { return !Existing.IsValid() || Existing.Get() == User; });
+}
+
+void FRuntimeMeshSharedData::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(Materials);
+	Collector.AddReferencedObject(BodySetup);
+}
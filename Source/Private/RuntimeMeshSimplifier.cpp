@@ -0,0 +1,386 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshSimplifier.h"
+
+
+namespace RuntimeMeshSimplifierInternal
+{
+	/* Sum of squared distances to a set of planes, weighted by the area of the triangle each plane came from */
+	struct FQuadric
+	{
+		double XX, YY, ZZ, XY, XZ, YZ, DX, DY, DZ, DD;
+		double Weight;
+
+		FQuadric()
+			: XX(0), YY(0), ZZ(0), XY(0), XZ(0), YZ(0), DX(0), DY(0), DZ(0), DD(0), Weight(0)
+		{ }
+
+		void AddPlane(const FVector& Normal, float Distance, float Area)
+		{
+			const double X = Normal.X, Y = Normal.Y, Z = Normal.Z, D = Distance;
+			XX += Area * X * X; YY += Area * Y * Y; ZZ += Area * Z * Z;
+			XY += Area * X * Y; XZ += Area * X * Z; YZ += Area * Y * Z;
+			DX += Area * D * X; DY += Area * D * Y; DZ += Area * D * Z;
+			DD += Area * D * D;
+			Weight += Area;
+		}
+
+		FQuadric& operator+=(const FQuadric& Other)
+		{
+			XX += Other.XX; YY += Other.YY; ZZ += Other.ZZ;
+			XY += Other.XY; XZ += Other.XZ; YZ += Other.YZ;
+			DX += Other.DX; DY += Other.DY; DZ += Other.DZ;
+			DD += Other.DD;
+			Weight += Other.Weight;
+			return *this;
+		}
+
+		/* Area weighted mean squared distance from P to the planes */
+		double Evaluate(const FVector& P) const
+		{
+			const double X = P.X, Y = P.Y, Z = P.Z;
+			const double Sum =
+				XX * X * X + YY * Y * Y + ZZ * Z * Z +
+				2.0 * (XY * X * Y + XZ * X * Z + YZ * Y * Z) +
+				2.0 * (DX * X + DY * Y + DZ * Z) +
+				DD;
+			return Weight > 0.0 ? FMath::Max(Sum, 0.0) / Weight : 0.0;
+		}
+	};
+
+	/* Collapse of the vertex From onto the vertex To */
+	struct FCollapse
+	{
+		int32 From;
+		int32 To;
+		float Error;
+
+		bool operator<(const FCollapse& Other) const { return Error < Other.Error; }
+	};
+
+	/* Compressed table of the triangles touching each vertex */
+	struct FVertexTriangles
+	{
+		TArray<int32> Offsets;
+		TArray<int32> Triangles;
+
+		void Build(const TArray<int32>& Indices, int32 NumVertices)
+		{
+			Offsets.Reset();
+			Offsets.SetNumZeroed(NumVertices + 1);
+
+			for (int32 Index : Indices)
+			{
+				Offsets[Index + 1]++;
+			}
+			for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+			{
+				Offsets[VertexIndex + 1] += Offsets[VertexIndex];
+			}
+
+			TArray<int32> Cursor(Offsets.GetData(), NumVertices);
+			Triangles.SetNumUninitialized(Indices.Num());
+			for (int32 Index = 0; Index < Indices.Num(); Index++)
+			{
+				Triangles[Cursor[Indices[Index]]++] = Index / 3;
+			}
+		}
+
+		int32 Start(int32 VertexIndex) const { return Offsets[VertexIndex]; }
+		int32 End(int32 VertexIndex) const { return Offsets[VertexIndex + 1]; }
+	};
+
+	FORCEINLINE uint64 MakeEdgeKey(int32 A, int32 B)
+	{
+		return A < B ? ((uint64)A << 32) | (uint32)B : ((uint64)B << 32) | (uint32)A;
+	}
+
+	/* Vertices that can't move: ones sharing a position with another vertex (seams), and ones on open or non manifold edges */
+	void FindLockedVertices(const TArray<FVector>& Positions, const TArray<int32>& Indices, TBitArray<>& OutLocked)
+	{
+		const int32 NumVertices = Positions.Num();
+
+		// Vertices at the same position share the first one's id
+		TArray<int32> WeldIds;
+		WeldIds.SetNumUninitialized(NumVertices);
+		TArray<int32> GroupSizes;
+		GroupSizes.SetNumZeroed(NumVertices);
+		{
+			TMap<FVector, int32> Groups;
+			Groups.Reserve(NumVertices);
+			for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+			{
+				WeldIds[VertexIndex] = Groups.FindOrAdd(Positions[VertexIndex], VertexIndex);
+				GroupSizes[WeldIds[VertexIndex]]++;
+			}
+		}
+
+		TBitArray<> LockedGroups(false, NumVertices);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			if (GroupSizes[WeldIds[VertexIndex]] > 1)
+			{
+				LockedGroups[WeldIds[VertexIndex]] = true;
+			}
+		}
+
+		// Edges are counted across seams, so only real borders count as open
+		TMap<uint64, int32> EdgeCounts;
+		EdgeCounts.Reserve(Indices.Num());
+		for (int32 Index = 0; Index < Indices.Num(); Index += 3)
+		{
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				const int32 A = WeldIds[Indices[Index + Corner]];
+				const int32 B = WeldIds[Indices[Index + (Corner + 1) % 3]];
+				EdgeCounts.FindOrAdd(MakeEdgeKey(A, B))++;
+			}
+		}
+		for (const auto& Edge : EdgeCounts)
+		{
+			if (Edge.Value != 2)
+			{
+				LockedGroups[(int32)(Edge.Key >> 32)] = true;
+				LockedGroups[(int32)(Edge.Key & 0xFFFFFFFF)] = true;
+			}
+		}
+
+		OutLocked.Init(false, NumVertices);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			OutLocked[VertexIndex] = LockedGroups[WeldIds[VertexIndex]];
+		}
+	}
+
+	/* Drops triangles that have collapsed to a line or point */
+	void RemoveDegenerateTriangles(TArray<int32>& Indices)
+	{
+		int32 WriteIndex = 0;
+		for (int32 Index = 0; Index < Indices.Num(); Index += 3)
+		{
+			const int32 A = Indices[Index], B = Indices[Index + 1], C = Indices[Index + 2];
+			if (A != B && B != C && A != C)
+			{
+				Indices[WriteIndex++] = A;
+				Indices[WriteIndex++] = B;
+				Indices[WriteIndex++] = C;
+			}
+		}
+		Indices.SetNum(WriteIndex, false);
+	}
+}
+
+float FRuntimeMeshSimplifier::Simplify(const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, const TArray<int32>& Indices,
+	int32 TargetIndexCount, float TargetError, TArray<int32>& OutIndices)
+{
+	using namespace RuntimeMeshSimplifierInternal;
+
+	check(Indices.Num() % 3 == 0);
+
+	OutIndices = Indices;
+	if (NumVertices == 0 || OutIndices.Num() <= TargetIndexCount)
+	{
+		return 0.0f;
+	}
+
+	// Work in a unit cube so errors are relative to the mesh size
+	FBox Bounds(0);
+	TArray<FVector> Positions;
+	Positions.SetNumUninitialized(NumVertices);
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+	{
+		Positions[VertexIndex] = *reinterpret_cast<const FVector*>(FirstPosition + VertexIndex * PositionStride);
+		Bounds += Positions[VertexIndex];
+	}
+
+	const float Extent = Bounds.GetSize().GetMax();
+	if (Extent <= SMALL_NUMBER)
+	{
+		return 0.0f;
+	}
+
+	TBitArray<> Locked;
+	FindLockedVertices(Positions, OutIndices, Locked);
+
+	const float InvExtent = 1.0f / Extent;
+	for (FVector& Position : Positions)
+	{
+		Position = (Position - Bounds.Min) * InvExtent;
+	}
+
+	TArray<FQuadric> Quadrics;
+	Quadrics.SetNum(NumVertices);
+	for (int32 Index = 0; Index < OutIndices.Num(); Index += 3)
+	{
+		check(OutIndices[Index] < NumVertices && OutIndices[Index + 1] < NumVertices && OutIndices[Index + 2] < NumVertices);
+
+		const FVector& P0 = Positions[OutIndices[Index]];
+		const FVector& P1 = Positions[OutIndices[Index + 1]];
+		const FVector& P2 = Positions[OutIndices[Index + 2]];
+
+		FVector Normal = (P2 - P0) ^ (P1 - P0);
+		const float Area = Normal.Size() * 0.5f;
+		if (Area <= 0.0f)
+		{
+			continue;
+		}
+		Normal /= Area * 2.0f;
+
+		const float Distance = -FVector::DotProduct(Normal, P0);
+		for (int32 Corner = 0; Corner < 3; Corner++)
+		{
+			Quadrics[OutIndices[Index + Corner]].AddPlane(Normal, Distance, Area);
+		}
+	}
+
+	const double MaxErrorSquared = (double)TargetError * TargetError;
+	double ReachedErrorSquared = 0.0;
+
+	FVertexTriangles VertexTriangles;
+	TArray<FCollapse> Collapses;
+	TArray<int32> Remap;
+	TBitArray<> Touched;
+
+	// Each pass does as many independent collapses as it can, cheapest first, then rebuilds the triangles
+	while (OutIndices.Num() > TargetIndexCount)
+	{
+		VertexTriangles.Build(OutIndices, NumVertices);
+
+		Collapses.Reset();
+		for (int32 Index = 0; Index < OutIndices.Num(); Index += 3)
+		{
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				const int32 A = OutIndices[Index + Corner];
+				const int32 B = OutIndices[Index + (Corner + 1) % 3];
+
+				for (int32 Direction = 0; Direction < 2; Direction++)
+				{
+					const int32 From = Direction == 0 ? A : B;
+					const int32 To = Direction == 0 ? B : A;
+					if (Locked[From])
+					{
+						continue;
+					}
+
+					FQuadric Combined = Quadrics[From];
+					Combined += Quadrics[To];
+
+					const double ErrorSquared = Combined.Evaluate(Positions[To]);
+					if (ErrorSquared <= MaxErrorSquared)
+					{
+						Collapses.Add(FCollapse{ From, To, (float)ErrorSquared });
+					}
+				}
+			}
+		}
+
+		if (Collapses.Num() == 0)
+		{
+			break;
+		}
+		Collapses.Sort();
+
+		Remap.SetNumUninitialized(NumVertices);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			Remap[VertexIndex] = VertexIndex;
+		}
+		Touched.Init(false, NumVertices);
+
+		const int32 TrianglesToRemove = (OutIndices.Num() - TargetIndexCount) / 3;
+		int32 TrianglesRemoved = 0;
+
+		for (const FCollapse& Collapse : Collapses)
+		{
+			if (TrianglesRemoved >= TrianglesToRemove)
+			{
+				break;
+			}
+
+			// Everything around From is left alone for the rest of the pass, so the checks below stay valid
+			if (Touched[Collapse.From] || Touched[Collapse.To])
+			{
+				continue;
+			}
+
+			// Moving From onto To mustn't flip or flatten any of the triangles that survive
+			bool bIsValid = true;
+			int32 NumCollapsed = 0;
+			for (int32 Entry = VertexTriangles.Start(Collapse.From); Entry < VertexTriangles.End(Collapse.From) && bIsValid; Entry++)
+			{
+				const int32* Corners = &OutIndices[VertexTriangles.Triangles[Entry] * 3];
+				if (Corners[0] == Collapse.To || Corners[1] == Collapse.To || Corners[2] == Collapse.To)
+				{
+					NumCollapsed++;
+					continue;
+				}
+
+				const FVector& P0 = Positions[Corners[0]];
+				const FVector& P1 = Positions[Corners[1]];
+				const FVector& P2 = Positions[Corners[2]];
+				const FVector& NewP0 = Corners[0] == Collapse.From ? Positions[Collapse.To] : P0;
+				const FVector& NewP1 = Corners[1] == Collapse.From ? Positions[Collapse.To] : P1;
+				const FVector& NewP2 = Corners[2] == Collapse.From ? Positions[Collapse.To] : P2;
+
+				const FVector OldNormal = (P2 - P0) ^ (P1 - P0);
+				const FVector NewNormal = (NewP2 - NewP0) ^ (NewP1 - NewP0);
+				bIsValid = FVector::DotProduct(OldNormal, NewNormal) > 0.0f;
+			}
+
+			if (!bIsValid || NumCollapsed == 0)
+			{
+				continue;
+			}
+
+			Remap[Collapse.From] = Collapse.To;
+			Quadrics[Collapse.To] += Quadrics[Collapse.From];
+			ReachedErrorSquared = FMath::Max(ReachedErrorSquared, (double)Collapse.Error);
+			TrianglesRemoved += NumCollapsed;
+
+			Touched[Collapse.To] = true;
+			for (int32 Entry = VertexTriangles.Start(Collapse.From); Entry < VertexTriangles.End(Collapse.From); Entry++)
+			{
+				const int32* Corners = &OutIndices[VertexTriangles.Triangles[Entry] * 3];
+				Touched[Corners[0]] = true;
+				Touched[Corners[1]] = true;
+				Touched[Corners[2]] = true;
+			}
+		}
+
+		if (TrianglesRemoved == 0)
+		{
+			break;
+		}
+
+		for (int32& Index : OutIndices)
+		{
+			Index = Remap[Index];
+		}
+		RemoveDegenerateTriangles(OutIndices);
+	}
+
+	return (float)FMath::Sqrt(ReachedErrorSquared);
+}
+
+void FRuntimeMeshSimplifier::CompactMesh(const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, const TArray<int32>& Indices,
+	TArray<FVector>& OutPositions, TArray<int32>& OutIndices)
+{
+	TArray<int32> Remap;
+	Remap.Init(INDEX_NONE, NumVertices);
+
+	OutPositions.Reset();
+	OutIndices.SetNumUninitialized(Indices.Num());
+	for (int32 Index = 0; Index < Indices.Num(); Index++)
+	{
+		const int32 VertexIndex = Indices[Index];
+		check(VertexIndex >= 0 && VertexIndex < NumVertices);
+
+		if (Remap[VertexIndex] == INDEX_NONE)
+		{
+			Remap[VertexIndex] = OutPositions.Add(*reinterpret_cast<const FVector*>(FirstPosition + VertexIndex * PositionStride));
+		}
+		OutIndices[Index] = Remap[VertexIndex];
+	}
+}
@@ -0,0 +1,330 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshTangents.h"
+
+
+namespace RuntimeMeshTangentsInternal
+{
+	/* Compressed table of the triangles touching each key (vertex or weld group) */
+	struct FAdjacency
+	{
+		TArray<int32> Offsets;
+		TArray<int32> Triangles;
+
+		void Build(const TArray<int32>& Indices, const TArray<int32>& Keys)
+		{
+			const int32 NumKeys = Keys.Num();
+			Offsets.SetNumZeroed(NumKeys + 1);
+
+			for (int32 Index : Indices)
+			{
+				Offsets[Keys[Index] + 1]++;
+			}
+			for (int32 Key = 0; Key < NumKeys; Key++)
+			{
+				Offsets[Key + 1] += Offsets[Key];
+			}
+
+			TArray<int32> Cursor(Offsets.GetData(), NumKeys);
+			Triangles.SetNumUninitialized(Indices.Num());
+			for (int32 Index = 0; Index < Indices.Num(); Index++)
+			{
+				Triangles[Cursor[Keys[Indices[Index]]]++] = Index / 3;
+			}
+		}
+
+		int32 Start(int32 Key) const { return Offsets[Key]; }
+		int32 End(int32 Key) const { return Offsets[Key + 1]; }
+	};
+
+	/* Runs Func over [0, Num) in chunks, in parallel once there's enough work */
+	template<typename FuncType>
+	void ForEachChunked(int32 Num, const FuncType& Func)
+	{
+		if (Num < FRuntimeMeshTangents::ParallelThreshold)
+		{
+			Func(0, Num);
+			return;
+		}
+
+		const int32 NumChunks = FMath::DivideAndRoundUp(Num, FRuntimeMeshTangents::ChunkSize);
+		ParallelFor(NumChunks, [&](int32 ChunkIndex)
+		{
+			const int32 Start = ChunkIndex * FRuntimeMeshTangents::ChunkSize;
+			Func(Start, FMath::Min(Start + FRuntimeMeshTangents::ChunkSize, Num));
+		});
+	}
+
+	/* Assigns each vertex the index of the first vertex at the same position, or within WeldTolerance of it */
+	void BuildWeldGroups(const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, float WeldTolerance, TArray<int32>& OutWeldIds)
+	{
+		OutWeldIds.SetNumUninitialized(NumVertices);
+
+		if (WeldTolerance < 0.0f)
+		{
+			for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+			{
+				OutWeldIds[VertexIndex] = VertexIndex;
+			}
+		}
+		else if (WeldTolerance == 0.0f)
+		{
+			TMap<FVector, int32> Groups;
+			Groups.Reserve(NumVertices);
+			for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+			{
+				const FVector& Position = *reinterpret_cast<const FVector*>(FirstPosition + VertexIndex * PositionStride);
+				OutWeldIds[VertexIndex] = Groups.FindOrAdd(Position, VertexIndex);
+			}
+		}
+		else
+		{
+			const float InvTolerance = 1.0f / WeldTolerance;
+			const float ToleranceSquared = WeldTolerance * WeldTolerance;
+
+			// Cells are as big as the tolerance, so a match can be in any of the neighbouring cells, not just the own one.
+			// Each cell links the first vertex of every group in it through NextInCell.
+			TMap<FIntVector, int32> CellHeads;
+			CellHeads.Reserve(NumVertices);
+			TArray<int32> NextInCell;
+			NextInCell.SetNumUninitialized(NumVertices);
+
+			for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+			{
+				const FVector& Position = *reinterpret_cast<const FVector*>(FirstPosition + VertexIndex * PositionStride);
+				const FIntVector Cell(
+					FMath::FloorToInt(Position.X * InvTolerance),
+					FMath::FloorToInt(Position.Y * InvTolerance),
+					FMath::FloorToInt(Position.Z * InvTolerance));
+
+				int32 WeldId = INDEX_NONE;
+				for (int32 Z = -1; Z <= 1 && WeldId == INDEX_NONE; Z++)
+				{
+					for (int32 Y = -1; Y <= 1 && WeldId == INDEX_NONE; Y++)
+					{
+						for (int32 X = -1; X <= 1 && WeldId == INDEX_NONE; X++)
+						{
+							const int32* Head = CellHeads.Find(Cell + FIntVector(X, Y, Z));
+							for (int32 Other = Head ? *Head : INDEX_NONE; Other != INDEX_NONE; Other = NextInCell[Other])
+							{
+								const FVector& OtherPosition = *reinterpret_cast<const FVector*>(FirstPosition + Other * PositionStride);
+								if (FVector::DistSquared(Position, OtherPosition) <= ToleranceSquared)
+								{
+									WeldId = Other;
+									break;
+								}
+							}
+						}
+					}
+				}
+
+				if (WeldId == INDEX_NONE)
+				{
+					// First vertex of a new group
+					int32& Head = CellHeads.FindOrAdd(Cell, INDEX_NONE);
+					NextInCell[VertexIndex] = Head;
+					Head = VertexIndex;
+					WeldId = VertexIndex;
+				}
+
+				OutWeldIds[VertexIndex] = WeldId;
+			}
+		}
+	}
+
+	/* Area weighted normal, tangent and binormal of a triangle */
+	FORCEINLINE void ComputeFace(const uint8* FirstPosition, int32 PositionStride, const TArray<FVector2D>& UVs, const int32* Corners,
+		FVector& OutNormal, FVector& OutTangent, FVector& OutBinormal)
+	{
+		// Positions are strided inside the vertex, so only load XYZ and keep W out of the dot products
+		const VectorRegister P0 = VectorLoadFloat3_W0(FirstPosition + Corners[0] * PositionStride);
+		const VectorRegister P1 = VectorLoadFloat3_W0(FirstPosition + Corners[1] * PositionStride);
+		const VectorRegister P2 = VectorLoadFloat3_W0(FirstPosition + Corners[2] * PositionStride);
+
+		const VectorRegister Edge1 = VectorSubtract(P1, P0);
+		const VectorRegister Edge2 = VectorSubtract(P2, P0);
+
+		// Length of the cross product is twice the area, which is the weight
+		VectorStoreFloat3(VectorCross(Edge2, Edge1), &OutNormal);
+		const VectorRegister Area = VectorSetFloat1(OutNormal.Size());
+
+		const FVector2D& UV0 = UVs[Corners[0]];
+		const FVector2D DeltaUV1 = UVs[Corners[1]] - UV0;
+		const FVector2D DeltaUV2 = UVs[Corners[2]] - UV0;
+
+		const float Determinant = DeltaUV1.X * DeltaUV2.Y - DeltaUV2.X * DeltaUV1.Y;
+		if (FMath::Abs(Determinant) <= SMALL_NUMBER)
+		{
+			// No usable UV mapping, leave it to the other faces
+			OutTangent = FVector::ZeroVector;
+			OutBinormal = FVector::ZeroVector;
+			return;
+		}
+
+		// Only the direction is kept, so the sign of the determinant stands in for dividing by it
+		const VectorRegister Sign = VectorSetFloat1(FMath::Sign(Determinant));
+		VectorRegister Tangent = VectorSubtract(VectorMultiply(Edge1, VectorSetFloat1(DeltaUV2.Y)), VectorMultiply(Edge2, VectorSetFloat1(DeltaUV1.Y)));
+		VectorRegister Binormal = VectorSubtract(VectorMultiply(Edge2, VectorSetFloat1(DeltaUV1.X)), VectorMultiply(Edge1, VectorSetFloat1(DeltaUV2.X)));
+		Tangent = VectorMultiply(Tangent, Sign);
+		Binormal = VectorMultiply(Binormal, Sign);
+
+		const VectorRegister TangentLengthSquared = VectorDot3(Tangent, Tangent);
+		const VectorRegister BinormalLengthSquared = VectorDot3(Binormal, Binormal);
+		if (VectorAnyGreaterThan(VectorSetFloat1(SMALL_NUMBER), VectorMin(TangentLengthSquared, BinormalLengthSquared)))
+		{
+			OutTangent = FVector::ZeroVector;
+			OutBinormal = FVector::ZeroVector;
+			return;
+		}
+
+		VectorStoreFloat3(VectorMultiply(Tangent, VectorMultiply(VectorReciprocalSqrt(TangentLengthSquared), Area)), &OutTangent);
+		VectorStoreFloat3(VectorMultiply(Binormal, VectorMultiply(VectorReciprocalSqrt(BinormalLengthSquared), Area)), &OutBinormal);
+	}
+}
+
+void FRuntimeMeshTangents::Calculate(const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, const TArray<FVector2D>& UVs,
+	const TArray<int32>& Indices, float WeldTolerance, const TBitArray<>* DirtyVertices, FRuntimeMeshTangentsResult& OutResult)
+{
+	using namespace RuntimeMeshTangentsInternal;
+
+	check(UVs.Num() == NumVertices);
+	check(Indices.Num() % 3 == 0);
+	check(DirtyVertices == nullptr || DirtyVertices->Num() == NumVertices);
+
+	OutResult.Vertices.Reset();
+	OutResult.Normals.Reset();
+	OutResult.Tangents.Reset();
+	OutResult.BinormalSigns.Reset();
+
+	const int32 NumTriangles = Indices.Num() / 3;
+
+	TArray<int32> WeldIds;
+	BuildWeldGroups(FirstPosition, PositionStride, NumVertices, WeldTolerance, WeldIds);
+
+	TArray<int32> VertexIds;
+	VertexIds.SetNumUninitialized(NumVertices);
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+	{
+		VertexIds[VertexIndex] = VertexIndex;
+	}
+
+	// Normals gather over the weld group, tangents only over the vertex itself
+	FAdjacency WeldAdjacency;
+	WeldAdjacency.Build(Indices, WeldIds);
+
+	FAdjacency VertexAdjacency;
+	VertexAdjacency.Build(Indices, VertexIds);
+
+	// Work out which vertices and faces are needed. Moving a vertex changes the faces around its weld group,
+	// which changes every vertex welded to any corner of those faces.
+	TBitArray<> FacesNeeded;
+	if (DirtyVertices)
+	{
+		TBitArray<> DirtyWelds(false, NumVertices);
+		for (TConstSetBitIterator<> It(*DirtyVertices); It; ++It)
+		{
+			DirtyWelds[WeldIds[It.GetIndex()]] = true;
+		}
+
+		TBitArray<> AffectedWelds(false, NumVertices);
+		for (TConstSetBitIterator<> It(DirtyWelds); It; ++It)
+		{
+			AffectedWelds[It.GetIndex()] = true;
+			for (int32 Entry = WeldAdjacency.Start(It.GetIndex()); Entry < WeldAdjacency.End(It.GetIndex()); Entry++)
+			{
+				const int32 Triangle = WeldAdjacency.Triangles[Entry];
+				for (int32 Corner = 0; Corner < 3; Corner++)
+				{
+					AffectedWelds[WeldIds[Indices[Triangle * 3 + Corner]]] = true;
+				}
+			}
+		}
+
+		FacesNeeded.Init(false, NumTriangles);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			if (AffectedWelds[WeldIds[VertexIndex]])
+			{
+				OutResult.Vertices.Add(VertexIndex);
+				for (int32 Entry = WeldAdjacency.Start(WeldIds[VertexIndex]); Entry < WeldAdjacency.End(WeldIds[VertexIndex]); Entry++)
+				{
+					FacesNeeded[WeldAdjacency.Triangles[Entry]] = true;
+				}
+			}
+		}
+
+		if (OutResult.Vertices.Num() == 0)
+		{
+			return;
+		}
+	}
+
+	const int32 NumResults = DirtyVertices ? OutResult.Vertices.Num() : NumVertices;
+
+	// Face data, written once per triangle so the ranges can run in parallel
+	TArray<FVector> FaceNormals;
+	TArray<FVector> FaceTangents;
+	TArray<FVector> FaceBinormals;
+	FaceNormals.SetNumUninitialized(NumTriangles);
+	FaceTangents.SetNumUninitialized(NumTriangles);
+	FaceBinormals.SetNumUninitialized(NumTriangles);
+
+	ForEachChunked(NumTriangles, [&](int32 Start, int32 End)
+	{
+		for (int32 Triangle = Start; Triangle < End; Triangle++)
+		{
+			if (DirtyVertices == nullptr || FacesNeeded[Triangle])
+			{
+				ComputeFace(FirstPosition, PositionStride, UVs, &Indices[Triangle * 3], FaceNormals[Triangle], FaceTangents[Triangle], FaceBinormals[Triangle]);
+			}
+		}
+	});
+
+	OutResult.Normals.SetNumUninitialized(NumResults);
+	OutResult.Tangents.SetNumUninitialized(NumResults);
+	OutResult.BinormalSigns.SetNumUninitialized(NumResults);
+
+	// Gather to each vertex, each result is only written by its own task
+	ForEachChunked(NumResults, [&](int32 Start, int32 End)
+	{
+		for (int32 Index = Start; Index < End; Index++)
+		{
+			const int32 VertexIndex = OutResult.GetVertex(Index);
+			const int32 WeldId = WeldIds[VertexIndex];
+
+			FVector Normal = FVector::ZeroVector;
+			for (int32 Entry = WeldAdjacency.Start(WeldId); Entry < WeldAdjacency.End(WeldId); Entry++)
+			{
+				Normal += FaceNormals[WeldAdjacency.Triangles[Entry]];
+			}
+
+			FVector Tangent = FVector::ZeroVector;
+			FVector Binormal = FVector::ZeroVector;
+			for (int32 Entry = VertexAdjacency.Start(VertexIndex); Entry < VertexAdjacency.End(VertexIndex); Entry++)
+			{
+				const int32 Triangle = VertexAdjacency.Triangles[Entry];
+				Tangent += FaceTangents[Triangle];
+				Binormal += FaceBinormals[Triangle];
+			}
+
+			Normal = Normal.GetSafeNormal();
+			if (Normal.IsZero())
+			{
+				Normal = FVector(0.0f, 0.0f, 1.0f);
+			}
+
+			// Gram-Schmidt the tangent against the smoothed normal
+			Tangent = (Tangent - Normal * (Normal | Tangent)).GetSafeNormal();
+			if (Tangent.IsZero())
+			{
+				FVector Unused;
+				Normal.FindBestAxisVectors(Tangent, Unused);
+			}
+
+			OutResult.Normals[Index] = Normal;
+			OutResult.Tangents[Index] = Tangent;
+			OutResult.BinormalSigns[Index] = ((Normal ^ Tangent) | Binormal) < 0.0f ? -1.0f : 1.0f;
+		}
+	});
+}
@@ -0,0 +1,199 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#include "RuntimeMeshComponentPluginPrivatePCH.h"
+#include "RuntimeMeshUpdateCommands.h"
+
+
+static TAutoConsoleVariable<int32> CVarRuntimeMeshCommandPoolMaxBlocks(
+	TEXT("RuntimeMesh.CommandPoolMaxBlocks"),
+	4096,
+	TEXT("Most free blocks of each size kept for render thread update commands. 0 disables pooling."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRuntimeMeshCommandRecycleMaxCount(
+	TEXT("RuntimeMesh.CommandRecycleMaxCount"),
+	64,
+	TEXT("Most released range update commands of each vertex type kept with their data arrays for reuse. 0 disables recycling."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRuntimeMeshCommandRecycleMaxBytes(
+	TEXT("RuntimeMesh.CommandRecycleMaxBytes"),
+	1024 * 1024,
+	TEXT("Commands holding more data than this are freed instead of being kept for reuse."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRuntimeMeshUploadBudgetBytes(
+	TEXT("RuntimeMesh.UploadBudgetBytes"),
+	0,
+	TEXT("Most bytes of section data uploaded per frame by components using bUseUploadBudget. The rest waits for later frames. 0 is unlimited."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRuntimeMeshUploadBudgetSections(
+	TEXT("RuntimeMesh.UploadBudgetSections"),
+	0,
+	TEXT("Most section creates/updates uploaded per frame by components using bUseUploadBudget. The rest waits for later frames. 0 is unlimited."),
+	ECVF_Default);
+
+
+namespace RuntimeMeshCommandAllocatorInternal
+{
+	/* Block sizes are powers of two from 1 << MinBlockShift up to 1 << MaxBlockShift. Anything larger isn't pooled */
+	static const int32 MinBlockShift = 5;
+	static const int32 MaxBlockShift = 10;
+	static const int32 NumBlockSizes = MaxBlockShift - MinBlockShift + 1;
+
+	struct FBlockFreeList
+	{
+		FCriticalSection Lock;
+		TArray<void*> Blocks;
+	};
+
+	static FBlockFreeList& GetFreeList(int32 SizeIndex)
+	{
+		static FBlockFreeList FreeLists[NumBlockSizes];
+		return FreeLists[SizeIndex];
+	}
+
+	/* Returns the free list for blocks of Size, or INDEX_NONE if it's too large to pool */
+	static int32 GetSizeIndex(SIZE_T Size)
+	{
+		if (Size > ((SIZE_T)1 << MaxBlockShift))
+		{
+			return INDEX_NONE;
+		}
+
+		int32 SizeIndex = 0;
+		while (((SIZE_T)1 << (MinBlockShift + SizeIndex)) < Size)
+		{
+			SizeIndex++;
+		}
+		return SizeIndex;
+	}
+
+	static SIZE_T GetBlockSize(int32 SizeIndex)
+	{
+		return (SIZE_T)1 << (MinBlockShift + SizeIndex);
+	}
+}
+
+
+void* FRuntimeMeshCommandAllocator::Allocate(SIZE_T Size)
+{
+	using namespace RuntimeMeshCommandAllocatorInternal;
+
+	const int32 SizeIndex = GetSizeIndex(Size);
+	if (SizeIndex == INDEX_NONE)
+	{
+		return FMemory::Malloc(Size);
+	}
+
+	FBlockFreeList& FreeList = GetFreeList(SizeIndex);
+	{
+		FScopeLock Lock(&FreeList.Lock);
+		if (FreeList.Blocks.Num() > 0)
+		{
+			DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CommandPoolMemory, GetBlockSize(SizeIndex));
+			return FreeList.Blocks.Pop(false);
+		}
+	}
+
+	// Always allocate the full block so it can be reused for anything of this size
+	return FMemory::Malloc(GetBlockSize(SizeIndex));
+}
+
+void FRuntimeMeshCommandAllocator::Free(void* Ptr, SIZE_T Size)
+{
+	using namespace RuntimeMeshCommandAllocatorInternal;
+
+	if (Ptr == nullptr)
+	{
+		return;
+	}
+
+	const int32 SizeIndex = GetSizeIndex(Size);
+	if (SizeIndex != INDEX_NONE)
+	{
+		FBlockFreeList& FreeList = GetFreeList(SizeIndex);
+		FScopeLock Lock(&FreeList.Lock);
+		if (FreeList.Blocks.Num() < CVarRuntimeMeshCommandPoolMaxBlocks.GetValueOnAnyThread())
+		{
+			INC_MEMORY_STAT_BY(STAT_RuntimeMesh_CommandPoolMemory, GetBlockSize(SizeIndex));
+			FreeList.Blocks.Add(Ptr);
+			return;
+		}
+	}
+
+	FMemory::Free(Ptr);
+}
+
+void FRuntimeMeshCommandAllocator::Trim()
+{
+	using namespace RuntimeMeshCommandAllocatorInternal;
+
+	for (int32 SizeIndex = 0; SizeIndex < NumBlockSizes; SizeIndex++)
+	{
+		FBlockFreeList& FreeList = GetFreeList(SizeIndex);
+		FScopeLock Lock(&FreeList.Lock);
+
+		for (void* Block : FreeList.Blocks)
+		{
+			FMemory::Free(Block);
+		}
+
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CommandPoolMemory, FreeList.Blocks.Num() * GetBlockSize(SizeIndex));
+		FreeList.Blocks.Empty();
+	}
+}
+
+int32 FRuntimeMeshCommandAllocator::GetMaxRecycledCommands()
+{
+	return FMath::Max(CVarRuntimeMeshCommandRecycleMaxCount.GetValueOnAnyThread(), 0);
+}
+
+SIZE_T FRuntimeMeshCommandAllocator::GetMaxRecycledPayloadSize()
+{
+	return (SIZE_T)FMath::Max(CVarRuntimeMeshCommandRecycleMaxBytes.GetValueOnAnyThread(), 0);
+}
+
+
+uint64 FRuntimeMeshUploadBudget::CurrentFrame = 0;
+SIZE_T FRuntimeMeshUploadBudget::BytesUsed = 0;
+int32 FRuntimeMeshUploadBudget::SectionsUsed = 0;
+
+bool FRuntimeMeshUploadBudget::IsEnabled()
+{
+	return CVarRuntimeMeshUploadBudgetBytes.GetValueOnGameThread() > 0 || CVarRuntimeMeshUploadBudgetSections.GetValueOnGameThread() > 0;
+}
+
+bool FRuntimeMeshUploadBudget::TryConsume(SIZE_T NumBytes)
+{
+	check(IsInGameThread());
+
+	if (CurrentFrame != GFrameCounter)
+	{
+		CurrentFrame = GFrameCounter;
+		BytesUsed = 0;
+		SectionsUsed = 0;
+	}
+
+	const int32 MaxBytes = CVarRuntimeMeshUploadBudgetBytes.GetValueOnGameThread();
+	const int32 MaxSections = CVarRuntimeMeshUploadBudgetSections.GetValueOnGameThread();
+
+	if (SectionsUsed > 0)
+	{
+		if (MaxBytes > 0 && BytesUsed + NumBytes > (SIZE_T)MaxBytes)
+		{
+			return false;
+		}
+
+		if (MaxSections > 0 && SectionsUsed >= MaxSections)
+		{
+			return false;
+		}
+	}
+
+	BytesUsed += NumBytes;
+	SectionsUsed++;
+	INC_DWORD_STAT_BY(STAT_RuntimeMesh_BudgetedUploadBytes, NumBytes);
+	return true;
+}
@@ -0,0 +1,166 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "Async/Async.h"
+#include "RuntimeMeshCore.h"
+#include "RuntimeMeshBounds.h"
+
+class URuntimeMeshComponent;
+template<typename VertexType> class TRuntimeMeshAsyncSectionJob;
+
+
+/* Where an async section is in its life. Only Pending can still change */
+enum class ERuntimeMeshAsyncSectionStatus : int32
+{
+	/* Generating, or generated and waiting for the game thread to commit it */
+	Pending,
+
+	/* Moved into the section */
+	Committed,
+
+	/* Cancelled through its handle */
+	Cancelled,
+
+	/* Replaced by a newer async or direct create, or its section was cleared */
+	Superseded,
+
+	/* The generated mesh was invalid, or didn't fit the section it was meant to update */
+	Failed,
+};
+
+/* State shared between an async section job, the worker running it and the handles to it */
+class FRuntimeMeshAsyncSectionState
+{
+public:
+	FRuntimeMeshAsyncSectionState() : Status((int32)ERuntimeMeshAsyncSectionStatus::Pending) { }
+
+	ERuntimeMeshAsyncSectionStatus GetStatus() const { return (ERuntimeMeshAsyncSectionStatus)Status.GetValue(); }
+
+	/* Moves a pending job to NewStatus. Returns false if it had already left pending */
+	bool Finish(ERuntimeMeshAsyncSectionStatus NewStatus)
+	{
+		return Status.InterlockedCompareExchange((int32)NewStatus, (int32)ERuntimeMeshAsyncSectionStatus::Pending) == (int32)ERuntimeMeshAsyncSectionStatus::Pending;
+	}
+
+private:
+	FThreadSafeCounter Status;
+};
+
+
+/**
+*	Handle to a section being generated by URuntimeMeshComponent::CreateMeshSectionAsync or UpdateMeshSectionAsync.
+*	Handles can be copied freely and stay valid after the job is gone.
+*/
+struct FRuntimeMeshAsyncSectionHandle
+{
+	FRuntimeMeshAsyncSectionHandle() { }
+	explicit FRuntimeMeshAsyncSectionHandle(const TSharedRef<FRuntimeMeshAsyncSectionState, ESPMode::ThreadSafe>& InState) : State(InState) { }
+
+	/* Was this handle returned for an async section */
+	bool IsValid() const { return State.IsValid(); }
+
+	/* Is the section still being generated or waiting to be committed */
+	bool IsPending() const { return GetStatus() == ERuntimeMeshAsyncSectionStatus::Pending; }
+
+	ERuntimeMeshAsyncSectionStatus GetStatus() const
+	{
+		return State.IsValid() ? State->GetStatus() : ERuntimeMeshAsyncSectionStatus::Failed;
+	}
+
+	/**
+	*	Stops the result from being committed. A generator that's already running is left to finish, and its result thrown away.
+	*	Returns false if the job had already been committed or discarded.
+	*/
+	bool Cancel()
+	{
+		return State.IsValid() && State->Finish(ERuntimeMeshAsyncSectionStatus::Cancelled);
+	}
+
+private:
+	TSharedPtr<FRuntimeMeshAsyncSectionState, ESPMode::ThreadSafe> State;
+};
+
+
+/* Work for one async section. Generated on the thread pool, committed to the component on the game thread */
+class FRuntimeMeshAsyncSectionJob
+{
+public:
+	FRuntimeMeshAsyncSectionJob(int32 InSectionIndex, bool bInIsCreate)
+		: State(MakeShareable(new FRuntimeMeshAsyncSectionState())), SectionIndex(InSectionIndex), bIsCreate(bInIsCreate), bIsGenerated(false) { }
+	virtual ~FRuntimeMeshAsyncSectionJob() { }
+
+	/* Runs the generator, then validates the result and computes its bounds. Runs on the thread pool */
+	virtual void Generate() = 0;
+
+	/* Moves the result into the section. Runs on the game thread */
+	virtual void Commit(URuntimeMeshComponent* Component) = 0;
+
+	/* Does this replace the section's mesh, or only derive something from it (like LODs) */
+	virtual bool ChangesSectionMesh() const { return true; }
+
+	/* Has the worker finished with this job */
+	bool IsGenerated() const { return bIsGenerated; }
+
+	void MarkGenerated() { bIsGenerated = true; }
+
+	TSharedRef<FRuntimeMeshAsyncSectionState, ESPMode::ThreadSafe> State;
+
+	/* Section this creates or updates */
+	int32 SectionIndex;
+
+	/* Does this create the section, or update an existing one */
+	bool bIsCreate;
+
+private:
+	FThreadSafeBool bIsGenerated;
+};
+
+
+namespace RuntimeMeshAsyncInternal
+{
+	template<typename VertexType>
+	static typename TEnableIf<FVertexHasPositionComponent<VertexType>::Value, FBox>::Type
+		ComputeVertexBounds(const TArray<VertexType>& Vertices)
+	{
+		return FRuntimeMeshBounds::ComputeVertexBounds(Vertices.GetData(), Vertices.Num());
+	}
+
+	template<typename VertexType>
+	static typename TEnableIf<!FVertexHasPositionComponent<VertexType>::Value, FBox>::Type
+		ComputeVertexBounds(const TArray<VertexType>& Vertices)
+	{
+		// Only reached by dual buffer builders, whose bounds come from the positions
+		return FBox(0);
+	}
+
+	/* Checks a generated mesh, returns an empty string if it's usable or why it isn't */
+	static FString ValidateMesh(int32 NumVertices, int32 NumPositions, bool bIsDualBuffer, const TArray<int32>& Indices)
+	{
+		if (NumVertices == 0 || Indices.Num() == 0)
+		{
+			return TEXT("Generated mesh is empty.");
+		}
+
+		if (bIsDualBuffer && NumPositions != NumVertices)
+		{
+			return TEXT("Positions must be the same length as Vertices.");
+		}
+
+		if (Indices.Num() % 3 != 0)
+		{
+			return TEXT("Triangles must be a multiple of 3 indices.");
+		}
+
+		for (int32 Index : Indices)
+		{
+			if (Index < 0 || Index >= NumVertices)
+			{
+				return FString::Printf(TEXT("Triangles reference vertex %d of %d."), Index, NumVertices);
+			}
+		}
+
+		return FString();
+	}
+}
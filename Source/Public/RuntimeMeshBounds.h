@@ -0,0 +1,130 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "Async/ParallelFor.h"
+
+
+/*
+*	Bounding box helpers for section updates. Min/max is done with vector registers, and large buffers
+*	are split into chunks that run through ParallelFor. When copying, each chunk is copied and then
+*	reduced while it's still in cache instead of walking the whole buffer twice.
+*/
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshBounds
+{
+	/* Number of vertices per chunk */
+	static const int32 ChunkSize = 16 * 1024;
+
+	/* Buffers with fewer vertices than this are done on the calling thread */
+	static const int32 ParallelThreshold = 64 * 1024;
+
+	/* Min/max reduction over Num positions, where each position is Stride bytes after the last. Returns an invalid box if Num is 0 */
+	static FBox ComputeBounds(const uint8* FirstPosition, int32 Num, int32 Stride);
+
+	/* Gets the bounds of a position buffer */
+	static FBox ComputeBounds(const FVector* Positions, int32 Num)
+	{
+		return ComputeBounds(reinterpret_cast<const uint8*>(Positions), Num, sizeof(FVector));
+	}
+
+	/* Gets the bounds of a vertex buffer using each vertex's Position member */
+	template<typename VertexType>
+	static FBox ComputeVertexBounds(const VertexType* Vertices, int32 Num)
+	{
+		return ComputeBounds(reinterpret_cast<const uint8*>(Vertices) + STRUCT_OFFSET(VertexType, Position), Num, sizeof(VertexType));
+	}
+
+	/* Copies Num elements from Source to Dest and returns the bounds of the copied data. */
+	template<typename Type, typename BoundsFunc>
+	static FBox CopyWithBounds(Type* Dest, const Type* Source, int32 Num, BoundsFunc GetChunkBounds)
+	{
+		if (Num < ParallelThreshold)
+		{
+			CopyChunk(Dest, Source, Num);
+			return GetChunkBounds(Dest, Num);
+		}
+
+		const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+		TArray<FBox> ChunkBounds;
+		ChunkBounds.SetNumUninitialized(NumChunks);
+
+		ParallelFor(NumChunks, [&](int32 ChunkIndex)
+		{
+			const int32 Start = ChunkIndex * ChunkSize;
+			const int32 Count = FMath::Min(ChunkSize, Num - Start);
+
+			CopyChunk(Dest + Start, Source + Start, Count);
+			ChunkBounds[ChunkIndex] = GetChunkBounds(Dest + Start, Count);
+		});
+
+		return CombineBounds(ChunkBounds);
+	}
+
+	/* Copies a position buffer returning its bounds */
+	static FBox CopyWithBounds(FVector* Dest, const FVector* Source, int32 Num)
+	{
+		return CopyWithBounds(Dest, Source, Num, [](const FVector* Chunk, int32 Count) { return ComputeBoundsSerial(reinterpret_cast<const uint8*>(Chunk), Count, sizeof(FVector)); });
+	}
+
+	/* Copies a vertex buffer returning the bounds of its Position members */
+	template<typename VertexType>
+	static FBox CopyVerticesWithBounds(VertexType* Dest, const VertexType* Source, int32 Num)
+	{
+		return CopyWithBounds(Dest, Source, Num, [](const VertexType* Chunk, int32 Count)
+		{
+			return ComputeBoundsSerial(reinterpret_cast<const uint8*>(Chunk) + STRUCT_OFFSET(VertexType, Position), Count, sizeof(VertexType));
+		});
+	}
+
+	/* Min/max reduction on the calling thread */
+	static FBox ComputeBoundsSerial(const uint8* FirstPosition, int32 Num, int32 Stride);
+
+private:
+	template<typename Type>
+	static void CopyChunk(Type* Dest, const Type* Source, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Dest[Index] = Source[Index];
+		}
+	}
+
+	static FBox CombineBounds(const TArray<FBox>& ChunkBounds);
+};
+
+
+/*
+*	Union of a set of keyed boxes that's kept up to date as boxes are set and removed, for the component
+*	bounds over all its sections. Growing is applied straight away. Shrinking only needs the union rebuilt
+*	when the box that shrank or went away was on one of its faces, otherwise another box still holds that face.
+*/
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshBoundsAccumulator
+{
+public:
+	FRuntimeMeshBoundsAccumulator() : Bounds(0), bNeedsRebuild(false) { }
+
+	/* Sets the box for Key, replacing any it had. An invalid box removes it */
+	void SetBox(int32 Key, const FBox& Box);
+
+	/* Removes the box for Key, if it had one */
+	void RemoveBox(int32 Key);
+
+	void Reset()
+	{
+		Boxes.Reset();
+		Bounds = FBox(0);
+		bNeedsRebuild = false;
+	}
+
+	/* Gets the union of all the boxes, rebuilding it first if needed */
+	const FBox& GetBounds();
+
+private:
+	/* Could removing this box shrink the union */
+	bool IsOnBoundary(const FBox& Box) const;
+
+	TMap<int32, FBox> Boxes;
+	FBox Bounds;
+	bool bNeedsRebuild;
+};
@@ -2,97 +2,322 @@
 
 #pragma once
 
-#include "RuntimeMeshComponent.h"
+#include "RuntimeMeshCore.h"
+#include "RuntimeMeshGenericVertex.h"
 
 //////////////////////////////////////////////////////////////////////////
-//	This feature in development. Not usable yet.
+//
+//	FRuntimeMeshBuilder is a cursor style writer for building a section without going through
+//	separate arrays first. Vertices are written at the vertex cursor, triangles at the triangle cursor.
+//	Writing at the end of the stream grows it, writing before the end overwrites what's there.
+//	The finished buffers are moved into the section by URuntimeMeshComponent::CreateMeshSection or
+//	UpdateMeshSection, so nothing is copied.
+//
+//	FRuntimeMeshBuilder<FRuntimeMeshVertexSimple> Mesh;
+//	Mesh.Reserve(3, 3);
+//
+//	int32 Vertex1 = Mesh.SetVertex(FVector(0, 0, 0));
+//	Mesh.SetNormal(FVector(1, 0, 0));
+//	Mesh.SetUV(0, FVector2D(0, 0));
+//	Mesh.MoveNext();
+//
+//	...
+//
+//	Mesh.AddTriangle(Vertex1, Vertex2, Vertex3);
+//	RuntimeMesh->CreateMeshSection(0, Mesh);
+//
+//	Dual buffer builders keep positions in their own stream, which SetPosition and the SetVertex
+//	overloads taking a position write to. The component setters (SetNormal, SetUV...) need the
+//	generic vertex layout, custom vertex types can be written whole with SetVertex(const VertexType&).
+//
 //////////////////////////////////////////////////////////////////////////
 
-template<typename VertexType>
-class FRuntimeMeshBuilder
+namespace RuntimeMeshBuilderInternal
 {
-public:
-	int32 SetVertex(const VertexType& InVertex);
-	int32 SetVertex(const FVector& InPosition);
-	int32 SetVertex(const FVector& InPosition, const FColor& InColor);
-	int32 SetVertex(const FVector& InPosition, const FVector2D& InUV0);
-	int32 SetVertex(const FVector& InPosition, const FVector& InNormal, const FRuntimeMeshTangent& InTangent, const FColor& InColor, const FVector2D& InUV0);
-	int32 SetVertex(const FVector& InPosition, const FVector& InTangentX, const FVector& InTangentY, const FVector& InTangentZ,
-		const FColor& InColor, const FVector2D& InUV0);
-
-
-	void SetPosition(const FVector& InPosition);
-	void SetNormal(const FVector& InNormal);
-	void SetTangent(const FRuntimeMeshTangent& InTangent);
-	void SetTangents(const FVector& InTangentX, const FVector& InTangentY, const FVector& InTangentZ);
-	void SetColor(const FColor& InColor);
-	void SetUV(int32 Channel, const FVector2D& UV);
-
-
-	void MoveNext();
-
-
-	int32 AddTriangle(int32 V0, int32 V1, int32 V2);
-
-	int32 AddVertices(const TArray<VertexType>& Vertices);
-	int32 AddTriangles(const TArray<int32>& Triangles);
-
-	void SeekVertices(int32 StreamPosition);
-	void SeekTriangles(int32 StreamPosition);
-
-
-	
-
-
-
-
-
+	template<typename Type>
+	static typename TEnableIf<FVertexHasPositionComponent<Type>::Value>::Type
+		SetPosition(Type& Vertex, const FVector& InPosition)
+	{
+		Vertex.Position = InPosition;
+	}
+
+	template<typename Type>
+	static typename TEnableIf<!FVertexHasPositionComponent<Type>::Value>::Type
+		SetPosition(Type& Vertex, const FVector& InPosition)
+	{
+		checkf(false, TEXT("Vertex type has no position. Use a dual buffer builder."));
+	}
+
+	/* UV channels are laid out back to back, so the channel is an offset from UV0 */
+	template<int32 TextureChannels>
+	static void SetUV(FRuntimeMeshUVComponents<TextureChannels, false>& Components, int32 Channel, const FVector2D& InUV)
+	{
+		check(Channel >= 0 && Channel < TextureChannels);
+		(&Components.UV0)[Channel] = InUV;
+	}
+
+	template<int32 TextureChannels>
+	static void SetUV(FRuntimeMeshUVComponents<TextureChannels, true>& Components, int32 Channel, const FVector2D& InUV)
+	{
+		check(Channel >= 0 && Channel < TextureChannels);
+		(&Components.UV0)[Channel] = FVector2DHalf(InUV);
+	}
+}
 
-
-
-};
-
-
-
-void Test()
+template<typename VertexType>
+class FRuntimeMeshBuilder : public FNoncopyable
 {
-	FRuntimeMeshBuilder<FRuntimeMeshVertexSimple> Mesh;
-
-	// Create 3 vertices setting position, normal, and UV0
-	int32 Vertex1 = Mesh.SetVertex(FVector(0, 0, 0));
-	Mesh.SetNormal(FVector(1, 0, 0));
-	Mesh.SetUV(0, FVector2D(0, 0));
-	Mesh.MoveNext();
-
-	int32 Vertex2 = Mesh.AddVertex(FVector(1, 1, 1));
-	Mesh.SetNormal(FVector(1, 0, 0));
-	Mesh.SetUV(0, FVector2D(1, 1));
-	Mesh.MoveNext();
+private:
+	/* Should positions be kept in their own buffer */
+	const bool bIsDualBuffer;
 
-	int32 Vertex3 = Mesh.AddVertex(FVector(2, 2, 2));
-	Mesh.SetNormal(FVector(1, 0, 0));
-	Mesh.SetUV(0, FVector2D(1, 1));
-	Mesh.MoveNext();
+	TArray<FVector> Positions;
+	TArray<VertexType> Vertices;
+	TArray<int32> Indices;
 
+	/* Vertex the setters write to */
+	int32 VertexCursor;
 
-	// Add the triangle
-	Mesh.AddTriangle(Vertex1, Vertex2, Vertex3);
-
-
-	// Update the 3 vertices positions, leaving everything else the same
-	Mesh.SeekVertices(0);
-	Mesh.SetVertex(FVector(5, 5, 5));
-	Mesh.MoveNext();
-	Mesh.SetVertex(FVector(6, 6, 6));
-	Mesh.MoveNext();
-	Mesh.SetVertex(FVector(7, 7, 7));
-	Mesh.MoveNext();
-
-
-
-	Mesh.SeekTriangles(0);
-	Mesh.AddTriangle(Vertex3, Vertex2, Vertex1);
-
+	/* Index of the first index of the next triangle written */
+	int32 IndexCursor;
 
+public:
+	FRuntimeMeshBuilder(bool bInIsDualBuffer = !FVertexHasPositionComponent<VertexType>::Value)
+		: bIsDualBuffer(bInIsDualBuffer), VertexCursor(0), IndexCursor(0)
+	{
+		checkf(bIsDualBuffer || FVertexHasPositionComponent<VertexType>::Value, TEXT("Vertex types without a position need a dual buffer builder."));
+	}
+
+	bool IsDualBuffer() const { return bIsDualBuffer; }
+
+	int32 NumVertices() const { return Vertices.Num(); }
+	int32 NumTriangles() const { return Indices.Num() / 3; }
+
+	/* Preallocates storage so building doesn't reallocate */
+	void Reserve(int32 NumVertices, int32 NumTriangles)
+	{
+		Positions.Reserve(bIsDualBuffer ? NumVertices : 0);
+		Vertices.Reserve(NumVertices);
+		Indices.Reserve(NumTriangles * 3);
+	}
+
+	/* Empties the builder and rewinds both cursors, keeping the given amount of storage */
+	void Reset(int32 NumVertices = 0, int32 NumTriangles = 0)
+	{
+		Positions.Empty(bIsDualBuffer ? NumVertices : 0);
+		Vertices.Empty(NumVertices);
+		Indices.Empty(NumTriangles * 3);
+		VertexCursor = 0;
+		IndexCursor = 0;
+	}
+
+
+	/* Replaces the vertex under the cursor, returns its index */
+	int32 SetVertex(const VertexType& InVertex)
+	{
+		EnsureVertex() = InVertex;
+		return VertexCursor;
+	}
+
+	/* Sets the position of the vertex under the cursor, leaving everything else alone. Returns its index */
+	int32 SetVertex(const FVector& InPosition)
+	{
+		SetPosition(InPosition);
+		return VertexCursor;
+	}
+
+	int32 SetVertex(const FVector& InPosition, const FColor& InColor)
+	{
+		SetPosition(InPosition);
+		SetColor(InColor);
+		return VertexCursor;
+	}
+
+	int32 SetVertex(const FVector& InPosition, const FVector2D& InUV0)
+	{
+		SetPosition(InPosition);
+		SetUV(0, InUV0);
+		return VertexCursor;
+	}
+
+	int32 SetVertex(const FVector& InPosition, const FVector& InNormal, const FRuntimeMeshTangent& InTangent, const FColor& InColor, const FVector2D& InUV0)
+	{
+		SetPosition(InPosition);
+		SetNormal(InNormal);
+		SetTangent(InTangent);
+		SetColor(InColor);
+		SetUV(0, InUV0);
+		return VertexCursor;
+	}
 
-}
\ No newline at end of file
+	int32 SetVertex(const FVector& InPosition, const FVector& InTangentX, const FVector& InTangentY, const FVector& InTangentZ,
+		const FColor& InColor, const FVector2D& InUV0)
+	{
+		SetPosition(InPosition);
+		SetTangents(InTangentX, InTangentY, InTangentZ);
+		SetColor(InColor);
+		SetUV(0, InUV0);
+		return VertexCursor;
+	}
+
+
+	void SetPosition(const FVector& InPosition)
+	{
+		VertexType& Vertex = EnsureVertex();
+		if (bIsDualBuffer)
+		{
+			Positions[VertexCursor] = InPosition;
+		}
+		else
+		{
+			RuntimeMeshBuilderInternal::SetPosition(Vertex, InPosition);
+		}
+	}
+
+	void SetNormal(const FVector& InNormal)
+	{
+		VertexType& Vertex = EnsureVertex();
+
+		// The tangent basis sign lives in the normal, so keep it
+		const uint8 TangentBasisSign = Vertex.Normal.Vector.W;
+		Vertex.Normal = InNormal;
+		Vertex.Normal.Vector.W = TangentBasisSign;
+	}
+
+	void SetTangent(const FRuntimeMeshTangent& InTangent)
+	{
+		VertexType& Vertex = EnsureVertex();
+		Vertex.Tangent = InTangent.TangentX;
+		InTangent.AdjustNormal(Vertex.Normal);
+	}
+
+	void SetTangents(const FVector& InTangentX, const FVector& InTangentY, const FVector& InTangentZ)
+	{
+		EnsureVertex().SetNormalAndTangent(InTangentX, InTangentY, InTangentZ);
+	}
+
+	void SetColor(const FColor& InColor)
+	{
+		EnsureVertex().Color = InColor;
+	}
+
+	void SetUV(int32 Channel, const FVector2D& InUV)
+	{
+		RuntimeMeshBuilderInternal::SetUV(EnsureVertex(), Channel, InUV);
+	}
+
+
+	/* Moves the cursor to the next vertex. A vertex that was never set is added with default values */
+	void MoveNext()
+	{
+		EnsureVertex();
+		VertexCursor++;
+	}
+
+
+	/* Writes a triangle at the triangle cursor and advances it, returns the index of the triangle */
+	int32 AddTriangle(int32 V0, int32 V1, int32 V2)
+	{
+		const int32 TriangleIndex = IndexCursor / 3;
+		WriteIndex(V0);
+		WriteIndex(V1);
+		WriteIndex(V2);
+		return TriangleIndex;
+	}
+
+	/* Writes vertices starting at the vertex cursor and moves the cursor past them, returns the index of the first */
+	int32 AddVertices(const TArray<VertexType>& InVertices)
+	{
+		checkf(!bIsDualBuffer, TEXT("Dual buffer builders need positions with their vertices."));
+
+		const int32 FirstVertex = VertexCursor;
+		for (const VertexType& Vertex : InVertices)
+		{
+			SetVertex(Vertex);
+			MoveNext();
+		}
+		return FirstVertex;
+	}
+
+	/* Writes vertices and their positions starting at the vertex cursor and moves the cursor past them, returns the index of the first */
+	int32 AddVertices(const TArray<FVector>& InPositions, const TArray<VertexType>& InVertices)
+	{
+		check(InPositions.Num() == InVertices.Num());
+
+		const int32 FirstVertex = VertexCursor;
+		for (int32 Index = 0; Index < InVertices.Num(); Index++)
+		{
+			SetVertex(InVertices[Index]);
+			SetPosition(InPositions[Index]);
+			MoveNext();
+		}
+		return FirstVertex;
+	}
+
+	/* Writes triangles starting at the triangle cursor and moves the cursor past them, returns the index of the first */
+	int32 AddTriangles(const TArray<int32>& Triangles)
+	{
+		check(Triangles.Num() % 3 == 0);
+
+		const int32 FirstTriangle = IndexCursor / 3;
+		for (int32 Index : Triangles)
+		{
+			WriteIndex(Index);
+		}
+		return FirstTriangle;
+	}
+
+	/* Moves the vertex cursor, so later writes overwrite existing vertices. Can be at most one past the last vertex */
+	void SeekVertices(int32 StreamPosition)
+	{
+		check(StreamPosition >= 0 && StreamPosition <= Vertices.Num());
+		VertexCursor = StreamPosition;
+	}
+
+	/* Moves the triangle cursor, so later writes overwrite existing triangles. Can be at most one past the last triangle */
+	void SeekTriangles(int32 StreamPosition)
+	{
+		check(StreamPosition >= 0 && StreamPosition * 3 <= Indices.Num());
+		IndexCursor = StreamPosition * 3;
+	}
+
+	/* Drops everything from the cursors on, for when a rebuild ends up smaller than before */
+	void TruncateAtCursors()
+	{
+		Vertices.SetNum(VertexCursor, false);
+		Positions.SetNum(bIsDualBuffer ? VertexCursor : 0, false);
+		Indices.SetNum(IndexCursor, false);
+	}
+
+private:
+	/* Gets the vertex under the cursor, adding it if the cursor is at the end */
+	VertexType& EnsureVertex()
+	{
+		check(VertexCursor <= Vertices.Num());
+		if (VertexCursor == Vertices.Num())
+		{
+			Vertices.Add(VertexType());
+			if (bIsDualBuffer)
+			{
+				Positions.Add(FVector::ZeroVector);
+			}
+		}
+		return Vertices[VertexCursor];
+	}
+
+	void WriteIndex(int32 Index)
+	{
+		check(IndexCursor <= Indices.Num());
+		if (IndexCursor == Indices.Num())
+		{
+			Indices.Add(Index);
+		}
+		else
+		{
+			Indices[IndexCursor] = Index;
+		}
+		IndexCursor++;
+	}
+
+	friend class URuntimeMeshComponent;
+};
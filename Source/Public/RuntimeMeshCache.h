@@ -0,0 +1,192 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "RuntimeMeshCore.h"
+
+class UBodySetup;
+struct FTriMeshCollisionData;
+
+
+/* Kinds of entry kept in the mesh cache */
+enum class ERuntimeMeshCacheEntryType : uint32
+{
+	Section = 0,
+	Collision = 1,
+};
+
+/*
+*	Fixed size header at the start of every cache entry. The blobs follow it at 16 byte aligned offsets from the start
+*	of the entry, stored exactly as they're laid out in memory, so a loaded entry is used in place without any parsing.
+*/
+struct FRuntimeMeshCacheEntryHeader
+{
+	uint32 Magic;
+
+	/* FRuntimeMeshVersion the entry was written with. Entries from any other version are misses */
+	int32 Version;
+
+	uint32 EntryType;
+	uint32 EngineVersion;
+	uint64 Key;
+
+	/* Hash of everything after the header, so partly written or corrupted entries are misses */
+	uint64 DataHash;
+
+	/* Vertex type of a section entry */
+	FGuid VertexTypeGuid;
+	uint32 VertexTypeNameHash;
+	int32 VertexStride;
+
+	int32 NumVertices;
+	int32 NumPositions;
+	int32 NumIndices;
+	uint32 VertexOffset;
+	uint32 PositionOffset;
+	uint32 IndexOffset;
+
+	/* Cooked physics data of a collision entry */
+	uint32 CollisionOffset;
+	int32 CollisionSize;
+
+	/* Bounds of a section entry */
+	float BoundsMin[3];
+	float BoundsMax[3];
+
+	uint32 TotalSize;
+};
+
+/* Section buffers to store in the cache, pointing into the section's own data */
+struct FRuntimeMeshCacheSectionView
+{
+	const FRuntimeMeshVertexTypeInfo* VertexType;
+	int32 VertexStride;
+
+	const void* Vertices;
+	int32 NumVertices;
+
+	/* Only set for dual buffer sections */
+	const FVector* Positions;
+	int32 NumPositions;
+
+	const int32* Indices;
+	int32 NumIndices;
+
+	FBox Bounds;
+
+	FRuntimeMeshCacheSectionView()
+		: VertexType(nullptr), VertexStride(0), Vertices(nullptr), NumVertices(0), Positions(nullptr), NumPositions(0), Indices(nullptr), NumIndices(0), Bounds(0)
+	{ }
+};
+
+/* A cache entry read back in one piece */
+class FRuntimeMeshCacheEntry
+{
+public:
+	const FRuntimeMeshCacheEntryHeader& GetHeader() const { return *reinterpret_cast<const FRuntimeMeshCacheEntryHeader*>(Data.GetData()); }
+
+	const uint8* GetBlob(uint32 Offset) const { return Data.GetData() + Offset; }
+
+	bool IsDualBuffer() const { return GetHeader().NumPositions > 0; }
+
+	FBox GetBounds() const
+	{
+		const FRuntimeMeshCacheEntryHeader& Header = GetHeader();
+		return FBox(FVector(Header.BoundsMin[0], Header.BoundsMin[1], Header.BoundsMin[2]), FVector(Header.BoundsMax[0], Header.BoundsMax[1], Header.BoundsMax[2]));
+	}
+
+	/* Copies a blob out into an array */
+	template<typename ElementType>
+	void CopyBlob(uint32 Offset, int32 Num, TArray<ElementType>& OutArray) const
+	{
+		OutArray.SetNumUninitialized(Num);
+		FMemory::Memcpy(OutArray.GetData(), GetBlob(Offset), Num * sizeof(ElementType));
+	}
+
+private:
+	TArray<uint8> Data;
+
+	friend class FRuntimeMeshCache;
+};
+
+
+/*
+*	Persistent cache of generated sections and cooked collision in the project's saved directory, so meshes that were
+*	already made in an earlier session don't have to be generated or cooked again.
+*
+*	Section entries are keyed by a hash of whatever the section is generated from, supplied by the caller, or by the
+*	content hash of the section. Collision entries are keyed by the content hash of the mesh being cooked, so they're
+*	found whatever sections it was built from. The cache is bounded by RuntimeMesh.CacheMaxSizeMB, the least recently
+*	used entries are evicted first. Entries are versioned by FRuntimeMeshVersion and the engine version.
+*
+*	Entries are read back with a single read of the whole file. Safe to use from any thread.
+*/
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshCache
+{
+public:
+	static FRuntimeMeshCache& Get();
+
+	/* Hashes a block of memory, continuing from Hash (FNV-1a) */
+	static uint64 HashBytes(const void* Data, SIZE_T Size, uint64 Hash = 0xcbf29ce484222325ull);
+
+	/* Content hash of a sections buffers and vertex type */
+	static uint64 HashSection(const FRuntimeMeshCacheSectionView& Section);
+
+	/* Content hash of a collision mesh and the settings of the body setup it's about to be cooked into */
+	static uint64 HashCollision(const FTriMeshCollisionData& CollisionData, const UBodySetup* BodySetup);
+
+	/* Stores a section, replacing any entry with the same key */
+	bool StoreSection(uint64 Key, const FRuntimeMeshCacheSectionView& Section);
+
+	/* Reads a section entry back, returns false if there's none for Key or it was stored with a different vertex type */
+	bool LoadSection(uint64 Key, const FRuntimeMeshVertexTypeInfo& VertexType, int32 VertexStride, FRuntimeMeshCacheEntry& OutEntry);
+
+	/* Cooks a body setup if it hasn't been yet and stores its cooked data. Must be called before CreatePhysicsMeshes() which drops the cooked data outside the editor */
+	bool StoreCollision(uint64 Key, UBodySetup* BodySetup);
+
+	/* Fills in the cooked data of a body setup from the cache so it doesn't need cooking, returns false if there's no entry for Key */
+	bool LoadCollision(uint64 Key, UBodySetup* BodySetup);
+
+	/* Removes every entry */
+	void Clear();
+
+	/* Total size of all entries */
+	int64 GetTotalSize();
+
+private:
+	FRuntimeMeshCache();
+
+	struct FEntryInfo
+	{
+		int64 Size;
+		FDateTime LastUsed;
+	};
+
+	/* Directory the entries are kept in */
+	FString CacheDirectory;
+
+	/* Every entry on disk by file name, found the first time the cache is used */
+	TMap<FString, FEntryInfo> Entries;
+	int64 TotalSize;
+	bool bHasScannedEntries;
+
+	FCriticalSection EntriesLock;
+
+	FString GetEntryFileName(uint64 Key, ERuntimeMeshCacheEntryType EntryType) const;
+
+	/* Fills in the header shared by every entry type */
+	void InitHeader(FRuntimeMeshCacheEntryHeader& Header, uint64 Key, ERuntimeMeshCacheEntryType EntryType) const;
+
+	/* Writes an entry and evicts the oldest entries if that takes the cache over its size */
+	bool WriteEntry(const FString& FileName, TArray<uint8>& Data);
+
+	/* Reads and validates an entry, marking it as used */
+	bool ReadEntry(uint64 Key, ERuntimeMeshCacheEntryType EntryType, FRuntimeMeshCacheEntry& OutEntry);
+
+	/* Finds the entries on disk. Must be called with EntriesLock held */
+	void ScanEntries();
+
+	/* Removes least recently used entries until the cache fits its budget. Must be called with EntriesLock held */
+	void EvictEntries();
+};
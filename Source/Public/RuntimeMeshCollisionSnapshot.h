@@ -0,0 +1,77 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "CoreUObject.h"
+#include "Interfaces/Interface_CollisionDataProvider.h"
+#include "Async/Async.h"
+#include "RuntimeMeshCollisionSnapshot.generated.h"
+
+class UBodySetup;
+
+/*
+*	Copy of a components collision mesh used to cook a new body setup off the game thread.
+*	This is the outer of the body setup being cooked so the cooker pulls the mesh from here
+*	instead of from the component, which is free to keep editing its sections meanwhile.
+*/
+UCLASS(Transient)
+class RUNTIMEMESHCOMPONENT_API URuntimeMeshCollisionSnapshot : public UObject, public IInterface_CollisionDataProvider
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Collision mesh at the time the snapshot was taken */
+	FTriMeshCollisionData CollisionData;
+
+	/* Body setup being cooked from this snapshot */
+	UPROPERTY()
+	UBodySetup* BodySetup;
+
+	/* Collision cache key to store the cooked data under once it's done, 0 if it isn't to be stored */
+	uint64 CacheKey;
+
+	/* Cook generation of the component when this was taken, the result is discarded if a newer cook was started since. For section elements this is the batch it's cooked in */
+	uint32 Generation;
+
+	/* Collision element this is cooked for, only used for section collision elements */
+	int32 ElementIndex;
+
+	/* Is ElementIndex a collision section element rather than a mesh section element */
+	bool bIsCollisionSectionElement;
+
+	/* Hash of the element mesh being cooked, see FRuntimeMeshCollisionElement::ContentHash */
+	uint32 ContentHash;
+
+	/* Starts cooking BodySetup on the thread pool */
+	void StartCook();
+
+	/* Has the background cook finished? */
+	bool IsCookComplete() const;
+
+	/* Blocks until the background cook has finished */
+	void WaitForCook() const;
+
+	/* Hands the data cooked on the worker to BodySetup. Must be called once the cook is complete, before creating its meshes */
+	void ApplyCookedData();
+
+	/* Frees the copied mesh once the cooked data is held by the body setup */
+	void ReleaseCollisionData();
+
+	//~ Begin UObject Interface.
+	virtual void BeginDestroy() override;
+	//~ End UObject Interface.
+
+	//~ Begin Interface_CollisionDataProvider Interface
+	virtual bool GetPhysicsTriMeshData(struct FTriMeshCollisionData* OutCollisionData, bool InUseAllTriData) override;
+	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override;
+	virtual bool WantsNegXTriMesh() override { return false; }
+	//~ End Interface_CollisionDataProvider Interface
+
+private:
+	/* Result of the background cook, true if cooked data was produced */
+	TFuture<bool> CookResult;
+
+	/* Data cooked on the worker, only written by it until the cook is complete */
+	TArray<uint8> CookedData;
+};
@@ -6,6 +6,10 @@
 #include "RuntimeMeshCore.h"
 #include "RuntimeMeshSection.h"
 #include "RuntimeMeshGenericVertex.h"
+#include "RuntimeMeshBuilder.h"
+#include "RuntimeMeshAsync.h"
+#include "RuntimeMeshSimplifier.h"
+#include "RuntimeMeshSharedData.h"
 #include "PhysicsEngine/ConvexElem.h"
 #include "RuntimeMeshComponent.generated.h"
 
@@ -53,6 +57,80 @@ struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshComponentPrePhysicsTickFunction : pu
 	virtual FString DiagnosticMessage() override;
 };
 
+/*
+*	This tick function flushes the updates collected by bAutoBatchUpdates and commits finished async sections. 
+*	It runs at the end of the frame, and is only enabled while either is pending so components without any don't pay for it.
+*/
+USTRUCT()
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshComponentEndOfFrameTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* Target RMC to tick */
+	class URuntimeMeshComponent* Target;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+		const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	virtual FString DiagnosticMessage() override;
+};
+
+/*
+*	Cooked collision for a single mesh section or collision section when using incremental section collision.
+*	Each gets its own body so changing one section doesn't re-cook the others.
+*/
+USTRUCT()
+struct FRuntimeMeshCollisionElement
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* Hash of the mesh BodySetup was cooked from, used to skip re-cooking unchanged sections */
+	uint32 ContentHash;
+
+	/* Hash of the mesh of the newest async cook for this element, 0 if none is in flight. Older cooks are discarded when they finish */
+	uint32 PendingContentHash;
+
+	/* Cooked trimesh for this element */
+	UPROPERTY()
+	UBodySetup* BodySetup;
+
+	/* Physics body for this element, only exists while the components physics state is created */
+	FBodyInstance* BodyInstance;
+
+	FRuntimeMeshCollisionElement()
+		: ContentHash(0), PendingContentHash(0), BodySetup(nullptr), BodyInstance(nullptr)
+	{}
+};
+
+/* Fired once new collision has been cooked and swapped in */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FRuntimeMeshCollisionUpdatedDelegate);
+
+/* Memory held by a runtime mesh component, see URuntimeMeshComponent::GetMemoryUsage() */
+struct FRuntimeMeshMemoryUsage
+{
+	int32 NumSections;
+	int32 NumVertices;
+	int32 NumIndices;
+
+	/* Game thread copies of the mesh data */
+	SIZE_T CPUVertexBytes;
+	SIZE_T CPUPositionBytes;
+	SIZE_T CPUIndexBytes;
+	SIZE_T CPUCollisionBytes;
+
+	/* RHI buffers, including every copy kept for frequently updated sections */
+	SIZE_T GPUVertexBytes;
+	SIZE_T GPUIndexBytes;
+
+	FRuntimeMeshMemoryUsage()
+		: NumSections(0), NumVertices(0), NumIndices(0), CPUVertexBytes(0), CPUPositionBytes(0), CPUIndexBytes(0), CPUCollisionBytes(0)
+		, GPUVertexBytes(0), GPUIndexBytes(0)
+	{ }
+
+	SIZE_T GetCPUBytes() const { return CPUVertexBytes + CPUPositionBytes + CPUIndexBytes + CPUCollisionBytes; }
+	SIZE_T GetGPUBytes() const { return GPUVertexBytes + GPUIndexBytes; }
+};
+
 /**
 *	Component that allows you to specify custom triangle mesh geometry for rendering and collision.
 */
@@ -79,33 +157,228 @@ private:
 
 		// Store section at index
 		MeshSections[SectionIndex] = NewSection;
+		AddValidSectionIndex(SectionIndex);
+
+		// Any pending async result for this section is older than this
+		SupersedeAsyncSections(SectionIndex);
 
 		return NewSection;
 	}
+
+	/* Creates a section from a builder, moving its buffers into the section. Computes the bounds unless they're supplied */
+	template<typename VertexType>
+	void CreateMeshSectionFromBuilder(int32 SectionIndex, FRuntimeMeshBuilder<VertexType>& Builder, const FBox* BoundingBox, bool bCreateCollision,
+		EUpdateFrequency UpdateFrequency, ESectionUpdateFlags UpdateFlags)
+	{
+		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = CreateOrResetSection<FRuntimeMeshSection<VertexType>>(SectionIndex, Builder.IsDualBuffer());
+
+		// Vertices first so the position buffer has the final say on the bounds of a dual buffer section
+		Section->UpdateVertexBuffer(Builder.Vertices, BoundingBox, true);
+		if (Builder.IsDualBuffer())
+		{
+			Section->UpdateVertexPositionBuffer(Builder.Positions, BoundingBox, true);
+		}
+		Section->UpdateIndexBuffer(Builder.Indices, true);
+		Builder.Reset();
+
+		// Track collision status and update collision information if necessary
+		Section->CollisionEnabled = bCreateCollision;
+		Section->UpdateFrequency = UpdateFrequency;
+
+		// Finalize section.
+		CreateSectionInternal(SectionIndex, UpdateFlags);
+	}
+
+	/* Replaces the mesh of a section with a builders, moving its buffers into the section. Computes the bounds unless they're supplied */
+	template<typename VertexType>
+	void UpdateMeshSectionFromBuilder(const TSharedPtr<FRuntimeMeshSection<VertexType>>& Section, int32 SectionIndex, FRuntimeMeshBuilder<VertexType>& Builder,
+		const FBox* BoundingBox, ESectionUpdateFlags UpdateFlags)
+	{
+		// Vertices first so the position buffer has the final say on the bounds of a dual buffer section
+		bool bNeedsBoundsUpdate = Section->UpdateVertexBuffer(Builder.Vertices, BoundingBox, true);
+		if (Builder.IsDualBuffer())
+		{
+			bNeedsBoundsUpdate |= Section->UpdateVertexPositionBuffer(Builder.Positions, BoundingBox, true);
+		}
+		Section->UpdateIndexBuffer(Builder.Indices, true);
+		Builder.Reset();
+
+		// Finalize section update
+		UpdateSectionInternal(SectionIndex, Builder.IsDualBuffer(), true, true, bNeedsBoundsUpdate, UpdateFlags);
+	}
+
+	/* Moves the buffers of one builder into another with the same layout */
+	template<typename VertexType>
+	static void MoveBuilder(FRuntimeMeshBuilder<VertexType>& Dest, FRuntimeMeshBuilder<VertexType>& Source)
+	{
+		check(Dest.IsDualBuffer() == Source.IsDualBuffer());
+		Dest.Positions = MoveTemp(Source.Positions);
+		Dest.Vertices = MoveTemp(Source.Vertices);
+		Dest.Indices = MoveTemp(Source.Indices);
+		Source.Reset();
+	}
+
+	/* Runs an async sections generator then validates its result and computes the bounds. Runs on the thread pool */
+	template<typename VertexType>
+	static void GenerateAsyncSection(TRuntimeMeshAsyncSectionJob<VertexType>& Job)
+	{
+		// Don't bother if it's been cancelled or superseded while queued
+		if (Job.State->GetStatus() != ERuntimeMeshAsyncSectionStatus::Pending)
+		{
+			return;
+		}
+
+		FRuntimeMeshBuilder<VertexType>& Builder = Job.Builder;
+		if (Job.Generator)
+		{
+			Job.Generator(Builder);
+
+			// Release anything the generator holds on to here instead of on the game thread
+			Job.Generator = nullptr;
+		}
+
+		Job.Error = RuntimeMeshAsyncInternal::ValidateMesh(Builder.Vertices.Num(), Builder.Positions.Num(), Builder.IsDualBuffer(), Builder.Indices);
+		if (Job.Error.IsEmpty())
+		{
+			Job.BoundingBox = Builder.IsDualBuffer() ?
+				FRuntimeMeshBounds::ComputeBounds(Builder.Positions.GetData(), Builder.Positions.Num()) :
+				RuntimeMeshAsyncInternal::ComputeVertexBounds(Builder.Vertices);
+
+			// Optimize here on the worker instead of leaving it to the game thread when the section is created
+			const ESectionUpdateFlags OptimizeFlags = ESectionUpdateFlags::OptimizeMesh | ESectionUpdateFlags::OptimizeVertexOrder;
+			if (Job.bIsCreate && (Job.UpdateFlags & OptimizeFlags) != ESectionUpdateFlags::None)
+			{
+				SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_OptimizeMesh);
+
+				TArray<int32> Remap;
+				const bool bReorderVertices = (Job.UpdateFlags & ESectionUpdateFlags::OptimizeVertexOrder) != ESectionUpdateFlags::None;
+				FRuntimeMeshOptimizer::OptimizeMesh<VertexType>(Builder.Vertices, Builder.IsDualBuffer() ? &Builder.Positions : nullptr,
+					Builder.Indices, bReorderVertices ? &Remap : nullptr);
+
+				Job.UpdateFlags &= ~OptimizeFlags;
+			}
+		}
+	}
+
+	/* Moves a generated async section into the component. Called on the game thread, inside a batch update */
+	template<typename VertexType>
+	void CommitAsyncSection(TRuntimeMeshAsyncSectionJob<VertexType>& Job)
+	{
+		const TCHAR* FunctionName = Job.bIsCreate ? TEXT("CreateMeshSectionAsync()") : TEXT("UpdateMeshSectionAsync()");
+
+		if (!Job.Error.IsEmpty())
+		{
+			if (Job.State->Finish(ERuntimeMeshAsyncSectionStatus::Failed))
+			{
+				Log(FString::Printf(TEXT("%s - %s Section %d will not be changed."), FunctionName, *Job.Error, Job.SectionIndex), true);
+			}
+			return;
+		}
+
+		if (Job.bIsCreate)
+		{
+			if (Job.State->Finish(ERuntimeMeshAsyncSectionStatus::Committed))
+			{
+				CreateMeshSectionFromBuilder(Job.SectionIndex, Job.Builder, &Job.BoundingBox, Job.bCreateCollision, Job.UpdateFrequency, Job.UpdateFlags);
+			}
+			return;
+		}
+
+		// The section may have been cleared or recreated differently while this was generated
+		bool bSectionMatches = Job.SectionIndex < MeshSections.Num() && MeshSections[Job.SectionIndex].IsValid() &&
+			MeshSections[Job.SectionIndex]->GetVertexType()->Equals(&VertexType::TypeInfo) &&
+			MeshSections[Job.SectionIndex]->IsDualBufferSection() == Job.Builder.IsDualBuffer();
+		if (!bSectionMatches)
+		{
+			if (Job.State->Finish(ERuntimeMeshAsyncSectionStatus::Failed))
+			{
+				Log(FString::Printf(TEXT("%s - Section %d no longer matches the generated mesh. Section will not be updated."), FunctionName, Job.SectionIndex), true);
+			}
+			return;
+		}
+
+		if (Job.State->Finish(ERuntimeMeshAsyncSectionStatus::Committed))
+		{
+			TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[Job.SectionIndex]);
+			UpdateMeshSectionFromBuilder(Section, Job.SectionIndex, Job.Builder, &Job.BoundingBox, Job.UpdateFlags);
+		}
+	}
+
+	/* Starts generating an async section on the thread pool, superseding any pending one for the same section */
+	FRuntimeMeshAsyncSectionHandle QueueAsyncSectionJob(const TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>& Job);
+
+	/* Drops any pending async results for a section. bOnlyDerived leaves the ones that change the section's mesh */
+	void SupersedeAsyncSections(int32 SectionIndex, bool bOnlyDerived = false);
+
+	/* Commits all async sections whose generation has finished */
+	void CommitFinishedAsyncSections();
+
+	/* Moves simplified LODs into their section. Called on the game thread, inside a batch update */
+	void CommitAsyncSectionLODs(class FRuntimeMeshAsyncLODJob& Job);
+
+	/* Enables the end of frame tick if there's anything for it to do */
+	void UpdateEndOfFrameTickEnabled();
 		
 	/* Creates a mesh section of an internal type meant for the generic vertex and the old PMC style API */
 	TSharedPtr<FRuntimeMeshSectionInterface> CreateOrResetSectionInternalType(int32 SectionIndex, int32 NumUVChannels, bool WantsHalfPrecsionUVs);
 
-	/* Gets the material for a section or the default material if one's not provided. */
+	/* Gets the material for a section or the default material if one's not provided. Instanced sections also fall back to the default if the material can't be used with instancing */
 	UMaterialInterface* GetSectionMaterial(int32 Index)
 	{
 		auto Material = GetMaterial(Index);
+		if (Material && Index < MeshSections.Num() && MeshSections[Index].IsValid() && MeshSections[Index]->bIsInstanced &&
+			!Material->CheckMaterialUsage_Concurrent(MATUSAGE_InstancedStaticMeshes))
+		{
+			Material = nullptr;
+		}
 		return Material ? Material : UMaterial::GetDefaultMaterial(MD_Surface);
 	}
 
 
 	/* Finishes creating a section, including entering it for batch updating, or updating the RT directly */
-	void CreateSectionInternal(int32 SectionIndex);
+	void CreateSectionInternal(int32 SectionIndex, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
 
 	/* Finishes updating a section, including entering it for batch updating, or updating the RT directly */
-	void UpdateSectionInternal(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates, bool bNeedsBoundsUpdate);
+	void UpdateSectionInternal(int32 SectionIndex, bool bHadVertexPositionsUpdate, bool bHadVertexUpdates, bool bHadIndexUpdates, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
+
+	/* Finishes a range update of a section, including entering it for batch updating, or updating the RT directly */
+	void UpdateSectionRangeInternal(int32 SectionIndex, bool bNeedsBoundsUpdate, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
 
 	/* Finishes updating a sections positions (Only used if section is dual vertex buffer), including entering it for batch updating, or updating the RT directly */
 	void UpdateSectionVertexPositionsInternal(int32 SectionIndex, bool bNeedsBoundsUpdate);
 
 	/* Finishes updating a sections properties, like visible/casts shadow, a*/
-	void UpdateSectionPropertiesInternal(int32 SectionIndex, bool bUpdateRequiresProxyRecreateIfStatic);
+	void UpdateSectionPropertiesInternal(int32 SectionIndex);
+
+	/* Finishes updating a sections instances, including entering it for batch updating, or updating the RT directly. bInstancingChanged recreates the section proxy */
+	void UpdateSectionInstancesInternal(int32 SectionIndex, bool bInstancingChanged);
+
+	/* Checks an instance update against a section, logging why it can't be applied */
+	bool ValidateInstanceUpdate(const TCHAR* FunctionName, int32 SectionIndex, const TArray<FTransform>& Transforms, const TArray<float>& CustomData);
+
+	/* Does a change to this section need the scene proxy recreated. Packed sections are repacked, and static sections need it on engines that can't re-cache their static meshes */
+	bool RequiresProxyRecreateForChange(const FRuntimeMeshSectionInterface& Section) const
+	{
+		return Section.UpdateFrequency == EUpdateFrequency::Infrequent && (bMergeSectionsForRendering || !RUNTIMEMESH_ENABLE_STATIC_SECTION_UPDATES);
+	}
 	
+	/* 
+	 *	Partial updates are checked against and merged into the game thread copy of the data, which render only sections 
+	 *	release once it's been sent. Logs why and returns false for those.
+	 */
+	bool CanPartiallyUpdateSection(int32 SectionIndex, const TCHAR* FunctionName)
+	{
+		if (MeshSections[SectionIndex]->bHasReleasedCPUData)
+		{
+			Log(FString::Printf(TEXT("%s - Section %d is render only and its data has been released, so it can only be updated with all its positions, vertices and triangles."), FunctionName, SectionIndex), true);
+			return false;
+		}
+		return true;
+	}
+
+	/* Does any section release its game thread data once it's been sent to the RT */
+	bool HasRenderOnlySections() const;
+
 	/* Internal log helper for the templates to be able to use the internal logger */
 	void Log(FString Text, bool bIsError = false)
 	{
@@ -154,7 +427,7 @@ public:
 		Section->UpdateFrequency = UpdateFrequency;
 
 		// Finalize section.
-		CreateSectionInternal(SectionIndex);
+		CreateSectionInternal(SectionIndex, UpdateFlags);
 	}
 
 	/**
@@ -190,7 +463,7 @@ public:
 		Section->UpdateFrequency = UpdateFrequency;
 
 		// Finalize section.
-		CreateSectionInternal(SectionIndex);
+		CreateSectionInternal(SectionIndex, UpdateFlags);
 	}
 
 	/**
@@ -224,7 +497,7 @@ public:
 		Section->UpdateFrequency = UpdateFrequency;
 
 		// Finalize section.
-		CreateSectionInternal(SectionIndex);
+		CreateSectionInternal(SectionIndex, UpdateFlags);
 	}
 
 	/**
@@ -260,9 +533,238 @@ public:
 		Section->UpdateFrequency = UpdateFrequency;
 
 		// Finalize section.
-		CreateSectionInternal(SectionIndex);
+		CreateSectionInternal(SectionIndex, UpdateFlags);
 	}
 	
+	/**
+	*	Create/replace a section from a builder. The builders buffers are moved into the section, so nothing is copied
+	*	and the builder is left empty. A dual buffer builder creates a dual buffer section.
+	*	@param	SectionIndex		Index of the section to create or replace.
+	*	@param	Builder				Builder holding the vertices and triangles for this section.
+	*	@param	bCreateCollision	Indicates whether collision should be created for this section. This adds significant cost.
+	*	@param	UpdateFrequency		Indicates how frequently the section will be updated. Allows the RMC to optimize itself to a particular use.
+	*	@param	UpdateFlags			Flags pertaining to this particular update. MoveArrays is always implied.
+	*/
+	template<typename VertexType>
+	void CreateMeshSection(int32 SectionIndex, FRuntimeMeshBuilder<VertexType>& Builder, bool bCreateCollision = false,
+		EUpdateFrequency UpdateFrequency = EUpdateFrequency::Average, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateMeshSection_Builder);
+
+		// Validate all creation parameters
+		RMC_VALIDATE_CREATIONPARAMETERS(SectionIndex, Builder.Vertices, Builder.Indices);
+
+		CreateMeshSectionFromBuilder(SectionIndex, Builder, nullptr, bCreateCollision, UpdateFrequency, UpdateFlags);
+	}
+
+	/**
+	*	Create/replace a section from the persistent mesh cache, skipping generating it. The entry has to have been stored
+	*	with SaveMeshSectionToCache() from a section of the same vertex type.
+	*	@param	SectionIndex		Index of the section to create or replace.
+	*	@param	Key					Key the section was stored with, a hash of whatever the section is generated from.
+	*	@param	bCreateCollision	Indicates whether collision should be created for this section. This adds significant cost.
+	*	@param	UpdateFrequency		Indicates how frequently the section will be updated. Allows the RMC to optimize itself to a particular use.
+	*	@param	UpdateFlags			Flags pertaining to this particular update. MoveArrays is always implied.
+	*	@return	False if there's no usable entry for Key, in which case the section is left as it was.
+	*/
+	template<typename VertexType>
+	bool CreateMeshSectionFromCache(int32 SectionIndex, uint64 Key, bool bCreateCollision = false,
+		EUpdateFrequency UpdateFrequency = EUpdateFrequency::Average, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CreateMeshSectionFromCache);
+
+		check(SectionIndex >= 0);
+
+		FRuntimeMeshCacheEntry Entry;
+		if (!FRuntimeMeshCache::Get().LoadSection(Key, VertexType::TypeInfo, sizeof(VertexType), Entry))
+		{
+			return false;
+		}
+
+		const FRuntimeMeshCacheEntryHeader& Header = Entry.GetHeader();
+		const FBox BoundingBox = Entry.GetBounds();
+
+		TArray<VertexType> Vertices;
+		TArray<int32> Triangles;
+		Entry.CopyBlob(Header.VertexOffset, Header.NumVertices, Vertices);
+		Entry.CopyBlob(Header.IndexOffset, Header.NumIndices, Triangles);
+
+		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = CreateOrResetSection<FRuntimeMeshSection<VertexType>>(SectionIndex, Entry.IsDualBuffer());
+
+		// The stored bounds are used as they are, a dual buffer section takes them from the position buffer
+		if (Entry.IsDualBuffer())
+		{
+			TArray<FVector> Positions;
+			Entry.CopyBlob(Header.PositionOffset, Header.NumPositions, Positions);
+
+			Section->UpdateVertexPositionBuffer(Positions, &BoundingBox, true);
+			Section->UpdateVertexBuffer(Vertices, nullptr, true);
+		}
+		else
+		{
+			Section->UpdateVertexBuffer(Vertices, &BoundingBox, true);
+		}
+		Section->UpdateIndexBuffer(Triangles, true);
+
+		// Track collision status and update collision information if necessary
+		Section->CollisionEnabled = bCreateCollision;
+		Section->UpdateFrequency = UpdateFrequency;
+
+		// Finalize section.
+		CreateSectionInternal(SectionIndex, UpdateFlags);
+		return true;
+	}
+
+	/**
+	*	Updates a section from a builder, replacing all its vertices and triangles. The builders buffers are moved
+	*	into the section, so nothing is copied and the builder is left empty. The builder must match the section's
+	*	vertex type and dual buffer layout.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	Builder				Builder holding the vertices and triangles for this section.
+	*	@param	UpdateFlags			Flags pertaining to this particular update. MoveArrays is always implied.
+	*/
+	template<typename VertexType>
+	void UpdateMeshSection(int32 SectionIndex, FRuntimeMeshBuilder<VertexType>& Builder, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSection_Builder);
+
+		// Validate all update parameters
+		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+		// Validate section type
+		MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<VertexType>();
+
+		// Cast section to correct type
+		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
+
+		if (Section->IsDualBufferSection() != Builder.IsDualBuffer())
+		{
+			Log(TEXT("UpdateMeshSection() - Builder and section must both be dual buffer or both not be."), true);
+			return;
+		}
+
+		if (Builder.NumVertices() == 0 || Builder.NumTriangles() == 0)
+		{
+			Log(TEXT("UpdateMeshSection() - Builder is empty. Section will not be updated."), true);
+			return;
+		}
+
+		UpdateMeshSectionFromBuilder(Section, SectionIndex, Builder, nullptr, UpdateFlags);
+	}
+
+	/**
+	*	Create/replace a section with a mesh generated on the thread pool. The generator fills the builder on a worker thread, 
+	*	where the mesh is also validated and its bounds computed. The result is committed on the game thread at the end of the frame 
+	*	it finishes in, in one batch update with any other results ready by then. A newer async create or update, a direct create, 
+	*	or clearing the section supersedes a pending result. The generator must not touch the component or other UObjects.
+	*	VertexType can't be deduced from a lambda, so it has to be given: CreateMeshSectionAsync<FRuntimeMeshVertexSimple>(0, Generator).
+	*	@param	SectionIndex		Index of the section to create or replace.
+	*	@param	Generator			Fills the builder with the vertices and triangles for this section. Runs on a worker thread.
+	*	@param	bCreateCollision	Indicates whether collision should be created for this section. This adds significant cost.
+	*	@param	UpdateFrequency		Indicates how frequently the section will be updated. Allows the RMC to optimize itself to a particular use.
+	*	@param	UpdateFlags			Flags pertaining to this particular update. MoveArrays is always implied.
+	*	@param	bIsDualBuffer		Should the builder and section keep positions in their own buffer.
+	*	@return	Handle to cancel the section or check on it.
+	*/
+	template<typename VertexType>
+	FRuntimeMeshAsyncSectionHandle CreateMeshSectionAsync(int32 SectionIndex, TFunction<void(FRuntimeMeshBuilder<VertexType>&)> Generator, bool bCreateCollision = false,
+		EUpdateFrequency UpdateFrequency = EUpdateFrequency::Average, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None,
+		bool bIsDualBuffer = !FVertexHasPositionComponent<VertexType>::Value)
+	{
+		check(SectionIndex >= 0 && "SectionIndex cannot be negative.");
+
+		auto* Job = new TRuntimeMeshAsyncSectionJob<VertexType>(SectionIndex, true, bIsDualBuffer);
+		Job->Generator = MoveTemp(Generator);
+		Job->bCreateCollision = bCreateCollision;
+		Job->UpdateFrequency = UpdateFrequency;
+		Job->UpdateFlags = UpdateFlags;
+
+		return QueueAsyncSectionJob(MakeShareable(Job));
+	}
+
+	/**
+	*	Create/replace a section from a filled builder, validating it and computing its bounds on the thread pool.
+	*	The builders buffers are moved into the job, so the builder is left empty. See the generator overload for how the result is committed.
+	*	@param	SectionIndex		Index of the section to create or replace.
+	*	@param	Builder				Builder holding the vertices and triangles for this section.
+	*	@param	bCreateCollision	Indicates whether collision should be created for this section. This adds significant cost.
+	*	@param	UpdateFrequency		Indicates how frequently the section will be updated. Allows the RMC to optimize itself to a particular use.
+	*	@param	UpdateFlags			Flags pertaining to this particular update. MoveArrays is always implied.
+	*	@return	Handle to cancel the section or check on it.
+	*/
+	template<typename VertexType>
+	FRuntimeMeshAsyncSectionHandle CreateMeshSectionAsync(int32 SectionIndex, FRuntimeMeshBuilder<VertexType>& Builder, bool bCreateCollision = false,
+		EUpdateFrequency UpdateFrequency = EUpdateFrequency::Average, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		check(SectionIndex >= 0 && "SectionIndex cannot be negative.");
+
+		auto* Job = new TRuntimeMeshAsyncSectionJob<VertexType>(SectionIndex, true, Builder.IsDualBuffer());
+		MoveBuilder(Job->Builder, Builder);
+		Job->bCreateCollision = bCreateCollision;
+		Job->UpdateFrequency = UpdateFrequency;
+		Job->UpdateFlags = UpdateFlags;
+
+		return QueueAsyncSectionJob(MakeShareable(Job));
+	}
+
+	/**
+	*	Updates a section with a mesh generated on the thread pool, replacing all its vertices and triangles. 
+	*	The builder handed to the generator matches the section's dual buffer layout. If the section no longer exists or has 
+	*	changed vertex type by the time the result is ready, it's dropped. See CreateMeshSectionAsync for how the result is committed.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	Generator			Fills the builder with the vertices and triangles for this section. Runs on a worker thread.
+	*	@param	UpdateFlags			Flags pertaining to this particular update. MoveArrays is always implied.
+	*	@return	Handle to cancel the update or check on it.
+	*/
+	template<typename VertexType>
+	FRuntimeMeshAsyncSectionHandle UpdateMeshSectionAsync(int32 SectionIndex, TFunction<void(FRuntimeMeshBuilder<VertexType>&)> Generator, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		// Validate all update parameters
+		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+		// Validate section type
+		MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<VertexType>();
+
+		auto* Job = new TRuntimeMeshAsyncSectionJob<VertexType>(SectionIndex, false, MeshSections[SectionIndex]->IsDualBufferSection());
+		Job->Generator = MoveTemp(Generator);
+		Job->UpdateFlags = UpdateFlags;
+
+		return QueueAsyncSectionJob(MakeShareable(Job));
+	}
+
+	/**
+	*	Updates a section from a filled builder, validating it and computing its bounds on the thread pool.
+	*	The builders buffers are moved into the job, so the builder is left empty. See UpdateMeshSectionAsync with a generator.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	Builder				Builder holding the vertices and triangles for this section.
+	*	@param	UpdateFlags			Flags pertaining to this particular update. MoveArrays is always implied.
+	*	@return	Handle to cancel the update or check on it.
+	*/
+	template<typename VertexType>
+	FRuntimeMeshAsyncSectionHandle UpdateMeshSectionAsync(int32 SectionIndex, FRuntimeMeshBuilder<VertexType>& Builder, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		// Validate all update parameters
+		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+		// Validate section type
+		MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<VertexType>();
+
+		if (MeshSections[SectionIndex]->IsDualBufferSection() != Builder.IsDualBuffer())
+		{
+			Log(TEXT("UpdateMeshSectionAsync() - Builder and section must both be dual buffer or both not be."), true);
+			return FRuntimeMeshAsyncSectionHandle();
+		}
+
+		auto* Job = new TRuntimeMeshAsyncSectionJob<VertexType>(SectionIndex, false, Builder.IsDualBuffer());
+		MoveBuilder(Job->Builder, Builder);
+		Job->UpdateFlags = UpdateFlags;
+
+		return QueueAsyncSectionJob(MakeShareable(Job));
+	}
+
+	/** Cancels all pending async section creates and updates */
+	void CancelAllAsyncSections();
+
 	/**
 	*	Updates a section. This is faster than CreateMeshSection. If this is a dual buffer section, you cannot change the length of the vertices.
 	*	@param	SectionIndex		Index of the section to update.
@@ -283,6 +785,12 @@ public:
 		// Cast section to correct type
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 		
+		// The positions aren't part of this update, so a released dual buffer section has nothing left to check them against
+		if (Section->IsDualBufferSection() && !CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSection()")))
+		{
+			return;
+		}
+
 		// Check dual buffer section status
 		if (Section->IsDualBufferSection() && Vertices.Num() != Section->VertexBuffer.Num())
 		{
@@ -308,7 +816,7 @@ public:
 		// Finalize section update if we have anything to apply
 		if (bUpdatedVertices)
 		{
-			UpdateSectionInternal(SectionIndex, false, bUpdatedVertices, false, bNeedsBoundsUpdate);
+			UpdateSectionInternal(SectionIndex, false, bUpdatedVertices, false, bNeedsBoundsUpdate, UpdateFlags);
 		}
 	}
 
@@ -334,6 +842,12 @@ public:
 		// Cast section to correct type
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
+		// The positions aren't part of this update, so a released dual buffer section has nothing left to check them against
+		if (Section->IsDualBufferSection() && !CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSection()")))
+		{
+			return;
+		}
+
 		// Check dual buffer section status
 		if (Section->IsDualBufferSection() && Vertices.Num() != Section->VertexBuffer.Num())
 		{
@@ -359,7 +873,7 @@ public:
 		// Finalize section update if we have anything to apply
 		if (bUpdatedVertices)
 		{
-			UpdateSectionInternal(SectionIndex, false, bUpdatedVertices, false, bNeedsBoundsUpdate);
+			UpdateSectionInternal(SectionIndex, false, bUpdatedVertices, false, bNeedsBoundsUpdate, UpdateFlags);
 		}
 	}
 
@@ -384,6 +898,12 @@ public:
 		// Cast section to correct type
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
+		// The positions aren't part of this update, so a released dual buffer section has nothing left to check them against
+		if (Section->IsDualBufferSection() && !CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSection()")))
+		{
+			return;
+		}
+
 		// Check dual buffer section status
 		if (Section->IsDualBufferSection() && Vertices.Num() != Section->VertexBuffer.Num())
 		{
@@ -421,7 +941,7 @@ public:
 		// Finalize section update if we have anything to apply
 		if (bUpdatedVertices || bUpdatedIndices)
 		{
-			UpdateSectionInternal(SectionIndex, false, bUpdatedVertices, bUpdatedIndices, bNeedsBoundsUpdate);
+			UpdateSectionInternal(SectionIndex, false, bUpdatedVertices, bUpdatedIndices, bNeedsBoundsUpdate, UpdateFlags);
 		}
 	}
 
@@ -448,6 +968,12 @@ public:
 		// Cast section to correct type
 		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
 
+		// The positions aren't part of this update, so a released dual buffer section has nothing left to check them against
+		if (Section->IsDualBufferSection() && !CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSection()")))
+		{
+			return;
+		}
+
 		// Check dual buffer section status
 		if (Section->IsDualBufferSection() && Vertices.Num() != Section->VertexBuffer.Num())
 		{
@@ -485,7 +1011,7 @@ public:
 		// Finalize section update if we have anything to apply
 		if (bUpdatedVertices || bUpdatedIndices)
 		{
-			UpdateSectionInternal(SectionIndex, false, bUpdatedVertices, bUpdatedIndices, bNeedsBoundsUpdate);
+			UpdateSectionInternal(SectionIndex, false, bUpdatedVertices, bUpdatedIndices, bNeedsBoundsUpdate, UpdateFlags);
 		}
 	}
 
@@ -550,7 +1076,7 @@ public:
 		// Finalize section update if we have anything to apply
 		if (bUpdatedVertexPositions || bUpdatedVertices)
 		{
-			UpdateSectionInternal(SectionIndex, bUpdatedVertexPositions, bUpdatedVertices, false, bNeedsBoundsUpdate);
+			UpdateSectionInternal(SectionIndex, bUpdatedVertexPositions, bUpdatedVertices, false, bNeedsBoundsUpdate, UpdateFlags);
 		}
 	}
 
@@ -616,7 +1142,7 @@ public:
 		// Finalize section update if we have anything to apply
 		if (bUpdatedVertexPositions || bUpdatedVertices)
 		{
-			UpdateSectionInternal(SectionIndex, bUpdatedVertexPositions, bUpdatedVertices, false, bNeedsBoundsUpdate);
+			UpdateSectionInternal(SectionIndex, bUpdatedVertexPositions, bUpdatedVertices, false, bNeedsBoundsUpdate, UpdateFlags);
 		}
 	}
 
@@ -693,7 +1219,7 @@ public:
 		// Finalize section update if we have anything to apply
 		if (bUpdatedVertexPositions || bUpdatedVertices || bUpdatedIndices)
 		{
-			UpdateSectionInternal(SectionIndex, bUpdatedVertexPositions, bUpdatedVertices, bUpdatedIndices, bNeedsBoundsUpdate);
+			UpdateSectionInternal(SectionIndex, bUpdatedVertexPositions, bUpdatedVertices, bUpdatedIndices, bNeedsBoundsUpdate, UpdateFlags);
 		}
 	}
 
@@ -772,10 +1298,87 @@ public:
 		// Finalize section update if we have anything to apply
 		if (bUpdatedVertexPositions || bUpdatedVertices || bUpdatedIndices)
 		{
-			UpdateSectionInternal(SectionIndex, bUpdatedVertexPositions, bUpdatedVertices, bUpdatedIndices, bNeedsBoundsUpdate);
+			UpdateSectionInternal(SectionIndex, bUpdatedVertexPositions, bUpdatedVertices, bUpdatedIndices, bNeedsBoundsUpdate, UpdateFlags);
 		}
 	}
 
+
+	/**
+	*	Updates a contiguous range of a sections vertices in place. Only the changed vertices are sent to the GPU, 
+	*	so this is much faster than UpdateMeshSection when a small part of a large section changes.
+	*	The range must lie within the existing vertices. The bounds are only grown by range updates, never shrunk.
+	*	The first range update of a Frequent section sends it in full once, to move it to buffers that can be written in place.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	FirstVertex			Index of the first vertex to replace.
+	*	@param	Vertices			Replacement vertices, starting at FirstVertex.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	template<typename VertexType>
+	void UpdateMeshSectionRange(int32 SectionIndex, int32 FirstVertex, const TArray<VertexType>& Vertices, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_UpdateMeshSectionRange_VertexType);
+
+		// Validate all update parameters
+		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+		// Validate section type
+		MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<VertexType>();
+
+		// Cast section to correct type
+		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
+
+		if (Vertices.Num() == 0)
+		{
+			Log(TEXT("UpdateMeshSectionRange() - Vertices empty. They will not be updated."));
+			return;
+		}
+
+		if (!CanPartiallyUpdateSection(SectionIndex, TEXT("UpdateMeshSectionRange()")))
+		{
+			return;
+		}
+
+		if (FirstVertex < 0 || FirstVertex + Vertices.Num() > Section->VertexBuffer.Num())
+		{
+			Log(TEXT("UpdateMeshSectionRange() - Range must lie within the existing vertices. Use UpdateMeshSection to change the length."), true);
+			return;
+		}
+
+		bool bNeedsBoundsUpdate = Section->UpdateVertexBufferRange(FirstVertex, Vertices);
+
+		UpdateSectionRangeInternal(SectionIndex, bNeedsBoundsUpdate, UpdateFlags);
+	}
+
+	/**
+	*	Starts an in place update of a sections vertices. Use EndMeshSectionUpdate to send the changed spans to the GPU.
+	*	The length of the vertex buffer must not be changed.
+	*	@param	SectionIndex		Index of the section to update.
+	*/
+	template<typename VertexType>
+	TArray<VertexType>* BeginMeshSectionUpdate(int32 SectionIndex)
+	{
+		// Validate all update parameters
+		RMC_VALIDATE_UPDATEPARAMETERS(SectionIndex);
+
+		// Validate section type
+		MeshSections[SectionIndex]->GetVertexType()->EnsureEquals<VertexType>();
+
+		// Cast section to correct type
+		TSharedPtr<FRuntimeMeshSection<VertexType>> Section = StaticCastSharedPtr<FRuntimeMeshSection<VertexType>>(MeshSections[SectionIndex]);
+
+		// Edit detaches the buffer from any data the RT still references
+		return &Section->VertexBuffer.Edit();
+	}
+
+	/**
+	*	Finishes an in place update of a sections vertices. Only the supplied spans are sent to the GPU. 
+	*	Overlapping and adjacent spans are merged so each vertex is only sent once.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	DirtyRanges			Spans of the vertex buffer that were changed.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	void EndMeshSectionUpdate(int32 SectionIndex, const TArray<FRuntimeMeshBufferRange>& DirtyRanges, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
+
 	
 	/**
 	*	Updates a sections position buffer only. This cannot be used on a non-dual buffer section. You cannot change the length of the vertex position buffer with this function.
@@ -816,6 +1419,61 @@ public:
 	*/
 	void EndMeshSectionPositionUpdate(int32 SectionIndex, const FBox& BoundingBox);
 
+	/**
+	*	Finishes an in place update of vertex positions. Only the supplied spans are sent to the GPU.
+	*	The bounds are only grown to contain the changed positions, never shrunk.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	DirtyRanges			Spans of the position buffer that were changed.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	void EndMeshSectionPositionUpdate(int32 SectionIndex, const TArray<FRuntimeMeshBufferRange>& DirtyRanges, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
+
+	/**
+	*	Deforms a section on the GPU with no CPU copy of the positions. Deformer runs on the rendering thread, and dispatches
+	*	compute shaders that write the positions, and optionally the normals, through the UAVs in its target. Parameters for
+	*	the shaders are captured by the deformer. The section must have been created with ESectionUpdateFlags::GPUDeformable.
+	*	GPU written positions last until the section's data is next sent from the game thread (updates, or the scene proxy being recreated).
+	*	@param	SectionIndex		Index of the section to deform.
+	*	@param	Deformer			Dispatches the compute work. Called once on the rendering thread.
+	*	@param	ConservativeBounds	Bounds containing every position the deformer can write. Used for culling instead of the CPU positions.
+	*/
+	void DeformMeshSectionGPU(int32 SectionIndex, const FRuntimeMeshGPUDeformer& Deformer, const FBox& ConservativeBounds);
+
+	/**
+	*	Updates a contiguous range of a sections vertex positions in place. This cannot be used on a non-dual buffer section.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	FirstVertex			Index of the first position to replace.
+	*	@param	VertexPositions		Replacement positions, starting at FirstVertex.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	void UpdateMeshSectionPositionsRange(int32 SectionIndex, int32 FirstVertex, const TArray<FVector>& VertexPositions, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
+
+
+	/**
+	*	Updates a sections triangles only. This is faster than UpdateMeshSection when the vertices haven't changed.
+	*	Sections with 65536 vertices or fewer are automatically drawn using 16 bit indices.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	Triangles			Index buffer indicating which vertices make up each triangle. Length must be a multiple of 3.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	void UpdateMeshSectionTriangles(int32 SectionIndex, TArray<int32>& Triangles, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
+
+	/**
+	*	Updates a sections triangles only, using 16 bit indices. The section must have 65536 vertices or fewer.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	Triangles			Index buffer indicating which vertices make up each triangle. Length must be a multiple of 3.
+	*/
+	void UpdateMeshSectionTriangles(int32 SectionIndex, const TArray<uint16>& Triangles);
+
+	/**
+	*	Updates a contiguous range of a sections triangles in place. Only the changed indices are sent to the GPU.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	FirstIndex			Index of the first index to replace. Should be a multiple of 3.
+	*	@param	Triangles			Replacement indices, starting at FirstIndex.
+	*	@param	UpdateFlags			Flags pertaining to this particular update.
+	*/
+	void UpdateMeshSectionTrianglesRange(int32 SectionIndex, int32 FirstIndex, const TArray<int32>& Triangles, ESectionUpdateFlags UpdateFlags = ESectionUpdateFlags::None);
+
 
 	/**
 	*	Create/replace a section.
@@ -978,6 +1636,78 @@ public:
 	bool IsMeshSectionCollisionEnabled(int32 SectionIndex);
 
 
+	/**
+	*	Sets a lower detail LOD for a section. LODs index the sections own vertices, so lower detail
+	*	vertices can be appended to the section and only referenced by its LODs.
+	*	@param	SectionIndex		Index of the section to set the LOD of.
+	*	@param	LODIndex			LOD to set, starting at 1 as LOD 0 is the sections own triangles. Must be at most one past the current last LOD.
+	*	@param	Triangles			Index buffer for this LOD.
+	*	@param	ScreenSize			The LOD is drawn once the section's screen size drops below this. Should decrease with each LOD.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void SetMeshSectionLOD(int32 SectionIndex, int32 LODIndex, const TArray<int32>& Triangles, float ScreenSize);
+
+	/** Removes all the lower detail LODs from a section */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void ClearMeshSectionLODs(int32 SectionIndex);
+
+	/** Returns the number of LODs a section has, including LOD 0 */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	int32 GetNumMeshSectionLODs(int32 SectionIndex) const;
+
+	/**
+	*	Simplifies a section on the thread pool and replaces its LODs with the result. Each LOD is simplified from the one before it,
+	*	and only reuses the section's own vertices. Borders and seams are kept, see FRuntimeMeshSimplifier.
+	*	One of the LODs can also be set as a collision section, which turns off the section's own collision so that
+	*	complex collision is cooked from the simplified triangles instead of the render ones.
+	*	The result is dropped if the section's triangles or vertex count change before it's ready.
+	*	@param	SectionIndex			Index of the section to simplify.
+	*	@param	LODs					Settings for each LOD, starting at LOD 1.
+	*	@param	CollisionLODIndex		LOD to build collision from, starting at 1. INDEX_NONE leaves collision alone.
+	*	@param	CollisionSectionIndex	Collision section to set from it.
+	*/
+	FRuntimeMeshAsyncSectionHandle GenerateMeshSectionLODsAsync(int32 SectionIndex, const TArray<FRuntimeMeshSimplifySettings>& LODs,
+		int32 CollisionLODIndex = INDEX_NONE, int32 CollisionSectionIndex = 0);
+
+
+	/**
+	*	Adds instances to a section. A section with instances is drawn once per instance with hardware instancing,
+	*	so its material needs 'Used with Instanced Static Meshes'. Instanced sections don't build collision.
+	*	@param	SectionIndex		Index of the section to add the instances to.
+	*	@param	Transforms			Transform of each instance, relative to the component.
+	*	@param	CustomData			Optional value for each instance, read in the material through PerInstanceRandom. Either empty or one per transform.
+	*	@return	Index of the first instance added, or INDEX_NONE if they couldn't be added.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	int32 AddMeshSectionInstances(int32 SectionIndex, const TArray<FTransform>& Transforms, const TArray<float>& CustomData);
+
+	/**
+	*	Replaces a span of a section's instances. Only the changed instances are sent to the GPU.
+	*	@param	SectionIndex		Index of the section to update.
+	*	@param	FirstInstance		Index of the first instance to replace.
+	*	@param	Transforms			New transform of each instance in the span.
+	*	@param	CustomData			New custom data of each instance in the span. Empty keeps the current values.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void UpdateMeshSectionInstances(int32 SectionIndex, int32 FirstInstance, const TArray<FTransform>& Transforms, const TArray<float>& CustomData);
+
+	/** Removes a span of a section's instances. Instances after it move down to fill the gap */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void RemoveMeshSectionInstances(int32 SectionIndex, int32 FirstInstance, int32 NumInstances);
+
+	/** Removes all instances from a section, so it's drawn once like a regular section again */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void ClearMeshSectionInstances(int32 SectionIndex);
+
+	/** Returns the number of instances a section has, 0 if it's not instanced */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	int32 GetNumMeshSectionInstances(int32 SectionIndex) const;
+
+	/** Turns packing of static sections into shared buffers on or off. See bMergeSectionsForRendering */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void SetMergeSectionsForRendering(bool bNewMergeSections);
+
+
 	/** Returns number of sections currently created for this component */
 	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
 	int32 GetNumSections() const;
@@ -990,6 +1720,44 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
 	int32 FirstAvailableMeshSectionIndex(int32 SectionIndex) const;
 
+	/**
+	*	Gets the memory held by this component. GPU memory is as of the last update the render thread finished.
+	*	@param	OutUsage				Totals for the whole component
+	*	@param	OutUsagePerVertexType	Optional breakdown of the section data by vertex type name. Collision and GPU memory aren't broken down.
+	*/
+	void GetMemoryUsage(FRuntimeMeshMemoryUsage& OutUsage, TMap<FString, FRuntimeMeshMemoryUsage>* OutUsagePerVertexType = nullptr) const;
+
+
+	/**
+	*	Stores a section in the persistent mesh cache, so a later CreateMeshSectionFromCache() with the same key loads it
+	*	instead of generating it again. LODs and instances aren't stored.
+	*	@param	SectionIndex		Index of the section to store. Its game thread copy of the data must not have been released.
+	*	@param	Key					Hash of whatever the section is generated from, or 0 to use GetMeshSectionContentHash().
+	*	@return	False if the section doesn't exist or couldn't be written.
+	*/
+	bool SaveMeshSectionToCache(int32 SectionIndex, uint64 Key = 0);
+
+	/** Gets a hash of the vertex type and buffers of a section, or 0 if it doesn't exist */
+	uint64 GetMeshSectionContentHash(int32 SectionIndex) const;
+
+
+	/**
+	*	Shares this components mesh so other components can draw it through SetSharedMeshData() without a copy of their own.
+	*	This component stays the one the mesh is edited through, every change is picked up by the components sharing it.
+	*	The data is created the first time this is called and kept for the lifetime of the component.
+	*/
+	TSharedRef<FRuntimeMeshSharedData> ShareMeshData();
+
+	/**
+	*	Draws a mesh shared from another component along with this components own sections, and uses its collision
+	*	instead of this components own. Shared sections are always drawn in the dynamic path.
+	*	@param	InSharedData		Data from the source components ShareMeshData(), or null to stop drawing it
+	*/
+	void SetSharedMeshData(const TSharedPtr<FRuntimeMeshSharedData>& InSharedData);
+
+	/** Gets the mesh shared from another component this component draws, if any */
+	const TSharedPtr<FRuntimeMeshSharedData>& GetSharedMeshData() const { return SharedMeshData; }
+
 
 	/** Sets the geometry for a collision only section */
 	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
@@ -1028,6 +1796,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
 	void EndBatchUpdates();
 
+	/** 
+	*	Sets the order a section is uploaded in when its component uses bUseUploadBudget. Higher priorities go first, sections 
+	*	with the same priority go closest to a view first. Kept across recreating the section.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void SetMeshSectionUploadPriority(int32 SectionIndex, float Priority);
+
+	/** Forces any updates collected by bAutoBatchUpdates to be sent now instead of at the end of the frame */
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	void FlushAutoBatchUpdates();
+
 
 
 	/**
@@ -1043,6 +1822,88 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
 	bool bShouldSerializeMeshData;
 
+	/**
+	*	Controls whether the serialized mesh data is zlib compressed when saved to a package.
+	*	Smaller on disk in exchange for decompressing it on load.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
+	bool bCompressSerializedMeshData;
+
+	/**
+	*	Controls whether sections rendered in the static path dither between their LODs.
+	*	Requires materials with dithered LOD transitions enabled.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
+	bool bUseDitheredLODTransitions;
+
+	/**
+	*	Controls whether visible infrequently updated sections sharing a vertex type, material and shadow setting
+	*	are packed into shared buffers and drawn together, instead of costing a draw call each.
+	*	Every packed section is repacked whenever one of them changes or any section is created or destroyed,
+	*	so this suits meshes made of many small mostly static sections. Render only sections and sections
+	*	with LODs are never packed.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
+	bool bMergeSectionsForRendering;
+
+	/**
+	*	Distance within which vertices share their normal when normals are calculated (ESectionUpdateFlags::CalculateNormalTangent).
+	*	Positions are snapped to a grid of this size, so split vertices along a seam are smoothed together while hard edges
+	*	can be kept by splitting and moving them apart. 0 only smooths vertices at exactly the same position, negative
+	*	never smooths across vertices. Tangents are never smoothed across vertices, so UV seams are kept.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	float NormalSmoothingTolerance;
+
+	/**
+	*	Controls whether collision is cooked on a background thread.
+	*	The previous collision stays active until the new one is ready. Edits made while a cook
+	*	is in flight start a new cook right away, and the result of the older one is discarded.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bUseAsyncCooking;
+
+	/**
+	*	Controls whether each collision enabled section and collision section gets its own cooked trimesh.
+	*	Only the sections that changed are re-cooked instead of the whole component. Sections are kept
+	*	in separate non-simulating bodies, so this is meant for static or kinematic complex collision.
+	*	The section bodies follow the components collision settings and are exported for navigation, but
+	*	aren't part of the main body. Traces against just this component (LineTraceComponent) and components
+	*	drawing this mesh through SetSharedMeshData() only see the simple collision.
+	*	Must be set before any collision is created.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RuntimeMesh")
+	bool bUseIncrementalSectionCollision;
+
+	/**
+	*	Controls whether section changes made outside of BeginBatchUpdates()/EndBatchUpdates() are collected and sent 
+	*	once at the end of the frame. Each section is then uploaded at most once per frame with its latest data, and 
+	*	bounds and collision are updated once for all changes. Only used in game worlds.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bAutoBatchUpdates;
+
+	/**
+	*	Controls whether section creates and updates from this component count against the per frame upload budget 
+	*	set by RuntimeMesh.UploadBudgetBytes and RuntimeMesh.UploadBudgetSections. Uploads that don't fit are sent in later 
+	*	frames, highest SetMeshSectionUploadPriority() first and then closest to a view. Property updates and destroys aren't limited.
+	*	Implies bAutoBatchUpdates.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bUseUploadBudget;
+
+	/**
+	*	Controls whether cooked collision is kept in the persistent mesh cache. Each cook is keyed by the content of the
+	*	mesh being cooked, so collision for a mesh that was cooked before, in this session or an earlier one, is loaded
+	*	from the cache instead of being cooked again. Bounded by RuntimeMesh.CacheMaxSizeMB.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RuntimeMesh")
+	bool bUseCollisionCache;
+
+	/** Called when new collision has been cooked and is in use */
+	UPROPERTY(BlueprintAssignable, Category = "Components|RuntimeMesh")
+	FRuntimeMeshCollisionUpdatedDelegate CollisionUpdated;
+
 	/** Collision data */
 	UPROPERTY(Transient, DuplicateTransient)
 	class UBodySetup* BodySetup;
@@ -1064,30 +1925,127 @@ private:
 	//~ Begin UPrimitiveComponent Interface.
 	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
 	virtual class UBodySetup* GetBodySetup() override;
+	virtual void OnComponentCollisionSettingsChanged() override;
+	virtual bool DoCustomNavigableGeometryExport(FNavigableGeometryExport& GeomExport) const override;
 	//~ End UPrimitiveComponent Interface.
 
+	//~ Begin UActorComponent Interface.
+	virtual void OnCreatePhysicsState() override;
+	virtual void OnDestroyPhysicsState() override;
+	//~ End UActorComponent Interface.
+
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 12
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+#else
+	virtual void OnUpdateTransform(bool bSkipPhysicsMove, ETeleportType Teleport = ETeleportType::None) override;
+#endif
+
 	//~ Begin UMeshComponent Interface.
 	virtual int32 GetNumMaterials() const override;
 	//~ End UMeshComponent Interface.
 
+	//~ Begin UObject Interface.
+	virtual void BeginDestroy() override;
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 14
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+#else
+	virtual SIZE_T GetResourceSize(EResourceSizeMode::Type Mode) override;
+#endif
+	//~ End UObject Interface.
+
+	/* Size of the collision only sections and convex shapes */
+	SIZE_T GetCollisionDataSize() const;
+
+	/* Brings the collision memory stat up to date */
+	void UpdateCollisionMemoryStats();
+
 
 
 	/** Update LocalBounds member from the local box of each section */
 	void UpdateLocalBounds(bool bMarkRenderTransform = true);
+
+	/* Brings the bounds kept for a section up to date after it was created, changed, hidden or removed */
+	void UpdateSectionBounds(int32 SectionIndex);
+
+	/* Rebuilds ValidSectionIndices and the section bounds from MeshSections, after it was changed as a whole */
+	void RebuildSectionIndices();
+
+	/* Adds a section index to ValidSectionIndices if it isn't already */
+	void AddValidSectionIndex(int32 SectionIndex);
+
+	/* Removes a section index from ValidSectionIndices */
+	void RemoveValidSectionIndex(int32 SectionIndex);
 	/** Ensure ProcMeshBodySetup is allocated and configured */
 	void EnsureBodySetupCreated();
 	/** Mark collision data as dirty, and re-create on instance if necessary */
 	void UpdateCollision();
 
+	/* Sets up the simple collision, trace flag, and guid of a body setup about to be cooked */
+	void ConfigureBodySetup(UBodySetup* Setup);
+
+	/* Snapshots the collision mesh and starts cooking it on a background thread */
+	void StartAsyncCollisionCook();
+
+	/* Swaps in the body setup from a finished async cook, unless a newer cook was started since */
+	void FinishAsyncCollisionCook();
+
+	/* Moves the async cook in flight, if any, out of the way of a newer collision update so its result gets discarded */
+	void SupersedeAsyncCollisionCook();
+
+	/* Hands new collision to the components sharing our mesh and fires CollisionUpdated */
+	void BroadcastCollisionUpdated();
+
 	/* Marks the collision for an end of frame update */
 	void MarkCollisionDirty();
 
+	/* Flags a mesh sections collision for re-cooking when using incremental section collision */
+	void MarkSectionCollisionDirty(int32 SectionIndex) { DirtySectionCollision.Add(SectionIndex); }
+
+	/* Flags a collision sections collision for re-cooking when using incremental section collision */
+	void MarkCollisionSectionDirty(int32 CollisionSectionIndex) { DirtyCollisionSections.Add(CollisionSectionIndex); }
+
+	/* Flags every mesh sections collision for re-cooking, including ones that have been removed */
+	void MarkAllSectionCollisionDirty();
+
+	/* Flags every collision sections collision for re-cooking, including ones that have been removed */
+	void MarkAllCollisionSectionsDirty();
+
+	/* Re-cooks the collision elements of the dirty sections */
+	void UpdateSectionCollision();
+
+	/* Starts re-cooking a single collision element on the worker if the mesh it's built from has changed. The old body stays until the cook is swapped in */
+	void UpdateCollisionElement(bool bIsCollisionSectionElement, int32 ElementIndex, const TArray<FVector>& Vertices, const TArray<int32>& Indices);
+
+	/* Swaps in the collision elements of every batch whose cooks have all finished, returns whether any element changed */
+	bool FinishCollisionElementCooks();
+
+	/* Gets a mesh section or collision section element, null if there's no such element */
+	FRuntimeMeshCollisionElement* FindCollisionElement(bool bIsCollisionSectionElement, int32 ElementIndex);
+
+	/* Is any async collision cook still in flight */
+	bool HasPendingCollisionCooks() const { return AsyncCookSnapshot != nullptr || SupersededCookSnapshots.Num() > 0 || ElementCookSnapshots.Num() > 0; }
+
+	/* Creates the physics body for a cooked collision element */
+	void CreateCollisionElementBody(FRuntimeMeshCollisionElement& Element);
+
+	/* Destroys the physics body for a collision element if it has one */
+	void DestroyCollisionElementBody(FRuntimeMeshCollisionElement& Element);
+
+	/* Applies the collision settings of the main body to a collision element body */
+	void CopyCollisionSettingsToElementBody(FBodyInstance& ElementBodyInstance) const;
+
 	/* Cooks the new collision mesh updating the body */
 	void BakeCollision();
 
 	/* Serializes this component */
 	virtual void Serialize(FArchive& Ar) override;
 
+	/* Serializes the mesh sections, either straight into the component archive or into the bulk data */
+	void SerializeMeshSections(FArchive& Ar);
+
+	/* Creates the sections from the loaded bulk data and frees it */
+	void UnpackMeshBulkData();
+
 	/* Does post load fixups */
 	virtual void PostLoad() override;
 
@@ -1095,15 +2053,104 @@ private:
 	virtual void RegisterComponentTickFunctions(bool bRegister) override;
 
 
+	/* Starts a batch for bAutoBatchUpdates if it's enabled and no batch is running yet */
+	void StartAutoBatchIfEnabled();
+
+	/* Commits finished async sections and sends the auto batch. Called at the end of the frame */
+	void TickEndOfFrame();
+
+	/* Takes the uploads that don't fit this frame's upload budget out of a batch, returning them and their updates */
+	void ScheduleBatchUploads(TArray<struct FRuntimeMeshBatchSectionWork>& SectionWork, TArray<TPair<int32, ERuntimeMeshSectionBatchUpdateType>>& OutDeferred);
+
+	/* Upload order set by SetMeshSectionUploadPriority() */
+	TMap<int32, float> SectionUploadPriorities;
+
+	/* Frame each currently deferred upload was first held back in */
+	TMap<int32, uint64> DeferredUploadFrames;
+
+	/* Async section creates and updates that haven't been committed yet, oldest first */
+	TArray<TSharedRef<FRuntimeMeshAsyncSectionJob, ESPMode::ThreadSafe>> PendingAsyncSections;
+
 	/* Current state of a batch update. */
 	FRuntimeMeshBatchUpdateState BatchState;
 
+	/*
+	*	Mesh sections as saved to a package. Stored after the exports so it's read in one block,
+	*	and only unpacked into the sections at PostLoad instead of while the package is serialized.
+	*/
+	FByteBulkData MeshBulkData;
+
+	/* Runtime mesh version the bulk data was saved with */
+	int32 MeshBulkDataVersion;
+
+	/* Has bulk data been loaded that still needs unpacking into the sections? */
+	bool bHasPendingMeshBulkData;
+
+	/* Data our mesh is shared with other components through, created by ShareMeshData() */
+	TSharedPtr<FRuntimeMeshSharedData> OwnedSharedMeshData;
+
+	/* Mesh shared from another component that's drawn along with our own sections */
+	TSharedPtr<FRuntimeMeshSharedData> SharedMeshData;
+
+	/* 
+	 *	Render data of the current scene proxy while there are render only sections. A released section can't be rebuilt, 
+	 *	so the next scene proxy takes its section proxy over from here when the scene proxy is recreated.
+	 */
+	TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe> RetainedRenderData;
+
+	/* GPU memory held by the scene proxy, shared with it so it outlives the proxy or the component */
+	TSharedPtr<FRuntimeMeshGPUMemoryCounter, ESPMode::ThreadSafe> GPUMemory;
+
+	/* Collision memory last added to the memory stats */
+	SIZE_T AccountedCollisionMemory;
+
 	/* Is the collision in need of a rebake? */
 	bool bCollisionDirty;
 
+	/* Does the simple collision (convex elements) need re-cooking? Only tracked for incremental section collision. */
+	bool bSimpleCollisionDirty;
+
+	/* Mesh sections whose collision needs re-cooking */
+	TSet<int32> DirtySectionCollision;
+
+	/* Collision sections that need re-cooking */
+	TSet<int32> DirtyCollisionSections;
+
+	/* Cooked collision per mesh section, when using incremental section collision */
+	UPROPERTY(Transient)
+	TArray<FRuntimeMeshCollisionElement> SectionCollisionElements;
+
+	/* Cooked collision per collision section, when using incremental section collision */
+	UPROPERTY(Transient)
+	TArray<FRuntimeMeshCollisionElement> CollisionSectionElements;
+
+	/* Snapshot currently being cooked when using async cooking */
+	UPROPERTY(Transient, DuplicateTransient)
+	class URuntimeMeshCollisionSnapshot* AsyncCookSnapshot;
+
+	/* Older snapshots still being cooked, kept until they're done so GC doesn't have to wait on them */
+	UPROPERTY(Transient, DuplicateTransient)
+	TArray<class URuntimeMeshCollisionSnapshot*> SupersededCookSnapshots;
+
+	/* Generation of the newest collision update, bumped every time one is started */
+	uint32 CollisionCookGeneration;
+
+	/* Batch the collision elements cooked by the next UpdateSectionCollision() belong to */
+	uint32 ElementCookBatch;
+
+	/* Snapshots of collision elements being cooked when using async cooking with incremental section collision */
+	UPROPERTY(Transient, DuplicateTransient)
+	TArray<class URuntimeMeshCollisionSnapshot*> ElementCookSnapshots;
+
 	/** Array of sections of mesh */	
 	TArray<RuntimeMeshSectionPtr> MeshSections;
 
+	/* Indices of the valid entries in MeshSections in ascending order, so loops over the sections skip the empty slots of sparse indices */
+	TArray<int32> ValidSectionIndices;
+
+	/* Bounds of each visible section, kept up to date as sections change so the local bounds don't re-sum every section */
+	FRuntimeMeshBoundsAccumulator SectionBounds;
+
 	/* Array of collision only mesh sections*/
 	UPROPERTY(Transient)
 	TArray<FRuntimeMeshCollisionSection> MeshCollisionSections;
@@ -1120,7 +2167,50 @@ private:
 	UPROPERTY(Transient)
 	FRuntimeMeshComponentPrePhysicsTickFunction PrePhysicsTick;
 
+	/* Tick function used to send the updates collected by bAutoBatchUpdates and commit async sections */
+	UPROPERTY(Transient)
+	FRuntimeMeshComponentEndOfFrameTickFunction EndOfFrameTick;
+
 
 	friend class FRuntimeMeshSceneProxy;
 	friend struct FRuntimeMeshComponentPrePhysicsTickFunction;
+	friend struct FRuntimeMeshComponentEndOfFrameTickFunction;
+	template<typename VertexType> friend class TRuntimeMeshAsyncSectionJob;
+	friend class FRuntimeMeshAsyncLODJob;
+};
+
+
+/* Async section job for a specific vertex type */
+template<typename VertexType>
+class TRuntimeMeshAsyncSectionJob : public FRuntimeMeshAsyncSectionJob
+{
+public:
+	TRuntimeMeshAsyncSectionJob(int32 InSectionIndex, bool bInIsCreate, bool bIsDualBuffer)
+		: FRuntimeMeshAsyncSectionJob(InSectionIndex, bInIsCreate), Builder(bIsDualBuffer), BoundingBox(0), bCreateCollision(false)
+		, UpdateFrequency(EUpdateFrequency::Average), UpdateFlags(ESectionUpdateFlags::None) { }
+
+	virtual void Generate() override
+	{
+		URuntimeMeshComponent::GenerateAsyncSection(*this);
+	}
+
+	virtual void Commit(URuntimeMeshComponent* Component) override
+	{
+		Component->CommitAsyncSection(*this);
+	}
+
+	/* Fills the builder. Unset when the builder came filled */
+	TFunction<void(FRuntimeMeshBuilder<VertexType>&)> Generator;
+
+	FRuntimeMeshBuilder<VertexType> Builder;
+
+	/* Bounds of the generated mesh */
+	FBox BoundingBox;
+
+	/* Why the generated mesh can't be used, empty if it can */
+	FString Error;
+
+	bool bCreateCollision;
+	EUpdateFrequency UpdateFrequency;
+	ESectionUpdateFlags UpdateFlags;
 };
@@ -36,6 +36,13 @@ using RuntimeMeshVertexStructure = FLocalVertexFactory::FDataType;
 using RuntimeMeshVertexStructure = FLocalVertexFactory::DataType;
 #endif
 
+/* Can the static meshes of a single primitive be re-cached, so static sections can change without recreating the scene proxy */
+#if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 12
+#define RUNTIMEMESH_ENABLE_STATIC_SECTION_UPDATES 1
+#else
+#define RUNTIMEMESH_ENABLE_STATIC_SECTION_UPDATES 0
+#endif
+
 #define RUNTIMEMESH_VERTEXCOMPONENT(VertexBuffer, VertexType, Member, MemberType) \
 	STRUCTMEMBER_VERTEXSTREAMCOMPONENT(&VertexBuffer, VertexType, Member, MemberType)
 
@@ -65,7 +72,54 @@ enum class ESectionUpdateFlags
 	MoveArrays = 0x1,
 
 
-	//CalculateNormalTangent = 0x2,
+	/**
+		Calculates the normals and tangents from the positions, triangles and UV0, replacing the supplied ones.
+		Normals are area weighted, and are smoothed across split vertices within the component's NormalSmoothingTolerance.
+		Range updates only recalculate the vertices affected by the range.
+		Only supported by the generic vertex types (FRuntimeMeshVertex).
+	*/
+	CalculateNormalTangent = 0x2,
+
+	/**
+		Releases the game thread copy of the section data once it's been sent to the render thread.
+		This saves holding the mesh in memory twice, but the section can't have collision, isn't serialized,
+		and can't be range updated. Dual buffer sections also can't update their positions or vertices on their own.
+		When the scene proxy is recreated the section's GPU buffers are carried over to the new one, so the component
+		keeps the previous proxy's sections alive while it's unregistered.
+		Only applies when creating a section. (Updates keep releasing their data until the section is recreated.)
+	*/
+	RenderOnly = 0x4,
+
+	/**
+		Stores the positions on the GPU as 16 bit integers relative to the section bounds, instead of full floats.
+		Saves 4 bytes per vertex on the GPU, with a precision of the bounds size / 65535 on each axis. The game thread
+		copy keeps full precision, so collision and serialization are unaffected. Only supported by dual buffer sections,
+		and only applies when creating a section. Local space transforms in materials see the quantized space.
+	*/
+	QuantizePositions = 0x8,
+
+	/**
+		Reorders the triangles for the GPU's vertex cache, and then to reduce overdraw, before the section is sent to the render thread.
+		Only the order changes, the vertices and what's drawn are untouched. Only applies when creating a section.
+	*/
+	OptimizeMesh = 0x10,
+
+	/**
+		Same as OptimizeMesh, and also reorders the vertices into the order the triangles use them so vertex fetch is linear.
+
+		CAUTION: This changes the vertex indices, so later updates by vertex index (ranges, positions, LODs) must
+		use the section's vertices as stored rather than the order they were supplied in.
+	*/
+	OptimizeVertexOrder = 0x20,
+
+	/**
+		Creates the GPU position buffer, and the vertex buffer where the vertex type allows, with unordered access so
+		URuntimeMeshComponent::DeformMeshSectionGPU can write them from compute shaders. Positions written on the GPU
+		aren't seen by the game thread copy, so collision, serialization and CPU updates still use the supplied positions.
+		Only supported by dual buffer sections on platforms with compute shaders, can't be combined with QuantizePositions,
+		and only applies when creating a section.
+	*/
+	GPUDeformable = 0x40,
 	
 };
 ENUM_CLASS_FLAGS(ESectionUpdateFlags)
@@ -109,6 +163,283 @@ struct FRuntimeMeshTangent
 };
 
 
+/*
+	Ref-counted array used for the game thread copy of section data. Render commands take a shared
+	reference to the array instead of copying it, and the game thread only copies it if it
+	edits the array while the render thread still holds a reference (copy-on-write).
+*/
+template<typename ElementType>
+class FRuntimeMeshSharedBuffer
+{
+public:
+	using ArrayType = TArray<ElementType>;
+
+	/* Reference handed to the render thread. Must not be modified through. */
+	using SharedArrayRef = TSharedPtr<const ArrayType, ESPMode::ThreadSafe>;
+
+	FRuntimeMeshSharedBuffer()
+		: Data(MakeShareable(new ArrayType()))
+	{}
+
+	/* Read only access to the data */
+	const ArrayType& Get() const { return *Data; }
+
+	/* Write access to the data, copies it first if it's still referenced elsewhere */
+	ArrayType& Edit()
+	{
+		if (!Data.IsUnique())
+		{
+			Data = MakeShareable(new ArrayType(*Data));
+		}
+		return *Data;
+	}
+
+	/* Write access for replacing the whole contents. Skips copying the old data if it's still referenced elsewhere */
+	ArrayType& Overwrite()
+	{
+		if (!Data.IsUnique())
+		{
+			Data = MakeShareable(new ArrayType());
+		}
+		return *Data;
+	}
+
+	/* Replaces the contents with a copy of the supplied data */
+	void Set(const ArrayType& InData)
+	{
+		Overwrite() = InData;
+	}
+
+	/* Replaces the contents with the supplied data, leaving it empty */
+	void Set(ArrayType&& InData)
+	{
+		Data = MakeShareable(new ArrayType(MoveTemp(InData)));
+	}
+
+	/* Gets a reference to the current data that stays valid and unchanged regardless of later edits */
+	SharedArrayRef Share() const { return Data; }
+
+	/* Drops our reference to the data. Anything sharing it keeps it alive until they're done with it */
+	void Release()
+	{
+		Data = MakeShareable(new ArrayType());
+	}
+
+	int32 Num() const { return Data->Num(); }
+
+	/* Size of the memory allocated for the current data */
+	SIZE_T GetAllocatedSize() const { return Data->GetAllocatedSize(); }
+
+	const ElementType& operator[](int32 Index) const { return (*Data)[Index]; }
+
+	friend FArchive& operator <<(FArchive& Ar, FRuntimeMeshSharedBuffer& Buffer)
+	{
+		if (Ar.IsLoading())
+		{
+			Ar << Buffer.Overwrite();
+		}
+		else
+		{
+			// Saving doesn't modify the array so there's no need to detach it
+			Ar << const_cast<ArrayType&>(Buffer.Get());
+		}
+		return Ar;
+	}
+
+	/* Serializes the array as one block instead of element by element, when the archive allows it */
+	void BulkSerialize(FArchive& Ar)
+	{
+		if (Ar.IsLoading())
+		{
+			Overwrite().BulkSerialize(Ar);
+		}
+		else
+		{
+			const_cast<ArrayType&>(Get()).BulkSerialize(Ar);
+		}
+	}
+
+private:
+	TSharedPtr<ArrayType, ESPMode::ThreadSafe> Data;
+};
+
+
+/* Lower detail index buffer for a section. It indexes the sections own vertices, and is drawn once the sections screen size drops below ScreenSize. */
+struct FRuntimeMeshSectionLOD
+{
+	/* Triangles for this LOD */
+	FRuntimeMeshSharedBuffer<int32> IndexBuffer;
+
+	/* Screen size below which this LOD is used */
+	float ScreenSize;
+
+	FRuntimeMeshSectionLOD()
+		: ScreenSize(0.0f)
+	{}
+
+	friend FArchive& operator <<(FArchive& Ar, FRuntimeMeshSectionLOD& LOD)
+	{
+		Ar << LOD.IndexBuffer;
+		Ar << LOD.ScreenSize;
+		return Ar;
+	}
+};
+
+
+/* Span of elements within a vertex or index buffer */
+struct FRuntimeMeshBufferRange
+{
+	/* First element in the span */
+	int32 Start;
+
+	/* Number of elements in the span */
+	int32 Count;
+
+	FRuntimeMeshBufferRange()
+		: Start(0), Count(0)
+	{}
+
+	FRuntimeMeshBufferRange(int32 InStart, int32 InCount)
+		: Start(InStart), Count(InCount)
+	{}
+
+	int32 End() const { return Start + Count; }
+};
+
+/*
+	Set of changed spans within a buffer. Spans are kept sorted, and overlapping
+	or adjacent spans are merged as they're added so each element is only sent once.
+*/
+struct FRuntimeMeshDirtyRanges
+{
+private:
+	TArray<FRuntimeMeshBufferRange> Ranges;
+
+public:
+
+	void Add(int32 Start, int32 Count)
+	{
+		if (Count <= 0)
+		{
+			return;
+		}
+
+		// Find the first span that ends at or after the new one starts
+		int32 Index = 0;
+		while (Index < Ranges.Num() && Ranges[Index].End() < Start)
+		{
+			Index++;
+		}
+
+		FRuntimeMeshBufferRange NewRange(Start, Count);
+
+		// Absorb every span that overlaps or touches the new one
+		while (Index < Ranges.Num() && Ranges[Index].Start <= NewRange.End())
+		{
+			int32 NewEnd = FMath::Max(NewRange.End(), Ranges[Index].End());
+			NewRange.Start = FMath::Min(NewRange.Start, Ranges[Index].Start);
+			NewRange.Count = NewEnd - NewRange.Start;
+			Ranges.RemoveAt(Index, 1, false);
+		}
+
+		Ranges.Insert(NewRange, Index);
+	}
+
+	void Add(const FRuntimeMeshBufferRange& Range)
+	{
+		Add(Range.Start, Range.Count);
+	}
+
+	void Reset()
+	{
+		Ranges.Reset();
+	}
+
+	bool IsEmpty() const
+	{
+		return Ranges.Num() == 0;
+	}
+
+	/* Total number of elements covered by all spans */
+	int32 GetTotalCount() const
+	{
+		int32 Total = 0;
+		for (const FRuntimeMeshBufferRange& Range : Ranges)
+		{
+			Total += Range.Count;
+		}
+		return Total;
+	}
+
+	const TArray<FRuntimeMeshBufferRange>& GetRanges() const
+	{
+		return Ranges;
+	}
+};
+
+
+/*
+	One instance of an instanced section, laid out the way the engine's instancing shader reads it.
+	The rows hold the instance transform relative to the component, and the w of the origin holds
+	the per instance custom data which materials read through the PerInstanceRandom node.
+*/
+struct FRuntimeMeshInstanceData
+{
+	FVector4 InstanceOrigin;
+	FVector4 InstanceTransform1;
+	FVector4 InstanceTransform2;
+	FVector4 InstanceTransform3;
+
+	/* Lightmap and shadowmap UV bias. Instanced sections have no static lighting so this is always zero */
+	int16 InstanceLightmapAndShadowMapUVBias[4];
+
+	FRuntimeMeshInstanceData()
+	{
+		SetInstance(FTransform::Identity, 0.0f);
+	}
+
+	FRuntimeMeshInstanceData(const FTransform& Transform, float CustomData)
+	{
+		SetInstance(Transform, CustomData);
+	}
+
+	void SetInstance(const FTransform& Transform, float CustomData)
+	{
+		const FMatrix Matrix = Transform.ToMatrixWithScale();
+		InstanceOrigin = FVector4(Matrix.M[3][0], Matrix.M[3][1], Matrix.M[3][2], CustomData);
+		InstanceTransform1 = FVector4(Matrix.M[0][0], Matrix.M[0][1], Matrix.M[0][2], 0.0f);
+		InstanceTransform2 = FVector4(Matrix.M[1][0], Matrix.M[1][1], Matrix.M[1][2], 0.0f);
+		InstanceTransform3 = FVector4(Matrix.M[2][0], Matrix.M[2][1], Matrix.M[2][2], 0.0f);
+		FMemory::Memzero(InstanceLightmapAndShadowMapUVBias);
+	}
+
+	FMatrix GetMatrix() const
+	{
+		return FMatrix(
+			FPlane(InstanceTransform1.X, InstanceTransform1.Y, InstanceTransform1.Z, 0.0f),
+			FPlane(InstanceTransform2.X, InstanceTransform2.Y, InstanceTransform2.Z, 0.0f),
+			FPlane(InstanceTransform3.X, InstanceTransform3.Y, InstanceTransform3.Z, 0.0f),
+			FPlane(InstanceOrigin.X, InstanceOrigin.Y, InstanceOrigin.Z, 1.0f));
+	}
+
+	float GetCustomData() const { return InstanceOrigin.W; }
+
+	friend FArchive& operator <<(FArchive& Ar, FRuntimeMeshInstanceData& Instance)
+	{
+		Ar << Instance.InstanceOrigin;
+		Ar << Instance.InstanceTransform1;
+		Ar << Instance.InstanceTransform2;
+		Ar << Instance.InstanceTransform3;
+
+		if (Ar.IsLoading())
+		{
+			FMemory::Memzero(Instance.InstanceLightmapAndShadowMapUVBias);
+		}
+		return Ar;
+	}
+};
+
+
 
 
 
@@ -986,34 +986,36 @@ public:
 
 	virtual bool UpdateVertexBufferInternal(const TArray<FVector>& Positions, const TArray<FVector>& Normals, const TArray<FRuntimeMeshTangent>& Tangents, const TArray<FVector2D>& UV0, const TArray<FVector2D>& UV1, const TArray<FColor>& Colors) override
 	{
-		int32 NewVertexCount = (Positions.Num() > 0) ? Positions.Num() : Super::VertexBuffer.Num();
-		int32 OldVertexCount = FMath::Min(Super::VertexBuffer.Num(), NewVertexCount);
+		// Existing data is kept where new data isn't supplied, so this has to copy if the RT still references it
+		auto& VertexBuffer = Super::VertexBuffer.Edit();
+
+		int32 NewVertexCount = (Positions.Num() > 0) ? Positions.Num() : VertexBuffer.Num();
+		int32 OldVertexCount = FMath::Min(VertexBuffer.Num(), NewVertexCount);
 
 		// Check existence of data components
 		const bool HasPositions = Positions.Num() == NewVertexCount;
 		
 		// Size the vertex buffer correctly
-		if (NewVertexCount != Super::VertexBuffer.Num())
+		if (NewVertexCount != VertexBuffer.Num())
 		{
-			Super::VertexBuffer.SetNumZeroed(NewVertexCount);
+			VertexBuffer.SetNumZeroed(NewVertexCount);
 		}
 
-		// Clear the bounding box if we have new positions
+		// Recalculate the bounding box if we have new positions
 		if (HasPositions)
 		{
-			Super::LocalBoundingBox.Init();
+			Super::LocalBoundingBox = FRuntimeMeshBounds::ComputeBounds(Positions.GetData(), Positions.Num());
 		}
 		
 		// Loop through existing range to update data
 		for (int32 VertexIdx = 0; VertexIdx < OldVertexCount; VertexIdx++)
 		{
-			auto& Vertex = Super::VertexBuffer[VertexIdx];
+			auto& Vertex = VertexBuffer[VertexIdx];
 
 			// Update position and bounding box
 			if (Positions.Num() == NewVertexCount)
 			{
 				Vertex.Position = Positions[VertexIdx];
-				Super::LocalBoundingBox += Vertex.Position;
 			}
 
 			// see if we have a new normal and/or tangent
@@ -1054,12 +1056,10 @@ public:
 		// Loop through additional range to add new data
 		for (int32 VertexIdx = OldVertexCount; VertexIdx < NewVertexCount; VertexIdx++)
 		{
-			auto& Vertex = Super::VertexBuffer[VertexIdx];
+			auto& Vertex = VertexBuffer[VertexIdx];
 
 			// Set position
 			Vertex.Position = Positions[VertexIdx];
-			// Update bounding box
-			Super::LocalBoundingBox += Vertex.Position;
 
 			// see if we have a new normal and/or tangent
 			bool HasNormal = Normals.Num() > VertexIdx;
@@ -1114,16 +1114,43 @@ public:
 	{
 		Super::Serialize(Ar);
 	
-		int32 VertexBufferLength = Super::VertexBuffer.Num();
+		auto& VertexBuffer = Super::VertexBuffer.Edit();
+
+		int32 VertexBufferLength = VertexBuffer.Num();
 		Ar << VertexBufferLength;
 		if (Ar.IsLoading())
 		{
-			Super::VertexBuffer.SetNum(VertexBufferLength);
+			VertexBuffer.SetNum(VertexBufferLength);
+		}
+
+		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::BulkSerialization)
+		{
+			// The vertices are written as one block, unless the archive needs to swap bytes
+			bool bIsRawVertexData = !Ar.IsByteSwapping();
+			int32 VertexStride = sizeof(VertexType);
+			Ar << bIsRawVertexData;
+			Ar << VertexStride;
+
+			if (bIsRawVertexData)
+			{
+				if (VertexStride == sizeof(VertexType))
+				{
+					Ar.Serialize(VertexBuffer.GetData(), VertexBufferLength * sizeof(VertexType));
+				}
+				else
+				{
+					// Saved with a different vertex layout, so it can't be read
+					UE_LOG(RuntimeMeshLog, Warning, TEXT("FRuntimeMeshSectionInternal::Serialize() - Vertex layout doesn't match the saved data. The vertices will be dropped."));
+					Ar.Seek(Ar.Tell() + (int64)VertexBufferLength * VertexStride);
+					VertexBuffer.Empty();
+				}
+				return;
+			}
 		}
 
 		for (int32 Index = 0; Index < VertexBufferLength; Index++)
 		{
-			auto& Vertex = Super::VertexBuffer[Index];
+			auto& Vertex = VertexBuffer[Index];
 
 			Ar << Vertex.Position;
 			Ar << Vertex.Normal;
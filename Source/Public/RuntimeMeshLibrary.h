@@ -29,5 +29,35 @@ class RUNTIMEMESHCOMPONENT_API URuntimeMeshLibrary : public UBlueprintFunctionLi
 	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
 	static void CreateBoxMesh(FVector BoxRadius, TArray<FVector>& Vertices, TArray<int32>& Triangles, TArray<FVector>& Normals, TArray<FVector2D>& UVs, TArray<FRuntimeMeshTangent>& Tangents);
 
+	/**
+	*	Reorders an index buffer for the GPU's vertex cache and to reduce overdraw. The vertices aren't changed.
+	*	Same as creating a section with ESectionUpdateFlags::OptimizeMesh, for meshes that are built once and kept.
+	*	@param	Vertices		Vertex positions the triangles index
+	*	@param	Triangles		Index buffer to reorder
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	static void OptimizeMeshTriangles(const TArray<FVector>& Vertices, UPARAM(ref) TArray<int32>& Triangles);
+
+	/**
+	*	Simplifies a mesh with quadric error decimation. The simplified triangles index the same vertices, so they can be used
+	*	directly as a section LOD. Borders and seams (vertices sharing a position) are never moved.
+	*	@param	Vertices		Vertex positions the triangles index
+	*	@param	Triangles		Index buffer to simplify
+	*	@param	TriangleRatio	Fraction of the triangles to aim for
+	*	@param	MaxError		Largest error allowed, as a fraction of the largest side of the mesh bounds
+	*	@out	OutTriangles	Simplified index buffer
+	*	@return					Error reached, as a fraction of the largest side of the mesh bounds
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Components|RuntimeMesh")
+	static float SimplifyMeshTriangles(const TArray<FVector>& Vertices, const TArray<int32>& Triangles, float TriangleRatio, float MaxError, TArray<int32>& OutTriangles);
+
+	/* Same as SimplifyMeshTriangles, for section vertex types. Safe to call from any thread */
+	template<typename VertexType>
+	static float SimplifyMesh(const TArray<VertexType>& Vertices, const TArray<int32>& Triangles, float TriangleRatio, float MaxError, TArray<int32>& OutTriangles)
+	{
+		const int32 TargetIndexCount = FMath::Max(FMath::RoundToInt(Triangles.Num() * TriangleRatio / 3.0f) * 3, 3);
+		return FRuntimeMeshSimplifier::Simplify<VertexType>(Vertices, nullptr, Triangles, TargetIndexCount, MaxError, OutTriangles);
+	}
+
 	
 };
\ No newline at end of file
@@ -0,0 +1,112 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "RuntimeMeshCore.h"
+
+
+/*
+*	Reordering of section triangles and vertices for faster drawing. None of these change what's drawn, only the order it's drawn in.
+*
+*	OptimizeVertexCache orders triangles so vertices are reused while they're still in the GPU's post transform cache (Tipsify).
+*	OptimizeOverdraw then splits that order into clusters at the points where the cache starts over anyway, and draws the clusters
+*	facing out from the mesh first so fewer pixels are shaded twice. OptimizeVertexFetch finally orders the vertices in the order
+*	the triangles first use them so vertex fetch reads memory linearly, and hands back the remap it applied to the indices.
+*
+*	Everything here is stateless and only touches the arrays it's passed, so it can run on any thread.
+*/
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshOptimizer
+{
+	/* Post transform cache size the triangle order is tuned for. Smaller than most hardware so it holds up everywhere */
+	static const int32 DefaultCacheSize = 16;
+
+	/* Reorders triangles for the post transform vertex cache */
+	static void OptimizeVertexCache(TArray<int32>& Indices, int32 NumVertices, int32 CacheSize = DefaultCacheSize);
+
+	/*
+	*	Reorders clusters of triangles so the ones facing out from the mesh are drawn first. Indices should already be cache optimized.
+	*	Threshold is how much worse than the cache optimized order a cluster's cache hit rate can get so it can be split into smaller
+	*	clusters, which sort better. 1 only splits where the cache starts over, 1.05 is a good balance.
+	*/
+	static void OptimizeOverdraw(TArray<int32>& Indices, const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, float Threshold = 1.05f, int32 CacheSize = DefaultCacheSize);
+
+	/* Builds the vertex order in which the triangles first use each vertex. Unused vertices keep their relative order after the used ones. OutRemap maps old vertex index to new */
+	static void BuildVertexFetchRemap(const TArray<int32>& Indices, int32 NumVertices, TArray<int32>& OutRemap);
+
+	/* Rewrites indices through a remap from BuildVertexFetchRemap */
+	static void RemapIndices(TArray<int32>& Indices, const TArray<int32>& Remap);
+
+	/* Moves each vertex to its remapped index */
+	template<typename ElementType>
+	static void RemapVertices(TArray<ElementType>& Vertices, const TArray<int32>& Remap)
+	{
+		check(Vertices.Num() == Remap.Num());
+
+		TArray<ElementType> RemappedVertices;
+		RemappedVertices.SetNumUninitialized(Vertices.Num());
+		for (int32 VertexIndex = 0; VertexIndex < Vertices.Num(); VertexIndex++)
+		{
+			RemappedVertices[Remap[VertexIndex]] = Vertices[VertexIndex];
+		}
+		Vertices = MoveTemp(RemappedVertices);
+	}
+
+	/* Reorders vertices for vertex fetch and remaps the indices to match. Positions is only used by dual buffer sections. OutRemap maps old vertex index to new */
+	template<typename VertexType>
+	static void OptimizeVertexFetch(TArray<VertexType>& Vertices, TArray<FVector>* Positions, TArray<int32>& Indices, TArray<int32>& OutRemap)
+	{
+		BuildVertexFetchRemap(Indices, Vertices.Num(), OutRemap);
+		RemapIndices(Indices, OutRemap);
+		RemapVertices(Vertices, OutRemap);
+
+		if (Positions)
+		{
+			RemapVertices(*Positions, OutRemap);
+		}
+	}
+
+	/*
+	*	Runs the cache and overdraw passes over a mesh. If OutVertexRemap is supplied the vertices are reordered as well, and it's
+	*	filled with the remap so other index buffers over the same vertices can follow. Positions is only used by dual buffer sections.
+	*/
+	template<typename VertexType>
+	static void OptimizeMesh(TArray<VertexType>& Vertices, TArray<FVector>* Positions, TArray<int32>& Indices, TArray<int32>* OutVertexRemap = nullptr)
+	{
+		const int32 NumVertices = Vertices.Num();
+		check(Positions == nullptr || Positions->Num() == NumVertices);
+
+		OptimizeVertexCache(Indices, NumVertices);
+
+		if (Positions)
+		{
+			OptimizeOverdraw(Indices, reinterpret_cast<const uint8*>(Positions->GetData()), sizeof(FVector), NumVertices);
+		}
+		else
+		{
+			OptimizeOverdraw(Indices, GetVertexPositions(Vertices), sizeof(VertexType), NumVertices);
+		}
+
+		if (OutVertexRemap)
+		{
+			OptimizeVertexFetch(Vertices, Positions, Indices, *OutVertexRemap);
+		}
+	}
+
+	/* Average number of vertices transformed per triangle with a FIFO cache. Lower is better, 0.5 is the best possible for large grids */
+	static float ComputeACMR(const TArray<int32>& Indices, int32 NumVertices, int32 CacheSize = DefaultCacheSize);
+
+private:
+	template<typename VertexType>
+	static typename TEnableIf<FVertexHasPositionComponent<VertexType>::Value, const uint8*>::Type GetVertexPositions(const TArray<VertexType>& Vertices)
+	{
+		return reinterpret_cast<const uint8*>(Vertices.GetData()) + STRUCT_OFFSET(VertexType, Position);
+	}
+
+	template<typename VertexType>
+	static typename TEnableIf<!FVertexHasPositionComponent<VertexType>::Value, const uint8*>::Type GetVertexPositions(const TArray<VertexType>& Vertices)
+	{
+		checkf(false, TEXT("Vertex type has no position, the position buffer must be supplied."));
+		return nullptr;
+	}
+};
@@ -10,7 +10,10 @@ DECLARE_STATS_GROUP(TEXT("RuntimeMesh"), STATGROUP_RuntimeMesh, STATCAT_Advanced
 DECLARE_CYCLE_STAT(TEXT("Create Section (RT)"), STAT_RuntimeMesh_CreateSection_RenderThread, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Section (RT)"), STAT_RuntimeMesh_UpdateSection_RenderThread, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Section - Position Only (RT)"), STAT_RuntimeMesh_UpdateSectionPositionOnly_RenderThread, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Section - Range (RT)"), STAT_RuntimeMesh_UpdateSectionRange_RenderThread, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Section Properties (RT)"), STAT_RuntimeMesh_UpdateSectionProperties_RenderThread, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Section Instances (RT)"), STAT_RuntimeMesh_UpdateSectionInstances_RenderThread, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Deform Section GPU (RT)"), STAT_RuntimeMesh_DeformSectionGPU_RenderThread, STATGROUP_RuntimeMesh);
 
 DECLARE_CYCLE_STAT(TEXT("Apply Batch Update (RT)"), STAT_RuntimeMesh_ApplyBatchUpdate_RenderThread, STATGROUP_RuntimeMesh);
 
@@ -18,12 +21,42 @@ DECLARE_CYCLE_STAT(TEXT("On Transform Changed (RT)"), STAT_RuntimeMesh_OnTransfo
 DECLARE_CYCLE_STAT(TEXT("Draw Static Elements (RT)"), STAT_RuntimeMesh_DrawStaticElements, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Get Dynamic Mesh Elements (RT)"), STAT_RuntimeMesh_GetDynamicMeshElements, STATGROUP_RuntimeMesh);
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Drawn"), STAT_RuntimeMesh_SectionsDrawn, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Culled"), STAT_RuntimeMesh_SectionsCulled, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Instances Drawn"), STAT_RuntimeMesh_InstancesDrawn, STATGROUP_RuntimeMesh);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Buffer Locks"), STAT_RuntimeMesh_BufferLocks, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Uploaded"), STAT_RuntimeMesh_BytesUploaded, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Buffer Reallocations"), STAT_RuntimeMesh_BufferReallocations, STATGROUP_RuntimeMesh);
+
+// Memory
+DECLARE_MEMORY_STAT(TEXT("CPU Vertex Data"), STAT_RuntimeMesh_CPUVertexMemory, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("CPU Position Data"), STAT_RuntimeMesh_CPUPositionMemory, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("CPU Index Data"), STAT_RuntimeMesh_CPUIndexMemory, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("CPU Collision Data"), STAT_RuntimeMesh_CPUCollisionMemory, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("GPU Vertex Buffers"), STAT_RuntimeMesh_GPUVertexMemory, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("GPU Index Buffers"), STAT_RuntimeMesh_GPUIndexMemory, STATGROUP_RuntimeMesh);
+DECLARE_MEMORY_STAT(TEXT("Pooled Command Memory"), STAT_RuntimeMesh_CommandPoolMemory, STATGROUP_RuntimeMesh);
+
 // RuntimeMeshComponent Profiling
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Created"), STAT_RuntimeMesh_SectionsCreated, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Updated"), STAT_RuntimeMesh_SectionsUpdated, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Destroyed"), STAT_RuntimeMesh_SectionsDestroyed, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Proxy Recreates"), STAT_RuntimeMesh_ProxyRecreates, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Cooks"), STAT_RuntimeMesh_CollisionCooks, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Section Uploads"), STAT_RuntimeMesh_DeferredUploads, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Upload Wait (Frames)"), STAT_RuntimeMesh_DeferredUploadWaitFrames, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Budgeted Upload Bytes"), STAT_RuntimeMesh_BudgetedUploadBytes, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mesh Cache Hits"), STAT_RuntimeMesh_CacheHits, STATGROUP_RuntimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mesh Cache Misses"), STAT_RuntimeMesh_CacheMisses, STATGROUP_RuntimeMesh);
+
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSection<VertexType> (GT)"), STAT_RuntimeMesh_CreateMeshSection_VertexType, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSection<VertexType> (With Bounding Box) (GT)"), STAT_RuntimeMesh_CreateMeshSection_VertexType_WithBoundingBox, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSectionDualBuffer<VertexType> (GT)"), STAT_RuntimeMesh_CreateMeshSectionDualBuffer_VertexType, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSectionDualBuffer<VertexType> (With Bounding Box) (GT)"), STAT_RuntimeMesh_CreateMeshSectionDualBuffer_VertexType_WithBoundingBox, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("CreateMeshSection<VertexType> (Builder) (GT)"), STAT_RuntimeMesh_CreateMeshSection_Builder, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("CreateMeshSectionFromCache<VertexType> (GT)"), STAT_RuntimeMesh_CreateMeshSectionFromCache, STATGROUP_RuntimeMesh);
 
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSection (GT)"), STAT_RuntimeMesh_CreateMeshSection, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("CreateMeshSection (GT)"), STAT_RuntimeMesh_CreateMeshSection_DualUV, STATGROUP_RuntimeMesh);
@@ -37,6 +70,7 @@ DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection<VertexType> (Dual) (GT)"), STAT_Runti
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection<VertexType> (Dual) (With Bounding Box) (GT)"), STAT_RuntimeMesh_UpdateMeshSection_Dual_VertexType_WithBoundingBox, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection<VertexType> (Dual) (With Triangles) (GT)"), STAT_RuntimeMesh_UpdateMeshSection_Dual_VertexType_WithTriangles, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection<VertexType> (Dual) (With Triangles and Bounding Box) (GT)"), STAT_RuntimeMesh_UpdateMeshSection_Dual_VertexType_WithTrianglesAndBoundinBox, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection<VertexType> (Builder) (GT)"), STAT_RuntimeMesh_UpdateMeshSection_Builder, STATGROUP_RuntimeMesh);
 
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection (GT)"), STAT_RuntimeMesh_UpdateMeshSection, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection (GT)"), STAT_RuntimeMesh_UpdateMeshSection_DualUV, STATGROUP_RuntimeMesh);
@@ -49,10 +83,23 @@ DECLARE_CYCLE_STAT(TEXT("UpdateMeshSection (GT)"), STAT_RuntimeMesh_UpdateMeshSe
 
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionPositionsImmediate (GT)"), STAT_RuntimeMesh_UpdateMeshSectionPositionsImmediate, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionPositionsImmediate (With Bounding Box) (GT)"), STAT_RuntimeMesh_UpdateMeshSectionPositionsImmediate_WithBoundinBox, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("DeformMeshSectionGPU (GT)"), STAT_RuntimeMesh_DeformMeshSectionGPU, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionTriangles (GT)"), STAT_RuntimeMesh_UpdateMeshSectionTriangles, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionTriangles (16 Bit) (GT)"), STAT_RuntimeMesh_UpdateMeshSectionTriangles_16Bit, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionRange<VertexType> (GT)"), STAT_RuntimeMesh_UpdateMeshSectionRange_VertexType, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionPositionsRange (GT)"), STAT_RuntimeMesh_UpdateMeshSectionPositionsRange, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("UpdateMeshSectionTrianglesRange (GT)"), STAT_RuntimeMesh_UpdateMeshSectionTrianglesRange, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("EndMeshSectionUpdate (GT)"), STAT_RuntimeMesh_EndMeshSectionUpdate, STATGROUP_RuntimeMesh);
 
 DECLARE_CYCLE_STAT(TEXT("Finish Create Section (GT)"), STAT_RuntimeMesh_FinishCreateSectionInternal, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Finish Update Section (GT)"), STAT_RuntimeMesh_FinishUpdateSectionInternal, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Finish Range Update Section (GT)"), STAT_RuntimeMesh_FinishRangeUpdateSectionInternal, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Prepare Batch Update (GT)"), STAT_RuntimeMesh_PrepareBatchUpdate, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Commit Async Sections (GT)"), STAT_RuntimeMesh_CommitAsyncSections, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Generate Async Section (Async)"), STAT_RuntimeMesh_GenerateAsyncSection, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Set Mesh Section LOD (GT)"), STAT_RuntimeMesh_SetMeshSectionLOD, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Clear Mesh Section (GT)"), STAT_RuntimeMesh_ClearMeshSection, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Mesh Section Instances (GT)"), STAT_RuntimeMesh_UpdateMeshSectionInstances, STATGROUP_RuntimeMesh);
 
 
 DECLARE_CYCLE_STAT(TEXT("Set Mesh Collision Section (GT)"), STAT_RuntimeMesh_SetMeshCollisionSection, STATGROUP_RuntimeMesh);
@@ -64,8 +111,19 @@ DECLARE_CYCLE_STAT(TEXT("Set Collision Convex Meshes (GT)"), STAT_RuntimeMesh_Se
 DECLARE_CYCLE_STAT(TEXT("Create Scene Proxy (GT)"), STAT_RuntimeMesh_CreateSceneProxy, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Get Physics TriMesh Data (GT)"), STAT_RuntimeMesh_GetPhysicsTriMeshData, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Collision (GT)"), STAT_RuntimeMesh_UpdateCollision, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Section Collision (GT)"), STAT_RuntimeMesh_UpdateSectionCollision, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Cook Collision Element (GT)"), STAT_RuntimeMesh_CookCollisionElement, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Start Async Collision Cook (GT)"), STAT_RuntimeMesh_StartAsyncCollisionCook, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Finish Async Collision Cook (GT)"), STAT_RuntimeMesh_FinishAsyncCollisionCook, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Cook Collision (Async)"), STAT_RuntimeMesh_CookCollisionAsync, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Update Local Bounds (GT)"), STAT_RuntimeMesh_UpdateLocalBounds, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Rebuild Section Bounds (GT)"), STAT_RuntimeMesh_RebuildBounds, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Calculate Normals/Tangents (GT)"), STAT_RuntimeMesh_CalculateNormalTangents, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Optimize Mesh"), STAT_RuntimeMesh_OptimizeMesh, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Simplify Mesh"), STAT_RuntimeMesh_SimplifyMesh, STATGROUP_RuntimeMesh);
 DECLARE_CYCLE_STAT(TEXT("Serialize"), STAT_RuntimeMesh_Serialize, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Load Cached Mesh"), STAT_RuntimeMesh_LoadCachedMesh, STATGROUP_RuntimeMesh);
+DECLARE_CYCLE_STAT(TEXT("Store Cached Mesh"), STAT_RuntimeMesh_StoreCachedMesh, STATGROUP_RuntimeMesh);
 
 
 
@@ -29,36 +29,212 @@ public:
 };
 
 
+/* 
+ *	Most copies of the vertex/index data RuntimeMesh.StreamingBufferCount can keep for sections marked as Frequent.
+ *	Each upload goes to the next copy so the GPU can keep reading the previous ones without stalling the update.
+ */
+#define RUNTIMEMESH_MAX_STREAMING_BUFFER_COUNT 3
+
+
+/* 
+ *	Picks allocation sizes for the RHI buffers. Buffers keep some slack when they grow, and only shrink
+ *	once they're mostly unused, so a mesh whose size changes slightly each update doesn't reallocate each time.
+ *	Controlled by RuntimeMesh.BufferGrowthFactor and RuntimeMesh.BufferShrinkThreshold.
+ */
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshBufferSizing
+{
+	/* Gets the capacity a buffer should have to hold NewCount elements. Returns CurrentCapacity if the buffer can be kept as is. */
+	static int32 GetCapacity(int32 CurrentCapacity, int32 NewCount);
+
+	/* Gets the number of copies a buffer of a Frequent section cycles through. 1 unless RuntimeMesh.StreamingBufferCount opts into a ring */
+	static int32 GetStreamingBufferCount();
+};
+
+
+/* Counts writes to the RHI buffers. The stats are per frame, the total is kept for tools like RuntimeMesh.Benchmark */
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshUploadStats
+{
+	/* Bytes written to RHI buffers since startup */
+	static FThreadSafeCounter64 TotalBytesUploaded;
+
+	static void TrackUpload(int64 NumBytes)
+	{
+		INC_DWORD_STAT(STAT_RuntimeMesh_BufferLocks);
+		INC_DWORD_STAT_BY(STAT_RuntimeMesh_BytesUploaded, NumBytes);
+		TotalBytesUploaded.Add(NumBytes);
+	}
+};
+
+
+/* GPU memory held by the scene proxy of a component. Written on the RT, read on the game thread */
+struct FRuntimeMeshGPUMemoryCounter
+{
+	FThreadSafeCounter64 VertexBytes;
+	FThreadSafeCounter64 IndexBytes;
+};
+
+
+/* Position stored as signed normalized 16 bit integers relative to the section bounds. W is always 1 */
+struct FRuntimeMeshQuantizedPosition
+{
+	int16 X;
+	int16 Y;
+	int16 Z;
+	int16 W;
+};
+
+/* 
+ *	Maps positions within a box to FRuntimeMeshQuantizedPosition and back. The GPU reads the quantized position as 
+ *	-1..1 on each axis, so the section is drawn with GetDequantizeTransform folded into its local to world transform.
+ */
+struct FRuntimeMeshPositionQuantization
+{
+	FVector Center;
+	FVector Extent;
+
+	FRuntimeMeshPositionQuantization() : Center(FVector::ZeroVector), Extent(1.0f, 1.0f, 1.0f) { }
+
+	explicit FRuntimeMeshPositionQuantization(const FBox& Bounds)
+	{
+		Center = Bounds.IsValid ? Bounds.GetCenter() : FVector::ZeroVector;
+		Extent = Bounds.IsValid ? Bounds.GetExtent() : FVector::ZeroVector;
+
+		// Flat sections still need an invertible transform
+		Extent = Extent.ComponentMax(FVector(KINDA_SMALL_NUMBER, KINDA_SMALL_NUMBER, KINDA_SMALL_NUMBER));
+	}
+
+	FRuntimeMeshQuantizedPosition Quantize(const FVector& Position) const
+	{
+		const FVector Normalized = (Position - Center) / Extent;
+
+		// Anything outside the bounds is clamped to them
+		FRuntimeMeshQuantizedPosition Quantized;
+		Quantized.X = (int16)FMath::RoundToInt(FMath::Clamp(Normalized.X, -1.0f, 1.0f) * MAX_int16);
+		Quantized.Y = (int16)FMath::RoundToInt(FMath::Clamp(Normalized.Y, -1.0f, 1.0f) * MAX_int16);
+		Quantized.Z = (int16)FMath::RoundToInt(FMath::Clamp(Normalized.Z, -1.0f, 1.0f) * MAX_int16);
+		Quantized.W = MAX_int16;
+		return Quantized;
+	}
+
+	/* Transform from the -1..1 space the GPU reads back to section local space */
+	FMatrix GetDequantizeTransform() const
+	{
+		return FScaleMatrix(Extent) * FTranslationMatrix(Center);
+	}
+};
+
+
 /** Vertex Buffer for one section. Templated to support different vertex types */
 template<typename VertexType>
 class FRuntimeMeshVertexBuffer : public FVertexBuffer
 {
 public:
 
-	FRuntimeMeshVertexBuffer(EUpdateFrequency SectionUpdateFrequency) : VertexCount(0)
+	FRuntimeMeshVertexBuffer(EUpdateFrequency SectionUpdateFrequency) : VertexCount(0), VertexCapacity(0), CurrentBuffer(0), AllocatedSize(0), UAVFormat(PF_Unknown)
 	{
-		UsageFlags = SectionUpdateFrequency == EUpdateFrequency::Frequent ? BUF_Dynamic : BUF_Static;
+		bool bIsStreaming = SectionUpdateFrequency == EUpdateFrequency::Frequent;
+		UsageFlags = bIsStreaming ? BUF_Dynamic : BUF_Static;
+		NumBuffers = bIsStreaming ? FRuntimeMeshBufferSizing::GetStreamingBufferCount() : 1;
 	}
 
 	virtual void InitRHI() override
 	{
-		// Create the vertex buffer
+		// Create the vertex buffer(s)
 		FRHIResourceCreateInfo CreateInfo;
-		VertexBufferRHI = RHICreateVertexBuffer(sizeof(VertexType) * VertexCount, UsageFlags, CreateInfo);
+		Buffers.SetNum(NumBuffers);
+		for (int32 Index = 0; Index < NumBuffers; Index++)
+		{
+			Buffers[Index] = RHICreateVertexBuffer(sizeof(VertexType) * VertexCapacity, UsageFlags, CreateInfo);
+		}
+
+		CurrentBuffer = 0;
+		VertexBufferRHI = Buffers[CurrentBuffer];
+
+		if (UAVFormat != PF_Unknown)
+		{
+			UAV = RHICreateUnorderedAccessView(VertexBufferRHI, UAVFormat);
+		}
+
+		AllocatedSize = sizeof(VertexType) * VertexCapacity * NumBuffers;
+		INC_MEMORY_STAT_BY(STAT_RuntimeMesh_GPUVertexMemory, AllocatedSize);
+	}
+
+	virtual void ReleaseRHI() override
+	{
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_GPUVertexMemory, AllocatedSize);
+		AllocatedSize = 0;
+
+		UAV.SafeRelease();
+		Buffers.Empty();
+		FVertexBuffer::ReleaseRHI();
+	}
+
+	/* Creates the buffer with an unordered access view in the given format so compute shaders can write it. Must be called before the buffer is first sized */
+	void EnableUnorderedAccess(EPixelFormat InUAVFormat)
+	{
+		check(VertexCapacity == 0);
+
+		// The GPU can't write dynamic buffers, and with a ring it would be writing a copy that isn't drawn next
+		UsageFlags = (EBufferUsageFlags)(BUF_Static | BUF_UnorderedAccess | BUF_ShaderResource);
+		NumBuffers = 1;
+		UAVFormat = InUAVFormat;
+	}
+
+	/* 
+	 *	Moves the buffer to a single copy that can be written in place, so SetDataRanges can be used. Dynamic buffers 
+	 *	are discarded whenever they're locked, so a partial write would lose the rest. An allocated buffer is recreated, 
+	 *	and its contents have to be sent again.
+	 */
+	void EnableRangeUpdates()
+	{
+		if (SupportsRangeUpdates())
+		{
+			return;
+		}
+
+		UsageFlags = (EBufferUsageFlags)((UsageFlags & ~BUF_Dynamic) | BUF_Static);
+		NumBuffers = 1;
+
+		if (VertexCapacity > 0)
+		{
+			INC_DWORD_STAT(STAT_RuntimeMesh_BufferReallocations);
+			ReleaseResource();
+			InitResource();
+		}
 	}
 
+	/* Can spans of this buffer be written without touching the rest */
+	bool SupportsRangeUpdates() const { return NumBuffers == 1 && (UsageFlags & BUF_Dynamic) == 0; }
+
+	/* Unordered access view of the buffer, null unless EnableUnorderedAccess was called */
+	FUnorderedAccessViewRHIParamRef GetUAV() const { return UAV; }
+
 	/* Get the size of the vertex buffer */
 	int32 Num() { return VertexCount; }
+
+	/* Get the GPU memory allocated for all copies of the buffer */
+	SIZE_T GetAllocatedSize() const { return AllocatedSize; }
+
+	/* Get the number of vertices the buffer is allocated to hold */
+	int32 GetCapacity() const { return VertexCapacity; }
 	
-	/* Set the size of the vertex buffer */
+	/* Set the size of the vertex buffer. Only reallocates if this doesn't fit the current capacity */
 	void SetNum(int32 NewVertexCount)
 	{
 		check(NewVertexCount != 0);
 
-		// Make sure we're not already the right size
-		if (NewVertexCount != VertexCount)
+		VertexCount = NewVertexCount;
+
+		// Make sure we're not already able to hold it
+		int32 NewCapacity = FRuntimeMeshBufferSizing::GetCapacity(VertexCapacity, NewVertexCount);
+		if (NewCapacity != VertexCapacity)
 		{
-			VertexCount = NewVertexCount;
+			if (VertexCapacity > 0)
+			{
+				INC_DWORD_STAT(STAT_RuntimeMesh_BufferReallocations);
+			}
+
+			VertexCapacity = NewCapacity;
 			
 			// Rebuild resource
 			ReleaseResource();
@@ -71,6 +247,9 @@ public:
 	{
 		check(Data.Num() == VertexCount);
 
+		// Move to the next buffer in the ring so we don't write to one the GPU might still be reading
+		FlipBuffer();
+
 		// Lock the vertex buffer
  		void* Buffer = RHILockVertexBuffer(VertexBufferRHI, 0, Data.Num() * sizeof(VertexType), RLM_WriteOnly);
  		 
@@ -79,45 +258,233 @@ public:
 
 		// Unlock the vertex buffer
  		RHIUnlockVertexBuffer(VertexBufferRHI);
+
+		FRuntimeMeshUploadStats::TrackUpload(Data.Num() * sizeof(VertexType));
+	}
+
+	/* Set the data for the supplied spans of the vertex buffer. Data holds the spans packed back to back */
+	void SetDataRanges(const TArray<FRuntimeMeshBufferRange>& Ranges, const TArray<VertexType>& Data)
+	{
+		// The rest of the buffer has to keep its contents, so this can't move through the ring or discard the buffer
+		check(SupportsRangeUpdates());
+
+		int32 DataOffset = 0;
+		for (const FRuntimeMeshBufferRange& Range : Ranges)
+		{
+			check(Range.Start >= 0 && Range.End() <= VertexCount);
+			check(DataOffset + Range.Count <= Data.Num());
+
+			// Lock only the span being written
+			void* Buffer = RHILockVertexBuffer(VertexBufferRHI, Range.Start * sizeof(VertexType), Range.Count * sizeof(VertexType), RLM_WriteOnly);
+
+			FMemory::Memcpy(Buffer, Data.GetData() + DataOffset, Range.Count * sizeof(VertexType));
+
+			RHIUnlockVertexBuffer(VertexBufferRHI);
+
+			FRuntimeMeshUploadStats::TrackUpload(Range.Count * sizeof(VertexType));
+
+			DataOffset += Range.Count;
+		}
+	}
+
+	/* Set the data for the vertex buffer, converting each element as it's written so there's no intermediate copy */
+	template<typename SourceType, typename ConverterType>
+	void SetDataConverted(const TArray<SourceType>& Data, const ConverterType& Converter)
+	{
+		check(Data.Num() == VertexCount);
+
+		FlipBuffer();
+
+		VertexType* Buffer = static_cast<VertexType*>(RHILockVertexBuffer(VertexBufferRHI, 0, Data.Num() * sizeof(VertexType), RLM_WriteOnly));
+		for (int32 Index = 0; Index < Data.Num(); Index++)
+		{
+			Buffer[Index] = Converter(Data[Index]);
+		}
+		RHIUnlockVertexBuffer(VertexBufferRHI);
+
+		FRuntimeMeshUploadStats::TrackUpload(Data.Num() * sizeof(VertexType));
+	}
+
+	/* Set the data for the supplied spans of the vertex buffer, converting each element as it's written. Data holds the spans packed back to back */
+	template<typename SourceType, typename ConverterType>
+	void SetDataRangesConverted(const TArray<FRuntimeMeshBufferRange>& Ranges, const TArray<SourceType>& Data, const ConverterType& Converter)
+	{
+		check(SupportsRangeUpdates());
+
+		int32 DataOffset = 0;
+		for (const FRuntimeMeshBufferRange& Range : Ranges)
+		{
+			check(Range.Start >= 0 && Range.End() <= VertexCount);
+			check(DataOffset + Range.Count <= Data.Num());
+
+			VertexType* Buffer = static_cast<VertexType*>(RHILockVertexBuffer(VertexBufferRHI, Range.Start * sizeof(VertexType), Range.Count * sizeof(VertexType), RLM_WriteOnly));
+			for (int32 Index = 0; Index < Range.Count; Index++)
+			{
+				Buffer[Index] = Converter(Data[DataOffset + Index]);
+			}
+			RHIUnlockVertexBuffer(VertexBufferRHI);
+
+			FRuntimeMeshUploadStats::TrackUpload(Range.Count * sizeof(VertexType));
+
+			DataOffset += Range.Count;
+		}
 	}
 
 private:
 
-	/* The number of vertices this buffer is currently allocated to hold */
+	/* Makes the next buffer in the ring current. The vertex factory reads VertexBufferRHI at draw time so this needs no rebinding */
+	void FlipBuffer()
+	{
+		if (NumBuffers > 1)
+		{
+			CurrentBuffer = (CurrentBuffer + 1) % NumBuffers;
+			VertexBufferRHI = Buffers[CurrentBuffer];
+		}
+	}
+
+	/* The number of vertices currently in use */
 	int32 VertexCount;
+	/* The number of vertices this buffer is currently allocated to hold */
+	int32 VertexCapacity;
 	/* The buffer configuration to use */
 	EBufferUsageFlags UsageFlags;
+	/* Number of copies of the buffer we cycle through */
+	int32 NumBuffers;
+	/* Index of the copy currently used for rendering */
+	int32 CurrentBuffer;
+	/* GPU memory allocated for all copies of the buffer */
+	SIZE_T AllocatedSize;
+	/* All copies of the buffer */
+	TArray<FVertexBufferRHIRef, TInlineAllocator<RUNTIMEMESH_MAX_STREAMING_BUFFER_COUNT>> Buffers;
+	/* Format of UAV, PF_Unknown if the buffer has none */
+	EPixelFormat UAVFormat;
+	/* View compute shaders write the buffer through */
+	FUnorderedAccessViewRHIRef UAV;
+};
+
+
+/** Buffers of one section a GPU deformer writes, see URuntimeMeshComponent::DeformMeshSectionGPU */
+struct FRuntimeMeshGPUDeformTarget
+{
+	/* Positions as a RWBuffer<float>, three per vertex */
+	FUnorderedAccessViewRHIParamRef PositionUAV;
+
+	/* The whole vertex buffer as a RWBuffer<uint>. Null if the vertex type isn't a whole number of uints */
+	FUnorderedAccessViewRHIParamRef VertexUAV;
+
+	int32 NumVertices;
+
+	/* Size of one vertex in VertexUAV, in uints */
+	int32 VertexStride;
+
+	/* Offsets of the normal (TangentZ) and tangent (TangentX) within a vertex in uints, INDEX_NONE if the vertex type has none */
+	int32 NormalOffset;
+	int32 TangentOffset;
+
+	/* Format of the normal and tangent, normally VET_PackedNormal */
+	EVertexElementType TangentBasisType;
+
+	FRuntimeMeshGPUDeformTarget()
+		: PositionUAV(nullptr), VertexUAV(nullptr), NumVertices(0), VertexStride(0), NormalOffset(INDEX_NONE), TangentOffset(INDEX_NONE), TangentBasisType(VET_None)
+	{ }
 };
 
+/** Dispatches the compute work that deforms a section. Runs on the rendering thread with the target's buffers already writable */
+using FRuntimeMeshGPUDeformer = TFunction<void(FRHICommandListImmediate& RHICmdList, const FRuntimeMeshGPUDeformTarget& Target)>;
+
 /** Index Buffer */
 class FRuntimeMeshIndexBuffer : public FIndexBuffer
 {
 public:
 
-	FRuntimeMeshIndexBuffer(EUpdateFrequency SectionUpdateFrequency) : IndexCount(0)
+	FRuntimeMeshIndexBuffer(EUpdateFrequency SectionUpdateFrequency) : IndexCount(0), IndexCapacity(0), bUse16BitIndices(false), CurrentBuffer(0), AllocatedSize(0)
 	{
-		UsageFlags = SectionUpdateFrequency == EUpdateFrequency::Frequent ? BUF_Dynamic : BUF_Static;
+		bool bIsStreaming = SectionUpdateFrequency == EUpdateFrequency::Frequent;
+		UsageFlags = bIsStreaming ? BUF_Dynamic : BUF_Static;
+		NumBuffers = bIsStreaming ? FRuntimeMeshBufferSizing::GetStreamingBufferCount() : 1;
 	}
 
 	virtual void InitRHI() override
 	{
-		// Create the index buffer
+		// Create the index buffer(s)
 		FRHIResourceCreateInfo CreateInfo;
-		IndexBufferRHI = RHICreateIndexBuffer(sizeof(int32), IndexCount * sizeof(int32), BUF_Dynamic, CreateInfo);
+		Buffers.SetNum(NumBuffers);
+		for (int32 Index = 0; Index < NumBuffers; Index++)
+		{
+			Buffers[Index] = RHICreateIndexBuffer(GetIndexStride(), IndexCapacity * GetIndexStride(), UsageFlags, CreateInfo);
+		}
+
+		CurrentBuffer = 0;
+		IndexBufferRHI = Buffers[CurrentBuffer];
+
+		AllocatedSize = GetIndexStride() * IndexCapacity * NumBuffers;
+		INC_MEMORY_STAT_BY(STAT_RuntimeMesh_GPUIndexMemory, AllocatedSize);
+	}
+
+	virtual void ReleaseRHI() override
+	{
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_GPUIndexMemory, AllocatedSize);
+		AllocatedSize = 0;
+
+		Buffers.Empty();
+		FIndexBuffer::ReleaseRHI();
 	}
 
+	/* Moves the buffer to a single copy that can be written in place, so SetDataRanges can be used. See FRuntimeMeshVertexBuffer::EnableRangeUpdates */
+	void EnableRangeUpdates()
+	{
+		if (SupportsRangeUpdates())
+		{
+			return;
+		}
+
+		UsageFlags = BUF_Static;
+		NumBuffers = 1;
+
+		if (IndexCapacity > 0)
+		{
+			INC_DWORD_STAT(STAT_RuntimeMesh_BufferReallocations);
+			ReleaseResource();
+			InitResource();
+		}
+	}
+
+	/* Can spans of this buffer be written without touching the rest */
+	bool SupportsRangeUpdates() const { return NumBuffers == 1 && (UsageFlags & BUF_Dynamic) == 0; }
+
 	/* Get the size of the index buffer */
 	int32 Num() { return IndexCount; }
 
-	/* Set the size of the index buffer */
-	void SetNum(int32 NewIndexCount)
+	/* Get the GPU memory allocated for all copies of the buffer */
+	SIZE_T GetAllocatedSize() const { return AllocatedSize; }
+
+	/* Get the number of indices the buffer is allocated to hold */
+	int32 GetCapacity() const { return IndexCapacity; }
+
+	/* Is this buffer currently using 16 bit indices */
+	bool Is16Bit() const { return bUse16BitIndices; }
+
+	/* Can a section with the supplied vertex count be drawn using 16 bit indices */
+	static bool CanUse16BitIndices(int32 NumVertices) { return NumVertices <= (MAX_uint16 + 1); }
+
+	/* Set the size of the index buffer, and the index format to use. Only reallocates if this doesn't fit the current capacity or the format changes */
+	void SetNum(int32 NewIndexCount, bool bNewUse16BitIndices)
 	{
 		check(NewIndexCount != 0);
 
-		// Make sure we're not already the right size
-		if (NewIndexCount != IndexCount)
+		IndexCount = NewIndexCount;
+
+		// Make sure we're not already able to hold it in the right format
+		int32 NewCapacity = FRuntimeMeshBufferSizing::GetCapacity(IndexCapacity, NewIndexCount);
+		if (NewCapacity != IndexCapacity || bNewUse16BitIndices != bUse16BitIndices)
 		{
-			IndexCount = NewIndexCount;
+			if (IndexCapacity > 0)
+			{
+				INC_DWORD_STAT(STAT_RuntimeMesh_BufferReallocations);
+			}
+
+			IndexCapacity = NewCapacity;
+			bUse16BitIndices = bNewUse16BitIndices;
 
 			// Rebuild resource
 			ReleaseResource();
@@ -125,27 +492,109 @@ public:
 		}
 	}
 
-	/* Set the data for the index buffer */
+	/* Set the data for the index buffer, converting to 16 bit indices if the buffer uses them */
 	void SetData(const TArray<int32>& Data)
 	{
 		check(Data.Num() == IndexCount);
 
+		// Move to the next buffer in the ring so we don't write to one the GPU might still be reading
+		FlipBuffer();
+
 		// Lock the index buffer
-		void* Buffer = RHILockIndexBuffer(IndexBufferRHI, 0, IndexCount * sizeof(int32), RLM_WriteOnly);
+		void* Buffer = RHILockIndexBuffer(IndexBufferRHI, 0, IndexCount * GetIndexStride(), RLM_WriteOnly);
 
-		// Write the indices to the vertex buffer	
-		FMemory::Memcpy(Buffer, Data.GetData(), Data.Num() * sizeof(int32));
+		if (bUse16BitIndices)
+		{
+			// Narrow the indices as we write them to the index buffer
+			uint16* IndexData = static_cast<uint16*>(Buffer);
+			for (int32 Index = 0; Index < IndexCount; Index++)
+			{
+				checkSlow(Data[Index] >= 0 && Data[Index] <= MAX_uint16);
+				IndexData[Index] = static_cast<uint16>(Data[Index]);
+			}
+		}
+		else
+		{
+			// Write the indices to the index buffer
+			FMemory::Memcpy(Buffer, Data.GetData(), Data.Num() * sizeof(int32));
+		}
 
 		// Unlock the index buffer
 		RHIUnlockIndexBuffer(IndexBufferRHI);
+
+		FRuntimeMeshUploadStats::TrackUpload(IndexCount * GetIndexStride());
+	}
+
+	/* Set the data for the supplied spans of the index buffer. Data holds the spans packed back to back */
+	void SetDataRanges(const TArray<FRuntimeMeshBufferRange>& Ranges, const TArray<int32>& Data)
+	{
+		// The rest of the buffer has to keep its contents, so this can't move through the ring or discard the buffer
+		check(SupportsRangeUpdates());
+
+		const uint32 Stride = GetIndexStride();
+		int32 DataOffset = 0;
+		for (const FRuntimeMeshBufferRange& Range : Ranges)
+		{
+			check(Range.Start >= 0 && Range.End() <= IndexCount);
+			check(DataOffset + Range.Count <= Data.Num());
+
+			// Lock only the span being written
+			void* Buffer = RHILockIndexBuffer(IndexBufferRHI, Range.Start * Stride, Range.Count * Stride, RLM_WriteOnly);
+
+			if (bUse16BitIndices)
+			{
+				uint16* IndexData = static_cast<uint16*>(Buffer);
+				for (int32 Index = 0; Index < Range.Count; Index++)
+				{
+					const int32 SourceIndex = Data[DataOffset + Index];
+					checkSlow(SourceIndex >= 0 && SourceIndex <= MAX_uint16);
+					IndexData[Index] = static_cast<uint16>(SourceIndex);
+				}
+			}
+			else
+			{
+				FMemory::Memcpy(Buffer, Data.GetData() + DataOffset, Range.Count * sizeof(int32));
+			}
+
+			RHIUnlockIndexBuffer(IndexBufferRHI);
+
+			FRuntimeMeshUploadStats::TrackUpload(Range.Count * Stride);
+
+			DataOffset += Range.Count;
+		}
 	}
 
 private:
 
-	/* The number of indices this buffer is currently allocated to hold */
+	/* Makes the next buffer in the ring current. Mesh batches read IndexBufferRHI at draw time so this needs no rebinding */
+	void FlipBuffer()
+	{
+		if (NumBuffers > 1)
+		{
+			CurrentBuffer = (CurrentBuffer + 1) % NumBuffers;
+			IndexBufferRHI = Buffers[CurrentBuffer];
+		}
+	}
+
+	/* Size in bytes of a single index in the current format */
+	uint32 GetIndexStride() const { return bUse16BitIndices ? sizeof(uint16) : sizeof(int32); }
+
+	/* The number of indices currently in use */
 	int32 IndexCount;
+	/* The number of indices this buffer is currently allocated to hold */
+	int32 IndexCapacity;
+	/* Is the buffer currently using 16 bit indices */
+	bool bUse16BitIndices;
 	/* The buffer configuration to use */
 	EBufferUsageFlags UsageFlags;
+	/* Number of copies of the buffer we cycle through */
+	int32 NumBuffers;
+	/* Index of the copy currently used for rendering */
+	int32 CurrentBuffer;
+	/* GPU memory allocated for all copies of the buffer */
+	SIZE_T AllocatedSize;
+	/* All copies of the buffer */
+	TArray<FIndexBufferRHIRef, TInlineAllocator<RUNTIMEMESH_MAX_STREAMING_BUFFER_COUNT>> Buffers;
 };
 
 /** Vertex Factory */
@@ -185,3 +634,81 @@ private:
 	/* Interface to the parent section for checking visibility.*/
 	FRuntimeMeshVisibilityInterface* SectionParent;
 };
+
+
+/* 
+ *	Vertex factory for instanced sections. Reads the section's vertices like the local vertex factory, plus
+ *	a per instance stream of FRuntimeMeshInstanceData, and compiles the engine's local vertex factory shader
+ *	with instancing enabled. Materials need 'Used with Instanced Static Meshes' to render with it.
+ */
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshInstancedVertexFactory : public FLocalVertexFactory
+{
+	DECLARE_VERTEX_FACTORY_TYPE(FRuntimeMeshInstancedVertexFactory);
+public:
+
+	struct FDataType : public RuntimeMeshVertexStructure
+	{
+		FVertexStreamComponent InstanceOriginComponent;
+		FVertexStreamComponent InstanceTransformComponent[3];
+		FVertexStreamComponent InstanceLightmapAndShadowMapUVBiasComponent;
+	};
+
+	FRuntimeMeshInstancedVertexFactory(FRuntimeMeshVisibilityInterface* InSectionParent) : SectionParent(InSectionParent) { }
+
+	/** Init function that can be called on any thread, and will do the right thing (enqueue command if called on main thread) */
+	void Init(const FDataType& VertexStructure)
+	{
+		if (IsInRenderingThread())
+		{
+			InstancedData = VertexStructure;
+			UpdateRHI();
+		}
+		else
+		{
+			// Send the command to the render thread
+			ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+				InitRuntimeMeshInstancedVertexFactory,
+				FRuntimeMeshInstancedVertexFactory*, VertexFactory, this,
+				const FDataType, VertexStructure, VertexStructure,
+				{
+					VertexFactory->Init(VertexStructure);
+				});
+		}
+	}
+
+	/* Builds the vertex streams for an instanced section from the sections vertex structure and its instance buffer */
+	static FDataType MakeInstancedStructure(const RuntimeMeshVertexStructure& VertexStructure, const FVertexBuffer* InstanceBuffer)
+	{
+		FDataType InstancedStructure;
+		static_cast<RuntimeMeshVertexStructure&>(InstancedStructure) = VertexStructure;
+
+		const uint32 Stride = sizeof(FRuntimeMeshInstanceData);
+		InstancedStructure.InstanceOriginComponent = FVertexStreamComponent(InstanceBuffer, STRUCT_OFFSET(FRuntimeMeshInstanceData, InstanceOrigin), Stride, VET_Float4, true);
+		InstancedStructure.InstanceTransformComponent[0] = FVertexStreamComponent(InstanceBuffer, STRUCT_OFFSET(FRuntimeMeshInstanceData, InstanceTransform1), Stride, VET_Float4, true);
+		InstancedStructure.InstanceTransformComponent[1] = FVertexStreamComponent(InstanceBuffer, STRUCT_OFFSET(FRuntimeMeshInstanceData, InstanceTransform2), Stride, VET_Float4, true);
+		InstancedStructure.InstanceTransformComponent[2] = FVertexStreamComponent(InstanceBuffer, STRUCT_OFFSET(FRuntimeMeshInstanceData, InstanceTransform3), Stride, VET_Float4, true);
+		InstancedStructure.InstanceLightmapAndShadowMapUVBiasComponent = FVertexStreamComponent(InstanceBuffer, STRUCT_OFFSET(FRuntimeMeshInstanceData, InstanceLightmapAndShadowMapUVBias), Stride, VET_Short4N, true);
+		return InstancedStructure;
+	}
+
+	static bool ShouldCache(EShaderPlatform Platform, const class FMaterial* Material, const class FShaderType* ShaderType);
+
+	static void ModifyCompilationEnvironment(EShaderPlatform Platform, const FMaterial* Material, FShaderCompilerEnvironment& OutEnvironment);
+
+	static FVertexFactoryShaderParameters* ConstructShaderParameters(EShaderFrequency ShaderFrequency);
+
+	virtual void InitRHI() override;
+
+	/* Gets the section visibility for static sections */
+	virtual uint64 GetStaticBatchElementVisibility(const class FSceneView& View, const struct FMeshBatch* Batch) const override
+	{
+		return SectionParent->ShouldRender();
+	}
+
+private:
+	/* Vertex and instance streams this factory binds */
+	FDataType InstancedData;
+
+	/* Interface to the parent section for checking visibility.*/
+	FRuntimeMeshVisibilityInterface* SectionParent;
+};
@@ -6,7 +6,11 @@
 #include "Components/MeshComponent.h"
 #include "RuntimeMeshProfiling.h"
 #include "RuntimeMeshVersion.h"
+#include "RuntimeMeshBounds.h"
+#include "RuntimeMeshTangents.h"
+#include "RuntimeMeshOptimizer.h"
 #include "RuntimeMeshSectionProxy.h"
+#include "RuntimeMeshCache.h"
 
 /** Interface class for a single mesh section */
 class FRuntimeMeshSectionInterface
@@ -16,10 +20,13 @@ protected:
 
 public:
 	/** Position only vertex buffer for this section */
-	TArray<FVector> PositionVertexBuffer;
+	FRuntimeMeshSharedBuffer<FVector> PositionVertexBuffer;
 
 	/** Index buffer for this section */
-	TArray<int32> IndexBuffer;
+	FRuntimeMeshSharedBuffer<int32> IndexBuffer;
+
+	/** Lower detail index buffers for this section, LOD 0 is IndexBuffer so this starts at LOD 1 */
+	TArray<FRuntimeMeshSectionLOD> LODs;
 
 	/** Local bounding box of section */
 	FBox LocalBoundingBox;
@@ -36,22 +43,85 @@ public:
 	/** Update frequency of this section */
 	EUpdateFrequency UpdateFrequency;
 
+	/** Per instance transforms and custom data. Only drawn once bIsInstanced is set */
+	FRuntimeMeshSharedBuffer<FRuntimeMeshInstanceData> Instances;
+
 	FRuntimeMeshSectionInterface(bool bInNeedsPositionOnlyBuffer) : 
 		bNeedsPositionOnlyBuffer(bInNeedsPositionOnlyBuffer),
 		LocalBoundingBox(0),
 		CollisionEnabled(false),
 		bIsVisible(true),
 		bCastsShadow(true),
-		bIsInternalSectionType(false)
+		bIsInternalSectionType(false),
+		bIsRenderOnly(false),
+		bHasReleasedCPUData(false),
+		bQuantizePositions(false),
+		bGPUDeformable(false),
+		bIsInstanced(false),
+		bInstanceCountChanged(false),
+		bRangeUpdatesEnabled(false),
+		bInstanceRangeUpdatesEnabled(false),
+		CachedInstanceBounds(0),
+		CachedInstanceMeshBounds(0),
+		bInstanceBoundsDirty(true),
+		AccountedVertexMemory(0),
+		AccountedPositionMemory(0),
+		AccountedIndexMemory(0)
 	{}
 
-	virtual ~FRuntimeMeshSectionInterface() { }
+	virtual ~FRuntimeMeshSectionInterface()
+	{
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUVertexMemory, AccountedVertexMemory);
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUPositionMemory, AccountedPositionMemory);
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUIndexMemory, AccountedIndexMemory);
+	}
 	
 protected:
 
 	/** Is this an internal section type. */
 	bool bIsInternalSectionType;
 
+	/** Is the game thread copy of the data released once it's been sent to the RT */
+	bool bIsRenderOnly;
+
+	/** Has the game thread copy of the data been released */
+	bool bHasReleasedCPUData;
+
+	/** Are positions quantized to the section bounds when sent to the GPU. The game thread copy keeps full precision */
+	bool bQuantizePositions;
+
+	/** Can the GPU copy of the positions and vertices be written by compute shaders. The game thread copy doesn't see those writes */
+	bool bGPUDeformable;
+
+	/** Spans of each buffer changed by range updates that haven't been sent to the RT yet */
+	FRuntimeMeshDirtyRanges DirtyPositionRanges;
+	FRuntimeMeshDirtyRanges DirtyVertexRanges;
+	FRuntimeMeshDirtyRanges DirtyIndexRanges;
+
+	/** Is this section drawn once per element of Instances with hardware instancing */
+	bool bIsInstanced;
+
+	/** Instances changed since they were last sent to the RT. A changed count always sends the whole buffer */
+	FRuntimeMeshDirtyRanges DirtyInstanceRanges;
+	bool bInstanceCountChanged;
+
+	/** 
+	 *	Have the RT buffers been moved to single copies that can be written in place. Frequent sections start out 
+	 *	with dynamic buffers that can only be replaced whole, and are switched with a full upload on their first range update.
+	 */
+	bool bRangeUpdatesEnabled;
+	bool bInstanceRangeUpdatesEnabled;
+
+	/** Bounds of the mesh under every instance transform, and the mesh bounds they were built from */
+	mutable FBox CachedInstanceBounds;
+	mutable FBox CachedInstanceMeshBounds;
+	mutable bool bInstanceBoundsDirty;
+
+	/** Memory of the game thread copies last added to the memory stats */
+	SIZE_T AccountedVertexMemory;
+	SIZE_T AccountedPositionMemory;
+	SIZE_T AccountedIndexMemory;
+
 	bool IsDualBufferSection() const { return bNeedsPositionOnlyBuffer; }
 
 	/* Updates the vertex position buffer,   returns whether we have a new bounding box */
@@ -63,15 +133,12 @@ protected:
 		if (bShouldMoveArray)
 		{
 			// Move buffer data
-			PositionVertexBuffer = MoveTemp(Positions);
+			PositionVertexBuffer.Set(MoveTemp(Positions));
 
 			// Calculate the bounding box if one doesn't exist.
 			if (BoundingBox == nullptr)
 			{
-				for (int32 VertexIdx = 0; VertexIdx < PositionVertexBuffer.Num(); VertexIdx++)
-				{
-					NewBoundingBox += PositionVertexBuffer[VertexIdx];
-				}
+				NewBoundingBox = FRuntimeMeshBounds::ComputeBounds(PositionVertexBuffer.Get().GetData(), PositionVertexBuffer.Num());
 			}
 			else
 			{
@@ -85,17 +152,14 @@ protected:
 			{
 				// Copy the buffer and calculate the bounding box at the same time
 				int32 NumVertices = Positions.Num();
-				PositionVertexBuffer.SetNumUninitialized(NumVertices);
-				for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
-				{
-					NewBoundingBox += Positions[VertexIdx];
-					PositionVertexBuffer[VertexIdx] = Positions[VertexIdx];
-				}
+				TArray<FVector>& NewPositions = PositionVertexBuffer.Overwrite();
+				NewPositions.SetNumUninitialized(NumVertices);
+				NewBoundingBox = FRuntimeMeshBounds::CopyWithBounds(NewPositions.GetData(), Positions.GetData(), NumVertices);
 			}
 			else
 			{
 				// Copy the buffer
-				PositionVertexBuffer = Positions;
+				PositionVertexBuffer.Set(Positions);
 
 				// Copy the supplied bounding box instead of calculating it.
 				NewBoundingBox = *BoundingBox;
@@ -116,25 +180,325 @@ protected:
 	{
 		if (bShouldMoveArray)
 		{
-			IndexBuffer = MoveTemp(Triangles);
+			IndexBuffer.Set(MoveTemp(Triangles));
 		}
 		else
 		{
-			IndexBuffer = Triangles;
+			IndexBuffer.Set(Triangles);
+		}
+	}
+
+	/* Updates the index buffer from 16 bit indices. The RT picks its own index format so these are widened for storage. */
+	void UpdateIndexBuffer(const TArray<uint16>& Triangles)
+	{
+		int32 NumIndices = Triangles.Num();
+		TArray<int32>& NewIndices = IndexBuffer.Overwrite();
+		NewIndices.SetNumUninitialized(NumIndices);
+		for (int32 Index = 0; Index < NumIndices; Index++)
+		{
+			NewIndices[Index] = Triangles[Index];
+		}
+	}
+
+	/* Grows the bounding box to contain the supplied box, returns whether we have a new bounding box */
+	bool ExpandBoundingBox(const FBox& BoundingBox)
+	{
+		if (!BoundingBox.IsValid)
+		{
+			return false;
+		}
+
+		FBox NewBoundingBox = LocalBoundingBox.IsValid ? LocalBoundingBox + BoundingBox : BoundingBox;
+		if (!(LocalBoundingBox == NewBoundingBox))
+		{
+			LocalBoundingBox = NewBoundingBox;
+			return true;
+		}
+
+		return false;
+	}
+
+	/* Updates a span of the position buffer in place,   returns whether we have a new bounding box */
+	bool UpdateVertexPositionBufferRange(int32 FirstVertex, const TArray<FVector>& Positions)
+	{
+		TArray<FVector>& EditPositions = PositionVertexBuffer.Edit();
+		FBox RangeBoundingBox = FRuntimeMeshBounds::CopyWithBounds(EditPositions.GetData() + FirstVertex, Positions.GetData(), Positions.Num());
+
+		DirtyPositionRanges.Add(FirstVertex, Positions.Num());
+		return ExpandBoundingBox(RangeBoundingBox);
+	}
+
+	/* Marks spans of the position buffer that were changed in place,   returns whether we have a new bounding box */
+	bool MarkPositionRangesDirty(const TArray<FRuntimeMeshBufferRange>& Ranges)
+	{
+		FBox RangeBoundingBox(0);
+		for (const FRuntimeMeshBufferRange& Range : Ranges)
+		{
+			RangeBoundingBox += FRuntimeMeshBounds::ComputeBounds(PositionVertexBuffer.Get().GetData() + Range.Start, Range.Count);
+
+			DirtyPositionRanges.Add(Range);
 		}
+
+		return ExpandBoundingBox(RangeBoundingBox);
+	}
+
+	/* Updates a span of the index buffer in place */
+	void UpdateIndexBufferRange(int32 FirstIndex, const TArray<int32>& Triangles)
+	{
+		TArray<int32>& EditIndices = IndexBuffer.Edit();
+		for (int32 Index = 0; Index < Triangles.Num(); Index++)
+		{
+			EditIndices[FirstIndex + Index] = Triangles[Index];
+		}
+
+		DirtyIndexRanges.Add(FirstIndex, Triangles.Num());
+	}
+
+	/* Bounds of everything the section draws. For instanced sections this is the mesh bounds under every instance transform */
+	FBox GetRenderBounds() const
+	{
+		if (!bIsInstanced)
+		{
+			return LocalBoundingBox;
+		}
+
+		if (bInstanceBoundsDirty || !(CachedInstanceMeshBounds == LocalBoundingBox))
+		{
+			CachedInstanceBounds = FBox(0);
+			if (LocalBoundingBox.IsValid)
+			{
+				for (const FRuntimeMeshInstanceData& Instance : Instances.Get())
+				{
+					CachedInstanceBounds += LocalBoundingBox.TransformBy(Instance.GetMatrix());
+				}
+			}
+
+			CachedInstanceMeshBounds = LocalBoundingBox;
+			bInstanceBoundsDirty = false;
+		}
+
+		return CachedInstanceBounds;
+	}
+
+	/* Appends instances, returns the index of the first one. CustomData is either empty or one value per transform */
+	int32 AddInstances(const TArray<FTransform>& Transforms, const TArray<float>& CustomData)
+	{
+		TArray<FRuntimeMeshInstanceData>& EditInstances = Instances.Edit();
+		const int32 FirstInstance = EditInstances.Num();
+		EditInstances.Reserve(FirstInstance + Transforms.Num());
+
+		for (int32 Index = 0; Index < Transforms.Num(); Index++)
+		{
+			const FRuntimeMeshInstanceData& Instance = EditInstances[EditInstances.Emplace(Transforms[Index], CustomData.Num() > 0 ? CustomData[Index] : 0.0f)];
+
+			// Appending can only grow the bounds, so they're extended instead of rebuilt
+			if (!bInstanceBoundsDirty && CachedInstanceMeshBounds == LocalBoundingBox && LocalBoundingBox.IsValid)
+			{
+				CachedInstanceBounds += LocalBoundingBox.TransformBy(Instance.GetMatrix());
+			}
+		}
+
+		bInstanceCountChanged = true;
+		return FirstInstance;
+	}
+
+	/* Replaces a span of existing instances in place */
+	void UpdateInstances(int32 FirstInstance, const TArray<FTransform>& Transforms, const TArray<float>& CustomData)
+	{
+		TArray<FRuntimeMeshInstanceData>& EditInstances = Instances.Edit();
+		for (int32 Index = 0; Index < Transforms.Num(); Index++)
+		{
+			FRuntimeMeshInstanceData& Instance = EditInstances[FirstInstance + Index];
+			Instance.SetInstance(Transforms[Index], CustomData.Num() > 0 ? CustomData[Index] : Instance.GetCustomData());
+		}
+
+		DirtyInstanceRanges.Add(FirstInstance, Transforms.Num());
+		bInstanceBoundsDirty = true;
+	}
+
+	/* Removes a span of instances, moving the ones after it down */
+	void RemoveInstances(int32 FirstInstance, int32 NumInstances)
+	{
+		Instances.Edit().RemoveAt(FirstInstance, NumInstances);
+		bInstanceCountChanged = true;
+		bInstanceBoundsDirty = true;
+	}
+
+	/* Gets the instance changes for the RT and clears them */
+	FRuntimeMeshSectionInstanceUpdateData* GetSectionInstanceUpdateData()
+	{
+		auto UpdateData = new FRuntimeMeshSectionInstanceUpdateData();
+
+		// The instance buffer of a Frequent section can only be replaced whole until it's switched, which takes one full upload
+		if (!bInstanceCountChanged && UpdateFrequency == EUpdateFrequency::Frequent && !bInstanceRangeUpdatesEnabled)
+		{
+			bInstanceRangeUpdatesEnabled = true;
+			UpdateData->bEnableRangeUpdates = true;
+			UpdateData->Instances = Instances.Share();
+		}
+		else if (bInstanceCountChanged)
+		{
+			UpdateData->Instances = Instances.Share();
+		}
+		else
+		{
+			const TArray<FRuntimeMeshInstanceData>& CurrentInstances = Instances.Get();
+			UpdateData->InstanceRanges = DirtyInstanceRanges.GetRanges();
+			UpdateData->InstanceData.Reserve(DirtyInstanceRanges.GetTotalCount());
+			for (const FRuntimeMeshBufferRange& Range : UpdateData->InstanceRanges)
+			{
+				UpdateData->InstanceData.Append(CurrentInstances.GetData() + Range.Start, Range.Count);
+			}
+		}
+
+		UpdateData->LocalBoundingBox = GetRenderBounds();
+
+		ClearInstanceChanges();
+
+		return UpdateData;
+	}
+
+	/* Drops any pending instance changes. Used when the instances are sent in full with the section */
+	void ClearInstanceChanges()
+	{
+		DirtyInstanceRanges.Reset();
+		bInstanceCountChanged = false;
+	}
+
+	/* Drops the game thread copy of the data if this is a render only section. Call once the data has been handed to the RT */
+	void ReleaseCPUDataIfRenderOnly()
+	{
+		if (bIsRenderOnly)
+		{
+			PositionVertexBuffer.Release();
+			IndexBuffer.Release();
+			for (FRuntimeMeshSectionLOD& LOD : LODs)
+			{
+				LOD.IndexBuffer.Release();
+			}
+			ReleaseVertexBuffer();
+			ClearDirtyRanges();
+			bHasReleasedCPUData = true;
+
+			UpdateMemoryStats();
+		}
+	}
+
+	/* Size of the game thread copy of the index buffer and the LOD index buffers */
+	SIZE_T GetIndexDataSize() const
+	{
+		SIZE_T Size = IndexBuffer.GetAllocatedSize() + LODs.GetAllocatedSize();
+		for (const FRuntimeMeshSectionLOD& LOD : LODs)
+		{
+			Size += LOD.IndexBuffer.GetAllocatedSize();
+		}
+		return Size;
+	}
+
+	/* Size of the game thread copy of the position buffer */
+	SIZE_T GetPositionDataSize() const { return PositionVertexBuffer.GetAllocatedSize(); }
+
+	/* Brings the memory stats up to date with the current buffers. Call after the buffers change */
+	void UpdateMemoryStats()
+	{
+		const SIZE_T VertexMemory = GetVertexDataSize();
+		const SIZE_T PositionMemory = GetPositionDataSize();
+		const SIZE_T IndexMemory = GetIndexDataSize();
+
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUVertexMemory, AccountedVertexMemory);
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUPositionMemory, AccountedPositionMemory);
+		DEC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUIndexMemory, AccountedIndexMemory);
+		INC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUVertexMemory, VertexMemory);
+		INC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUPositionMemory, PositionMemory);
+		INC_MEMORY_STAT_BY(STAT_RuntimeMesh_CPUIndexMemory, IndexMemory);
+
+		AccountedVertexMemory = VertexMemory;
+		AccountedPositionMemory = PositionMemory;
+		AccountedIndexMemory = IndexMemory;
+	}
+
+	/* Gets references to the LOD index buffers for the RT */
+	void ShareLODs(TArray<FRuntimeMeshSharedBuffer<int32>::SharedArrayRef>& OutIndexBuffers, TArray<float>& OutScreenSizes) const
+	{
+		OutIndexBuffers.Reset(LODs.Num());
+		OutScreenSizes.Reset(LODs.Num());
+		for (const FRuntimeMeshSectionLOD& LOD : LODs)
+		{
+			OutIndexBuffers.Add(LOD.IndexBuffer.Share());
+			OutScreenSizes.Add(LOD.ScreenSize);
+		}
+	}
+
+	/* Do we have range updates waiting to be sent to the RT */
+	bool HasDirtyRanges() const
+	{
+		return !DirtyPositionRanges.IsEmpty() || !DirtyVertexRanges.IsEmpty() || !DirtyIndexRanges.IsEmpty();
+	}
+
+	/* Bytes of the pending range updates of the chosen buffers, as they'll be sent to the RT */
+	virtual SIZE_T GetDirtyRangeDataSize(bool bIncludePositions, bool bIncludeVertices, bool bIncludeIndices) const = 0;
+
+	/* Bytes of the pending instance changes, the whole buffer if it has to be sent in full */
+	SIZE_T GetInstanceUpdateDataSize() const
+	{
+		const bool bSendsAllInstances = bInstanceCountChanged || (UpdateFrequency == EUpdateFrequency::Frequent && !bInstanceRangeUpdatesEnabled);
+		return bSendsAllInstances ? Instances.GetAllocatedSize() : DirtyInstanceRanges.GetTotalCount() * sizeof(FRuntimeMeshInstanceData);
+	}
+
+	/* Drops any pending range updates. Used when the full buffers are being sent instead */
+	void ClearDirtyRanges()
+	{
+		DirtyPositionRanges.Reset();
+		DirtyVertexRanges.Reset();
+		DirtyIndexRanges.Reset();
 	}
 
 	virtual FRuntimeMeshSectionCreateDataInterface* GetSectionCreationData(UMaterialInterface* InMaterial) const = 0;
 
+	/* 
+	 *	Gets the creation data for one proxy holding all of PackedSections back to back. Every section must
+	 *	have this sections vertex type and buffer layout. OutRanges receives where each section was placed.
+	 */
+	virtual FRuntimeMeshSectionCreateDataInterface* GetPackedSectionCreationData(const TArray<FRuntimeMeshSectionInterface*>& PackedSections, 
+		UMaterialInterface* InMaterial, TArray<FRuntimeMeshPackedSectionRange>& OutRanges) const = 0;
+
 	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionUpdateData(bool bIncludePositionVertices, bool bIncludeVertices, bool bIncludeIndices) const = 0;
 
 	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionPositionUpdateData() const = 0;
 
+	/* Drops the game thread copy of the vertex buffer */
+	virtual void ReleaseVertexBuffer() = 0;
+
+	/* Size of the game thread copy of the vertex buffer */
+	virtual SIZE_T GetVertexDataSize() const = 0;
+
+	/* Gets the data for all pending range updates and clears them */
+	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionRangeUpdateData() = 0;
+
+	/* Marks spans of the vertex buffer that were changed in place,   returns whether we have a new bounding box */
+	virtual bool MarkVertexRangesDirty(const TArray<FRuntimeMeshBufferRange>& Ranges) = 0;
+
+	/*
+	*	Recalculates normals and tangents from the positions, triangles and UV0. If bOnlyDirtyRanges is set only the vertices
+	*	affected by the pending dirty ranges are recalculated, and they're added to the dirty vertex ranges.
+	*	Returns false if the vertex type doesn't support it.
+	*/
+	virtual bool CalculateNormalTangents(float WeldTolerance, bool bOnlyDirtyRanges) = 0;
+
+	/*
+	*	Reorders the triangles for the vertex cache and overdraw, and the vertices for vertex fetch if bReorderVertices is set.
+	*	Returns false if the game thread copy of the data has been released.
+	*/
+	virtual bool OptimizeMesh(bool bReorderVertices) = 0;
+
 
 
 
 	virtual int32 GetAllVertexPositions(TArray<FVector>& Positions) = 0;
 
+	/* Gets the number of vertices in this section */
+	virtual int32 GetNumVertices() const = 0;
+
 	virtual void GetInternalVertexComponents(int32& NumUVChannels, bool& WantsHalfPrecisionUVs) { }
 
 	// This is only meant for internal use for supporting the old style create/update sections
@@ -143,21 +507,72 @@ protected:
 
 	virtual const FRuntimeMeshVertexTypeInfo* GetVertexType() const = 0;
 
+	/* Points a cache view at the game thread copy of the section buffers */
+	virtual void GetCacheView(FRuntimeMeshCacheSectionView& OutView) const = 0;
+
 
 	virtual void Serialize(FArchive& Ar)
 	{
-		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::DualVertexBuffer)
+		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::BulkSerialization)
+		{
+			PositionVertexBuffer.BulkSerialize(Ar);
+			IndexBuffer.BulkSerialize(Ar);
+
+			int32 NumLODs = LODs.Num();
+			Ar << NumLODs;
+			if (Ar.IsLoading())
+			{
+				LODs.SetNum(NumLODs);
+			}
+
+			for (FRuntimeMeshSectionLOD& LOD : LODs)
+			{
+				LOD.IndexBuffer.BulkSerialize(Ar);
+				Ar << LOD.ScreenSize;
+			}
+		}
+		else
 		{
-			Ar << PositionVertexBuffer;
+			if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::DualVertexBuffer)
+			{
+				Ar << PositionVertexBuffer;
+			}
+
+			Ar << IndexBuffer;
+
+			if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::SectionLODs)
+			{
+				Ar << LODs;
+			}
 		}
 
-		Ar << IndexBuffer;
 		Ar << LocalBoundingBox;
 		Ar << CollisionEnabled;
 		Ar << bIsVisible;
 		int32 UpdateFreq = (int32)UpdateFrequency;
 		Ar << UpdateFreq;
 		UpdateFrequency = (EUpdateFrequency)UpdateFreq;
+
+		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::QuantizedPositions)
+		{
+			Ar << bQuantizePositions;
+		}
+
+		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::InstancedSections)
+		{
+			Ar << bIsInstanced;
+			Instances.BulkSerialize(Ar);
+
+			if (Ar.IsLoading())
+			{
+				bInstanceBoundsDirty = true;
+			}
+		}
+
+		if (Ar.CustomVer(FRuntimeMeshVersion::GUID) >= FRuntimeMeshVersion::GPUDeformableSections)
+		{
+			Ar << bGPUDeformable;
+		}
 	}
 	
 	friend FArchive& operator <<(FArchive& Ar, FRuntimeMeshSectionInterface& Section)
@@ -194,9 +609,69 @@ namespace RuntimeMeshSectionInternal
 
 
 
+	template<typename Type>
+	static typename TEnableIf<FVertexIsGenericVertex<Type>::Value, bool>::Type
+		CalculateNormalTangents(TArray<Type>& VertexBuffer, const TArray<FVector>* PositionVertexBuffer, const TArray<int32>& IndexBuffer,
+			float WeldTolerance, const TBitArray<>* DirtyVertices, FRuntimeMeshTangentsResult& OutResult)
+	{
+		FRuntimeMeshTangents::CalculateVertexTangents(VertexBuffer, PositionVertexBuffer, IndexBuffer, WeldTolerance, DirtyVertices, OutResult);
+		return true;
+	}
+
+	template<typename Type>
+	static typename TEnableIf<!FVertexIsGenericVertex<Type>::Value, bool>::Type
+		CalculateNormalTangents(TArray<Type>& VertexBuffer, const TArray<FVector>* PositionVertexBuffer, const TArray<int32>& IndexBuffer,
+			float WeldTolerance, const TBitArray<>* DirtyVertices, FRuntimeMeshTangentsResult& OutResult)
+	{
+		return false;
+	}
+
+	/* Flags every vertex in the ranges */
+	static void MarkDirtyVertices(const FRuntimeMeshDirtyRanges& Ranges, TBitArray<>& DirtyVertices)
+	{
+		for (const FRuntimeMeshBufferRange& Range : Ranges.GetRanges())
+		{
+			for (int32 VertexIndex = Range.Start; VertexIndex < Range.End(); VertexIndex++)
+			{
+				DirtyVertices[VertexIndex] = true;
+			}
+		}
+	}
+
+
+
+	template<typename Type>
+	static typename TEnableIf<FVertexHasPositionComponent<Type>::Value, FBox>::Type
+		GetVertexRangeBoundingBox(const TArray<Type>& VertexBuffer, int32 FirstVertex, int32 NumVertices)
+	{
+		return FRuntimeMeshBounds::ComputeVertexBounds(VertexBuffer.GetData() + FirstVertex, NumVertices);
+	}
+
+	template<typename Type>
+	static typename TEnableIf<!FVertexHasPositionComponent<Type>::Value, FBox>::Type
+		GetVertexRangeBoundingBox(const TArray<Type>& VertexBuffer, int32 FirstVertex, int32 NumVertices)
+	{
+		return FBox(0);
+	}
+
+	/* Copies the dirty spans out of a buffer, packed back to back */
+	template<typename Type>
+	static void PackDirtyRanges(const FRuntimeMeshDirtyRanges& DirtyRanges, const TArray<Type>& Source, TArray<FRuntimeMeshBufferRange>& OutRanges, TArray<Type>& OutData)
+	{
+		OutRanges = DirtyRanges.GetRanges();
+		OutData.Reset(DirtyRanges.GetTotalCount());
+
+		for (const FRuntimeMeshBufferRange& Range : OutRanges)
+		{
+			OutData.Append(Source.GetData() + Range.Start, Range.Count);
+		}
+	}
+
+
+
 	template<typename Type>
 	static typename TEnableIf<FVertexHasPositionComponent<Type>::Value, bool>::Type
-		UpdateVertexBufferInternal(TArray<Type>& VertexBuffer, FBox& LocalBoundingBox, TArray<Type>& Vertices, const FBox* BoundingBox, bool bShouldMoveArray)
+		UpdateVertexBufferInternal(FRuntimeMeshSharedBuffer<Type>& VertexBuffer, FBox& LocalBoundingBox, TArray<Type>& Vertices, const FBox* BoundingBox, bool bShouldMoveArray)
 	{
 		// Holds the new bounding box after this update.
 		FBox NewBoundingBox(0);
@@ -204,15 +679,12 @@ namespace RuntimeMeshSectionInternal
 		if (bShouldMoveArray)
 		{
 			// Move buffer data
-			VertexBuffer = MoveTemp(Vertices);
+			VertexBuffer.Set(MoveTemp(Vertices));
 
 			// Calculate the bounding box if one doesn't exist.
 			if (BoundingBox == nullptr)
 			{
-				for (int32 VertexIdx = 0; VertexIdx < VertexBuffer.Num(); VertexIdx++)
-				{
-					NewBoundingBox += VertexBuffer[VertexIdx].Position;
-				}
+				NewBoundingBox = FRuntimeMeshBounds::ComputeVertexBounds(VertexBuffer.Get().GetData(), VertexBuffer.Num());
 			}
 			else
 			{
@@ -226,17 +698,14 @@ namespace RuntimeMeshSectionInternal
 			{
 				// Copy the buffer and calculate the bounding box at the same time
 				int32 NumVertices = Vertices.Num();
-				VertexBuffer.SetNumUninitialized(NumVertices);
-				for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
-				{
-					NewBoundingBox += Vertices[VertexIdx].Position;
-					VertexBuffer[VertexIdx] = Vertices[VertexIdx];
-				}
+				TArray<Type>& NewVertices = VertexBuffer.Overwrite();
+				NewVertices.SetNumUninitialized(NumVertices);
+				NewBoundingBox = FRuntimeMeshBounds::CopyVerticesWithBounds(NewVertices.GetData(), Vertices.GetData(), NumVertices);
 			}
 			else
 			{
 				// Copy the buffer
-				VertexBuffer = Vertices;
+				VertexBuffer.Set(Vertices);
 
 				// Copy the supplied bounding box instead of calculating it.
 				NewBoundingBox = *BoundingBox;
@@ -255,15 +724,15 @@ namespace RuntimeMeshSectionInternal
 
 	template<typename Type>
 	static typename TEnableIf<!FVertexHasPositionComponent<Type>::Value, bool>::Type
-		UpdateVertexBufferInternal(TArray<Type>& VertexBuffer, FBox& LocalBoundingBox, TArray<Type>& Vertices, const FBox* BoundingBox, bool bShouldMoveArray)
+		UpdateVertexBufferInternal(FRuntimeMeshSharedBuffer<Type>& VertexBuffer, FBox& LocalBoundingBox, TArray<Type>& Vertices, const FBox* BoundingBox, bool bShouldMoveArray)
 	{
 		if (bShouldMoveArray)
 		{
-			VertexBuffer = MoveTemp(Vertices);
+			VertexBuffer.Set(MoveTemp(Vertices));
 		}
 		else
 		{
-			VertexBuffer = Vertices;
+			VertexBuffer.Set(Vertices);
 		}
 		return false;
 	}
@@ -276,7 +745,7 @@ class FRuntimeMeshSection : public FRuntimeMeshSectionInterface
 
 public:
 	/** Vertex buffer for this section */
-	TArray<VertexType> VertexBuffer;
+	FRuntimeMeshSharedBuffer<VertexType> VertexBuffer;
 
 	FRuntimeMeshSection(bool bInNeedsPositionOnlyBuffer) : FRuntimeMeshSectionInterface(bInNeedsPositionOnlyBuffer) { }
 	virtual ~FRuntimeMeshSection() override { }
@@ -288,6 +757,19 @@ protected:
 		return RuntimeMeshSectionInternal::UpdateVertexBufferInternal<VertexType>(VertexBuffer, LocalBoundingBox, Vertices, BoundingBox, bShouldMoveArray);
 	}
 
+	/* Updates a span of the vertex buffer in place,   returns whether we have a new bounding box */
+	bool UpdateVertexBufferRange(int32 FirstVertex, const TArray<VertexType>& Vertices)
+	{
+		TArray<VertexType>& EditVertices = VertexBuffer.Edit();
+		for (int32 Index = 0; Index < Vertices.Num(); Index++)
+		{
+			EditVertices[FirstVertex + Index] = Vertices[Index];
+		}
+
+		DirtyVertexRanges.Add(FirstVertex, Vertices.Num());
+		return ExpandBoundingBox(RuntimeMeshSectionInternal::GetVertexRangeBoundingBox<VertexType>(EditVertices, FirstVertex, Vertices.Num()));
+	}
+
 	virtual FRuntimeMeshSectionCreateDataInterface* GetSectionCreationData(UMaterialInterface* InMaterial) const override
 	{
 		auto UpdateData = new FRuntimeMeshSectionCreateData<VertexType>();
@@ -295,16 +777,103 @@ protected:
 		// Create new section proxy based on whether we need separate position buffer
 		if (IsDualBufferSection())
 		{
-			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, true>(UpdateFrequency, bIsVisible, bCastsShadow, InMaterial);
-			UpdateData->PositionVertexBuffer = PositionVertexBuffer;
+			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, true>(UpdateFrequency, bIsVisible, bCastsShadow, InMaterial, bQuantizePositions, bIsInstanced, bGPUDeformable);
+			UpdateData->PositionVertexBuffer = PositionVertexBuffer.Share();
 		}
 		else
 		{
-			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, false>(UpdateFrequency, bIsVisible, bCastsShadow, InMaterial);
+			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, false>(UpdateFrequency, bIsVisible, bCastsShadow, InMaterial, false, bIsInstanced);
 		}
 
-		UpdateData->VertexBuffer = VertexBuffer;
-		UpdateData->IndexBuffer = IndexBuffer;
+		// The RT references our buffers directly, so there's no copy here
+		UpdateData->VertexBuffer = VertexBuffer.Share();
+		UpdateData->IndexBuffer = IndexBuffer.Share();
+		ShareLODs(UpdateData->LODIndexBuffers, UpdateData->LODScreenSizes);
+		if (bIsInstanced)
+		{
+			UpdateData->Instances = Instances.Share();
+		}
+		UpdateData->LocalBoundingBox = GetRenderBounds();
+		UpdateData->bEnableRangeUpdates = bRangeUpdatesEnabled;
+		UpdateData->bEnableInstanceRangeUpdates = bInstanceRangeUpdatesEnabled;
+
+		return UpdateData;
+	}
+
+	virtual FRuntimeMeshSectionCreateDataInterface* GetPackedSectionCreationData(const TArray<FRuntimeMeshSectionInterface*>& PackedSections, 
+		UMaterialInterface* InMaterial, TArray<FRuntimeMeshPackedSectionRange>& OutRanges) const override
+	{
+		int32 TotalVertices = 0;
+		int32 TotalIndices = 0;
+		for (const FRuntimeMeshSectionInterface* PackedSection : PackedSections)
+		{
+			const auto* TypedSection = static_cast<const FRuntimeMeshSection<VertexType>*>(PackedSection);
+			check(TypedSection->GetVertexType() == GetVertexType() && TypedSection->IsDualBufferSection() == IsDualBufferSection());
+			TotalVertices += PackedSection->GetNumVertices();
+			TotalIndices += PackedSection->IndexBuffer.Num();
+		}
+
+		FRuntimeMeshSharedBuffer<FVector> PackedPositions;
+		FRuntimeMeshSharedBuffer<VertexType> PackedVertices;
+		FRuntimeMeshSharedBuffer<int32> PackedIndices;
+
+		TArray<FVector>& Positions = PackedPositions.Overwrite();
+		TArray<VertexType>& Vertices = PackedVertices.Overwrite();
+		TArray<int32>& Indices = PackedIndices.Overwrite();
+		Positions.Reserve(IsDualBufferSection() ? TotalVertices : 0);
+		Vertices.Reserve(TotalVertices);
+		Indices.Reserve(TotalIndices);
+
+		FBox PackedBoundingBox(0);
+		OutRanges.Reset(PackedSections.Num());
+
+		for (const FRuntimeMeshSectionInterface* PackedSection : PackedSections)
+		{
+			const auto* TypedSection = static_cast<const FRuntimeMeshSection<VertexType>*>(PackedSection);
+			const TArray<int32>& SectionIndices = TypedSection->IndexBuffer.Get();
+			const int32 BaseVertex = Vertices.Num();
+
+			FRuntimeMeshPackedSectionRange& Range = OutRanges[OutRanges.AddDefaulted()];
+			Range.FirstIndex = Indices.Num();
+			Range.NumIndices = SectionIndices.Num();
+			Range.MinVertexIndex = BaseVertex;
+			Range.MaxVertexIndex = BaseVertex + TypedSection->GetNumVertices() - 1;
+			Range.LocalBounds = TypedSection->LocalBoundingBox;
+
+			Vertices.Append(TypedSection->VertexBuffer.Get());
+			if (IsDualBufferSection())
+			{
+				Positions.Append(TypedSection->PositionVertexBuffer.Get());
+			}
+
+			// Rebase the indices onto where this sections vertices were placed
+			for (int32 Index : SectionIndices)
+			{
+				Indices.Add(Index + BaseVertex);
+			}
+
+			if (TypedSection->LocalBoundingBox.IsValid)
+			{
+				PackedBoundingBox += TypedSection->LocalBoundingBox;
+			}
+		}
+
+		auto UpdateData = new FRuntimeMeshSectionCreateData<VertexType>();
+
+		// Only static sections are packed, and packed sections are always visible
+		if (IsDualBufferSection())
+		{
+			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, true>(EUpdateFrequency::Infrequent, true, bCastsShadow, InMaterial);
+			UpdateData->PositionVertexBuffer = PackedPositions.Share();
+		}
+		else
+		{
+			UpdateData->NewProxy = new FRuntimeMeshSectionProxy<VertexType, false>(EUpdateFrequency::Infrequent, true, bCastsShadow, InMaterial);
+		}
+
+		UpdateData->VertexBuffer = PackedVertices.Share();
+		UpdateData->IndexBuffer = PackedIndices.Share();
+		UpdateData->LocalBoundingBox = PackedBoundingBox;
 
 		return UpdateData;
 	}
@@ -315,22 +884,26 @@ protected:
 		UpdateData->bIncludeVertexBuffer = bIncludeVertices;
 		UpdateData->bIncludePositionBuffer = bIncludePositionVertices;
 		UpdateData->bIncludeIndices = bIncludeIndices;
+		UpdateData->bEnableRangeUpdates = bRangeUpdatesEnabled;
 
 		if (bIncludePositionVertices)
 		{
-			UpdateData->PositionVertexBuffer = PositionVertexBuffer;
+			UpdateData->PositionVertexBuffer = PositionVertexBuffer.Share();
 		}
 
 		if (bIncludeVertices)
 		{
-			UpdateData->VertexBuffer = VertexBuffer;
+			UpdateData->VertexBuffer = VertexBuffer.Share();
 		}
 
 		if (bIncludeIndices)
 		{
-			UpdateData->IndexBuffer = IndexBuffer;
+			UpdateData->IndexBuffer = IndexBuffer.Share();
+			ShareLODs(UpdateData->LODIndexBuffers, UpdateData->LODScreenSizes);
 		}
 
+		UpdateData->LocalBoundingBox = GetRenderBounds();
+
 		return UpdateData;
 	}
 
@@ -338,18 +911,166 @@ protected:
 	{
 		auto UpdateData = new FRuntimeMeshSectionPositionOnlyUpdateData<VertexType>();
 
-		UpdateData->PositionVertexBuffer = PositionVertexBuffer;
+		UpdateData->PositionVertexBuffer = PositionVertexBuffer.Share();
+		UpdateData->LocalBoundingBox = GetRenderBounds();
 
 		return UpdateData;
 	}
 
+	virtual FRuntimeMeshRenderThreadCommandInterface* GetSectionRangeUpdateData() override
+	{
+		auto UpdateData = FRuntimeMeshSectionRangeUpdateData<VertexType>::Create();
+
+		if (IsDualBufferSection())
+		{
+			RuntimeMeshSectionInternal::PackDirtyRanges(DirtyPositionRanges, PositionVertexBuffer.Get(), UpdateData->PositionRanges, UpdateData->PositionData);
+		}
+		RuntimeMeshSectionInternal::PackDirtyRanges(DirtyVertexRanges, VertexBuffer.Get(), UpdateData->VertexRanges, UpdateData->VertexData);
+		RuntimeMeshSectionInternal::PackDirtyRanges(DirtyIndexRanges, IndexBuffer.Get(), UpdateData->IndexRanges, UpdateData->IndexData);
+		UpdateData->LocalBoundingBox = GetRenderBounds();
+
+		ClearDirtyRanges();
+
+		return UpdateData;
+	}
+
+	virtual SIZE_T GetDirtyRangeDataSize(bool bIncludePositions, bool bIncludeVertices, bool bIncludeIndices) const override
+	{
+		SIZE_T Size = 0;
+		Size += bIncludePositions && IsDualBufferSection() ? DirtyPositionRanges.GetTotalCount() * sizeof(FVector) : 0;
+		Size += bIncludeVertices ? DirtyVertexRanges.GetTotalCount() * sizeof(VertexType) : 0;
+		Size += bIncludeIndices ? DirtyIndexRanges.GetTotalCount() * sizeof(int32) : 0;
+		return Size;
+	}
+
+	virtual void ReleaseVertexBuffer() override
+	{
+		VertexBuffer.Release();
+	}
+
+	virtual SIZE_T GetVertexDataSize() const override
+	{
+		return VertexBuffer.GetAllocatedSize();
+	}
+
+	virtual bool MarkVertexRangesDirty(const TArray<FRuntimeMeshBufferRange>& Ranges) override
+	{
+		FBox RangeBoundingBox(0);
+		for (const FRuntimeMeshBufferRange& Range : Ranges)
+		{
+			RangeBoundingBox += RuntimeMeshSectionInternal::GetVertexRangeBoundingBox<VertexType>(VertexBuffer.Get(), Range.Start, Range.Count);
+			DirtyVertexRanges.Add(Range);
+		}
+
+		return ExpandBoundingBox(RangeBoundingBox);
+	}
+
+	virtual bool CalculateNormalTangents(float WeldTolerance, bool bOnlyDirtyRanges) override
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_CalculateNormalTangents);
+
+		if (bHasReleasedCPUData || !FVertexIsGenericVertex<VertexType>::Value)
+		{
+			return false;
+		}
+
+		const int32 NumVertices = VertexBuffer.Num();
+		const TArray<int32>& Indices = IndexBuffer.Get();
+
+		TBitArray<> DirtyVertices;
+		if (bOnlyDirtyRanges)
+		{
+			// Positions, UVs and triangles all feed the basis, so any of them changing seeds the update
+			DirtyVertices.Init(false, NumVertices);
+			RuntimeMeshSectionInternal::MarkDirtyVertices(DirtyPositionRanges, DirtyVertices);
+			RuntimeMeshSectionInternal::MarkDirtyVertices(DirtyVertexRanges, DirtyVertices);
+			for (const FRuntimeMeshBufferRange& Range : DirtyIndexRanges.GetRanges())
+			{
+				for (int32 Index = Range.Start; Index < Range.End(); Index++)
+				{
+					DirtyVertices[Indices[Index]] = true;
+				}
+			}
+
+			if (DirtyVertices.Find(true) == INDEX_NONE)
+			{
+				return true;
+			}
+		}
+
+		FRuntimeMeshTangentsResult Result;
+		RuntimeMeshSectionInternal::CalculateNormalTangents<VertexType>(VertexBuffer.Edit(), bNeedsPositionOnlyBuffer ? &PositionVertexBuffer.Get() : nullptr,
+			Indices, WeldTolerance, bOnlyDirtyRanges ? &DirtyVertices : nullptr, Result);
+
+		if (bOnlyDirtyRanges)
+		{
+			// Result vertices are sorted, so send them up as runs
+			int32 RunStart = 0;
+			for (int32 Index = 1; Index <= Result.Vertices.Num(); Index++)
+			{
+				if (Index == Result.Vertices.Num() || Result.Vertices[Index] != Result.Vertices[Index - 1] + 1)
+				{
+					DirtyVertexRanges.Add(Result.Vertices[RunStart], Index - RunStart);
+					RunStart = Index;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	virtual bool OptimizeMesh(bool bReorderVertices) override
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RuntimeMesh_OptimizeMesh);
+
+		if (bHasReleasedCPUData)
+		{
+			return false;
+		}
+
+		TArray<int32> Remap;
+		FRuntimeMeshOptimizer::OptimizeMesh<VertexType>(VertexBuffer.Edit(), bNeedsPositionOnlyBuffer ? &PositionVertexBuffer.Edit() : nullptr,
+			IndexBuffer.Edit(), bReorderVertices ? &Remap : nullptr);
+
+		// LODs share the vertices, so they have to follow them
+		if (Remap.Num() > 0)
+		{
+			for (FRuntimeMeshSectionLOD& LOD : LODs)
+			{
+				FRuntimeMeshOptimizer::RemapIndices(LOD.IndexBuffer.Edit(), Remap);
+			}
+		}
+
+		return true;
+	}
+
 	virtual int32 GetAllVertexPositions(TArray<FVector>& Positions) override
 	{
-		return RuntimeMeshSectionInternal::GetAllVertexPositions<VertexType>(VertexBuffer, PositionVertexBuffer, Positions);
+		return RuntimeMeshSectionInternal::GetAllVertexPositions<VertexType>(VertexBuffer.Get(), PositionVertexBuffer.Get(), Positions);
 	}
 
+	virtual int32 GetNumVertices() const override { return VertexBuffer.Num(); }
+
 	virtual const FRuntimeMeshVertexTypeInfo* GetVertexType() const { return &VertexType::TypeInfo; }
 
+	virtual void GetCacheView(FRuntimeMeshCacheSectionView& OutView) const override
+	{
+		OutView.VertexType = &VertexType::TypeInfo;
+		OutView.VertexStride = sizeof(VertexType);
+		OutView.Vertices = VertexBuffer.Get().GetData();
+		OutView.NumVertices = VertexBuffer.Num();
+
+		if (IsDualBufferSection())
+		{
+			OutView.Positions = PositionVertexBuffer.Get().GetData();
+			OutView.NumPositions = PositionVertexBuffer.Num();
+		}
+
+		OutView.Indices = IndexBuffer.Get().GetData();
+		OutView.NumIndices = IndexBuffer.Num();
+		OutView.Bounds = LocalBoundingBox;
+	}
+
 	friend class URuntimeMeshComponent;
 };
 
@@ -14,23 +14,122 @@
 /** Interface class for the RT proxy of a single mesh section */
 class FRuntimeMeshSectionProxyInterface : public FRuntimeMeshVisibilityInterface
 {
+protected:
+	/** Local space bounds of this section, used for per section culling */
+	FBox LocalBounds;
+
+	/** Does the GPU read positions that need PositionTransform to get to local space */
+	bool bHasPositionTransform;
+	FMatrix PositionTransform;
+
+	/** Primitive uniform buffer with PositionTransform folded into the local to world transform */
+	TUniformBufferRef<FPrimitiveUniformShaderParameters> UniformBuffer;
+
 public:
 
-	FRuntimeMeshSectionProxyInterface() {}
+	FRuntimeMeshSectionProxyInterface() : LocalBounds(0), bHasPositionTransform(false), PositionTransform(FMatrix::Identity) {}
 	virtual ~FRuntimeMeshSectionProxyInterface() {}
 
 	virtual bool ShouldRender() = 0;
 	virtual bool WantsToRenderInStaticPath() const = 0;
+	virtual bool CastsShadow() const = 0;
 
+	/* Number of times the section is drawn, more than one only for instanced sections */
+	virtual int32 GetNumInstances() const = 0;
 
-	virtual void CreateMeshBatch(FMeshBatch& MeshBatch, FMaterialRenderProxy* WireframeMaterial, bool bIsSelected) = 0;
+	const FBox& GetLocalBounds() const { return LocalBounds; }
+
+	/* Does this section need its own primitive uniform buffer instead of the one shared by the component */
+	bool HasPositionTransform() const { return bHasPositionTransform; }
+	const FMatrix& GetPositionTransform() const { return PositionTransform; }
+	const TUniformBufferRef<FPrimitiveUniformShaderParameters>& GetUniformBuffer() const { return UniformBuffer; }
+
+	/* Rebuilds the section's own uniform buffer. Needs to be called when the component transform or the position transform changes */
+	void UpdateUniformBuffer(const FMatrix& LocalToWorld, const FBoxSphereBounds& PrimitiveWorldBounds, const FBoxSphereBounds& PrimitiveLocalBounds, bool bUseEditorDepthTest)
+	{
+		check(IsInRenderingThread());
+
+		if (bHasPositionTransform)
+		{
+			UniformBuffer = CreatePrimitiveUniformBufferImmediate(PositionTransform * LocalToWorld, PrimitiveWorldBounds, PrimitiveLocalBounds, true, bUseEditorDepthTest);
+		}
+		else
+		{
+			UniformBuffer.SafeRelease();
+		}
+	}
+
+	/* Number of LODs including LOD 0 */
+	virtual int32 GetNumLODs() const = 0;
+
+	/* Screen size below which a LOD is used. LOD 0 is always usable */
+	virtual float GetLODScreenSize(int32 LODIndex) const = 0;
+
+	/* Picks the lowest detail LOD whose screen size threshold the section is still below */
+	int32 GetLODForScreenSize(float ScreenSize) const
+	{
+		for (int32 LODIndex = GetNumLODs() - 1; LODIndex > 0; LODIndex--)
+		{
+			if (ScreenSize < GetLODScreenSize(LODIndex))
+			{
+				return LODIndex;
+			}
+		}
+		return 0;
+	}
+
+
+	virtual void CreateMeshBatch(FMeshBatch& MeshBatch, FMaterialRenderProxy* WireframeMaterial, bool bIsSelected, int32 LODIndex = 0) = 0;
+
+	/* Adds the GPU memory held by the section's buffers */
+	virtual void GetGPUMemoryUsage(SIZE_T& OutVertexBytes, SIZE_T& OutIndexBytes) const = 0;
+
+	/* Size of the proxy and anything it allocated on the CPU */
+	virtual SIZE_T GetAllocatedSize() const = 0;
 
 
 	virtual void FinishCreate_RenderThread(FRuntimeMeshSectionCreateDataInterface* UpdateData) = 0;
 	virtual void FinishUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
 	virtual void FinishPositionUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
+	virtual void FinishRangeUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
 	virtual void FinishPropertyUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
+	virtual void FinishInstanceUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) = 0;
+
+	/* Runs a GPU deformer over the section's buffers. Does nothing unless the section was created GPU deformable */
+	virtual void DeformGPU_RenderThread(FRHICommandListImmediate& RHICmdList, const FRuntimeMeshGPUDeformer& Deformer, const FBox& ConservativeBounds) = 0;
 
+	/* Replaces the material, for sections carried over to a new scene proxy */
+	virtual void SetMaterial_RenderThread(UMaterialInterface* InMaterial) = 0;
+
+};
+
+/** Where a single section lives within the shared buffers of a packed section group */
+struct FRuntimeMeshPackedSectionRange
+{
+	/* Index of the component section this range came from */
+	int32 SectionIndex;
+
+	int32 FirstIndex;
+	int32 NumIndices;
+	int32 MinVertexIndex;
+	int32 MaxVertexIndex;
+
+	/** Local space bounds of this section, used for per section culling */
+	FBox LocalBounds;
+
+	FRuntimeMeshPackedSectionRange() : SectionIndex(INDEX_NONE), FirstIndex(0), NumIndices(0), MinVertexIndex(0), MaxVertexIndex(0), LocalBounds(0) { }
+};
+
+/** RT proxy for several sections sharing one vertex/index buffer so they can be drawn together */
+struct FRuntimeMeshPackedSectionGroup
+{
+	/* Proxy holding the shared buffers. Its own bounds cover the whole group */
+	FRuntimeMeshSectionProxyInterface* Proxy;
+
+	/* Ranges of each packed section, back to back in the index buffer */
+	TArray<FRuntimeMeshPackedSectionRange> Ranges;
+
+	FRuntimeMeshPackedSectionGroup() : Proxy(nullptr) { }
 };
 
 /** Templated class for the RT proxy of a single mesh section */
@@ -50,43 +149,114 @@ protected:
 	/** Material applied to this section */
 	UMaterialInterface* Material;
 
+	/** Are positions sent to the GPU quantized to the section bounds. Only used with a position only buffer */
+	const bool bQuantizePositions;
+
 	FRuntimeMeshVertexBuffer<FVector>* PositionVertexBuffer;
 
+	/** Position only buffer for quantized sections, used instead of PositionVertexBuffer */
+	FRuntimeMeshVertexBuffer<FRuntimeMeshQuantizedPosition>* QuantizedPositionVertexBuffer;
+
+	/** Bounds the quantized positions are relative to */
+	FRuntimeMeshPositionQuantization Quantization;
+
 	/** Vertex buffer for this section */
 	FRuntimeMeshVertexBuffer<VertexType> VertexBuffer;
 
 	/** Index buffer for this section */
 	FRuntimeMeshIndexBuffer IndexBuffer;
 
+	/** Index buffers for LOD 1 and up */
+	TArray<FRuntimeMeshIndexBuffer*> LODIndexBuffers;
+
+	/** Screen size below which each of LODIndexBuffers is used */
+	TArray<float> LODScreenSizes;
+
 	/** Vertex factory for this section */
 	FRuntimeMeshVertexFactory VertexFactory;
 
+	/** Is this section drawn once per instance. Instancing and quantized positions can't be combined */
+	const bool bIsInstanced;
+
+	/** Number of instances in InstanceBuffer */
+	int32 NumInstances;
+
+	/** Have the buffers been moved to storage that can be written in place, for range updates */
+	bool bRangeUpdatesEnabled;
+
+	/** Per instance transforms and custom data. Only created for instanced sections */
+	FRuntimeMeshVertexBuffer<FRuntimeMeshInstanceData>* InstanceBuffer;
+
+	/** Vertex factory reading the vertex and instance buffers, used instead of VertexFactory for instanced sections */
+	FRuntimeMeshInstancedVertexFactory* InstancedVertexFactory;
+
+	/** Are the position and vertex buffers created with UAVs for GPU deformers. Only used with a full precision position only buffer */
+	const bool bGPUDeformable;
+
 public:
-	FRuntimeMeshSectionProxy(EUpdateFrequency InUpdateFrequency, bool bInIsVisible, bool bInCastsShadow, UMaterialInterface* InMaterial) :
+	FRuntimeMeshSectionProxy(EUpdateFrequency InUpdateFrequency, bool bInIsVisible, bool bInCastsShadow, UMaterialInterface* InMaterial, bool bInQuantizePositions = false, bool bInIsInstanced = false,
+		bool bInGPUDeformable = false) :
 		bIsVisible(bInIsVisible), bCastsShadow(bInCastsShadow), UpdateFrequency(InUpdateFrequency), Material(InMaterial), 
-		PositionVertexBuffer(nullptr), VertexBuffer(InUpdateFrequency), IndexBuffer(InUpdateFrequency), VertexFactory(this) { }
+		bQuantizePositions(NeedsPositionOnlyBuffer && bInQuantizePositions && !bInIsInstanced), PositionVertexBuffer(nullptr), QuantizedPositionVertexBuffer(nullptr), 
+		VertexBuffer(InUpdateFrequency), IndexBuffer(InUpdateFrequency), VertexFactory(this), 
+		bIsInstanced(bInIsInstanced), NumInstances(0), bRangeUpdatesEnabled(false), InstanceBuffer(nullptr), InstancedVertexFactory(nullptr),
+		bGPUDeformable(NeedsPositionOnlyBuffer && bInGPUDeformable && !bQuantizePositions) { }
 	virtual ~FRuntimeMeshSectionProxy() override
 	{
 		VertexBuffer.ReleaseResource();
 		IndexBuffer.ReleaseResource();
 		VertexFactory.ReleaseResource();
 
+		if (InstancedVertexFactory)
+		{
+			InstancedVertexFactory->ReleaseResource();
+			delete InstancedVertexFactory;
+		}
+
+		if (InstanceBuffer)
+		{
+			InstanceBuffer->ReleaseResource();
+			delete InstanceBuffer;
+		}
+
+		for (FRuntimeMeshIndexBuffer* LODIndexBuffer : LODIndexBuffers)
+		{
+			LODIndexBuffer->ReleaseResource();
+			delete LODIndexBuffer;
+		}
+
 		if (PositionVertexBuffer)
 		{
 			PositionVertexBuffer->ReleaseResource();
 			delete PositionVertexBuffer;
 		}
+
+		if (QuantizedPositionVertexBuffer)
+		{
+			QuantizedPositionVertexBuffer->ReleaseResource();
+			delete QuantizedPositionVertexBuffer;
+		}
 	}
 
 
-	virtual bool ShouldRender() override { return bIsVisible && VertexBuffer.Num() > 0 && IndexBuffer.Num() > 0; }
+	virtual bool ShouldRender() override { return bIsVisible && VertexBuffer.Num() > 0 && IndexBuffer.Num() > 0 && (!bIsInstanced || NumInstances > 0); }
 
 	virtual bool WantsToRenderInStaticPath() const override { return UpdateFrequency == EUpdateFrequency::Infrequent; }
 
+	virtual bool CastsShadow() const override { return bCastsShadow; }
+
+	virtual int32 GetNumInstances() const override { return bIsInstanced ? NumInstances : 1; }
+
+	virtual int32 GetNumLODs() const override { return LODIndexBuffers.Num() + 1; }
+
+	virtual float GetLODScreenSize(int32 LODIndex) const override { return LODIndex == 0 ? FLT_MAX : LODScreenSizes[LODIndex - 1]; }
 
-	virtual void CreateMeshBatch(FMeshBatch& MeshBatch, FMaterialRenderProxy* WireframeMaterial, bool bIsSelected) override
+
+	virtual void CreateMeshBatch(FMeshBatch& MeshBatch, FMaterialRenderProxy* WireframeMaterial, bool bIsSelected, int32 LODIndex = 0) override
 	{
-		MeshBatch.VertexFactory = &VertexFactory;
+		FRuntimeMeshIndexBuffer* LODIndexBuffer = LODIndex == 0 ? &IndexBuffer : LODIndexBuffers[LODIndex - 1];
+
+		MeshBatch.VertexFactory = bIsInstanced ? static_cast<FVertexFactory*>(InstancedVertexFactory) : &VertexFactory;
 		MeshBatch.bWireframe = WireframeMaterial != nullptr;
 		MeshBatch.MaterialRenderProxy = MeshBatch.bWireframe ? WireframeMaterial : Material->GetRenderProxy(bIsSelected);
 		MeshBatch.Type = PT_TriangleList;
@@ -94,11 +264,53 @@ public:
 		MeshBatch.CastShadow = bCastsShadow;
 
 		FMeshBatchElement& BatchElement = MeshBatch.Elements[0];
-		BatchElement.IndexBuffer = &IndexBuffer;
+		BatchElement.IndexBuffer = LODIndexBuffer;
 		BatchElement.FirstIndex = 0;
-		BatchElement.NumPrimitives = IndexBuffer.Num() / 3;
+		BatchElement.NumPrimitives = LODIndexBuffer->Num() / 3;
 		BatchElement.MinVertexIndex = 0;
 		BatchElement.MaxVertexIndex = VertexBuffer.Num() - 1;
+		BatchElement.NumInstances = GetNumInstances();
+	}
+
+	virtual void GetGPUMemoryUsage(SIZE_T& OutVertexBytes, SIZE_T& OutIndexBytes) const override
+	{
+		OutVertexBytes += VertexBuffer.GetAllocatedSize();
+		if (PositionVertexBuffer)
+		{
+			OutVertexBytes += PositionVertexBuffer->GetAllocatedSize();
+		}
+		if (QuantizedPositionVertexBuffer)
+		{
+			OutVertexBytes += QuantizedPositionVertexBuffer->GetAllocatedSize();
+		}
+		if (InstanceBuffer)
+		{
+			OutVertexBytes += InstanceBuffer->GetAllocatedSize();
+		}
+
+		OutIndexBytes += IndexBuffer.GetAllocatedSize();
+		for (const FRuntimeMeshIndexBuffer* LODIndexBuffer : LODIndexBuffers)
+		{
+			OutIndexBytes += LODIndexBuffer->GetAllocatedSize();
+		}
+	}
+
+	virtual SIZE_T GetAllocatedSize() const override
+	{
+		SIZE_T Size = sizeof(*this) + LODIndexBuffers.GetAllocatedSize() + LODScreenSizes.GetAllocatedSize() + LODIndexBuffers.Num() * sizeof(FRuntimeMeshIndexBuffer);
+		if (PositionVertexBuffer)
+		{
+			Size += sizeof(*PositionVertexBuffer);
+		}
+		if (QuantizedPositionVertexBuffer)
+		{
+			Size += sizeof(*QuantizedPositionVertexBuffer);
+		}
+		if (InstanceBuffer)
+		{
+			Size += sizeof(*InstanceBuffer) + sizeof(*InstancedVertexFactory);
+		}
+		return Size;
 	}
 
 
@@ -108,41 +320,75 @@ public:
 
 		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionCreateData<VertexType>>();
 		check(SectionUpdateData);
+
+		LocalBounds = SectionUpdateData->LocalBoundingBox;
 		
 		if (NeedsPositionOnlyBuffer)
 		{
-			// Initialize the position buffer
-			PositionVertexBuffer = new FRuntimeMeshVertexBuffer<FVector>(UpdateFrequency);
-
 			// Get and adjust the vertex structure
 			auto VertexStructure = VertexType::GetVertexStructure(VertexBuffer);
-			VertexStructure.PositionComponent = FVertexStreamComponent(PositionVertexBuffer, 0, sizeof(FVector), VET_Float3);
-			VertexFactory.Init(VertexStructure);
+
+			// Initialize the position buffer
+			if (bQuantizePositions)
+			{
+				QuantizedPositionVertexBuffer = new FRuntimeMeshVertexBuffer<FRuntimeMeshQuantizedPosition>(UpdateFrequency);
+				VertexStructure.PositionComponent = FVertexStreamComponent(QuantizedPositionVertexBuffer, 0, sizeof(FRuntimeMeshQuantizedPosition), VET_Short4N);
+			}
+			else
+			{
+				PositionVertexBuffer = new FRuntimeMeshVertexBuffer<FVector>(UpdateFrequency);
+				VertexStructure.PositionComponent = FVertexStreamComponent(PositionVertexBuffer, 0, sizeof(FVector), VET_Float3);
+
+				if (bGPUDeformable)
+				{
+					PositionVertexBuffer->EnableUnorderedAccess(PF_R32_FLOAT);
+
+					// Vertices are only written as whole uints
+					if (sizeof(VertexType) % sizeof(uint32) == 0)
+					{
+						VertexBuffer.EnableUnorderedAccess(PF_R32_UINT);
+					}
+				}
+			}
+
+			InitVertexFactory(VertexStructure);
 		}
 		else
 		{
 			// Get and submit the vertex structure
 			auto VertexStructure = VertexType::GetVertexStructure(VertexBuffer);
-			VertexFactory.Init(VertexStructure);
+			InitVertexFactory(VertexStructure);
+		}
+
+		if (SectionUpdateData->bEnableRangeUpdates)
+		{
+			EnableRangeUpdates();
+		}
+
+		if (bIsInstanced && SectionUpdateData->bEnableInstanceRangeUpdates)
+		{
+			InstanceBuffer->EnableRangeUpdates();
+		}
+
+		if (bIsInstanced && SectionUpdateData->Instances.IsValid())
+		{
+			SetInstances(*SectionUpdateData->Instances);
 		}
-		
-		// Initialize the vertex factory
-		VertexFactory.InitResource();
 
-		auto& Vertices = SectionUpdateData->VertexBuffer;
+		auto& Vertices = *SectionUpdateData->VertexBuffer;
 		VertexBuffer.SetNum(Vertices.Num());
 		VertexBuffer.SetData(Vertices);
 
 		if (NeedsPositionOnlyBuffer)
 		{
-			auto& PositionVertices = SectionUpdateData->PositionVertexBuffer;
-			PositionVertexBuffer->SetNum(PositionVertices.Num());
-			PositionVertexBuffer->SetData(PositionVertices);
+			SetPositions(*SectionUpdateData->PositionVertexBuffer);
 		}
 
-		auto& Indices = SectionUpdateData->IndexBuffer;
-		IndexBuffer.SetNum(Indices.Num());
+		auto& Indices = *SectionUpdateData->IndexBuffer;
+		IndexBuffer.SetNum(Indices.Num(), FRuntimeMeshIndexBuffer::CanUse16BitIndices(VertexBuffer.Num()));
 		IndexBuffer.SetData(Indices);
+
+		SetLODs(SectionUpdateData->LODIndexBuffers, SectionUpdateData->LODScreenSizes);
 	}
 	
 	virtual void FinishUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) override
@@ -152,25 +398,35 @@ public:
 		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionUpdateData<VertexType>>();
 		check(SectionUpdateData);
 
+		LocalBounds = SectionUpdateData->LocalBoundingBox;
+
+		// Recreating the buffers drops their contents, the game thread sends every buffer along with this
+		if (SectionUpdateData->bEnableRangeUpdates && !bRangeUpdatesEnabled)
+		{
+			check(SectionUpdateData->bIncludeVertexBuffer && SectionUpdateData->bIncludeIndices && (!NeedsPositionOnlyBuffer || SectionUpdateData->bIncludePositionBuffer));
+			EnableRangeUpdates();
+		}
+
 		if (SectionUpdateData->bIncludeVertexBuffer)
 		{
-			auto& VertexBufferData = SectionUpdateData->VertexBuffer;
+			auto& VertexBufferData = *SectionUpdateData->VertexBuffer;
 			VertexBuffer.SetNum(VertexBufferData.Num());
 			VertexBuffer.SetData(VertexBufferData);
 		}
 
 		if (NeedsPositionOnlyBuffer && SectionUpdateData->bIncludePositionBuffer)
 		{
-			auto& PositionVertices = SectionUpdateData->PositionVertexBuffer;
-			PositionVertexBuffer->SetNum(PositionVertices.Num());
-			PositionVertexBuffer->SetData(PositionVertices);
+			SetPositions(*SectionUpdateData->PositionVertexBuffer);
 		}
 
 		if (SectionUpdateData->bIncludeIndices)
 		{
-			auto& IndexBufferData = SectionUpdateData->IndexBuffer;
-			IndexBuffer.SetNum(IndexBufferData.Num());
+			// Vertices are applied first, so this picks the index format from the updated vertex count
+			auto& IndexBufferData = *SectionUpdateData->IndexBuffer;
+			IndexBuffer.SetNum(IndexBufferData.Num(), FRuntimeMeshIndexBuffer::CanUse16BitIndices(VertexBuffer.Num()));
 			IndexBuffer.SetData(IndexBufferData);
+
+			SetLODs(SectionUpdateData->LODIndexBuffers, SectionUpdateData->LODScreenSizes);
 		}
 	}
 
@@ -181,9 +437,190 @@ public:
 		// Get the Position Only update data
 		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionPositionOnlyUpdateData<VertexType>>();
 		check(SectionUpdateData);
+
+		LocalBounds = SectionUpdateData->LocalBoundingBox;
 		
 		// Copy the new data to the gpu
-		PositionVertexBuffer->SetData(SectionUpdateData->PositionVertexBuffer);
+		SetPositions(*SectionUpdateData->PositionVertexBuffer);
+	}
+
+	virtual void FinishRangeUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) override
+	{
+		check(IsInRenderingThread());
+
+		// Get the range update data
+		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionRangeUpdateData<VertexType>>();
+		check(SectionUpdateData);
+
+		LocalBounds = SectionUpdateData->LocalBoundingBox;
+
+		// Only the changed spans are copied, the buffers already have the right size and format
+		if (SectionUpdateData->VertexRanges.Num() > 0)
+		{
+			VertexBuffer.SetDataRanges(SectionUpdateData->VertexRanges, SectionUpdateData->VertexData);
+		}
+
+		if (NeedsPositionOnlyBuffer && SectionUpdateData->PositionRanges.Num() > 0)
+		{
+			if (bQuantizePositions)
+			{
+				// Range updates that grow the bounds are sent in full, so these always fit the current quantization
+				const FRuntimeMeshPositionQuantization& CurrentQuantization = Quantization;
+				QuantizedPositionVertexBuffer->SetDataRangesConverted(SectionUpdateData->PositionRanges, SectionUpdateData->PositionData,
+					[&CurrentQuantization](const FVector& Position) { return CurrentQuantization.Quantize(Position); });
+			}
+			else
+			{
+				PositionVertexBuffer->SetDataRanges(SectionUpdateData->PositionRanges, SectionUpdateData->PositionData);
+			}
+		}
+
+		if (SectionUpdateData->IndexRanges.Num() > 0)
+		{
+			IndexBuffer.SetDataRanges(SectionUpdateData->IndexRanges, SectionUpdateData->IndexData);
+		}
+	}
+
+	virtual void DeformGPU_RenderThread(FRHICommandListImmediate& RHICmdList, const FRuntimeMeshGPUDeformer& Deformer, const FBox& ConservativeBounds) override
+	{
+		check(IsInRenderingThread());
+
+		if (!bGPUDeformable || PositionVertexBuffer == nullptr || PositionVertexBuffer->GetUAV() == nullptr)
+		{
+			return;
+		}
+
+		LocalBounds = ConservativeBounds;
+
+		FRuntimeMeshGPUDeformTarget Target;
+		Target.PositionUAV = PositionVertexBuffer->GetUAV();
+		Target.VertexUAV = VertexBuffer.GetUAV();
+		Target.NumVertices = PositionVertexBuffer->Num();
+
+		if (Target.VertexUAV)
+		{
+			const auto VertexStructure = VertexType::GetVertexStructure(VertexBuffer);
+			const FVertexStreamComponent& Tangent = VertexStructure.TangentBasisComponents[0];
+			const FVertexStreamComponent& Normal = VertexStructure.TangentBasisComponents[1];
+
+			Target.VertexStride = sizeof(VertexType) / sizeof(uint32);
+			Target.TangentOffset = Tangent.VertexBuffer ? Tangent.Offset / sizeof(uint32) : INDEX_NONE;
+			Target.NormalOffset = Normal.VertexBuffer ? Normal.Offset / sizeof(uint32) : INDEX_NONE;
+			Target.TangentBasisType = Normal.VertexBuffer ? Normal.Type : VET_None;
+		}
+
+		TArray<FUnorderedAccessViewRHIParamRef, TInlineAllocator<2>> UAVs;
+		UAVs.Add(Target.PositionUAV);
+		if (Target.VertexUAV)
+		{
+			UAVs.Add(Target.VertexUAV);
+		}
+
+		RHICmdList.TransitionResources(EResourceTransitionAccess::EWritable, EResourceTransitionPipeline::EGfxToCompute, UAVs.GetData(), UAVs.Num());
+		Deformer(RHICmdList, Target);
+		RHICmdList.TransitionResources(EResourceTransitionAccess::EReadable, EResourceTransitionPipeline::EComputeToGfx, UAVs.GetData(), UAVs.Num());
+	}
+
+	/* Initializes the vertex factory the section draws with. Instanced sections also get their instance buffer here */
+	void InitVertexFactory(const RuntimeMeshVertexStructure& VertexStructure)
+	{
+		if (bIsInstanced)
+		{
+			InstanceBuffer = new FRuntimeMeshVertexBuffer<FRuntimeMeshInstanceData>(UpdateFrequency);
+			InstancedVertexFactory = new FRuntimeMeshInstancedVertexFactory(this);
+			InstancedVertexFactory->Init(FRuntimeMeshInstancedVertexFactory::MakeInstancedStructure(VertexStructure, InstanceBuffer));
+			InstancedVertexFactory->InitResource();
+		}
+		else
+		{
+			VertexFactory.Init(VertexStructure);
+			VertexFactory.InitResource();
+		}
+	}
+
+	/* Moves the vertex, position and index buffers to single copies that can be written in place. LODs are only ever replaced whole */
+	void EnableRangeUpdates()
+	{
+		bRangeUpdatesEnabled = true;
+
+		VertexBuffer.EnableRangeUpdates();
+		IndexBuffer.EnableRangeUpdates();
+
+		if (PositionVertexBuffer)
+		{
+			PositionVertexBuffer->EnableRangeUpdates();
+		}
+
+		if (QuantizedPositionVertexBuffer)
+		{
+			QuantizedPositionVertexBuffer->EnableRangeUpdates();
+		}
+	}
+
+	/* Replaces the whole instance buffer */
+	void SetInstances(const TArray<FRuntimeMeshInstanceData>& Instances)
+	{
+		check(bIsInstanced);
+
+		// An empty section keeps its buffer and just stops drawing
+		NumInstances = Instances.Num();
+		if (NumInstances > 0)
+		{
+			InstanceBuffer->SetNum(NumInstances);
+			InstanceBuffer->SetData(Instances);
+		}
+	}
+
+	/* Replaces the whole position buffer. Quantized sections are requantized to the current bounds */
+	void SetPositions(const TArray<FVector>& Positions)
+	{
+		check(NeedsPositionOnlyBuffer);
+
+		if (bQuantizePositions)
+		{
+			Quantization = FRuntimeMeshPositionQuantization(LocalBounds);
+			PositionTransform = Quantization.GetDequantizeTransform();
+			bHasPositionTransform = true;
+
+			const FRuntimeMeshPositionQuantization& CurrentQuantization = Quantization;
+			QuantizedPositionVertexBuffer->SetNum(Positions.Num());
+			QuantizedPositionVertexBuffer->SetDataConverted(Positions, [&CurrentQuantization](const FVector& Position) { return CurrentQuantization.Quantize(Position); });
+		}
+		else
+		{
+			PositionVertexBuffer->SetNum(Positions.Num());
+			PositionVertexBuffer->SetData(Positions);
+		}
+	}
+
+	/* Replaces the LOD index buffers, reusing the existing buffers where possible */
+	void SetLODs(const TArray<FRuntimeMeshSharedBuffer<int32>::SharedArrayRef>& LODIndexData, const TArray<float>& ScreenSizes)
+	{
+		check(IsInRenderingThread());
+		check(LODIndexData.Num() == ScreenSizes.Num());
+
+		// Free the LODs we no longer have
+		while (LODIndexBuffers.Num() > LODIndexData.Num())
+		{
+			FRuntimeMeshIndexBuffer* LODIndexBuffer = LODIndexBuffers.Pop(false);
+			LODIndexBuffer->ReleaseResource();
+			delete LODIndexBuffer;
+		}
+
+		while (LODIndexBuffers.Num() < LODIndexData.Num())
+		{
+			LODIndexBuffers.Add(new FRuntimeMeshIndexBuffer(UpdateFrequency));
+		}
+
+		const bool bUse16BitIndices = FRuntimeMeshIndexBuffer::CanUse16BitIndices(VertexBuffer.Num());
+		for (int32 LODIndex = 0; LODIndex < LODIndexData.Num(); LODIndex++)
+		{
+			const TArray<int32>& Indices = *LODIndexData[LODIndex];
+			LODIndexBuffers[LODIndex]->SetNum(Indices.Num(), bUse16BitIndices);
+			LODIndexBuffers[LODIndex]->SetData(Indices);
+		}
+
+		LODScreenSizes = ScreenSizes;
 	}
 
 	virtual void FinishPropertyUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) override
@@ -196,4 +633,36 @@ public:
 		bCastsShadow = SectionUpdateData->bCastsShadow;
 	}
 
+	virtual void SetMaterial_RenderThread(UMaterialInterface* InMaterial) override
+	{
+		check(IsInRenderingThread());
+		Material = InMaterial;
+	}
+
+	virtual void FinishInstanceUpdate_RenderThread(FRuntimeMeshRenderThreadCommandInterface* UpdateData) override
+	{
+		check(IsInRenderingThread());
+		check(bIsInstanced);
+
+		auto* SectionUpdateData = UpdateData->As<FRuntimeMeshSectionInstanceUpdateData>();
+		check(SectionUpdateData);
+
+		LocalBounds = SectionUpdateData->LocalBoundingBox;
+
+		if (SectionUpdateData->Instances.IsValid())
+		{
+			if (SectionUpdateData->bEnableRangeUpdates)
+			{
+				InstanceBuffer->EnableRangeUpdates();
+			}
+
+			SetInstances(*SectionUpdateData->Instances);
+		}
+		else if (SectionUpdateData->InstanceRanges.Num() > 0)
+		{
+			// Partial updates are only sent when the instance count is unchanged
+			InstanceBuffer->SetDataRanges(SectionUpdateData->InstanceRanges, SectionUpdateData->InstanceData);
+		}
+	}
+
 };
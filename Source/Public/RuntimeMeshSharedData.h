@@ -0,0 +1,142 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "RuntimeMeshSectionProxy.h"
+
+class URuntimeMeshComponent;
+class UBodySetup;
+
+
+/*
+*	Render thread side of a components sections. Owned by its scene proxy, and held on to by the scene proxies
+*	of every component sharing the mesh so the section buffers live as long as something draws them.
+*	Only the owning scene proxy changes it, always on the render thread.
+*/
+struct FRuntimeMeshSharedRenderData
+{
+	/** Section proxies by section index. Only sections that exist have an entry, so sparse section indices cost nothing */
+	TMap<int32, FRuntimeMeshSectionProxyInterface*> Sections;
+
+	/** Number of sections in Sections that are drawn in the static and in the dynamic path */
+	int32 NumStaticSections;
+	int32 NumDynamicSections;
+
+	/** Groups of sections drawn from shared buffers. They have no entry in Sections */
+	TArray<FRuntimeMeshPackedSectionGroup> PackedGroups;
+
+	FRuntimeMeshSharedRenderData() : NumStaticSections(0), NumDynamicSections(0) { }
+
+	~FRuntimeMeshSharedRenderData()
+	{
+		check(IsInRenderingThread());
+
+		for (const auto& SectionEntry : Sections)
+		{
+			delete SectionEntry.Value;
+		}
+
+		for (FRuntimeMeshPackedSectionGroup& PackedGroup : PackedGroups)
+		{
+			delete PackedGroup.Proxy;
+		}
+	}
+
+	bool HasSections() const { return Sections.Num() > 0 || PackedGroups.Num() > 0; }
+
+	/* Creates render data that's always destroyed on the render thread, wherever the last reference is let go */
+	static TSharedRef<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe> Create()
+	{
+		return TSharedRef<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe>(new FRuntimeMeshSharedRenderData(), &DeleteRenderData);
+	}
+
+private:
+	static void DeleteRenderData(FRuntimeMeshSharedRenderData* RenderData)
+	{
+		if (IsInRenderingThread())
+		{
+			delete RenderData;
+		}
+		else
+		{
+			ENQUEUE_UNIQUE_RENDER_COMMAND_ONEPARAMETER(
+				FRuntimeMeshDeleteSharedRenderData,
+				FRuntimeMeshSharedRenderData*, RenderData, RenderData,
+				{
+					delete RenderData;
+				}
+			);
+		}
+	}
+};
+
+
+/*
+*	Mesh of one component shared with any number of others, so identical meshes are built, uploaded and cooked once.
+*
+*	The component that created it through URuntimeMeshComponent::ShareMeshData() is its source. All edits are made
+*	through the source's sections as usual, and every component given the data with SetSharedMeshData() draws the
+*	same section buffers and uses the same collision, picking up each change as the source makes it.
+*	Those components keep no copy of the shared mesh, but can still have sections of their own drawn along with it.
+*
+*	The data is reference counted. The section buffers, collision and materials stay alive while any component
+*	or other reference holds on to it, even after the source is destroyed, but can't be changed anymore then.
+*	The source has to be registered and drawn for its sections to be published, so share from one of the visible
+*	components instead of a hidden template. Game thread only.
+*/
+class RUNTIMEMESHCOMPONENT_API FRuntimeMeshSharedData : public FGCObject
+{
+public:
+	FRuntimeMeshSharedData(URuntimeMeshComponent* InSource);
+
+	/* Component the mesh is edited through, null once it's been destroyed */
+	URuntimeMeshComponent* GetSource() const { return Source.Get(); }
+
+	/* Latest section buffers published by the source's scene proxy, or null if it hasn't been drawn yet */
+	const TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe>& GetRenderData() const { return RenderData; }
+
+	/* Materials used by the shared sections */
+	const TArray<UMaterialInterface*>& GetMaterials() const { return Materials; }
+
+	/* Collision cooked by the source, or null if it has none */
+	UBodySetup* GetBodySetup() const { return BodySetup; }
+
+	/* Local bounds of the shared sections. Invalid until the source has bounds */
+	const FBox& GetLocalBounds() const { return LocalBounds; }
+
+	/* Components drawing this mesh, other than the source */
+	int32 GetNumUsers() const;
+
+	/* Called by the source when its scene proxy was recreated, every user recreates theirs to draw the new buffers */
+	void PublishRenderData(const TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe>& InRenderData, const TArray<UMaterialInterface*>& InMaterials);
+
+	/* Called by the source when its bounds changed */
+	void PublishBounds(const FBox& InLocalBounds);
+
+	/* Called by the source when new collision has been cooked, every user recreates its physics state with it */
+	void PublishBodySetup(UBodySetup* InBodySetup);
+
+	/* Registers and unregisters a component drawing this mesh */
+	void AddUser(URuntimeMeshComponent* User);
+	void RemoveUser(URuntimeMeshComponent* User);
+
+	//~ Begin FGCObject Interface.
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	//~ End FGCObject Interface.
+
+private:
+	TWeakObjectPtr<URuntimeMeshComponent> Source;
+
+	/* Components drawing this mesh. Weak so a component destroyed without unregistering doesn't linger */
+	TArray<TWeakObjectPtr<URuntimeMeshComponent>> Users;
+
+	TSharedPtr<FRuntimeMeshSharedRenderData, ESPMode::ThreadSafe> RenderData;
+
+	/* Kept alive here since the section proxies reference them and the source might go away first */
+	TArray<UMaterialInterface*> Materials;
+
+	UBodySetup* BodySetup;
+
+	FBox LocalBounds;
+};
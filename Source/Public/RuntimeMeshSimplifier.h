@@ -0,0 +1,76 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "RuntimeMeshCore.h"
+
+
+/* Settings for one simplified LOD */
+struct FRuntimeMeshSimplifySettings
+{
+	/* Fraction of the full detail triangles to aim for */
+	float TriangleRatio;
+
+	/* Largest error allowed, as a fraction of the largest side of the mesh bounds. Simplification stops early rather than go past it */
+	float MaxError;
+
+	/* The LOD is drawn once the section's screen size drops below this */
+	float ScreenSize;
+
+	FRuntimeMeshSimplifySettings(float InTriangleRatio = 0.5f, float InMaxError = 0.01f, float InScreenSize = 0.5f)
+		: TriangleRatio(InTriangleRatio), MaxError(InMaxError), ScreenSize(InScreenSize)
+	{ }
+};
+
+
+/*
+*	Quadric error mesh decimation.
+*
+*	Collapses edges onto one of their existing vertices, so the simplified triangles index the original vertices and can be
+*	used directly as a section LOD. Vertices on open borders or UV/normal seams (anywhere vertices share a position)
+*	are never moved, so chunk edges still meet their neighbours and seams stay closed at every LOD.
+*
+*	Everything here is stateless and only touches the arrays it's passed, so it can run on any thread.
+*/
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshSimplifier
+{
+	/*
+	*	Simplifies Indices down towards TargetIndexCount indices, stopping early once the next collapse would pass TargetError.
+	*	TargetError is a fraction of the largest side of the mesh bounds. Returns the error reached, in the same units.
+	*/
+	static float Simplify(const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, const TArray<int32>& Indices,
+		int32 TargetIndexCount, float TargetError, TArray<int32>& OutIndices);
+
+	/* Simplifies a section's triangles. Positions is only used by dual buffer sections */
+	template<typename VertexType>
+	static float Simplify(const TArray<VertexType>& Vertices, const TArray<FVector>* Positions, const TArray<int32>& Indices,
+		int32 TargetIndexCount, float TargetError, TArray<int32>& OutIndices)
+	{
+		check(Positions == nullptr || Positions->Num() == Vertices.Num());
+
+		if (Positions)
+		{
+			return Simplify(reinterpret_cast<const uint8*>(Positions->GetData()), sizeof(FVector), Positions->Num(), Indices, TargetIndexCount, TargetError, OutIndices);
+		}
+		return Simplify(GetVertexPositions(Vertices), sizeof(VertexType), Vertices.Num(), Indices, TargetIndexCount, TargetError, OutIndices);
+	}
+
+	/* Copies out only the vertices the triangles use, for collision which doesn't want the unused ones */
+	static void CompactMesh(const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, const TArray<int32>& Indices,
+		TArray<FVector>& OutPositions, TArray<int32>& OutIndices);
+
+private:
+	template<typename VertexType>
+	static typename TEnableIf<FVertexHasPositionComponent<VertexType>::Value, const uint8*>::Type GetVertexPositions(const TArray<VertexType>& Vertices)
+	{
+		return reinterpret_cast<const uint8*>(Vertices.GetData()) + STRUCT_OFFSET(VertexType, Position);
+	}
+
+	template<typename VertexType>
+	static typename TEnableIf<!FVertexHasPositionComponent<VertexType>::Value, const uint8*>::Type GetVertexPositions(const TArray<VertexType>& Vertices)
+	{
+		checkf(false, TEXT("Vertex type has no position, the position buffer must be supplied."));
+		return nullptr;
+	}
+};
@@ -0,0 +1,102 @@
+// Copyright 2016 Chris Conway (Koderz). All Rights Reserved.
+
+#pragma once
+
+#include "Engine.h"
+#include "Async/ParallelFor.h"
+#include "RuntimeMeshCore.h"
+
+template<int32 TextureChannels, bool HalfPrecisionUVs, bool HasPositionComponent>
+struct FRuntimeMeshVertex;
+
+/* Helper for determining if a vertex type is one of the generic FRuntimeMeshVertex types */
+template<typename T> struct FVertexIsGenericVertex { static bool const Value = false; };
+template<int32 TextureChannels, bool HalfPrecisionUVs, bool HasPositionComponent>
+struct FVertexIsGenericVertex<FRuntimeMeshVertex<TextureChannels, HalfPrecisionUVs, HasPositionComponent>> { static bool const Value = true; };
+
+
+/* Tangent basis of the vertices recalculated by FRuntimeMeshTangents::Calculate */
+struct FRuntimeMeshTangentsResult
+{
+	/* Vertices that were recalculated in ascending order, empty if all of them were */
+	TArray<int32> Vertices;
+
+	/* Basis of each recalculated vertex, in the same order as Vertices (or indexed by vertex) */
+	TArray<FVector> Normals;
+	TArray<FVector> Tangents;
+	TArray<float> BinormalSigns;
+
+	int32 Num() const { return Normals.Num(); }
+	int32 GetVertex(int32 Index) const { return Vertices.Num() > 0 ? Vertices[Index] : Index; }
+};
+
+/*
+*	Normal and tangent generation for sections. Face normals are area weighted, and face tangents are
+*	built from UV0 and area weighted the same way. Each vertex gets an orthonormal tangent and a sign
+*	for the binormal, like MikkTSpace stores it. Faces are computed in parallel over triangle ranges and
+*	then gathered per vertex in parallel through a vertex to triangle table, so nothing is written twice.
+*
+*	Vertices within WeldTolerance of each other share their normal, which smooths across split vertices.
+*	Tangents are never welded since split vertices are usually UV seams. A negative tolerance turns welding off.
+*/
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshTangents
+{
+	/* Number of triangles or vertices per parallel task */
+	static const int32 ChunkSize = 4 * 1024;
+
+	/* Meshes with fewer triangles than this are done on the calling thread */
+	static const int32 ParallelThreshold = 16 * 1024;
+
+	/*
+	*	Calculates the tangent basis of a mesh. If DirtyVertices is supplied only the vertices whose basis
+	*	depends on them are recalculated, which are listed in the result.
+	*/
+	static void Calculate(const uint8* FirstPosition, int32 PositionStride, int32 NumVertices, const TArray<FVector2D>& UVs,
+		const TArray<int32>& Indices, float WeldTolerance, const TBitArray<>* DirtyVertices, FRuntimeMeshTangentsResult& OutResult);
+
+	/* Calculates the basis of a generic vertex buffer and writes it into the vertices. Positions is only used by dual buffer sections */
+	template<typename VertexType>
+	static void CalculateVertexTangents(TArray<VertexType>& Vertices, const TArray<FVector>* Positions, const TArray<int32>& Indices,
+		float WeldTolerance, const TBitArray<>* DirtyVertices, FRuntimeMeshTangentsResult& OutResult)
+	{
+		const int32 NumVertices = Vertices.Num();
+
+		TArray<FVector2D> UVs;
+		UVs.SetNumUninitialized(NumVertices);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			UVs[VertexIndex] = Vertices[VertexIndex].UV0;
+		}
+
+		if (Positions)
+		{
+			check(Positions->Num() == NumVertices);
+			Calculate(reinterpret_cast<const uint8*>(Positions->GetData()), sizeof(FVector), NumVertices, UVs, Indices, WeldTolerance, DirtyVertices, OutResult);
+		}
+		else
+		{
+			Calculate(GetVertexPositions(Vertices), sizeof(VertexType), NumVertices, UVs, Indices, WeldTolerance, DirtyVertices, OutResult);
+		}
+
+		for (int32 Index = 0; Index < OutResult.Num(); Index++)
+		{
+			const FVector& Normal = OutResult.Normals[Index];
+			const FVector& Tangent = OutResult.Tangents[Index];
+			Vertices[OutResult.GetVertex(Index)].SetNormalAndTangent(Tangent, (Normal ^ Tangent) * OutResult.BinormalSigns[Index], Normal);
+		}
+	}
+
+private:
+	template<typename VertexType>
+	static typename TEnableIf<FVertexHasPositionComponent<VertexType>::Value, const uint8*>::Type GetVertexPositions(const TArray<VertexType>& Vertices)
+	{
+		return reinterpret_cast<const uint8*>(Vertices.GetData()) + STRUCT_OFFSET(VertexType, Position);
+	}
+
+	template<typename VertexType>
+	static typename TEnableIf<!FVertexHasPositionComponent<VertexType>::Value, const uint8*>::Type GetVertexPositions(const TArray<VertexType>& Vertices)
+	{
+		checkf(false, TEXT("Vertex type has no position, the position buffer must be supplied."));
+		return nullptr;
+	}
+};
@@ -6,17 +6,110 @@
 #include "Components/MeshComponent.h"
 #include "RuntimeMeshProfiling.h"
 #include "RuntimeMeshVersion.h"
+#include "RuntimeMeshCore.h"
 
 
 
+/*
+ *	Pool for render thread command storage. Commands are built on the game thread or the batch workers and freed
+ *	on the render thread once applied, so freed blocks are kept in free lists per size instead of going back to the allocator.
+ *	Controlled by RuntimeMesh.CommandPoolMaxBlocks, RuntimeMesh.CommandRecycleMaxCount and RuntimeMesh.CommandRecycleMaxBytes.
+ */
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshCommandAllocator
+{
+	static void* Allocate(SIZE_T Size);
+	static void Free(void* Ptr, SIZE_T Size);
+
+	/* Returns all free blocks to the allocator */
+	static void Trim();
+
+	/* Most released commands of a single type to keep for reuse */
+	static int32 GetMaxRecycledCommands();
+
+	/* Largest payload a released command can hold on to and still be kept for reuse */
+	static SIZE_T GetMaxRecycledPayloadSize();
+};
+
+/* Routes new/delete of a command type through FRuntimeMeshCommandAllocator */
+#define RUNTIMEMESH_POOLED_COMMAND() \
+	static void* operator new(size_t Size) { return FRuntimeMeshCommandAllocator::Allocate(Size); } \
+	static void operator delete(void* Ptr, size_t Size) { FRuntimeMeshCommandAllocator::Free(Ptr, Size); }
+
+
+/*
+ *	Keeps released commands of one type with their arrays still allocated, so the next command of that type 
+ *	reuses the storage. Used by the commands that carry their own copy of the mesh data instead of sharing it.
+ *	CommandType needs GetPayloadSize() and ResetPayload().
+ */
+template<typename CommandType>
+class TRuntimeMeshCommandRecycler
+{
+public:
+	static CommandType* Get()
+	{
+		FFreeList& FreeList = GetFreeList();
+		{
+			FScopeLock Lock(&FreeList.Lock);
+			if (FreeList.Commands.Num() > 0)
+			{
+				return FreeList.Commands.Pop(false);
+			}
+		}
+		return new CommandType();
+	}
+
+	static void Recycle(CommandType* Command)
+	{
+		if (Command->GetPayloadSize() <= FRuntimeMeshCommandAllocator::GetMaxRecycledPayloadSize())
+		{
+			Command->ResetPayload();
+
+			FFreeList& FreeList = GetFreeList();
+			FScopeLock Lock(&FreeList.Lock);
+			if (FreeList.Commands.Num() < FRuntimeMeshCommandAllocator::GetMaxRecycledCommands())
+			{
+				FreeList.Commands.Add(Command);
+				return;
+			}
+		}
+
+		delete Command;
+	}
+
+private:
+	struct FFreeList
+	{
+		FCriticalSection Lock;
+		TArray<CommandType*> Commands;
+
+		~FFreeList()
+		{
+			for (CommandType* Command : Commands)
+			{
+				delete Command;
+			}
+		}
+	};
+
+	static FFreeList& GetFreeList()
+	{
+		static FFreeList FreeList;
+		return FreeList;
+	}
+};
+
 
 /* Base class for all render thread command information */
 class FRuntimeMeshRenderThreadCommandInterface
 {
 public:
+	RUNTIMEMESH_POOLED_COMMAND()
 
 	FRuntimeMeshRenderThreadCommandInterface() { }
 	virtual ~FRuntimeMeshRenderThreadCommandInterface() { }
+
+	/* Frees the command once the render thread is done with it */
+	virtual void Release() { delete this; }
 	
 	virtual void SetTargetSection(int32 InTargetSection) { TargetSection = InTargetSection; }
 	virtual int32 GetTargetSection() { return TargetSection; }
@@ -51,17 +144,35 @@ template<typename VertexType>
 class FRuntimeMeshSectionCreateData : public FRuntimeMeshSectionCreateDataInterface
 {
 public:
-	/* Updated position vertex buffer for the section */
-	TArray<FVector> PositionVertexBuffer;
+	/* Updated position vertex buffer for the section. Shared with the game thread section */
+	FRuntimeMeshSharedBuffer<FVector>::SharedArrayRef PositionVertexBuffer;
+
+	/* Updated vertex buffer for the section. Shared with the game thread section */
+	typename FRuntimeMeshSharedBuffer<VertexType>::SharedArrayRef VertexBuffer;
+
+	/* Updated index buffer for the section. Shared with the game thread section */
+	FRuntimeMeshSharedBuffer<int32>::SharedArrayRef IndexBuffer;
+
+	/* Index buffers for LOD 1 and up. Shared with the game thread section */
+	TArray<FRuntimeMeshSharedBuffer<int32>::SharedArrayRef> LODIndexBuffers;
 
-	/* Updated vertex buffer for the section */
-	TArray<VertexType> VertexBuffer;
+	/* Screen size below which each of LODIndexBuffers is used */
+	TArray<float> LODScreenSizes;
 
-	/* Updated index buffer for the section */
-	TArray<int32> IndexBuffer;
+	/* Instances of an instanced section, null for regular sections. Shared with the game thread section */
+	FRuntimeMeshSharedBuffer<FRuntimeMeshInstanceData>::SharedArrayRef Instances;
 
+	/* Local bounding box of the section after this update */
+	FBox LocalBoundingBox;
 
-	FRuntimeMeshSectionCreateData() {}
+	/* Should the buffers be created so spans can be written in place. Frequent sections start out with buffers that can only be replaced whole */
+	bool bEnableRangeUpdates;
+
+	/* Should the instance buffer be created so spans can be written in place */
+	bool bEnableInstanceRangeUpdates;
+
+
+	FRuntimeMeshSectionCreateData() : bEnableRangeUpdates(false), bEnableInstanceRangeUpdates(false) {}
 	virtual ~FRuntimeMeshSectionCreateData() override { }
 
 };
@@ -71,14 +182,14 @@ template<typename VertexType>
 class FRuntimeMeshSectionUpdateData : public FRuntimeMeshRenderThreadCommandInterface
 {
 public:
-	/* Updated position vertex buffer for the section */
-	TArray<FVector> PositionVertexBuffer;
+	/* Updated position vertex buffer for the section. Shared with the game thread section */
+	FRuntimeMeshSharedBuffer<FVector>::SharedArrayRef PositionVertexBuffer;
 
-	/* Updated vertex buffer for the section */
-	TArray<VertexType> VertexBuffer;
+	/* Updated vertex buffer for the section. Shared with the game thread section */
+	typename FRuntimeMeshSharedBuffer<VertexType>::SharedArrayRef VertexBuffer;
 
-	/* Updated index buffer for the section */
-	TArray<int32> IndexBuffer;
+	/* Updated index buffer for the section. Shared with the game thread section */
+	FRuntimeMeshSharedBuffer<int32>::SharedArrayRef IndexBuffer;
 
 	/* Should we apply the position buffer */
 	bool bIncludePositionBuffer;
@@ -89,7 +200,19 @@ public:
 	/* Should we apply the indices as an update */
 	bool bIncludeIndices;
 
-	FRuntimeMeshSectionUpdateData() {}
+	/* Index buffers for LOD 1 and up, sent along with the indices. Shared with the game thread section */
+	TArray<FRuntimeMeshSharedBuffer<int32>::SharedArrayRef> LODIndexBuffers;
+
+	/* Screen size below which each of LODIndexBuffers is used */
+	TArray<float> LODScreenSizes;
+
+	/* Local bounding box of the section after this update */
+	FBox LocalBoundingBox;
+
+	/* Should the buffers be moved to storage that can be written in place before they're replaced. Sent with every buffer included */
+	bool bEnableRangeUpdates;
+
+	FRuntimeMeshSectionUpdateData() : bEnableRangeUpdates(false) {}
 	virtual ~FRuntimeMeshSectionUpdateData() override { }
 };
 
@@ -98,13 +221,74 @@ template<typename VertexType>
 class FRuntimeMeshSectionPositionOnlyUpdateData : public FRuntimeMeshRenderThreadCommandInterface
 {
 public:
-	/* Updated position vertex buffer for the section */
-	TArray<FVector> PositionVertexBuffer;
+	/* Updated position vertex buffer for the section. Shared with the game thread section */
+	FRuntimeMeshSharedBuffer<FVector>::SharedArrayRef PositionVertexBuffer;
+
+	/* Local bounding box of the section after this update */
+	FBox LocalBoundingBox;
 
 	FRuntimeMeshSectionPositionOnlyUpdateData() {}
 	virtual ~FRuntimeMeshSectionPositionOnlyUpdateData() override { }
 };
 
+/** Templated class for update data sent to the RT for updating spans of a single mesh section */
+template<typename VertexType>
+class FRuntimeMeshSectionRangeUpdateData : public FRuntimeMeshRenderThreadCommandInterface
+{
+public:
+	/* Changed spans of the position vertex buffer */
+	TArray<FRuntimeMeshBufferRange> PositionRanges;
+
+	/* Position data for all spans in PositionRanges, packed back to back */
+	TArray<FVector> PositionData;
+
+	/* Changed spans of the vertex buffer */
+	TArray<FRuntimeMeshBufferRange> VertexRanges;
+
+	/* Vertex data for all spans in VertexRanges, packed back to back */
+	TArray<VertexType> VertexData;
+
+	/* Changed spans of the index buffer */
+	TArray<FRuntimeMeshBufferRange> IndexRanges;
+
+	/* Index data for all spans in IndexRanges, packed back to back */
+	TArray<int32> IndexData;
+
+	/* Local bounding box of the section after this update */
+	FBox LocalBoundingBox;
+
+	FRuntimeMeshSectionRangeUpdateData() {}
+	virtual ~FRuntimeMeshSectionRangeUpdateData() override { }
+
+	/* Gets a range update, reusing the arrays of a previous one when possible */
+	static FRuntimeMeshSectionRangeUpdateData* Create()
+	{
+		return TRuntimeMeshCommandRecycler<FRuntimeMeshSectionRangeUpdateData>::Get();
+	}
+
+	virtual void Release() override
+	{
+		TRuntimeMeshCommandRecycler<FRuntimeMeshSectionRangeUpdateData>::Recycle(this);
+	}
+
+	SIZE_T GetPayloadSize() const
+	{
+		return PositionRanges.GetAllocatedSize() + PositionData.GetAllocatedSize() + VertexRanges.GetAllocatedSize() +
+			VertexData.GetAllocatedSize() + IndexRanges.GetAllocatedSize() + IndexData.GetAllocatedSize();
+	}
+
+	/* Empties the arrays but keeps their allocations */
+	void ResetPayload()
+	{
+		PositionRanges.Reset();
+		PositionData.Reset();
+		VertexRanges.Reset();
+		VertexData.Reset();
+		IndexRanges.Reset();
+		IndexData.Reset();
+	}
+};
+
 /** Property update for a single section */
 class FRuntimeMeshSectionPropertyUpdateData : public FRuntimeMeshRenderThreadCommandInterface
 {
@@ -119,6 +303,29 @@ public:
 	virtual ~FRuntimeMeshSectionPropertyUpdateData() override { }
 };
 
+/** Instance update for a single instanced section */
+class FRuntimeMeshSectionInstanceUpdateData : public FRuntimeMeshRenderThreadCommandInterface
+{
+public:
+	/* Every instance of the section, set when the whole buffer is replaced. Shared with the game thread section */
+	FRuntimeMeshSharedBuffer<FRuntimeMeshInstanceData>::SharedArrayRef Instances;
+
+	/* Changed spans of the instance buffer, used instead of Instances when the instance count is unchanged */
+	TArray<FRuntimeMeshBufferRange> InstanceRanges;
+
+	/* Instance data for all spans in InstanceRanges, packed back to back */
+	TArray<FRuntimeMeshInstanceData> InstanceData;
+
+	/* Local bounding box of the section and all its instances after this update */
+	FBox LocalBoundingBox;
+
+	/* Should the instance buffer be moved to storage that can be written in place before it's replaced. Sent with Instances */
+	bool bEnableRangeUpdates;
+
+	FRuntimeMeshSectionInstanceUpdateData() : bEnableRangeUpdates(false) {}
+	virtual ~FRuntimeMeshSectionInstanceUpdateData() override { }
+};
+
 enum class ERuntimeMeshSectionBatchUpdateType
 {
 	None = 0x0,
@@ -128,6 +335,8 @@ enum class ERuntimeMeshSectionBatchUpdateType
 	VerticesUpdate = 0x8,
 	IndicesUpdate = 0x10,
 	PropertyUpdate = 0x20,
+	RangeUpdate = 0x40,
+	InstanceUpdate = 0x80,
 };
 
 ENUM_CLASS_FLAGS(ERuntimeMeshSectionBatchUpdateType)
@@ -136,26 +345,55 @@ ENUM_CLASS_FLAGS(ERuntimeMeshSectionBatchUpdateType)
 /* Struct carrying all update data for a batch update sent to the render thread */
 struct FRuntimeMeshBatchUpdateData
 {
+	RUNTIMEMESH_POOLED_COMMAND()
+
 	TArray<FRuntimeMeshSectionCreateDataInterface*> CreateSections;
 	TArray<int32> DestroySections;
 	TArray<FRuntimeMeshRenderThreadCommandInterface*> UpdateSections;
+	TArray<FRuntimeMeshRenderThreadCommandInterface*> RangeUpdateSections;
 	TArray<FRuntimeMeshSectionPropertyUpdateData*> PropertyUpdateSections;
+	TArray<FRuntimeMeshSectionInstanceUpdateData*> InstanceUpdateSections;
 };
 
 
 
+/*
+*	Per frame limit on the section uploads sent by components using bUseUploadBudget, shared by all of them.
+*	Set by RuntimeMesh.UploadBudgetBytes and RuntimeMesh.UploadBudgetSections. Game thread only.
+*/
+struct RUNTIMEMESHCOMPONENT_API FRuntimeMeshUploadBudget
+{
+	/* Is either limit set */
+	static bool IsEnabled();
+
+	/* Takes an upload out of this frame's budget, returns false if it doesn't fit. The first upload of a frame always fits so large sections still go */
+	static bool TryConsume(SIZE_T NumBytes);
+
+private:
+	static uint64 CurrentFrame;
+	static SIZE_T BytesUsed;
+	static int32 SectionsUsed;
+};
+
+
 struct FRuntimeMeshBatchUpdateState
 {
-	void StartBatch() { bIsPending = true; }
+	void StartBatch(bool bInIsAutoBatch = false) 
+	{
+		bIsPending = true;
+		bIsAutoBatch = bInIsAutoBatch;
+	}
 
 	void ResetBatch() 
 	{
 		bIsPending = false;
+		bIsAutoBatch = false;
 		bRequiresSceneProxyReCreate = false;
 		bRequiresBoundsUpdate = false;
 		bRequiresCollisionUpdate = false;
 
-		SectionUpdates.Empty();
+		SectionUpdates.Reset();
+		DirtySections.Reset();
 	}
 
 	
@@ -163,6 +401,11 @@ struct FRuntimeMeshBatchUpdateState
 
 	bool IsBatchPending() { return bIsPending; }
 
+	ERuntimeMeshSectionBatchUpdateType GetSectionUpdates(int32 SectionIndex) { return SectionUpdates.FindRef(SectionIndex); }
+
+	/* Was the batch started by the component for bAutoBatchUpdates instead of by BeginBatchUpdates() */
+	bool IsAutoBatch() { return bIsPending && bIsAutoBatch; }
+
 	void MarkSectionCreated(int32 SectionIndex, bool bPromoteToProxyRecreate)
 	{
 		// Flag recreate instead of individual section
@@ -172,19 +415,17 @@ struct FRuntimeMeshBatchUpdateState
 			return;
 		}
 
-		EnsureUpdateLength(SectionIndex);
+		ERuntimeMeshSectionBatchUpdateType& Updates = FindOrAddSectionUpdates(SectionIndex);
 
 		// Clear destroyed flag and set created
-		SectionUpdates[SectionIndex] &= ~ERuntimeMeshSectionBatchUpdateType::Destroy;
-		SectionUpdates[SectionIndex] |= ERuntimeMeshSectionBatchUpdateType::Create;
+		Updates &= ~ERuntimeMeshSectionBatchUpdateType::Destroy;
+		Updates |= ERuntimeMeshSectionBatchUpdateType::Create;
 	}
 
 	void MarkUpdateForSection(int32 SectionIndex, ERuntimeMeshSectionBatchUpdateType UpdateType)
 	{
-		EnsureUpdateLength(SectionIndex);
-		
 		// Add update type
-		SectionUpdates[SectionIndex] |= UpdateType;
+		FindOrAddSectionUpdates(SectionIndex) |= UpdateType;
 	}
 
 	void MarkSectionDestroyed(int32 SectionIndex, bool bPromoteToProxyRecreate)
@@ -196,11 +437,11 @@ struct FRuntimeMeshBatchUpdateState
 			return;
 		}
 
-		EnsureUpdateLength(SectionIndex);
+		ERuntimeMeshSectionBatchUpdateType& Updates = FindOrAddSectionUpdates(SectionIndex);
 
-		// Clear destroyed flag and set created
-		SectionUpdates[SectionIndex] &= ~ERuntimeMeshSectionBatchUpdateType::Create;
-		SectionUpdates[SectionIndex] |= ERuntimeMeshSectionBatchUpdateType::Destroy;
+		// Clear created flag and set destroyed
+		Updates &= ~ERuntimeMeshSectionBatchUpdateType::Create;
+		Updates |= ERuntimeMeshSectionBatchUpdateType::Destroy;
 	}
 
 	void MarkRenderStateDirty() { bRequiresSceneProxyReCreate = true; }
@@ -211,11 +452,11 @@ struct FRuntimeMeshBatchUpdateState
 
 
 
-	bool HasAnyFlagSet(int32 SectionIndex) { return SectionUpdates[SectionIndex] != ERuntimeMeshSectionBatchUpdateType::None; }
+	bool HasAnyFlagSet(int32 SectionIndex) { return GetSectionUpdates(SectionIndex) != ERuntimeMeshSectionBatchUpdateType::None; }
 
 	bool HasFlagSet(int32 SectionIndex, ERuntimeMeshSectionBatchUpdateType UpdateType)
 	{
-		return (SectionUpdates[SectionIndex] & UpdateType) == UpdateType;
+		return (GetSectionUpdates(SectionIndex) & UpdateType) == UpdateType;
 	}
 
 	bool RequiresSceneProxyRecreate() { return bRequiresSceneProxyReCreate; }
@@ -224,26 +465,32 @@ struct FRuntimeMeshBatchUpdateState
 
 	bool RequiresCollisionUpdate() { return bRequiresCollisionUpdate; }
 
-	int32 GetMaxSection() { return SectionUpdates.Num() - 1; }
+	/* Sections with any update flagged, in the order they were first flagged */
+	const TArray<int32>& GetDirtySections() { return DirtySections; }
 
 private:
 
-	void EnsureUpdateLength(int32 SectionIndex)
+	ERuntimeMeshSectionBatchUpdateType& FindOrAddSectionUpdates(int32 SectionIndex)
 	{
-		if (SectionIndex < SectionUpdates.Num())
+		if (ERuntimeMeshSectionBatchUpdateType* Updates = SectionUpdates.Find(SectionIndex))
 		{
-			return;
+			return *Updates;
 		}
 
-		SectionUpdates.AddZeroed((SectionIndex + 1) - SectionUpdates.Num());
+		DirtySections.Add(SectionIndex);
+		return SectionUpdates.Add(SectionIndex, ERuntimeMeshSectionBatchUpdateType::None);
 	}
 
 
 	bool bIsPending;
+	bool bIsAutoBatch;
 	bool bRequiresSceneProxyReCreate;
 	bool bRequiresBoundsUpdate;
 	bool bRequiresCollisionUpdate;
-	TArray<ERuntimeMeshSectionBatchUpdateType> SectionUpdates;
+
+	/* Only sections touched by the batch have an entry, so sparse section indices don't cost anything */
+	TMap<int32, ERuntimeMeshSectionBatchUpdateType> SectionUpdates;
+	TArray<int32> DirtySections;
 	
 
 
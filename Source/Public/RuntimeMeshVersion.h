@@ -14,6 +14,12 @@ namespace FRuntimeMeshVersion
 		TemplatedVertexFix = 1,
 		SerializationOptional = 2,
 		DualVertexBuffer = 3,
+		SectionLODs = 4,
+		QuantizedPositions = 5,
+		BulkSerialization = 6,
+		InstancedSections = 7,
+		GPUDeformableSections = 8,
+		MeshCache = 9,
 
 
 		// -----<new versions can be added above this line>-------------------------------------------------
@@ -20,5 +20,8 @@ public class RuntimeMeshComponent : ModuleRules
                         "RHI"
                 }
             );
+
+        // Only for finding the PhysX cooker, which is loaded through the module manager
+        PrivateIncludePathModuleNames.Add("TargetPlatform");
     }
 }